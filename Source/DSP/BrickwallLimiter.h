@@ -0,0 +1,236 @@
+#pragma once
+
+#include "DspArena.h"
+#include "TruePeak.h"
+#include <algorithm>
+#include <cmath>
+#include <span>
+
+/// マスター出力用ルックアヘッド ブリックウォール リミッター（ヘッダオンリー、
+/// オーディオスレッド専用）。
+///
+/// ゲイン計算:
+///   1. 要求ゲイン req = min(1, ceiling / peak)（True Peak 時は 4× 補間ピーク）
+///   2. 直近 window サンプルの req 最小値（単調デックで償却 O(1)）
+///   3. リリース平滑（下げは即時、戻しは 1 次）
+///   4. ルックアヘッド長の移動平均（累積和で O(1)）
+/// 音声は同じ長さだけ遅延させるため、平均後のゲインは各ピークが出力される
+/// 時点で必ず req 以下になり、オーバーシュートしない。
+///
+/// setEnabled(false) でもゲイン計算と遅延線は止めず、適用するゲインを
+/// kBypassFadeMs かけて 1 へ戻す（切り替えでレイテンシも音も途切れない）。
+class BrickwallLimiter {
+public:
+  static constexpr float kLookaheadMs = 1.5f;
+  static constexpr float kReleaseMs = 80.0f;
+  static constexpr float kBypassFadeMs = 10.0f;
+  static constexpr float kQuietLevel = 1.0e-6f; ///< isSettled() の無音判定
+
+  /// prepare(sampleRate, arena) が切り出すバイト数
+  static std::size_t arenaBytes(double sampleRate) noexcept {
+    const Lengths n = lengthsFor(sampleRate);
+    return 2 * DspArena::bytesFor<float>(n.delay) +
+           DspArena::bytesFor<float>(n.lookahead) +
+           DspArena::bytesFor<int>(n.window) +
+           DspArena::bytesFor<float>(n.window);
+  }
+
+  /// sampleRate でのレイテンシ（prepare 前に見積もる用）
+  static int latencyFor(double sampleRate) noexcept {
+    return static_cast<int>(lengthsFor(sampleRate).delay);
+  }
+
+  /// prepareToPlay() から呼ぶ。遅延線とゲイン窓を arena から切り出す。
+  void prepare(double sampleRate, DspArena &arena) {
+    const Lengths n = lengthsFor(sampleRate);
+    lookahead_ = static_cast<int>(n.lookahead);
+    delay_ = static_cast<int>(n.delay);
+    window_ = static_cast<int>(n.window);
+
+    delayL_ = arena.take<float>(n.delay);
+    delayR_ = arena.take<float>(n.delay);
+    box_ = arena.take<float>(n.lookahead);
+    dequeIdx_ = arena.take<int>(n.window);
+    dequeVal_ = arena.take<float>(n.window);
+    std::ranges::fill(dequeVal_, 1.0f);
+    releaseCoeff_ = static_cast<float>(
+        1.0 - std::exp(-1.0 / (kReleaseMs * 0.001 * sampleRate)));
+    fadeStep_ = static_cast<float>(1.0 / (kBypassFadeMs * 0.001 * sampleRate));
+    tpL_.prepare();
+    tpR_.prepare();
+    reset();
+  }
+
+  /// 単体利用（テスト等）: 自前のアリーナで prepare する。
+  void prepare(double sampleRate) {
+    localArena_.reset(arenaBytes(sampleRate));
+    prepare(sampleRate, localArena_);
+  }
+
+  void reset() noexcept {
+    std::ranges::fill(delayL_, 0.0f);
+    std::ranges::fill(delayR_, 0.0f);
+    std::ranges::fill(box_, 1.0f);
+    delayPos_ = 0;
+    boxPos_ = 0;
+    boxSum_ = static_cast<double>(lookahead_);
+    dqHead_ = 0;
+    dqSize_ = 0;
+    time_ = 0;
+    env_ = 1.0f;
+    mix_ = enabled_ ? 1.0f : 0.0f;
+    quietRun_ = 0;
+    tpL_.reset();
+    tpR_.reset();
+  }
+
+  void setCeilingDb(float db) noexcept {
+    ceiling_ = std::pow(10.0f, db / 20.0f);
+  }
+  void setTruePeak(bool on) noexcept { truePeak_ = on; }
+  /// false でバイパス（遅延はそのまま、ゲインだけクロスフェードで外す）
+  void setEnabled(bool on) noexcept {
+    enabled_ = on;
+    if (isSettled()) // 鳴っていなければフェード不要
+      mix_ = on ? 1.0f : 0.0f;
+  }
+
+  /// 報告すべきレイテンシ（サンプル）
+  [[nodiscard]] int latencySamples() const noexcept { return delay_; }
+
+  /// 遅延線とゲイン窓が無音で満たされていれば true（アイドル短絡可）
+  [[nodiscard]] bool isSettled() const noexcept { return quietRun_ >= window_; }
+
+  /// 直近ブロックで実際に掛けた最大ゲインリダクション（dB, 0 以下。
+  /// バイパス中は 0）
+  [[nodiscard]] float lastReductionDb() const noexcept {
+    return 20.0f * std::log10(std::max(minGain_, 1.0e-5f));
+  }
+
+  /// inputGain を掛けてからリミットする（マスターゲインとの融合パス）。
+  /// r == nullptr のときはモノとして l のみ処理する。
+  void process(float *l, float *r, int numSamples, float inputGain) noexcept {
+    minGain_ = 1.0f;
+    for (int i = 0; i < numSamples; ++i) {
+      const float xl = l[i] * inputGain;
+      const float xr = r != nullptr ? r[i] * inputGain : xl;
+      quietRun_ = std::abs(xl) + std::abs(xr) < kQuietLevel
+                      ? std::min(quietRun_ + 1, window_)
+                      : 0;
+
+      float peak = std::max(std::abs(xl), std::abs(xr));
+      if (truePeak_)
+        peak = std::max({peak, tpL_.push(xl), tpR_.push(xr)});
+      const float req = peak > ceiling_ ? ceiling_ / peak : 1.0f;
+
+      const float held = slidingMin(req);
+      env_ = held < env_ ? held : env_ + (held - env_) * releaseCoeff_;
+
+      // 移動平均（ルックアヘッド長）
+      const auto b = static_cast<std::size_t>(boxPos_);
+      boxSum_ += static_cast<double>(env_) - static_cast<double>(box_[b]);
+      box_[b] = env_;
+      if (++boxPos_ == lookahead_) {
+        boxPos_ = 0;
+        // 累積誤差を周期的に捨てる
+        boxSum_ = 0.0;
+        for (const float v : box_)
+          boxSum_ += static_cast<double>(v);
+      }
+      const auto limited =
+          static_cast<float>(boxSum_ / static_cast<double>(lookahead_));
+      mix_ = enabled_ ? std::min(1.0f, mix_ + fadeStep_)
+                      : std::max(0.0f, mix_ - fadeStep_);
+      const float gain = 1.0f + (limited - 1.0f) * mix_;
+      minGain_ = std::min(minGain_, gain);
+
+      // 遅延線（delay_ サンプル前の入力を出力）
+      const auto d = static_cast<std::size_t>(delayPos_);
+      const float dl = delayL_[d];
+      const float dr = delayR_[d];
+      delayL_[d] = xl;
+      delayR_[d] = xr;
+      if (++delayPos_ == delay_)
+        delayPos_ = 0;
+
+      l[i] = dl * gain;
+      if (r != nullptr)
+        r[i] = dr * gain;
+    }
+  }
+
+private:
+  struct Lengths {
+    std::size_t lookahead;
+    std::size_t delay;
+    std::size_t window;
+  };
+  static Lengths lengthsFor(double sampleRate) noexcept {
+    const auto lookahead = std::max(
+        1, static_cast<int>(std::lround(kLookaheadMs * 0.001 * sampleRate)));
+    // True Peak 推定の群遅延ぶんも先読みする（ON/OFF でレイテンシを変えない）
+    const int delay = lookahead + TruePeak::kGroupDelay;
+    return {static_cast<std::size_t>(lookahead),
+            static_cast<std::size_t>(delay),
+            static_cast<std::size_t>(delay + 1)};
+  }
+
+  /// 直近 window_ サンプルの最小値（単調増加デック、償却 O(1)）
+  float slidingMin(float v) noexcept {
+    const int cap = window_;
+    // 末尾から v 以上の値を捨てる
+    while (dqSize_ > 0) {
+      const int back = (dqHead_ + dqSize_ - 1) % cap;
+      if (dequeVal_[static_cast<std::size_t>(back)] < v)
+        break;
+      --dqSize_;
+    }
+    const int tail = (dqHead_ + dqSize_) % cap;
+    dequeIdx_[static_cast<std::size_t>(tail)] = time_;
+    dequeVal_[static_cast<std::size_t>(tail)] = v;
+    ++dqSize_;
+    // 窓外に出た先頭を捨てる
+    if (time_ - dequeIdx_[static_cast<std::size_t>(dqHead_)] >= window_) {
+      dqHead_ = (dqHead_ + 1) % cap;
+      --dqSize_;
+    }
+    // オーバーフロー防止（差分しか使わないので周期的に巻き戻す）
+    if (++time_ >= (1 << 30)) {
+      for (int k = 0; k < dqSize_; ++k)
+        dequeIdx_[static_cast<std::size_t>((dqHead_ + k) % cap)] -= time_;
+      time_ = 0;
+    }
+    return dequeVal_[static_cast<std::size_t>(dqHead_)];
+  }
+
+  float ceiling_ = 0.891f; ///< ≈ -1 dBFS
+  bool truePeak_ = true;
+  bool enabled_ = true;
+  float mix_ = 1.0f; ///< 適用率（0 = バイパス、1 = リミット）
+  float fadeStep_ = 0.01f;
+  int lookahead_ = 1;
+  int delay_ = 1;
+  int window_ = 2;
+  float releaseCoeff_ = 0.001f;
+
+  std::span<float> delayL_;
+  std::span<float> delayR_;
+  int delayPos_ = 0;
+
+  std::span<float> box_;
+  int boxPos_ = 0;
+  double boxSum_ = 1.0;
+
+  std::span<int> dequeIdx_;
+  std::span<float> dequeVal_;
+  int dqHead_ = 0;
+  int dqSize_ = 0;
+  int time_ = 0;
+
+  float env_ = 1.0f;
+  int quietRun_ = 0; ///< 連続無音入力サンプル数（window_ で飽和）
+  float minGain_ = 1.0f;
+  TruePeak::Estimator tpL_;
+  TruePeak::Estimator tpR_;
+  DspArena localArena_; ///< 単体利用時のみ使う
+};
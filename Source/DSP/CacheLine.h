@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+
+/// 偽共有を避ける境界長。UI スレッドが書くアトミック群と、オーディオ
+/// スレッドが毎サンプル書く状態を別ラインに分ける alignas に使う。
+/// Apple Silicon などの arm64 はキャッシュラインが 128 バイト（L2 の
+/// ライン / 隣接ラインのペア取得）なので 128、x86-64 は 64 とする。
+/// std::hardware_destructive_interference_size はコンパイラ間で値が
+/// 揺れて ABI 警告も出るため使わず、ここで明示的に決める。
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm64__)
+inline constexpr std::size_t kCacheLineSize = 128;
+#else
+inline constexpr std::size_t kCacheLineSize = 64;
+#endif
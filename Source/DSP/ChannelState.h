@@ -1,13 +1,16 @@
 #pragma once
 
-#include "LevelDetector.h"
+#include "CacheLine.h"
 #include <array>
 #include <atomic>
 #include <utility>
 
-/// チャンネル単位の Mute / Solo / レベル計測 を一元管理するヘルパー。
+/// チャンネル単位の Mute / Solo を一元管理するヘルパー。
+/// レベル計測は MeterEngine が担当する。
 /// BoomBabyAudioProcessor から分離し、メソッド数を削減する。
-class ChannelState {
+/// UI だけが書き込むので、隣接するオーディオ側状態と同じキャッシュラインに
+/// 乗らないよう 1 ライン単位で配置する。
+class alignas(kCacheLineSize) ChannelState {
 public:
   enum class Channel { sub = 0, click = 1, direct = 2 };
 
@@ -28,13 +31,6 @@ public:
     solo_[static_cast<std::size_t>(std::to_underlying(ch))].store(soloed);
   }
 
-  // ── UI スレッドから呼び出す getter ──
-
-  [[nodiscard]] float getChannelLevelDb(Channel ch) const noexcept {
-    return detectors_[static_cast<std::size_t>(std::to_underlying(ch))]
-        .getPeakDb();
-  }
-
   // ── オーディオスレッドから呼び出す ──
 
   /// 現在の mute/solo 状態から各チャンネルの通過判定を算出。
@@ -55,20 +51,7 @@ public:
             !isMuted(click) && (!anySolo || isSoloed(click))};
   }
 
-  /// LevelDetector への直接アクセス（オーディオスレッドから process()
-  /// 呼び出し用）。
-  LevelDetector &detector(Channel ch) noexcept {
-    return detectors_[static_cast<std::size_t>(std::to_underlying(ch))];
-  }
-
-  /// prepareToPlay() で呼び出す。
-  void resetDetectors() noexcept {
-    for (auto &d : detectors_)
-      d.reset();
-  }
-
 private:
   std::array<std::atomic<bool>, 3> mute_{};
   std::array<std::atomic<bool>, 3> solo_{};
-  std::array<LevelDetector, 3> detectors_;
 };
@@ -1,8 +1,21 @@
 #include "ClickEngine.h"
 #include "Saturator.h"
+#include <algorithm>
 #include <cmath>
 
+std::size_t ClickEngine::arenaBytes(int samplesPerBlock) noexcept {
+  // scratch + サンプル読み出し L / R
+  return 3 * DspArena::bytesFor<float>(
+                 static_cast<std::size_t>(samplesPerBlock));
+}
+
 void ClickEngine::prepareToPlay(double sampleRate, int samplesPerBlock) {
+  localArena_.reset(arenaBytes(samplesPerBlock));
+  prepareToPlay(sampleRate, samplesPerBlock, localArena_);
+}
+
+void ClickEngine::prepareToPlay(double sampleRate, int samplesPerBlock,
+                                DspArena &arena) {
   // ── BPF / HPF / LPF 初期化 ──
   using enum juce::dsp::StateVariableTPTFilterType;
   juce::dsp::ProcessSpec spec{};
@@ -22,7 +35,9 @@ void ClickEngine::prepareToPlay(double sampleRate, int samplesPerBlock) {
     f.setType(lowpass);
   }
 
-  scratchBuffer_.resize(static_cast<size_t>(samplesPerBlock));
+  scratchBuffer_ = arena.take<float>(static_cast<size_t>(samplesPerBlock));
+  sampleL_ = arena.take<float>(static_cast<size_t>(samplesPerBlock));
+  sampleR_ = arena.take<float>(static_cast<size_t>(samplesPerBlock));
   noteTimeSamples_ = 0.0f;
   startOffset_ = 0;
   active_.store(false);
@@ -99,39 +114,49 @@ float ClickEngine::processFilterChain(const FilterFlags &flags, int ch,
   return s;
 }
 
-float ClickEngine::computeMaxTimeSamples(float sr, int mode,
-                                         double playRate) const {
+float ClickEngine::computeMaxTimeSamples(float sr, int mode, double playRate,
+                                         double sampleDurSec) const {
   if (mode != 2)
     return decayMs_.load() * sr / 1000.0f;
 
   const float ampDurMs = sampleParams_.decayMs.load();
   const float ampDurSamples = ampDurMs * sr / 1000.0f;
-  const double dur = sampler_.durationSec();
   const float samplerDurSamples =
-      (dur > 0.0 && playRate > 0.0)
-          ? static_cast<float>(dur / playRate * static_cast<double>(sr))
+      (sampleDurSec > 0.0 && playRate > 0.0)
+          ? static_cast<float>(sampleDurSec / playRate *
+                               static_cast<double>(sr))
           : 1e9f;
   return std::min(ampDurSamples, samplerDurSamples);
 }
 
-float ClickEngine::computeSampleAmp(float noteTimeMs) const {
-  return EnvelopeLutManager::computeAmp(
-      clickAmpLut_.getActiveLut(), clickAmpLut_.getDurationMs(), noteTimeMs);
+float ClickEngine::computeSampleAmp(float noteTimeMs, int &cursor) const {
+  return EnvelopeLutManager::computeAmp(clickAmpLut_.current(), noteTimeMs,
+                                        cursor);
+}
+
+void ClickEngine::readSampleBlock(int numSamples, double playRate) {
+  // 開始オフセット以降をまとめて読む。ロックが取れないブロックは無音
+  // （従来の 1 サンプルずつの読み出しで失敗したときと同じ）
+  const int lead = std::min(startOffset_, numSamples);
+  const auto view = sampler_.lock();
+  if (!view) {
+    std::fill_n(sampleL_.data(), numSamples, 0.0f);
+    std::fill_n(sampleR_.data(), numSamples, 0.0f);
+    return;
+  }
+  sampler_.readBlockStereo(view.samples, playRate, sampleL_.data() + lead,
+                           sampleR_.data() + lead, numSamples - lead);
 }
 
 void ClickEngine::renderOneSample(const FilterFlags &flags, float amp,
                                   float gain, bool clickPass,
-                                  juce::AudioBuffer<float> &buffer, int sample,
-                                  double playRate) {
+                                  juce::AudioBuffer<float> &buffer,
+                                  int sample) {
   const int numChannels = buffer.getNumChannels();
-  bool finished = false;
-  auto [sL, sR] = sampler_.readNextStereo(playRate, finished);
-  if (finished) {
-    sL = 0.0f;
-    sR = 0.0f;
-  }
-  sL = processFilterChain(flags, 0, sL) * amp * gain;
-  sR = processFilterChain(flags, 1, sR) * amp * gain;
+  // 末端以降は readBlockStereo() が 0 を書いている
+  const auto idx = static_cast<size_t>(sample);
+  const float sL = processFilterChain(flags, 0, sampleL_[idx]) * amp * gain;
+  const float sR = processFilterChain(flags, 1, sampleR_[idx]) * amp * gain;
   scratchBuffer_[static_cast<size_t>(sample)] = (sL + sR) * 0.5f;
   if (clickPass) {
     buffer.addSample(0, sample, sL);
@@ -168,7 +193,10 @@ void ClickEngine::render(juce::AudioBuffer<float> &buffer, int numSamples,
   const float decayMs = decayMs_.load();
   const int mode = mode_.load();
 
-  const double fileSr = sampler_.sampleRate();
+  // LUT とサンプルのメタ情報はブロック先頭で 1 回だけ取り込む
+  clickAmpLut_.acquire();
+  const auto &info = sampler_.acquireInfo();
+  const double fileSr = info.sampleRate;
   const double srRatio = (fileSr > 0) ? fileSr / sampleRate : 1.0;
 
   const double playRate =
@@ -176,8 +204,12 @@ void ClickEngine::render(juce::AudioBuffer<float> &buffer, int numSamples,
           ? std::pow(2.0, sampleParams_.pitchSemitones.load() / 12.0) * srRatio
           : 1.0;
 
-  const float maxTimeSamples = computeMaxTimeSamples(sr, mode, playRate);
+  const float maxTimeSamples =
+      computeMaxTimeSamples(sr, mode, playRate, info.durationSec);
   const FilterFlags flags = setupFilters(sr);
+  if (mode == 2)
+    readSampleBlock(numSamples, playRate);
+  int ampCursor = -1; // LUT の読み出し位置（ブロック内で単調に進む）
 
   for (int sample = 0; sample < numSamples; ++sample) {
     if (startOffset_ > 0) {
@@ -195,12 +227,11 @@ void ClickEngine::render(juce::AudioBuffer<float> &buffer, int numSamples,
 
     const float amp =
         (mode == 2)
-            ? computeSampleAmp(noteTimeSamples_ * 1000.0f / sr)
+            ? computeSampleAmp(noteTimeSamples_ * 1000.0f / sr, ampCursor)
             : std::exp(-noteTimeSamples_ * 5000.0f / (decayMs * sr + 1e-6f));
 
     if (mode == 2)
-      renderOneSample(flags, amp, clickGain, clickPass, buffer, sample,
-                      playRate);
+      renderOneSample(flags, amp, clickGain, clickPass, buffer, sample);
     else
       renderOneNoise(flags, amp, clickGain, clickPass, buffer, sample);
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "DspArena.h"
 #include "EnvelopeLutManager.h"
 #include "SamplePlayer.h"
 
@@ -8,7 +9,7 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_core/juce_core.h>
 #include <juce_dsp/juce_dsp.h>
-#include <vector>
+#include <span>
 
 /// Click チャンネルの DSP エンジン。
 ///   mode=1 (Noise)  : ホワイトノイズ → BPF 励起型（セルフレゾナント）
@@ -17,6 +18,13 @@
 class ClickEngine {
 public:
   // ── lifecycle ──
+  /// prepareToPlay(..., arena) が切り出すバイト数
+  static std::size_t arenaBytes(int samplesPerBlock) noexcept;
+
+  /// フィルターを初期化し、スクラッチを arena から切り出す。
+  void prepareToPlay(double sampleRate, int samplesPerBlock, DspArena &arena);
+
+  /// 単体利用（テスト等）: 自前のアリーナで prepareToPlay する。
   void prepareToPlay(double sampleRate, int samplesPerBlock);
 
   /// MIDI NoteOn / トランジェント検出時のトリガー
@@ -83,6 +91,9 @@ public:
   /// レベル計測用 scratchBuffer の先頭ポインタ
   const float *scratchData() const noexcept { return scratchBuffer_.data(); }
 
+  /// 発音中（トリガー待ちを含む）かどうか（アイドル判定用）
+  bool isActive() const noexcept { return active_.load(); }
+
   /// 内部 SamplePlayer への参照（UI からのロード用）
   SamplePlayer &sampler() noexcept { return sampler_; }
   const SamplePlayer &sampler() const noexcept { return sampler_; }
@@ -113,18 +124,31 @@ private:
   /// フィルタチェーン（Drive→HPF/LPF→共振整形）を 1ch 分処理
   float processFilterChain(const FilterFlags &flags, int ch, float s);
   /// Sampleモードの停止判定用時間（サンプル数）を計算
-  float computeMaxTimeSamples(float sr, int mode, double playRate) const;
-  /// Sampleモードのエンベロープ振幅（LUT + 末尾フェード）を計算
-  float computeSampleAmp(float noteTimeMs) const;
-  /// Sample モード 1 サンプルレンダリング
+  float computeMaxTimeSamples(float sr, int mode, double playRate,
+                              double sampleDurSec) const;
+  /// Sampleモードのエンベロープ振幅（LUT + 末尾フェード）を計算。
+  /// LUT は render 先頭で acquire() したものを使う。cursor は render 内で
+  /// 使い回す LUT の読み出し位置（ブロック先頭で -1）
+  float computeSampleAmp(float noteTimeMs, int &cursor) const;
+  /// Sample モードのサンプルを 1 ブロック分 sampleL_ / sampleR_ に読む
+  void readSampleBlock(int numSamples, double playRate);
+  /// Sample モード 1 サンプルレンダリング（readSampleBlock() 済みの値を使う）
   void renderOneSample(const FilterFlags &flags, float amp, float gain,
                        bool clickPass, juce::AudioBuffer<float> &buffer,
-                       int sample, double playRate);
+                       int sample);
   /// Noise モード 1 サンプルレンダリング
   void renderOneNoise(const FilterFlags &flags, float amp, float gain,
                       bool clickPass, juce::AudioBuffer<float> &buffer,
                       int sample);
 
+  // ── オーディオスレッドが書く再生状態 ──
+  float noteTimeSamples_{0.0f};
+  int startOffset_{0};
+  std::atomic<bool> active_{false};
+  std::span<float> scratchBuffer_; ///< DspArena 上
+  /// Sample モードで 1 ブロック分まとめて読んだサンプル（DspArena 上）
+  std::span<float> sampleL_;
+  std::span<float> sampleR_;
   // ── BPF（bpf1 はカスケード最大4段） ──
   std::array<juce::dsp::StateVariableTPTFilter<float>, kMaxCascade>
       bpf1s_; // freq1 / focus1
@@ -134,11 +158,7 @@ private:
 
   juce::Random random_;  // Noise モード用 RNG
   SamplePlayer sampler_; // Sample モード用
-
-  std::vector<float> scratchBuffer_;
-  float noteTimeSamples_{0.0f};
-  int startOffset_{0};
-  std::atomic<bool> active_{false};
+  EnvelopeLutManager clickAmpLut_; ///< Click Amp エンベロープ LUT
 
   /// Drive + ClipType をまとめた構造体（Noise/Sample 共通ポスト処理）
   struct SaturatorParams {
@@ -153,16 +173,18 @@ private:
     std::atomic<float> decayMs{300.0f}; ///< 停止判定用デケイ時間
   };
 
-  std::atomic<int> mode_{1}; // 1=Noise, 2=Sample
+  // ── UI スレッドが書くパラメータ（再生状態とはキャッシュラインを分ける）──
+  alignas(kCacheLineSize) std::atomic<int> mode_{1}; // 1=Noise, 2=Sample
   std::atomic<float> gainDb_{0.0f};
   std::atomic<float> decayMs_{30.0f};
   SampleModeParams sampleParams_; ///< Sample モード用パラメーター一式
   SaturatorParams saturatorParams_; ///< Drive + ClipType
-  EnvelopeLutManager clickAmpLut_;  ///< Click Amp エンベロープ LUT
   FilterParams bpf1Params_{5000.0f, 0.71f,
                            1}; // BPF1: freq=5kHz, Q=0.71, 12dB/oct
   FilterParams hpfParams_{20.0f, 0.71f,
                           1}; // デフォルト: バイパス(20Hz), Q=0.71
   FilterParams lpfParams_{20000.0f, 0.71f,
                           1}; // デフォルト: バイパス(20kHz), Q=0.71
+
+  DspArena localArena_; ///< 単体利用時のみ使う
 };
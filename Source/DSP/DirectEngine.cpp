@@ -8,7 +8,19 @@
 // lifecycle
 // ────────────────────────────────────────────────────
 
+std::size_t DirectEngine::arenaBytes(int samplesPerBlock) noexcept {
+  // scratch + サンプル読み出し L / R
+  return 3 * DspArena::bytesFor<float>(
+                 static_cast<std::size_t>(samplesPerBlock));
+}
+
 void DirectEngine::prepareToPlay(double sampleRate, int samplesPerBlock) {
+  localArena_.reset(arenaBytes(samplesPerBlock));
+  prepareToPlay(sampleRate, samplesPerBlock, localArena_);
+}
+
+void DirectEngine::prepareToPlay(double sampleRate, int samplesPerBlock,
+                                 DspArena &arena) {
   using enum juce::dsp::StateVariableTPTFilterType;
   juce::dsp::ProcessSpec spec{};
   spec.sampleRate = sampleRate;
@@ -23,7 +35,10 @@ void DirectEngine::prepareToPlay(double sampleRate, int samplesPerBlock) {
     f.setType(lowpass);
   }
 
-  scratchBuffer_.resize(static_cast<std::size_t>(samplesPerBlock));
+  scratchBuffer_ =
+      arena.take<float>(static_cast<std::size_t>(samplesPerBlock));
+  sampleL_ = arena.take<float>(static_cast<std::size_t>(samplesPerBlock));
+  sampleR_ = arena.take<float>(static_cast<std::size_t>(samplesPerBlock));
   noteTimeSamples_ = 0.0f;
   startOffset_ = 0;
   active_.store(false);
@@ -51,7 +66,8 @@ void DirectEngine::triggerNote(int sampleOffset) {
   // リトリガー時エンベロープ不連続防止: 現在の amp を保存しランプ開始
   if (active_.load() && noteTimeSamples_ > 0.0f) {
     const float noteTimeMs = noteTimeSamples_ * 1000.0f / cachedSampleRate_;
-    ramp_.prevAmp = computeSampleAmp(noteTimeMs);
+    ramp_.prevAmp =
+        EnvelopeLutManager::computeAmp(directAmpLut_.current(), noteTimeMs);
     ramp_.counter = ramp_.length;
   } else {
     ramp_.prevAmp = 0.0f;
@@ -111,20 +127,21 @@ float DirectEngine::processFilterChain(const FilterState &fs, int ch, float s) {
   return s;
 }
 
-float DirectEngine::computeMaxTimeSamples(float sr, double playRate) const {
+float DirectEngine::computeMaxTimeSamples(float sr, double playRate,
+                                          double sampleDurSec) const {
   const float ampDurMs = maxDurationMs_.load();
   const float ampDurSamples = ampDurMs * sr / 1000.0f;
-  const double dur = sampler_.durationSec();
   const float samplerDurSamples =
-      (dur > 0.0 && playRate > 0.0)
-          ? static_cast<float>(dur / playRate * static_cast<double>(sr))
+      (sampleDurSec > 0.0 && playRate > 0.0)
+          ? static_cast<float>(sampleDurSec / playRate *
+                               static_cast<double>(sr))
           : 1e9f;
   return std::min(ampDurSamples, samplerDurSamples);
 }
 
-float DirectEngine::computeSampleAmp(float noteTimeMs) const {
-  return EnvelopeLutManager::computeAmp(
-      directAmpLut_.getActiveLut(), directAmpLut_.getDurationMs(), noteTimeMs);
+float DirectEngine::computeSampleAmp(float noteTimeMs, int &cursor) const {
+  return EnvelopeLutManager::computeAmp(directAmpLut_.current(), noteTimeMs,
+                                        cursor);
 }
 
 // ────────────────────────────────────────────────────
@@ -141,25 +158,33 @@ void DirectEngine::render(juce::AudioBuffer<float> &buffer, int numSamples,
 
   const auto sr = static_cast<float>(sampleRate);
   const float gain = juce::Decibels::decibelsToGain(gainDb_.load());
+  // LUT とサンプルのメタ情報はブロック先頭で 1 回だけ取り込む
+  directAmpLut_.acquire();
+  const auto &info = sampler_.acquireInfo();
   const double playRate =
       static_cast<double>(std::pow(2.0f, pitchSemitones_.load() / 12.0f)) *
-      sampler_.sampleRate() / sampleRate;
+      info.sampleRate / sampleRate;
 
-  const float maxTimeSamples = computeMaxTimeSamples(sr, playRate);
+  const float maxTimeSamples =
+      computeMaxTimeSamples(sr, playRate, info.durationSec);
   const FilterState fs = prepareFilters(sr);
 
-  auto view = sampler_.lock();
-  if (!view) {
-    std::fill_n(scratchBuffer_.data(), static_cast<std::size_t>(numSamples),
-                0.0f);
-    return;
+  {
+    const auto view = sampler_.lock();
+    if (!view) {
+      std::fill_n(scratchBuffer_.data(),
+                  static_cast<std::size_t>(numSamples), 0.0f);
+      return;
+    }
+    // 開始オフセット以降をブロック分まとめて読む（ロックはここだけ）。
+    // 停止判定で途中で抜けても、次のノートでプレイヘッドは戻る
+    const int lead = std::min(startOffset_, numSamples);
+    sampler_.readBlockStereo(view.samples, playRate, sampleL_.data() + lead,
+                             sampleR_.data() + lead, numSamples - lead);
   }
-  // readInterpolatedStereo() からアクセスするためメンバーにキャッシュ
-  viewCache_.data = view.data;
-  viewCache_.dataR = view.dataR ? view.dataR : view.data;
-  viewCache_.length = view.length;
 
   const int numCh = buffer.getNumChannels();
+  int ampCursor = -1; // LUT の読み出し位置（ブロック内で単調に進む）
 
   for (int i = 0; i < numSamples; ++i) {
     if (startOffset_ > 0) {
@@ -176,17 +201,15 @@ void DirectEngine::render(juce::AudioBuffer<float> &buffer, int numSamples,
     }
 
     const float noteTimeMs = noteTimeSamples_ * 1000.0f / sr;
-    const float amp = computeSampleAmp(noteTimeMs);
-
-    bool finished = false;
-    auto [sL, sR] = sampler_.readInterpolatedStereo(
-        viewCache_.data, viewCache_.dataR, viewCache_.length, playRate, finished);
-    if (finished) {
-      sL = 0.0f;
-      sR = 0.0f;
-    }
-    sL = processFilterChain(fs, 0, sL) * amp * gain;
-    sR = processFilterChain(fs, 1, sR) * amp * gain;
+    const float amp = computeSampleAmp(noteTimeMs, ampCursor);
+
+    // 末端以降は readBlockStereo() が 0 を書いている
+    const float sL = processFilterChain(
+                         fs, 0, sampleL_[static_cast<std::size_t>(i)]) *
+                     amp * gain;
+    const float sR = processFilterChain(
+                         fs, 1, sampleR_[static_cast<std::size_t>(i)]) *
+                     amp * gain;
 
     scratchBuffer_[static_cast<std::size_t>(i)] = (sL + sR) * 0.5f;
     if (directPass) {
@@ -196,15 +219,14 @@ void DirectEngine::render(juce::AudioBuffer<float> &buffer, int numSamples,
     }
     noteTimeSamples_ += 1.0f;
   }
-
-  viewCache_.clear();
 }
 
 // ────────────────────────────────────────────────
 // renderPassthrough
 // ────────────────────────────────────────────────
 
-float DirectEngine::computePassthroughAmp(float sr, float maxTimeSamples) {
+float DirectEngine::computePassthroughAmp(float sr, float maxTimeSamples,
+                                          int &ampCursor) {
   if (!active_.load())
     return 0.0f;
 
@@ -219,7 +241,7 @@ float DirectEngine::computePassthroughAmp(float sr, float maxTimeSamples) {
   }
 
   const float noteTimeMs = noteTimeSamples_ * 1000.0f / sr;
-  float amp = computeSampleAmp(noteTimeMs);
+  float amp = computeSampleAmp(noteTimeMs, ampCursor);
 
   // リトリガーランプ: 旧アンプ → 新アンプへスムーズ遷移
   if (ramp_.counter > 0) {
@@ -239,6 +261,7 @@ void DirectEngine::renderPassthrough(juce::AudioBuffer<float> &buffer,
                                      int numSamples, double sampleRate) {
   const auto sr = static_cast<float>(sampleRate);
   const float gain = juce::Decibels::decibelsToGain(gainDb_.load());
+  directAmpLut_.acquire();
 
   // 停止判定用最大再生時間（パススルーではサンプル長がないので期間のみ）
   const float ampDurMs = maxDurationMs_.load();
@@ -246,9 +269,10 @@ void DirectEngine::renderPassthrough(juce::AudioBuffer<float> &buffer,
 
   const FilterState fs = prepareFilters(sr);
   const int numCh = buffer.getNumChannels();
+  int ampCursor = -1; // LUT の読み出し位置（ブロック内で単調に進む）
 
   for (int i = 0; i < numSamples; ++i) {
-    const float amp = computePassthroughAmp(sr, maxTimeSamples);
+    const float amp = computePassthroughAmp(sr, maxTimeSamples, ampCursor);
 
     const auto idx = static_cast<std::size_t>(i);
     float sL = (i < static_cast<int>(inputL.size())) ? inputL[idx] : 0.0f;
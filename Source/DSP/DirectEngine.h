@@ -1,5 +1,6 @@
 #pragma once
 
+#include "DspArena.h"
 #include "EnvelopeLutManager.h"
 #include "SamplePlayer.h"
 
@@ -9,7 +10,6 @@
 #include <array>
 #include <atomic>
 #include <span>
-#include <vector>
 
 /// サンプル再生エンジン（Direct チャンネル / Sample モード）
 /// - Click sampler と同一の LUT エンベロープ方式
@@ -18,6 +18,13 @@
 class DirectEngine {
 public:
   // ── lifecycle ──
+  /// prepareToPlay(..., arena) が切り出すバイト数
+  static std::size_t arenaBytes(int samplesPerBlock) noexcept;
+
+  /// フィルターを初期化し、スクラッチを arena から切り出す。
+  void prepareToPlay(double sampleRate, int samplesPerBlock, DspArena &arena);
+
+  /// 単体利用（テスト等）: 自前のアリーナで prepareToPlay する。
   void prepareToPlay(double sampleRate, int samplesPerBlock);
 
   /// MIDI NoteOn / トランジェント検出時のトリガー
@@ -79,6 +86,9 @@ public:
   /// レベル計測用スクラッチバッファの先頭ポインタ
   const float *scratchData() const noexcept { return scratchBuffer_.data(); }
 
+  /// 発音中（トリガー待ちを含む）かどうか（アイドル判定用）
+  bool isActive() const noexcept { return active_.load(); }
+
 private:
   static constexpr int kMaxCascade = 4;
 
@@ -92,12 +102,15 @@ private:
   FilterState prepareFilters(float sr);
   /// フィルタチェーン（Drive→HPF/LPF→共振整形）を 1ch 分処理
   float processFilterChain(const FilterState &fs, int ch, float s);
-  /// LUT エンベロープ振幅（末尾 half-cosine フェード付き）
-  float computeSampleAmp(float noteTimeMs) const;
+  /// LUT エンベロープ振幅（末尾 half-cosine フェード付き）。
+  /// LUT は render 先頭で acquire() したものを使う。cursor は render 内で
+  /// 使い回す LUT の読み出し位置（ブロック先頭で -1）
+  float computeSampleAmp(float noteTimeMs, int &cursor) const;
   /// 停止判定用最大再生時間（サンプル数）
-  float computeMaxTimeSamples(float sr, double playRate) const;
+  float computeMaxTimeSamples(float sr, double playRate,
+                              double sampleDurSec) const;
   /// パススルーモード時の 1 サンプル分 amp 計算（ネスト削減用）
-  float computePassthroughAmp(float sr, float maxTimeSamples);
+  float computePassthroughAmp(float sr, float maxTimeSamples, int &ampCursor);
 
   struct FilterParams {
     std::atomic<float> freq{0.0f};
@@ -105,14 +118,6 @@ private:
     std::atomic<int> stages{1};
   };
 
-  /// render 中のみ有効なロックビューキャッシュ
-  struct ViewCache {
-    const float *data{nullptr};
-    const float *dataR{nullptr};
-    int length{0};
-    void clear() { data = nullptr; dataR = nullptr; length = 0; }
-  };
-
   /// リトリガーランプ状態（エンベロープ不連続防止）
   struct RampState {
     float prevAmp{0.0f};
@@ -120,30 +125,33 @@ private:
     int length{22};
   };
 
-  SamplePlayer sampler_;
-  ViewCache viewCache_;
-
-  // 再生状態
-  std::vector<float> scratchBuffer_;
+  // ── オーディオスレッドが書く再生状態 ──
   std::atomic<bool> active_{false};
   float noteTimeSamples_{0.0f};
   int startOffset_{0};
-
   RampState ramp_;
   float cachedSampleRate_{44100.0f};
+  std::span<float> scratchBuffer_; ///< DspArena 上
+  /// readBlockStereo() で 1 ブロック分まとめて読んだサンプル（DspArena 上）
+  std::span<float> sampleL_;
+  std::span<float> sampleR_;
 
   // フィルター
   std::array<juce::dsp::StateVariableTPTFilter<float>, kMaxCascade> hpfs_;
   std::array<juce::dsp::StateVariableTPTFilter<float>, kMaxCascade> lpfs_;
-  FilterParams hpfParams_{};
-  FilterParams lpfParams_{};
 
-  // パラメータ
+  SamplePlayer sampler_;
+  EnvelopeLutManager directAmpLut_; // Direct Amp エンベロープ LUT
+
+  // ── UI スレッドが書くパラメータ（再生状態とはキャッシュラインを分ける）──
+  alignas(kCacheLineSize) FilterParams hpfParams_{};
+  FilterParams lpfParams_{};
   std::atomic<float> gainDb_{0.0f};
   std::atomic<float> pitchSemitones_{0.0f};
   std::atomic<float> driveDb_{0.0f};
   std::atomic<int> clipType_{0};
   std::atomic<bool> passthroughMode_{false};
   std::atomic<float> maxDurationMs_{300.0f}; // 停止判定用
-  EnvelopeLutManager directAmpLut_; // Direct Amp エンベロープ LUT
+
+  DspArena localArena_; ///< 単体利用時のみ使う
 };
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "CacheLine.h"
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+/// 1 インスタンス分の DSP 作業メモリ（スクラッチ・遅延線・テーブル）を
+/// 1 回の確保でまかなうバンプアロケータ（ヘッダオンリー）。
+///
+/// prepareToPlay() で各コンポーネントの arenaBytes() を合計して reset() し、
+/// 続く各 prepare が take() で自分の領域を順に切り出す。切り出した領域は
+/// キャッシュライン境界から始まり、ゼロ初期化されている。
+/// オーディオスレッドでは確保も解放もしない。
+class DspArena {
+public:
+  /// n 個の T が占めるバイト数（キャッシュライン境界まで切り上げ）
+  template <typename T>
+  static constexpr std::size_t bytesFor(std::size_t n) noexcept {
+    return (n * sizeof(T) + kCacheLineSize - 1) / kCacheLineSize *
+           kCacheLineSize;
+  }
+
+  /// 容量を bytes 以上にして先頭から切り出し直す。以前に切り出した領域は
+  /// すべて無効になる（容量が足りていれば再確保しない）。
+  void reset(std::size_t bytes) {
+    if (bytes > capacity_) {
+      data_ = allocate(bytes);
+      capacity_ = bytes;
+    }
+    used_ = 0;
+    overflow_.clear();
+  }
+
+  /// n 個の T を切り出す（ゼロ初期化済み）。
+  /// 容量超過は arenaBytes() の見積もり漏れ（プログラミングエラー）なので
+  /// デバッグビルドでは assert で止める。リリースビルドでは呼び出し側が
+  /// 範囲外を触らないよう、その分だけ別に確保して返す（次の reset() で解放）。
+  template <typename T> std::span<T> take(std::size_t n) {
+    static_assert(std::is_trivially_copyable_v<T> &&
+                  alignof(T) <= kCacheLineSize);
+    if (n == 0)
+      return {};
+    const std::size_t bytes = bytesFor<T>(n);
+    assert(used_ + bytes <= capacity_);
+    std::byte *block = nullptr;
+    if (used_ + bytes <= capacity_) {
+      block = data_.get() + used_;
+      used_ += bytes;
+    } else {
+      block = overflow_.emplace_back(allocate(bytes)).get();
+    }
+    auto *p = reinterpret_cast<T *>(block);
+    std::uninitialized_fill_n(p, n, T{});
+    return {p, n};
+  }
+
+  [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+  [[nodiscard]] std::size_t used() const noexcept { return used_; }
+  /// 容量超過で別確保した領域の数（見積もりが正しければ常に 0）
+  [[nodiscard]] std::size_t overflowCount() const noexcept {
+    return overflow_.size();
+  }
+
+private:
+  struct AlignedDelete {
+    void operator()(std::byte *p) const noexcept {
+      ::operator delete[](p, std::align_val_t{kCacheLineSize});
+    }
+  };
+  using Block = std::unique_ptr<std::byte[], AlignedDelete>;
+
+  static Block allocate(std::size_t bytes) {
+    return Block(static_cast<std::byte *>(
+        ::operator new[](bytes, std::align_val_t{kCacheLineSize})));
+  }
+
+  Block data_;
+  std::size_t capacity_ = 0;
+  std::size_t used_ = 0;
+  std::vector<Block> overflow_;
+};
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <functional>
 #include <limits>
 #include <vector>
 
@@ -18,6 +19,10 @@ struct EnvelopePoint {
 /// - points が空 → defaultValue（フラット）
 /// - points が 1 → 定数
 /// - points が 2+ → lerp + curve 補間
+///
+/// 各セグメントのカーブ指数（2^(-curve*3)）は編集時に計算して保持する。
+/// 等間隔の連続評価は evaluateRange() を使うと、セグメントをカーソルで
+/// 辿るためポイント数（手描きの数千点でも）に依らず 1 サンプル O(1)。
 class EnvelopeData {
 public:
     // ── デフォルト値（ポイントなし時のフラット値） ──
@@ -42,9 +47,11 @@ public:
 
     /// セグメント（index 番目のポイント→次のポイント）のカーブ値を設定
     void setSegmentCurve(int index, float curve) {
-        if (index >= 0 && index < static_cast<int>(points.size()))
-            points[static_cast<size_t>(index)].curve =
-                std::clamp(curve, -1.0f, 1.0f);
+        if (index >= 0 && index < static_cast<int>(points.size())) {
+            const float c = std::clamp(curve, -1.0f, 1.0f);
+            points[static_cast<size_t>(index)].curve = c;
+            exponents[static_cast<size_t>(index)] = curveExponent(c);
+        }
     }
 
     /// timeMs 昇順に挿入
@@ -55,16 +62,22 @@ public:
             [](const EnvelopePoint& a, const EnvelopePoint& b) {
                 return a.timeMs < b.timeMs;
             });
+        exponents.insert(exponents.begin() + (it - points.begin()), 1.0f);
         points.insert(it, p);
     }
 
     void removePoint(int index) {
-        if (index >= 0 && index < static_cast<int>(points.size()))
+        if (index >= 0 && index < static_cast<int>(points.size())) {
             points.erase(points.begin() + index);
+            exponents.erase(exponents.begin() + index);
+        }
     }
 
     /// 全ポイントを削除
-    void clearPoints() { points.clear(); }
+    void clearPoints() {
+        points.clear();
+        exponents.clear();
+    }
 
     /// ポイントを移動。newTimeMs は隣接ポイント間にクランプされる。
     /// 戻り値: 移動後のインデックス（隣接クランプ済みのためソート不要、通常は入力と同じ）
@@ -101,38 +114,69 @@ public:
         if (timeMs >= points[static_cast<size_t>(n - 1)].timeMs)
             return points[static_cast<size_t>(n - 1)].value;
 
-        // timeMs が属するセグメント [i, i+1] を探す
-        int seg = 0;
-        for (int i = 0; i < n - 1; ++i) {
-            if (timeMs < points[static_cast<size_t>(i + 1)].timeMs) {
-                seg = i;
-                break;
-            }
-        }
+        return segmentValue(findSegment(timeMs), timeMs);
+    }
 
-        const float t0 = points[static_cast<size_t>(seg)].timeMs;
-        const float t1 = points[static_cast<size_t>(seg + 1)].timeMs;
-        const float t = (t1 > t0) ? (timeMs - t0) / (t1 - t0) : 0.0f;
+    /// t0Ms から dtMs 間隔の n 点を out に評価する（dtMs >= 0）。
+    /// 開始セグメントを二分探索した後はカーソルを進めるだけなので
+    /// O(log points + n + 通過セグメント数)。結果は evaluate() と一致する。
+    void evaluateRange(float t0Ms, float dtMs, int n, float* out) const {
+        const auto np = static_cast<int>(points.size());
+        if (np < 2 || dtMs < 0.0f) {
+            for (int k = 0; k < n; ++k)
+                out[k] = evaluate(t0Ms + dtMs * static_cast<float>(k));
+            return;
+        }
 
-        const float v0 = points[static_cast<size_t>(seg)].value;
-        const float v1 = points[static_cast<size_t>(seg + 1)].value;
-        const float c  = points[static_cast<size_t>(seg)].curve;
+        const auto& first = points.front();
+        const auto& last = points.back();
+        int seg = t0Ms > first.timeMs ? findSegment(t0Ms) : 0;
+        for (int k = 0; k < n; ++k) {
+            const float t = t0Ms + dtMs * static_cast<float>(k);
+            if (t <= first.timeMs) {
+                out[k] = first.value;
+            } else if (t >= last.timeMs) {
+                // 以降も末尾値（dtMs >= 0）
+                std::fill(out + k, out + n, last.value);
+                return;
+            } else {
+                while (t >= points[static_cast<size_t>(seg + 1)].timeMs)
+                    ++seg;
+                out[k] = segmentValue(seg, t);
+            }
+        }
+    }
 
-        return curveLerp(v0, v1, t, c);
+    /// curve ∈ [-1,+1] → t' = t^exponent の指数。
+    /// curve=0 → 直線（1）, >0 → 上に凸, <0 → 下に凸。
+    /// 2^(-curve*3) で対数的にカーブ感度を拡大する。
+    static float curveExponent(float curve) {
+        return std::abs(curve) < 1e-4f ? 1.0f : std::pow(2.0f, -curve * 3.0f);
     }
 
 private:
     float defaultValue{1.0f};
     std::vector<EnvelopePoint> points;
+    /// points[i]→points[i+1] セグメントのカーブ指数（points と同じ長さ）
+    std::vector<float> exponents;
+
+    /// points[0].timeMs < timeMs < points.back().timeMs を前提に、
+    /// timeMs < points[i+1].timeMs を満たす最初のセグメント i を返す
+    int findSegment(float timeMs) const {
+        const auto it = std::ranges::upper_bound(
+            points, timeMs, std::ranges::less{}, &EnvelopePoint::timeMs);
+        const auto idx = static_cast<int>(it - points.begin()) - 1;
+        return std::clamp(idx, 0, static_cast<int>(points.size()) - 2);
+    }
 
-    /// curve 付き線形補間（t ∈ [0,1], curve ∈ [-1,+1]）
-    /// curve=0 → 直線, >0 → 上に凸, <0 → 下に凸
-    /// 方式: t' = t^(2^(-curve*3)) で対数的にカーブ感度を拡大
-    static float curveLerp(float v0, float v1, float t, float curve) {
-        if (std::abs(curve) < 1e-4f)
-            return std::lerp(v0, v1, t);
-        // 指数マッピング: curve ±1 で十分な曲率を得る
-        const float ct = std::pow(t, std::pow(2.0f, -curve * 3.0f));
-        return std::lerp(v0, v1, ct);
+    /// セグメント seg 上の timeMs における値（curve 付き線形補間）
+    float segmentValue(int seg, float timeMs) const {
+        const auto& p0 = points[static_cast<size_t>(seg)];
+        const auto& p1 = points[static_cast<size_t>(seg + 1)];
+        const float t = (p1.timeMs > p0.timeMs)
+            ? (timeMs - p0.timeMs) / (p1.timeMs - p0.timeMs)
+            : 0.0f;
+        const float e = exponents[static_cast<size_t>(seg)];
+        return std::lerp(p0.value, p1.value, e == 1.0f ? t : std::pow(t, e));
     }
 };
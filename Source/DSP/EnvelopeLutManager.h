@@ -1,69 +1,232 @@
 #pragma once
 
+#include "TripleBuffer.h"
 #include <algorithm>
 #include <array>
 #include <atomic>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
 #include <numbers>
 
-/// エンベロープ LUT のダブルバッファ管理。
-/// UI スレッドが bake() で書き込み → アトミックフリップ、
-/// オーディオスレッドが getActiveLut() で読み出す。
+/// エンベロープ LUT の公開管理。
+/// UI スレッドが bake() / bakeBreakpoints() / update() で書き込んで
+/// TripleBuffer で公開し、オーディオスレッドがブロック先頭の acquire() で
+/// 取り込んで読み出す。複数本を同時に切り替えたい場合は Bank<N> を使う。
+///
+/// LUT は等間隔テーブルではなく最大 lutSize 点の折れ線（正規化位置 0〜1 →
+/// 値）として持ち、読み出しは線形補間する。頂点の間隔はエンベロープ毎に
+/// 自由なので、急峻なアタックには密に、平坦な区間には疎に割り当てられる
+/// （LutBaker.h の bakeLut() 参照）。
 class EnvelopeLutManager {
 public:
-  static constexpr int lutSize = 512;
+  static constexpr int lutSize = 512; ///< 折れ線の最大頂点数
 
-  /// UIスレッドから呼び出し: 非アクティブ側バッファにコピー →
-  /// アトミックフリップ。
-  void bake(const float *data, int size) {
-    const int activeIdx = activeIndex_.load();
-    auto &dst = (activeIdx == 0) ? lut1_ : lut0_;
-
-    // ソースを LUT サイズにリサンプル（線形補間）
-    for (int i = 0; i < lutSize; ++i) {
-      const float srcPos = static_cast<float>(i) /
-                           static_cast<float>(lutSize - 1) *
-                           static_cast<float>(size - 1);
-      const auto idx0 = static_cast<int>(srcPos);
-      const auto idx1 = std::min(idx0 + 1, size - 1);
-      const float frac = srcPos - static_cast<float>(idx0);
-      dst[static_cast<size_t>(i)] =
-          data[idx0] * (1.0f - frac) // NOLINT: pointer arithmetic
-          + data[idx1] * frac;
+  /// 折れ線表現。pos は durationMs で正規化した位置（0〜1、非減少）。
+  /// 同じ pos が並ぶ箇所はステップ（右側の値を採る）。
+  struct Table {
+    std::array<float, lutSize> pos{};
+    std::array<float, lutSize> value{};
+    int size = 0;
+
+    /// 正規化位置 u の値（線形補間、範囲外は端点値でホールド）。
+    /// cursor は直前に使ったセグメント（-1 で未知）。u が単調増加する
+    /// 呼び出し列では二分探索を初回だけにして 1 回あたり償却 O(1)。
+    float evaluate(float u, int &cursor) const noexcept {
+      if (size <= 0)
+        return 0.0f;
+      const auto last = static_cast<std::size_t>(size - 1);
+      if (u <= pos[0])
+        return value[0];
+      if (u >= pos[last])
+        return value[last];
+
+      if (cursor < 0 || cursor >= size - 1 ||
+          pos[static_cast<std::size_t>(cursor)] > u) {
+        const auto *it = std::upper_bound(pos.data(), pos.data() + size, u);
+        cursor = static_cast<int>(it - pos.data()) - 1;
+      }
+      while (pos[static_cast<std::size_t>(cursor + 1)] <= u)
+        ++cursor;
+
+      const auto i = static_cast<std::size_t>(cursor);
+      const float p0 = pos[i];
+      const float p1 = pos[i + 1];
+      const float f = p1 > p0 ? (u - p0) / (p1 - p0) : 0.0f;
+      return std::lerp(value[i], value[i + 1], f);
+    }
+
+    float evaluate(float u) const noexcept {
+      int cursor = -1;
+      return evaluate(u, cursor);
+    }
+
+    /// durationMs 基準の時刻で評価する（durMs <= 0 なら先頭値）
+    float evaluateMs(float timeMs, float durMs, int &cursor) const noexcept {
+      return evaluate(durMs > 0.0f ? timeMs / durMs : 0.0f, cursor);
+    }
+  };
+
+  /// 公開の単位となる 1 本ぶんの LUT（折れ線 + 正規化に使う期間）。
+  /// 期間をテーブルと同じ面に持つので、両者が食い違って読まれることはない。
+  struct Lut {
+    Table table;
+    float durationMs = 300.0f;
+
+    float evaluateMs(float timeMs, int &cursor) const noexcept {
+      return table.evaluateMs(timeMs, durationMs, cursor);
+    }
+
+    /// 値 v のフラットな 2 点折れ線にする
+    void setFlat(float v) noexcept {
+      table.pos[0] = 0.0f;
+      table.pos[1] = 1.0f;
+      table.value[0] = v;
+      table.value[1] = v;
+      table.size = 2;
+    }
+
+    /// 等間隔サンプル列（0〜durationMs）を lutSize 点へ線形リサンプルする
+    void setUniform(const float *data, int size) noexcept {
+      for (int i = 0; i < lutSize; ++i) {
+        const float u =
+            static_cast<float>(i) / static_cast<float>(lutSize - 1);
+        const float srcPos = u * static_cast<float>(size - 1);
+        const auto idx0 = static_cast<int>(srcPos);
+        const auto idx1 = std::min(idx0 + 1, size - 1);
+        const float frac = srcPos - static_cast<float>(idx0);
+        table.pos[static_cast<size_t>(i)] = u;
+        table.value[static_cast<size_t>(i)] =
+            data[idx0] * (1.0f - frac) // NOLINT: pointer arithmetic
+            + data[idx1] * frac;
+      }
+      table.size = lutSize;
+    }
+
+    /// 不等間隔の折れ線頂点（pos は 0〜1 昇順）をコピーする。
+    /// count は lutSize で打ち切る。
+    void setBreakpoints(const float *pos, const float *values,
+                        int count) noexcept {
+      const int n = std::clamp(count, 0, lutSize);
+      std::copy_n(pos, n, table.pos.begin());
+      std::copy_n(values, n, table.value.begin());
+      table.size = n;
+    }
+  };
+
+  /// N 本の LUT をひとまとめに公開するバンク。
+  ///
+  /// 書き手は update() でステージング上の N 本を書き換え、まとめて
+  /// TripleBuffer に 1 回で公開する。オーディオスレッドはブロック先頭で
+  /// acquire() を 1 回呼び、そのブロック中は同じ組を読む。
+  ///   - 連続で公開されても読み手が参照中の面は上書きされない
+  ///   - 複数本（Sub の Amp/Freq/Dist/Mix など）が途中まで更新された
+  ///     組を読むことはない
+  /// 書き手（エディタと、プロセッサの状態復元 / 保留ベイク）同士は
+  /// writeMutex_ で直列化する。書き手はロックと確保を伴うのでオーディオ
+  /// スレッドからは呼ばない。読み手はロックを取らない。
+  template <std::size_t N> class Bank {
+  public:
+    using Luts = std::array<Lut, N>;
+
+    Bank() { reset(); }
+
+    /// 書き手: fn(Luts &) でステージングを書き換えてから公開する。
+    /// 公開後の世代（generation()）を返す。
+    template <typename Fn> std::uint64_t update(Fn &&fn) {
+      const std::scoped_lock lock(writeMutex_);
+      fn(staged_);
+      published_.publish(staged_);
+      return generation_.fetch_add(1) + 1;
+    }
+
+    /// 公開（update / reset）の通算回数。呼び出し側が「前回自分が焼いた
+    /// 内容のままか」を判定するのに使う。
+    [[nodiscard]] std::uint64_t generation() const noexcept {
+      return generation_.load();
     }
 
-    // フリップ
-    activeIndex_.store(1 - activeIdx);
+    /// 書き手側から見た slot の期間（UI / テスト用）
+    [[nodiscard]] float durationMs(std::size_t slot) const {
+      const std::scoped_lock lock(writeMutex_);
+      return staged_[slot].durationMs;
+    }
+
+    /// オーディオスレッド専用: 最新の組を取り込む（ブロック先頭で 1 回）
+    const Luts &acquire() noexcept { return published_.acquire(); }
+
+    /// オーディオスレッド専用: 直近の acquire() で取り込んだ組
+    const Luts &current() const noexcept { return published_.current(); }
+
+    /// prepareToPlay() で呼び出す。全 LUT を 1.0 のフラットにする
+    /// （期間は保持）。
+    void reset() {
+      const std::scoped_lock lock(writeMutex_);
+      for (auto &lut : staged_)
+        lut.setFlat(1.0f);
+      published_.reset(staged_);
+      generation_.fetch_add(1);
+    }
+
+  private:
+    Luts staged_{};
+    TripleBuffer<Luts> published_;
+    mutable std::mutex writeMutex_;
+    std::atomic<std::uint64_t> generation_{0};
+  };
+
+  /// 書き手: fn(Lut &) で書き換えて公開する（期間とテーブルを 1 回で）。
+  /// 公開後の世代を返す。
+  template <typename Fn> std::uint64_t update(Fn &&fn) {
+    return bank_.update([&fn](Bank<1>::Luts &luts) { fn(luts[0]); });
+  }
+
+  /// 公開の通算回数（Bank::generation() 参照）
+  [[nodiscard]] std::uint64_t generation() const noexcept {
+    return bank_.generation();
   }
 
-  void setDurationMs(float ms) { durationMs_.store(ms); }
+  /// UIスレッドから呼び出し: 等間隔サンプル列を書き込んで公開する。
+  void bake(const float *data, int size) {
+    update([data, size](Lut &lut) { lut.setUniform(data, size); });
+  }
 
-  [[nodiscard]] float getDurationMs() const { return durationMs_.load(); }
+  /// UIスレッドから呼び出し: 折れ線頂点を書き込んで公開する。
+  void bakeBreakpoints(const float *pos, const float *values, int count) {
+    update([pos, values, count](Lut &lut) {
+      lut.setBreakpoints(pos, values, count);
+    });
+  }
 
-  /// オーディオスレッドから呼び出し: 現在アクティブな LUT を取得。
-  [[nodiscard]] const std::array<float, lutSize> &
-  getActiveLut() const noexcept {
-    const int idx = activeIndex_.load();
-    return (idx == 0) ? lut0_ : lut1_;
+  void setDurationMs(float ms) {
+    update([ms](Lut &lut) { lut.durationMs = ms; });
   }
 
-  /// prepareToPlay() で呼び出す。
-  void reset() noexcept {
-    lut0_.fill(1.0f);
-    lut1_.fill(1.0f);
-    activeIndex_.store(0);
+  [[nodiscard]] float getDurationMs() const { return bank_.durationMs(0); }
+
+  /// オーディオスレッド専用: 最新の LUT を取り込む（ブロック先頭で 1 回）。
+  const Lut &acquire() noexcept { return bank_.acquire()[0]; }
+
+  /// オーディオスレッド専用: 直近の acquire() で取り込んだ LUT。
+  const Lut &current() const noexcept { return bank_.current()[0]; }
+
+  /// オーディオスレッド専用: 最新の LUT のテーブルを取得。
+  [[nodiscard]] const Table &getActiveLut() noexcept {
+    return acquire().table;
   }
 
+  /// prepareToPlay() で呼び出す。1.0 のフラットにする。
+  void reset() { bank_.reset(); }
+
   /// LUT エンベロープ振幅を計算（末尾 5ms half-cosine フェード付き）。
   /// ClickEngine / DirectEngine の computeSampleAmp() から共用。
-  [[nodiscard]] static float
-  computeAmp(const std::array<float, lutSize> &ampLut, float ampDurMs,
-             float noteTimeMs) noexcept {
-    const float lutPos = (ampDurMs > 0.0f) ? (noteTimeMs / ampDurMs) *
-                                                 static_cast<float>(lutSize - 1)
-                                           : 0.0f;
-    const auto lutIdx = std::min(static_cast<int>(lutPos), lutSize - 1);
-    float amp = ampLut[static_cast<std::size_t>(lutIdx)];
+  /// cursor は Table::evaluate() と同じ。ブロック内で同じ変数を渡し続ける
+  /// と（SubEngine の各 LUT と同様に）二分探索はブロック先頭の 1 回で済む。
+  [[nodiscard]] static float computeAmp(const Table &ampLut, float ampDurMs,
+                                        float noteTimeMs,
+                                        int &cursor) noexcept {
+    float amp = ampLut.evaluateMs(noteTimeMs, ampDurMs, cursor);
 
     constexpr float fadeOutMs = 5.0f;
     if (const float fadeStartMs = std::max(0.0f, ampDurMs - fadeOutMs);
@@ -74,9 +237,24 @@ public:
     return amp;
   }
 
+  [[nodiscard]] static float computeAmp(const Lut &ampLut, float noteTimeMs,
+                                        int &cursor) noexcept {
+    return computeAmp(ampLut.table, ampLut.durationMs, noteTimeMs, cursor);
+  }
+
+  /// 単発評価用（毎回二分探索する）
+  [[nodiscard]] static float computeAmp(const Table &ampLut, float ampDurMs,
+                                        float noteTimeMs) noexcept {
+    int cursor = -1;
+    return computeAmp(ampLut, ampDurMs, noteTimeMs, cursor);
+  }
+
+  [[nodiscard]] static float computeAmp(const Lut &ampLut,
+                                        float noteTimeMs) noexcept {
+    int cursor = -1;
+    return computeAmp(ampLut, noteTimeMs, cursor);
+  }
+
 private:
-  std::array<float, lutSize> lut0_{};
-  std::array<float, lutSize> lut1_{};
-  std::atomic<int> activeIndex_{0};
-  std::atomic<float> durationMs_{300.0f};
+  Bank<1> bank_;
 };
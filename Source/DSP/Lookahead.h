@@ -0,0 +1,140 @@
+#pragma once
+
+#include "DspArena.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <span>
+
+/// ルックアヘッド用の入力遅延リング + 遅延タイムライン上のトリガー予約
+/// （ヘッダオンリー、オーディオスレッド専用）。
+///
+/// - delayStereo(): パススルー入力を delaySamples だけ遅らせる
+/// - schedule():    現サブブロック先頭からの相対位置でトリガーを予約
+/// - popDue():      現サブブロック内に入った予約を昇順に取り出す
+///
+/// delaySamples = 0 のときは素通し（予約も同一サブブロック内で即発火）。
+class Lookahead {
+public:
+  static constexpr int kMaxPending = 16;
+
+  /// prepare(maxDelaySamples, arena) が切り出すバイト数
+  static std::size_t arenaBytes(int maxDelaySamples) noexcept {
+    return 2 * DspArena::bytesFor<float>(
+                   static_cast<std::size_t>(capacityFor(maxDelaySamples)));
+  }
+
+  /// prepareToPlay() から呼ぶ。最大遅延分のリングを arena から切り出す。
+  void prepare(int maxDelaySamples, DspArena &arena) {
+    capacity_ = capacityFor(maxDelaySamples);
+    ringL_ = arena.take<float>(static_cast<std::size_t>(capacity_));
+    ringR_ = arena.take<float>(static_cast<std::size_t>(capacity_));
+    ringDirty_ = false;
+    delay_ = 0;
+    reset();
+  }
+
+  /// 単体利用（テスト等）: 自前のアリーナで prepare する。
+  void prepare(int maxDelaySamples) {
+    localArena_.reset(arenaBytes(maxDelaySamples));
+    prepare(maxDelaySamples, localArena_);
+  }
+
+  /// 遅延ラインを無音にし、予約を破棄する。
+  /// 直前の reset() 以降に書き込みがなければリングの再クリアは省く。
+  void reset() noexcept {
+    clearRing();
+    numPending_ = 0;
+  }
+
+  /// 遅延量を設定（prepare 時の最大値でクランプ）。
+  /// 変わったときはリングを無音に戻す（以前の遅延量で書いた古い音を
+  /// 再生しない）。予約はそのまま残す。
+  void setDelaySamples(int n) noexcept {
+    n = std::clamp(n, 0, capacity_ - 1);
+    if (n == delay_)
+      return;
+    delay_ = n;
+    clearRing();
+  }
+  [[nodiscard]] int getDelaySamples() const noexcept { return delay_; }
+
+  /// L/R をその場で遅延させる。
+  void delayStereo(float *l, float *r, int numSamples) noexcept {
+    if (delay_ == 0)
+      return; // 素通し（リングも更新不要）
+    ringDirty_ = true;
+    for (int i = 0; i < numSamples; ++i) {
+      const auto w = static_cast<std::size_t>(writePos_);
+      int rp = writePos_ - delay_;
+      if (rp < 0)
+        rp += capacity_;
+      const auto r0 = static_cast<std::size_t>(rp);
+      ringL_[w] = l[i];
+      ringR_[w] = r[i];
+      l[i] = ringL_[r0];
+      r[i] = ringR_[r0];
+      if (++writePos_ == capacity_)
+        writePos_ = 0;
+    }
+  }
+
+  /// トリガーを予約（offset = 現サブブロック先頭からのサンプル数）。
+  /// 満杯時は最も遅い予約を上書きしない（新規分を破棄）。
+  void schedule(int offset) noexcept {
+    if (numPending_ >= kMaxPending)
+      return;
+    offset = std::max(0, offset);
+    // 昇順を保つ挿入（件数が少ないので線形で十分）
+    int i = numPending_;
+    while (i > 0 && pending_[static_cast<std::size_t>(i - 1)] > offset) {
+      pending_[static_cast<std::size_t>(i)] =
+          pending_[static_cast<std::size_t>(i - 1)];
+      --i;
+    }
+    pending_[static_cast<std::size_t>(i)] = offset;
+    ++numPending_;
+  }
+
+  /// [0, numSamples) に入った予約を昇順で fn(pos) に渡して消費し、
+  /// 残りの予約を numSamples だけ前へ進める。
+  template <typename Fn> void popDue(int numSamples, Fn &&fn) {
+    int consumed = 0;
+    while (consumed < numPending_ &&
+           pending_[static_cast<std::size_t>(consumed)] < numSamples) {
+      fn(pending_[static_cast<std::size_t>(consumed)]);
+      ++consumed;
+    }
+    const int remaining = numPending_ - consumed;
+    for (int i = 0; i < remaining; ++i)
+      pending_[static_cast<std::size_t>(i)] =
+          pending_[static_cast<std::size_t>(i + consumed)] - numSamples;
+    numPending_ = remaining;
+  }
+
+  [[nodiscard]] int numPending() const noexcept { return numPending_; }
+
+private:
+  void clearRing() noexcept {
+    if (ringDirty_) {
+      std::ranges::fill(ringL_, 0.0f);
+      std::ranges::fill(ringR_, 0.0f);
+      ringDirty_ = false;
+    }
+    writePos_ = 0;
+  }
+
+  static int capacityFor(int maxDelaySamples) noexcept {
+    return std::max(1, maxDelaySamples + 1);
+  }
+
+  std::span<float> ringL_;
+  std::span<float> ringR_;
+  int capacity_{1};
+  int writePos_{0};
+  int delay_{0};
+  bool ringDirty_{false};
+  std::array<int, kMaxPending> pending_{};
+  int numPending_{0};
+  DspArena localArena_; ///< 単体利用時のみ使う
+};
@@ -0,0 +1,350 @@
+#pragma once
+
+#include "DspArena.h"
+#include "TripleBuffer.h"
+#include "TruePeak.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <span>
+
+/// マスター L/R と Sub / Click / Direct の 5 ストリームをまとめて計測する
+/// メーターエンジン（ヘッダオンリー）。
+///
+/// 1 回の process() で全ストリームの
+///   - サンプルピーク / RMS（300ms 積分）
+///   - 4× オーバーサンプリング True Peak（48 タップ ポリフェーズ FIR）
+///   - K 特性 Momentary（400ms）/ Short-term（3s）ラウドネス
+/// を計算する。入力を [サンプル][レーン] に転置し、全処理をレーン方向の
+/// 固定長ループで回すため 5 ストリーム分が 1 パスでベクトル化される。
+///
+/// 結果はトリプルバッファ経由の MeterSnapshot として UI スレッドへ渡す
+/// （オーディオスレッドはロック・待ちなし、UI は常に最新の完全な 1 組を読む）。
+class MeterEngine {
+public:
+  enum Stream { kMasterL = 0, kMasterR, kSub, kClick, kDirect, kNumStreams };
+  /// ラウドネスの計測対象（マスターは L+R の合算）
+  enum Loudness {
+    kLoudMaster = 0,
+    kLoudSub,
+    kLoudClick,
+    kLoudDirect,
+    kNumLoudness
+  };
+
+  /// SIMD 幅に合わせたレーン数（5 ストリーム + パディング）
+  static constexpr int kLanes = 8;
+  static constexpr float kFloorDb = -100.0f;
+
+  /// UI スレッドへ渡す計測結果（リニア値で保持し、dB 変換は読み手側）
+  struct Snapshot {
+    std::array<float, kNumStreams> peak{};     ///< サンプルピーク
+    std::array<float, kNumStreams> rms{};      ///< RMS（振幅）
+    std::array<float, kNumStreams> truePeak{}; ///< 4× True Peak
+    std::array<float, kNumLoudness> momentary{}; ///< K 特性平均二乗（400ms）
+    std::array<float, kNumLoudness> shortTerm{}; ///< K 特性平均二乗（3s）
+
+    float peakDb(Stream s) const noexcept { return toDb(peak[idx(s)]); }
+    float rmsDb(Stream s) const noexcept { return toDb(rms[idx(s)]); }
+    float truePeakDb(Stream s) const noexcept {
+      return toDb(truePeak[idx(s)]);
+    }
+    float momentaryLufs(Loudness l) const noexcept {
+      return toLufs(momentary[idx(l)]);
+    }
+    float shortTermLufs(Loudness l) const noexcept {
+      return toLufs(shortTerm[idx(l)]);
+    }
+
+  private:
+    static std::size_t idx(int i) noexcept {
+      return static_cast<std::size_t>(i);
+    }
+    static float toDb(float lin) noexcept {
+      return lin > 1.0e-5f ? 20.0f * std::log10(lin) : kFloorDb;
+    }
+    static float toLufs(float ms) noexcept {
+      return ms > 1.0e-10f ? -0.691f + 10.0f * std::log10(ms) : kFloorDb;
+    }
+  };
+
+  /// prepare(sampleRate, maxBlockSize, arena) が切り出すバイト数
+  static std::size_t arenaBytes(int maxBlockSize) noexcept {
+    return DspArena::bytesFor<float>(
+        static_cast<std::size_t>(maxBlockSize * kLanes));
+  }
+
+  /// prepareToPlay() から呼ぶ。maxBlockSize は process() 1 回の最大長。
+  void prepare(double sampleRate, int maxBlockSize, DspArena &arena) {
+    sr_ = sampleRate;
+    frames_ =
+        arena.take<float>(static_cast<std::size_t>(maxBlockSize * kLanes));
+    binSamples_ =
+        std::max(1, static_cast<int>(std::lround(0.1 * sampleRate)));
+    designKWeighting();
+    tpCoeffs_ = TruePeak::designCoeffs();
+    reset();
+  }
+
+  /// 単体利用（テスト等）: 自前のアリーナで prepare する。
+  void prepare(double sampleRate, int maxBlockSize) {
+    localArena_.reset(arenaBytes(maxBlockSize));
+    prepare(sampleRate, maxBlockSize, localArena_);
+  }
+
+  void reset() noexcept {
+    peak_.fill(0.0f);
+    truePeak_.fill(0.0f);
+    meanSq_.fill(0.0f);
+    resetFilterState();
+    binAccum_.fill(0.0f);
+    binFill_ = 0;
+    for (auto &b : bins_)
+      b.fill(0.0f);
+    binPos_ = 0;
+    publish();
+  }
+
+  /// 1 サブブロック分を計測（オーディオスレッド）。
+  /// src[s] == nullptr のストリームは無音として扱う。
+  void process(const std::array<const float *, kNumStreams> &src,
+               int numSamples) noexcept {
+    numSamples = std::min(numSamples, maxBlockSize());
+    if (numSamples <= 0)
+      return;
+
+    // ── 転置: [サンプル][レーン]（パディングレーンは常に 0） ──
+    for (std::size_t s = 0; s < kNumStreams; ++s) {
+      const float *in = src[s];
+      for (int i = 0; i < numSamples; ++i)
+        frames_[static_cast<std::size_t>(i * kLanes) + s] =
+            in != nullptr ? in[i] : 0.0f;
+    }
+
+    Lanes blockPeak{};
+    Lanes blockTp{};
+    Lanes sumSq{};
+    for (int i = 0; i < numSamples; ++i) {
+      const float *x = &frames_[static_cast<std::size_t>(i * kLanes)];
+      Lanes kw{};
+      for (std::size_t l = 0; l < kLanes; ++l) {
+        blockPeak[l] = std::max(blockPeak[l], std::abs(x[l]));
+        sumSq[l] += x[l] * x[l];
+
+        // K 特性: シェルビング → RLB ハイパス（Transposed Direct Form II）
+        const float y1 = shelf_.b0 * x[l] + shelfZ1_[l];
+        shelfZ1_[l] = shelf_.b1 * x[l] - shelf_.a1 * y1 + shelfZ2_[l];
+        shelfZ2_[l] = shelf_.b2 * x[l] - shelf_.a2 * y1;
+        const float y2 = hpf_.b0 * y1 + hpfZ1_[l];
+        hpfZ1_[l] = hpf_.b1 * y1 - hpf_.a1 * y2 + hpfZ2_[l];
+        hpfZ2_[l] = hpf_.b2 * y1 - hpf_.a2 * y2;
+        kw[l] = y2 * y2;
+      }
+      accumulateLoudness(kw);
+      pushTruePeak(x, blockTp);
+    }
+
+    // ── バリスティクス（サンプル数基準なのでブロック長に依存しない） ──
+    const float fall =
+        std::exp(peakFallPerSample_ * static_cast<float>(numSamples));
+    const float rmsCoeff = std::exp(-static_cast<float>(numSamples) /
+                                    (kRmsTauSec * static_cast<float>(sr_)));
+    const float invN = 1.0f / static_cast<float>(numSamples);
+    for (std::size_t l = 0; l < kLanes; ++l) {
+      peak_[l] = std::max(blockPeak[l], peak_[l] * fall);
+      truePeak_[l] =
+          std::max({blockTp[l], blockPeak[l], truePeak_[l] * fall});
+      meanSq_[l] =
+          rmsCoeff * meanSq_[l] + (1.0f - rmsCoeff) * sumSq[l] * invN;
+    }
+    publish();
+  }
+
+  /// 無音区間 numSamples 分を解析的に進める（アイドル時、バッファ走査なし）。
+  void decay(int numSamples) noexcept {
+    if (numSamples <= 0)
+      return;
+    const float fall =
+        std::exp(peakFallPerSample_ * static_cast<float>(numSamples));
+    const float rmsCoeff = std::exp(-static_cast<float>(numSamples) /
+                                    (kRmsTauSec * static_cast<float>(sr_)));
+    for (std::size_t l = 0; l < kLanes; ++l) {
+      peak_[l] *= fall;
+      truePeak_[l] *= fall;
+      meanSq_[l] *= rmsCoeff;
+    }
+    // 入力は無音なのでフィルター状態も 0 に落ちている扱い
+    resetFilterState();
+    // ラウドネス窓は無音ビンで進める（3s 分で全ビンが 0 になる）
+    const int maxSamples = binSamples_ * (kNumBins + 1);
+    for (int left = std::min(numSamples, maxSamples); left > 0;) {
+      const int n = std::min(left, binSamples_ - binFill_);
+      binFill_ += n;
+      left -= n;
+      if (binFill_ >= binSamples_)
+        closeBin();
+    }
+    publish();
+  }
+
+  /// 最新の計測結果を取得（UI スレッド専用: 読み手は 1 スレッドのみ）。
+  const Snapshot &snapshot() noexcept { return snapshots_.acquire(); }
+
+private:
+  using Lanes = std::array<float, kLanes>;
+
+  struct Biquad {
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+  };
+
+  static constexpr float kRmsTauSec = 0.3f;
+  /// ピーク / True Peak の落下速度（ブロック長・サンプルレート非依存）
+  static constexpr float kPeakFallDbPerSec = 23.0f;
+  static constexpr int kTpTaps = TruePeak::kTaps;
+  static constexpr int kBinsMomentary = 4; ///< 100ms × 4 = 400ms
+  static constexpr int kNumBins = 30;      ///< 100ms × 30 = 3s
+
+  int maxBlockSize() const noexcept {
+    return static_cast<int>(frames_.size()) / kLanes;
+  }
+
+  void resetFilterState() noexcept {
+    shelfZ1_.fill(0.0f);
+    shelfZ2_.fill(0.0f);
+    hpfZ1_.fill(0.0f);
+    hpfZ2_.fill(0.0f);
+    for (auto &h : tpHist_)
+      h.fill(0.0f);
+    tpPos_ = 0;
+  }
+
+  /// ITU-R BS.1770 の K 特性（2 段バイクアッド）を sr_ に合わせて設計
+  void designKWeighting() noexcept {
+    const double fs = sr_;
+    {
+      constexpr double f0 = 1681.974450955533;
+      constexpr double gainDb = 3.999843853973347;
+      constexpr double q = 0.7071752369554196;
+      const double k = std::tan(std::numbers::pi * f0 / fs);
+      const double vh = std::pow(10.0, gainDb / 20.0);
+      const double vb = std::pow(vh, 0.4996667741545416);
+      const double a0 = 1.0 + k / q + k * k;
+      shelf_ = {static_cast<float>((vh + vb * k / q + k * k) / a0),
+                static_cast<float>(2.0 * (k * k - vh) / a0),
+                static_cast<float>((vh - vb * k / q + k * k) / a0),
+                static_cast<float>(2.0 * (k * k - 1.0) / a0),
+                static_cast<float>((1.0 - k / q + k * k) / a0)};
+    }
+    {
+      constexpr double f0 = 38.13547087602444;
+      constexpr double q = 0.5003270373238773;
+      const double k = std::tan(std::numbers::pi * f0 / fs);
+      const double a0 = 1.0 + k / q + k * k;
+      hpf_ = {1.0f, -2.0f, 1.0f, static_cast<float>(2.0 * (k * k - 1.0) / a0),
+              static_cast<float>((1.0 - k / q + k * k) / a0)};
+    }
+    // ピーク落下: 1 サンプルあたりの自然対数ゲイン
+    peakFallPerSample_ = static_cast<float>(
+        -kPeakFallDbPerSec * std::numbers::ln10 / 20.0 / fs);
+  }
+
+  /// True Peak: 履歴（二重化リング）へ 1 サンプル追加し 4 位相を評価
+  void pushTruePeak(const float *x, Lanes &blockTp) noexcept {
+    tpPos_ = tpPos_ == 0 ? kTpTaps - 1 : tpPos_ - 1;
+    auto &h0 = tpHist_[static_cast<std::size_t>(tpPos_)];
+    auto &h1 = tpHist_[static_cast<std::size_t>(tpPos_ + kTpTaps)];
+    for (std::size_t l = 0; l < kLanes; ++l) {
+      h0[l] = x[l];
+      h1[l] = x[l];
+    }
+    for (const auto &coeffs : tpCoeffs_) {
+      Lanes acc{};
+      for (std::size_t k = 0; k < kTpTaps; ++k) {
+        const auto &h = tpHist_[static_cast<std::size_t>(tpPos_) + k];
+        for (std::size_t l = 0; l < kLanes; ++l)
+          acc[l] += coeffs[k] * h[l];
+      }
+      for (std::size_t l = 0; l < kLanes; ++l)
+        blockTp[l] = std::max(blockTp[l], std::abs(acc[l]));
+    }
+  }
+
+  /// K 特性二乗を 100ms ビンへ積算。ビンが埋まったら窓を更新。
+  void accumulateLoudness(const Lanes &kw) noexcept {
+    for (std::size_t l = 0; l < kLanes; ++l)
+      binAccum_[l] += kw[l];
+    if (++binFill_ >= binSamples_)
+      closeBin();
+  }
+
+  void closeBin() noexcept {
+    const float inv = 1.0f / static_cast<float>(binSamples_);
+    auto &bin = bins_[static_cast<std::size_t>(binPos_)];
+    for (std::size_t l = 0; l < kLanes; ++l)
+      bin[l] = binAccum_[l] * inv;
+    binAccum_.fill(0.0f);
+    binFill_ = 0;
+    binPos_ = (binPos_ + 1) % kNumBins;
+
+    // 窓平均（ビン数が少ないので毎回足し直してドリフトを避ける）
+    Lanes mom{};
+    Lanes st{};
+    for (int b = 0; b < kNumBins; ++b) {
+      const auto newest = (binPos_ + kNumBins - 1 - b) % kNumBins;
+      const auto &v = bins_[static_cast<std::size_t>(newest)];
+      for (std::size_t l = 0; l < kLanes; ++l) {
+        st[l] += v[l];
+        if (b < kBinsMomentary)
+          mom[l] += v[l];
+      }
+    }
+    for (std::size_t l = 0; l < kLanes; ++l) {
+      momentary_[l] = mom[l] / static_cast<float>(kBinsMomentary);
+      shortTerm_[l] = st[l] / static_cast<float>(kNumBins);
+    }
+  }
+
+  /// 計測値を書き込み側バッファへ詰めてトリプルバッファを入れ替える
+  void publish() noexcept {
+    auto &out = snapshots_.back();
+    for (std::size_t s = 0; s < kNumStreams; ++s) {
+      out.peak[s] = peak_[s];
+      out.rms[s] = std::sqrt(meanSq_[s]);
+      out.truePeak[s] = truePeak_[s];
+    }
+    // マスターは L+R の合算（BS.1770 のチャンネル重み 1.0）
+    out.momentary[kLoudMaster] = momentary_[kMasterL] + momentary_[kMasterR];
+    out.shortTerm[kLoudMaster] = shortTerm_[kMasterL] + shortTerm_[kMasterR];
+    for (std::size_t l = 1; l < kNumLoudness; ++l) {
+      out.momentary[l] = momentary_[l + 1];
+      out.shortTerm[l] = shortTerm_[l + 1];
+    }
+    snapshots_.publish();
+  }
+
+  double sr_ = 44100.0;
+  float peakFallPerSample_ = 0.0f;
+  std::span<float> frames_; ///< 転置済み入力 [maxBlockSize][kLanes]
+
+  Biquad shelf_;
+  Biquad hpf_;
+  Lanes shelfZ1_{}, shelfZ2_{}, hpfZ1_{}, hpfZ2_{};
+
+  TruePeak::Coeffs tpCoeffs_{};
+  std::array<Lanes, 2 * kTpTaps> tpHist_{};
+  int tpPos_ = 0;
+
+  Lanes peak_{}, truePeak_{}, meanSq_{};
+
+  int binSamples_ = 4410;
+  int binFill_ = 0;
+  int binPos_ = 0;
+  Lanes binAccum_{};
+  std::array<Lanes, kNumBins> bins_{};
+  Lanes momentary_{}, shortTerm_{};
+
+  TripleBuffer<Snapshot> snapshots_; ///< オーディオ → UI
+  DspArena localArena_;              ///< 単体利用時のみ使う
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+/// トランジェント検出用の間引き IIR フィルターバンク（ヘッダオンリー）。
+///
+/// 構成（kDecimation = 8 サンプル毎に 1 フレームを出力）:
+///   1. フル レート: 1 次 LPF（kSplitHighHz）で高域を除去し 8 サンプル平均
+///   2. 1/8 レート:  1 次 LPF（kSplitLowHz）で Low / Mid に分割
+///        Low = LPF 出力、Mid = 平均値 − LPF 出力
+///
+/// フル レートで行うのは 1 次 LPF と加算のみ。帯域分割と以降の
+/// オンセット検出は 1/8 レートで走るため、フル帯域検出より軽い。
+class OnsetFilterbank {
+public:
+  enum class Band { low = 0, mid };
+
+  static constexpr int kDecimation = 8;
+  static constexpr float kSplitLowHz = 150.0f;   ///< Low / Mid 境界
+  static constexpr float kSplitHighHz = 2000.0f; ///< Mid 上限（高域除去）
+
+  void prepare(double sampleRate) noexcept {
+    const auto fs = static_cast<float>(sampleRate);
+    coeffHigh_ = onePoleCoeff(kSplitHighHz, fs);
+    coeffLow_ =
+        onePoleCoeff(kSplitLowHz, fs / static_cast<float>(kDecimation));
+    reset();
+  }
+
+  void reset() noexcept {
+    lpHigh_ = 0.0f;
+    lpLow_ = 0.0f;
+    sum_ = 0.0f;
+    phase_ = 0;
+  }
+
+  /// 1 サンプル入力。フレームが揃ったら選択帯域の値を out に書き true を返す。
+  bool push(float x, Band band, float &out) noexcept {
+    lpHigh_ += coeffHigh_ * (x - lpHigh_);
+    sum_ += lpHigh_;
+    if (++phase_ < kDecimation)
+      return false;
+
+    const float avg = sum_ * (1.0f / static_cast<float>(kDecimation));
+    sum_ = 0.0f;
+    phase_ = 0;
+    lpLow_ += coeffLow_ * (avg - lpLow_);
+    out = band == Band::low ? lpLow_ : avg - lpLow_;
+    return true;
+  }
+
+private:
+  static float onePoleCoeff(float hz, float fs) noexcept {
+    const float w = 2.0f * std::numbers::pi_v<float> * hz / fs;
+    return std::clamp(1.0f - std::exp(-w), 0.0f, 1.0f);
+  }
+
+  float coeffHigh_ = 0.25f;
+  float coeffLow_ = 0.15f;
+  float lpHigh_ = 0.0f;
+  float lpLow_ = 0.0f;
+  float sum_ = 0.0f;
+  int phase_ = 0;
+};
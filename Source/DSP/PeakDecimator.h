@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+/// 波形表示用 min/max ピラミッド（ヘッダオンリー、オーディオスレッド専用）。
+///
+/// レベル 0 は kBaseBin サンプル毎、レベル k は下位 kFanout ビン毎に
+/// {min, max} を 1 つ出力する。GUI は表示倍率に合うレベルだけを読めば
+/// よく、生サンプルを走査する必要がない。
+class PeakDecimator {
+public:
+  struct MinMax {
+    float min = 0.0f;
+    float max = 0.0f;
+  };
+
+  static constexpr int kNumLevels = 3;
+  static constexpr int kBaseBin = 16; ///< レベル 0 の 1 ビンあたりサンプル数
+  static constexpr int kFanout = 4;   ///< 上位レベルが束ねる下位ビン数
+
+  /// level の 1 ビンあたりサンプル数（16 / 64 / 256）
+  static constexpr int binSize(int level) noexcept {
+    int size = kBaseBin;
+    for (int i = 0; i < level; ++i)
+      size *= kFanout;
+    return size;
+  }
+
+  void reset() noexcept {
+    acc_.fill(kEmpty);
+    count_.fill(0);
+  }
+
+  /// src（nullptr なら無音）を取り込み、ビンが揃う度に emit(level, MinMax)
+  /// を呼ぶ。レベル 0 のビンは kBaseBin 単位の区間でまとめて走査する。
+  template <typename Emit>
+  void push(const float *src, int numSamples, Emit &&emit) {
+    int i = 0;
+    while (i < numSamples) {
+      const int take = std::min(numSamples - i, kBaseBin - count_[0]);
+      auto &acc = acc_[0];
+      if (src != nullptr) {
+        const auto [lo, hi] = std::minmax_element(src + i, src + i + take);
+        acc.min = std::min(acc.min, *lo);
+        acc.max = std::max(acc.max, *hi);
+      } else {
+        acc.min = std::min(acc.min, 0.0f);
+        acc.max = std::max(acc.max, 0.0f);
+      }
+      count_[0] += take;
+      i += take;
+      if (count_[0] == kBaseBin)
+        complete(0, emit);
+    }
+  }
+
+private:
+  static constexpr MinMax kEmpty{std::numeric_limits<float>::max(),
+                                 std::numeric_limits<float>::lowest()};
+
+  template <typename Emit> void complete(int level, Emit &emit) {
+    const auto l = static_cast<std::size_t>(level);
+    const MinMax bin = acc_[l];
+    acc_[l] = kEmpty;
+    count_[l] = 0;
+    emit(level, bin);
+    if (level + 1 >= kNumLevels)
+      return;
+    auto &up = acc_[l + 1];
+    up.min = std::min(up.min, bin.min);
+    up.max = std::max(up.max, bin.max);
+    if (++count_[l + 1] == kFanout)
+      complete(level + 1, emit);
+  }
+
+  std::array<MinMax, kNumLevels> acc_{kEmpty, kEmpty, kEmpty};
+  std::array<int, kNumLevels> count_{};
+};
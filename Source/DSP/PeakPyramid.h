@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// サンプル全体の min/max ピラミッド（不変、ヘッダオンリー）。
+///
+/// レベル 0 が 4096 ビン、以降 kFanout ビンずつ束ねて 1024 / 256 / 64 ビン。
+/// サンプルを走査するのはレベル 0 を作るときの 1 回だけ。デコード時に
+/// 作って SamplePlayer::Decoded と一緒に共有し、表示側は levelFor() で
+/// 必要な細かさのレベルを選んで読む（走査し直しもコピーもしない）。
+/// 各ビンは (L + R) / 2 の {min, max}。min は 0 以下、max は 0 以上に
+/// 揃える（空のビンは {0, 0}）。
+class PeakPyramid {
+public:
+  static constexpr int kNumLevels = 4;
+  static constexpr int kFinestBins = 4096; ///< レベル 0 のビン数
+  static constexpr int kFanout = 4;        ///< 上位レベルが束ねる下位ビン数
+
+  struct Level {
+    std::vector<float> min;
+    std::vector<float> max;
+  };
+
+  /// level のビン数（4096 / 1024 / 256 / 64）
+  static constexpr int numBins(int level) noexcept {
+    int bins = kFinestBins;
+    for (int i = 0; i < level; ++i)
+      bins /= kFanout;
+    return bins;
+  }
+
+  /// minBins 以上のビンを持つ最も粗いレベル（足りなければレベル 0）
+  static constexpr int levelFor(int minBins) noexcept {
+    for (int level = kNumLevels - 1; level > 0; --level)
+      if (numBins(level) >= minBins)
+        return level;
+    return 0;
+  }
+
+  /// left / right の先頭 length サンプルから作る（モノは left == right）
+  PeakPyramid(const float *left, const float *right, int length) {
+    auto &finest = levels_[0];
+    finest.min.assign(kFinestBins, 0.0f);
+    finest.max.assign(kFinestBins, 0.0f);
+    const auto total = static_cast<std::int64_t>(std::max(length, 0));
+    for (int bin = 0; bin < kFinestBins; ++bin) {
+      const auto s = static_cast<int>(bin * total / kFinestBins);
+      const auto e = static_cast<int>((bin + 1) * total / kFinestBins);
+      float mn = 0.0f;
+      float mx = 0.0f;
+      for (int j = s; j < e; ++j) {
+        const float v = (left[j] + right[j]) * 0.5f;
+        mn = std::min(mn, v);
+        mx = std::max(mx, v);
+      }
+      finest.min[static_cast<std::size_t>(bin)] = mn;
+      finest.max[static_cast<std::size_t>(bin)] = mx;
+    }
+
+    // ビン境界は bin * total / bins なので、束ねた結果は直接作った場合と
+    // 一致する
+    for (std::size_t l = 1; l < kNumLevels; ++l) {
+      const auto &lower = levels_[l - 1];
+      auto &upper = levels_[l];
+      const auto bins =
+          static_cast<std::size_t>(numBins(static_cast<int>(l)));
+      upper.min.resize(bins);
+      upper.max.resize(bins);
+      for (std::size_t bin = 0; bin < bins; ++bin) {
+        const float *mins = lower.min.data() + bin * kFanout;
+        const float *maxs = lower.max.data() + bin * kFanout;
+        upper.min[bin] = *std::min_element(mins, mins + kFanout);
+        upper.max[bin] = *std::max_element(maxs, maxs + kFanout);
+      }
+    }
+  }
+
+  const Level &level(int index) const noexcept {
+    return levels_[static_cast<std::size_t>(
+        std::clamp(index, 0, kNumLevels - 1))];
+  }
+
+private:
+  std::array<Level, kNumLevels> levels_;
+};
@@ -1,5 +1,85 @@
 #include "SamplePlayer.h"
+#include "SamplePool.h"
 #include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+SampleFormat chooseFormat(SamplePlayer::Residency residency,
+                          const juce::AudioFormatReader &reader) {
+  using enum SamplePlayer::Residency;
+  switch (residency) {
+  case float32:
+    return SampleFormat::float32;
+  case int16:
+    return SampleFormat::int16;
+  case half:
+    return SampleFormat::half;
+  case automatic:
+    break;
+  }
+  // 16bit 以下の整数ソースは int16 に戻しても失われるものが無い
+  return !reader.usesFloatingPointData && reader.bitsPerSample <= 16
+             ? SampleFormat::int16
+             : SampleFormat::float32;
+}
+
+/// 最初に無音でなくなるフレーム。ブロックずつ読んで（デコードして）探し、
+/// 見つかった時点でやめる。読んだブロックは捨てるので、先頭の無音は
+/// 保持しないだけでデコードはされる（全体が無音なら 0 = 削らない）
+juce::int64 findAudibleStart(juce::AudioFormatReader &reader,
+                             int numChannels) {
+  constexpr int kBlock = 4096;
+  juce::AudioBuffer<float> block(static_cast<int>(reader.numChannels), kBlock);
+  for (juce::int64 pos = 0; pos < reader.lengthInSamples; pos += kBlock) {
+    const auto n = static_cast<int>(
+        std::min<juce::int64>(kBlock, reader.lengthInSamples - pos));
+    reader.read(&block, 0, n, pos, true, true);
+    const int i =
+        SampleTrim::firstAbove(block.getArrayOfReadPointers(), numChannels, n,
+                               SampleTrim::kSilenceThreshold);
+    if (i >= 0)
+      return pos + i;
+  }
+  return 0;
+}
+
+/// 読み出しカーネル本体。T は常駐形式、Mono なら R は L の値をそのまま使う
+template <typename T, bool Mono>
+int readBlockKernel(const SampleStorage::View &v, double &playhead,
+                    double playRate, float *outL, float *outR,
+                    int numFrames) noexcept {
+  using SampleConvert::toFloat;
+  const auto *l = static_cast<const T *>(v.left);
+  const auto *r = static_cast<const T *>(v.right);
+  const auto last = static_cast<double>(v.length - 1);
+  int i = 0;
+  for (; i < numFrames && playhead < last; ++i) {
+    const auto i0 = static_cast<int>(playhead);
+    const int i1 = std::min(i0 + 1, v.length - 1);
+    const auto frac = static_cast<float>(playhead - static_cast<double>(i0));
+    outL[i] = toFloat(l[i0]) * (1.0f - frac) + toFloat(l[i1]) * frac;
+    if constexpr (Mono)
+      outR[i] = outL[i];
+    else
+      outR[i] = toFloat(r[i0]) * (1.0f - frac) + toFloat(r[i1]) * frac;
+    playhead += playRate;
+  }
+  std::fill(outL + i, outL + numFrames, 0.0f);
+  std::fill(outR + i, outR + numFrames, 0.0f);
+  return i;
+}
+
+template <typename T>
+int readBlockAs(const SampleStorage::View &v, double &playhead,
+                double playRate, float *outL, float *outR,
+                int numFrames) noexcept {
+  return v.isMono() ? readBlockKernel<T, true>(v, playhead, playRate, outL,
+                                               outR, numFrames)
+                    : readBlockKernel<T, false>(v, playhead, playRate, outL,
+                                                outR, numFrames);
+}
+} // namespace
 
 // ────────────────────────────────────────────────────
 // lifecycle
@@ -15,71 +95,122 @@ void SamplePlayer::prepare() {
 // ────────────────────────────────────────────────────
 
 void SamplePlayer::loadSample(const juce::File &file) {
+  // 他のインスタンスが同じファイルをロード済みならデコードしない
+  loadDecoded(SamplePool::acquire(SamplePool::keyFor(file), [&] {
+    return decode(file, formatManager_);
+  }));
+}
+
+void SamplePlayer::loadSample(std::unique_ptr<juce::InputStream> stream,
+                              const juce::String &sourceId) {
+  loadDecoded(SamplePool::acquire(sourceId, [&] {
+    return decode(std::move(stream), sourceId, formatManager_);
+  }));
+}
+
+std::optional<SamplePlayer::Decoded>
+SamplePlayer::decode(const juce::File &file,
+                     juce::AudioFormatManager &formatManager,
+                     Residency residency,
+                     const SampleTrim::Options &trim) {
   std::unique_ptr<juce::AudioFormatReader> reader(
-      formatManager_.createReaderFor(file));
+      formatManager.createReaderFor(file));
   if (reader == nullptr)
-    return;
+    return std::nullopt;
+  auto d = decodeReader(*reader, residency, trim);
+  d.source = file.getFullPathName();
+  d.modified = file.getLastModificationTime();
+  return d;
+}
 
-  // デコード（最大 30 秒）
-  const auto maxSamples = static_cast<int>(
-      std::min(reader->lengthInSamples,
-               static_cast<juce::int64>(reader->sampleRate * 30.0)));
-  juce::AudioBuffer<float> buf(static_cast<int>(reader->numChannels),
-                               maxSamples);
-  reader->read(&buf, 0, maxSamples, 0, true, true);
-
-  // 常に 2ch（ステレオ）で保持。モノソースは ch0 を ch1 にコピー
-  juce::AudioBuffer<float> stereo(2, maxSamples);
-  stereo.copyFrom(0, 0, buf, 0, 0, maxSamples);
-  if (buf.getNumChannels() >= 2)
-    stereo.copyFrom(1, 0, buf, 1, 0, maxSamples);
-  else
-    stereo.copyFrom(1, 0, buf, 0, 0, maxSamples);
-
-  const double fileSr = reader->sampleRate;
-
-  // 波形サムネイル事前計算（モノ平均で表示）
-  {
-    constexpr int kThumbBins = 512;
-    const int total = maxSamples;
-    const float *srcL = stereo.getReadPointer(0);
-    const float *srcR = stereo.getReadPointer(1);
-    thumbMin_.resize(static_cast<std::size_t>(kThumbBins));
-    thumbMax_.resize(static_cast<std::size_t>(kThumbBins));
-    for (int bin = 0; bin < kThumbBins; ++bin) {
-      const int s = (bin * total) / kThumbBins;
-      const int e = ((bin + 1) * total) / kThumbBins;
-      float mn = 0.0f;
-      float mx = 0.0f;
-      for (int j = s; j < e; ++j) {
-        const float val = (srcL[j] + srcR[j]) * 0.5f;
-        mn = std::min(mn, val);
-        mx = std::max(mx, val);
-      }
-      thumbMin_[static_cast<std::size_t>(bin)] = mn;
-      thumbMax_[static_cast<std::size_t>(bin)] = mx;
-    }
-    durationSec_.store(static_cast<double>(total) / fileSr);
-  }
+std::optional<SamplePlayer::Decoded>
+SamplePlayer::decode(std::unique_ptr<juce::InputStream> stream,
+                     const juce::String &sourceId,
+                     juce::AudioFormatManager &formatManager,
+                     Residency residency,
+                     const SampleTrim::Options &trim) {
+  if (stream == nullptr)
+    return std::nullopt;
+  std::unique_ptr<juce::AudioFormatReader> reader(
+      formatManager.createReaderFor(std::move(stream)));
+  if (reader == nullptr)
+    return std::nullopt;
+  auto d = decodeReader(*reader, residency, trim);
+  d.source = sourceId;
+  return d;
+}
+
+SamplePlayer::Decoded
+SamplePlayer::decodeReader(juce::AudioFormatReader &reader,
+                           Residency residency,
+                           const SampleTrim::Options &trim) {
+  // モノは 1ch のまま（R は L を共有）、3ch 以上は先頭 2ch を持つ
+  Decoded d;
+  const int readerChannels = static_cast<int>(reader.numChannels);
+  const int numChannels = std::min(readerChannels, 2);
+
+  const double fileSr = reader.sampleRate;
+  const auto preRoll = static_cast<int>(fileSr * SampleTrim::kPreRollSec);
 
-  // スピンロックで保護しながらスワップ
+  // 先頭の無音は探すために一度読むが、保持はしない
+  juce::int64 start = 0;
+  if (trim.skipSilence)
+    start = std::max<juce::int64>(
+        findAudibleStart(reader, numChannels) - preRoll, 0);
+
+  // 開始位置から再生が届く範囲だけデコードする（後ろは読まない）
+  const double window = std::ceil(trim.maxLengthSec * fileSr) + 1.0;
+  const auto remaining =
+      std::max<juce::int64>(reader.lengthInSamples - start, 0);
+  const auto total = static_cast<int>(
+      std::min({static_cast<double>(remaining), window,
+                static_cast<double>(std::numeric_limits<int>::max())}));
+  juce::AudioBuffer<float> resident(readerChannels, total);
+  reader.read(&resident, 0, total, start, true, true);
+
+  // 波形ピラミッドは常駐形式に変換する前の float から作る
+  d.peaks = std::make_shared<const PeakPyramid>(
+      resident.getReadPointer(0), resident.getReadPointer(numChannels - 1),
+      total);
+  d.info = {fileSr, static_cast<double>(total) / fileSr};
+
+  d.samples = SampleStorage(resident, numChannels, total,
+                            chooseFormat(residency, reader));
+  return d;
+}
+
+void SamplePlayer::loadDecoded(std::shared_ptr<const Decoded> decoded) {
+  if (decoded == nullptr)
+    return;
+  loadedInfo_ = decoded->info;
+
+  // スピンロックで保護しながらポインタだけ入れ替える。前のサンプルは
+  // decoded に移り、ロックを抜けた後にここで手放す
   {
     const juce::SpinLock::ScopedLockType lk(sampleLock_);
-    buffer_ = std::move(stereo);
-    sampleSampleRate_ = fileSr;
+    sample_.swap(decoded);
+    info_.publish(loadedInfo_);
   }
-
   loaded_.store(true);
 }
 
+bool SamplePlayer::isLoadedFrom(const juce::File &file) const {
+  return isLoadedFrom(file.getFullPathName()) &&
+         file.getLastModificationTime() == sample_->modified;
+}
+
+bool SamplePlayer::isLoadedFrom(const juce::String &sourceId) const {
+  return loaded_.load() && sample_ != nullptr && sourceId == sample_->source;
+}
+
 void SamplePlayer::unloadSample() {
+  std::shared_ptr<const Decoded> released;
   {
     const juce::SpinLock::ScopedLockType lk(sampleLock_);
-    buffer_.setSize(0, 0);
+    released.swap(sample_);
+    loadedInfo_.durationSec = 0.0;
+    info_.publish(loadedInfo_);
   }
-  thumbMin_.clear();
-  thumbMax_.clear();
-  durationSec_.store(0.0);
   playheadSamples_ = 0.0;
   loaded_.store(false);
 }
@@ -88,13 +219,10 @@ void SamplePlayer::unloadSample() {
 // メタ情報
 // ────────────────────────────────────────────────────
 
-bool SamplePlayer::copyThumbnail(std::vector<float> &outMin,
-                                 std::vector<float> &outMax) const noexcept {
-  if (!loaded_.load())
-    return false;
-  outMin = thumbMin_;
-  outMax = thumbMax_;
-  return true;
+std::shared_ptr<const PeakPyramid> SamplePlayer::peaks() const noexcept {
+  if (!loaded_.load() || sample_ == nullptr)
+    return nullptr;
+  return sample_->peaks;
 }
 
 // ────────────────────────────────────────────────────
@@ -104,46 +232,40 @@ bool SamplePlayer::copyThumbnail(std::vector<float> &outMin,
 SamplePlayer::LockedView SamplePlayer::lock() noexcept {
   LockedView v;
   v.lock = std::make_unique<juce::SpinLock::ScopedTryLockType>(sampleLock_);
-  if (v.lock->isLocked() && loaded_.load()) {
-    v.data = buffer_.getReadPointer(0);
-    v.dataR = buffer_.getNumChannels() >= 2 ? buffer_.getReadPointer(1)
-                                            : buffer_.getReadPointer(0);
-    v.length = buffer_.getNumSamples();
-  }
+  if (v.lock->isLocked() && loaded_.load() && sample_ != nullptr)
+    v.samples = sample_->samples.view();
   return v;
 }
 
-float SamplePlayer::readInterpolated(const float *srcData, int srcLen,
-                                     double playRate, bool &finished) {
-  if (playheadSamples_ >= static_cast<double>(srcLen - 1)) {
-    finished = true;
-    return 0.0f;
+int SamplePlayer::readBlockStereo(const SampleStorage::View &samples,
+                                  double playRate, float *outL, float *outR,
+                                  int numFrames) noexcept {
+  switch (samples.format) {
+  case SampleFormat::int16:
+    return readBlockAs<std::int16_t>(samples, playheadSamples_, playRate,
+                                     outL, outR, numFrames);
+  case SampleFormat::half:
+    return readBlockAs<SampleConvert::Half>(samples, playheadSamples_,
+                                            playRate, outL, outR, numFrames);
+  case SampleFormat::float32:
+    break;
   }
-  const auto i0 = static_cast<int>(playheadSamples_);
-  const int i1 = juce::jmin(i0 + 1, srcLen - 1);
-  const auto frac =
-      static_cast<float>(playheadSamples_ - static_cast<double>(i0));
-  const float s = srcData[i0] * (1.0f - frac) + srcData[i1] * frac;
-  playheadSamples_ += playRate;
-  return s;
-}
-
-std::pair<float, float> SamplePlayer::readInterpolatedStereo(const float *srcL,
-                                                             const float *srcR,
-                                                             int srcLen,
-                                                             double playRate,
-                                                             bool &finished) {
-  if (playheadSamples_ >= static_cast<double>(srcLen - 1)) {
+  return readBlockAs<float>(samples, playheadSamples_, playRate, outL, outR,
+                            numFrames);
+}
+
+float SamplePlayer::readInterpolated(const SampleStorage::View &samples,
+                                     double playRate, bool &finished) {
+  return readInterpolatedStereo(samples, playRate, finished).first;
+}
+
+std::pair<float, float>
+SamplePlayer::readInterpolatedStereo(const SampleStorage::View &samples,
+                                     double playRate, bool &finished) {
+  float l = 0.0f;
+  float r = 0.0f;
+  if (readBlockStereo(samples, playRate, &l, &r, 1) == 0)
     finished = true;
-    return {0.0f, 0.0f};
-  }
-  const auto i0 = static_cast<int>(playheadSamples_);
-  const int i1 = juce::jmin(i0 + 1, srcLen - 1);
-  const auto frac =
-      static_cast<float>(playheadSamples_ - static_cast<double>(i0));
-  const float l = srcL[i0] * (1.0f - frac) + srcL[i1] * frac;
-  const float r = srcR[i0] * (1.0f - frac) + srcR[i1] * frac;
-  playheadSamples_ += playRate;
   return {l, r};
 }
 
@@ -154,8 +276,7 @@ std::pair<float, float> SamplePlayer::readNextStereo(double playRate,
     finished = true;
     return {0.0f, 0.0f};
   }
-  return readInterpolatedStereo(view.data, view.dataR, view.length, playRate,
-                                finished);
+  return readInterpolatedStereo(view.samples, playRate, finished);
 }
 
 float SamplePlayer::readNext(double playRate, bool &finished) {
@@ -164,5 +285,5 @@ float SamplePlayer::readNext(double playRate, bool &finished) {
     finished = true;
     return 0.0f;
   }
-  return readInterpolated(view.data, view.length, playRate, finished);
+  return readInterpolated(view.samples, playRate, finished);
 }
@@ -3,13 +3,23 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_audio_formats/juce_audio_formats.h>
 
+#include "PeakPyramid.h"
+#include "SampleStorage.h"
+#include "SampleTrim.h"
+#include "TripleBuffer.h"
+
 #include <atomic>
+#include <memory>
+#include <optional>
 #include <utility>
-#include <vector>
 
 /// WAV/AIFF サンプルのロード・再生を管理する共通クラス。
 /// Direct / Click の Sample モードで共有する。
 /// フィルターやエンベロープは呼び出し側が担当する。
+/// デコード済みデータは SamplePool の共有サンプルを参照するだけで、
+/// インスタンスごとに持つのはプレイヘッドのみ。
+/// ロード時に先頭の無音を削り、再生が届く範囲（SampleTrim::kMaxReachSec）
+/// だけを持つ。届く範囲より後ろはデコードしない。
 class SamplePlayer {
 public:
   // ── lifecycle ──
@@ -18,11 +28,24 @@ public:
   /// サンプルファイルをロード（メッセージスレッドから呼ぶこと）。
   void loadSample(const juce::File &file);
 
+  /// ストリーム（埋め込みデータ等）からロード（メッセージスレッドから）。
+  /// sourceId は isLoadedFrom(sourceId) で照合するための識別子。
+  void loadSample(std::unique_ptr<juce::InputStream> stream,
+                  const juce::String &sourceId);
+
   /// ロード済みサンプルを解放する（メッセージスレッドから呼ぶこと）。
   void unloadSample();
 
   bool isLoaded() const noexcept { return loaded_.load(); }
 
+  /// file（パスと更新時刻が一致）を既にロード済みなら true。
+  /// プリセット / ホスト復元で同じサンプルをデコードし直さないために使う
+  /// （メッセージスレッド専用）。
+  bool isLoadedFrom(const juce::File &file) const;
+
+  /// ストリームからロードしたもの用: sourceId が一致すれば true
+  bool isLoadedFrom(const juce::String &sourceId) const;
+
   /// NoteOn 時にプレイヘッドをリセット。
   void resetPlayhead() noexcept { playheadSamples_ = 0.0; }
 
@@ -32,45 +55,109 @@ public:
   float readNext(double playRate, bool &finished);
 
   /// ロック取得を render ループの先頭で 1 回だけ行う版。
-  /// srcData/srcLen が有効な間、readInterpolated を直接呼べる。
+  /// lock が有効な間、samples を readBlockStereo 等に直接渡せる。
   struct LockedView {
-    const float *data = nullptr;
-    const float *dataR = nullptr;
-    int length = 0;
+    SampleStorage::View samples;
     std::unique_ptr<juce::SpinLock::ScopedTryLockType> lock;
-    explicit operator bool() const noexcept { return data != nullptr; }
+    explicit operator bool() const noexcept {
+      return static_cast<bool>(samples);
+    }
   };
   LockedView lock() noexcept;
 
-  /// ロック済みバッファに対する線形補間読み出し。プレイヘッドを進める。
-  float readInterpolated(const float *srcData, int srcLen, double playRate,
+  /// ロック済みサンプルから numFrames 分を線形補間で outL / outR に読み、
+  /// プレイヘッドを進める。常駐形式（int16 / half）から float への変換は
+  /// このカーネルの中で行い、形式の分岐はブロックにつき 1 回。
+  /// サンプル末端以降は 0 を書く。戻り値は末端までに読めたフレーム数。
+  int readBlockStereo(const SampleStorage::View &samples, double playRate,
+                      float *outL, float *outR, int numFrames) noexcept;
+
+  /// ロック済みサンプルの L を 1 サンプル線形補間で読み、プレイヘッドを
+  /// 進める。
+  float readInterpolated(const SampleStorage::View &samples, double playRate,
                          bool &finished);
 
   /// ステレオ版: L/R ペアで線形補間読み出し。
-  std::pair<float, float> readInterpolatedStereo(const float *srcL,
-                                                 const float *srcR, int srcLen,
-                                                 double playRate,
-                                                 bool &finished);
+  std::pair<float, float>
+  readInterpolatedStereo(const SampleStorage::View &samples, double playRate,
+                         bool &finished);
 
   /// ステレオ版: ロック取得 + readInterpolatedStereo。
   std::pair<float, float> readNextStereo(double playRate, bool &finished);
 
   // ── メタ情報 ──
-  double sampleRate() const noexcept { return sampleSampleRate_; }
-  double durationSec() const noexcept { return durationSec_.load(); }
-  bool copyThumbnail(std::vector<float> &outMin,
-                     std::vector<float> &outMax) const noexcept;
+  /// ロード済みサンプルのメタ情報。ロード / アンロード時に 1 組で公開する。
+  struct Info {
+    double sampleRate = 44100.0;
+    double durationSec = 0.0;
+  };
+
+  /// オーディオスレッド専用: 最新のメタ情報を取り込む（ブロック先頭で 1 回）
+  const Info &acquireInfo() noexcept { return info_.acquire(); }
+
+  /// メッセージスレッド専用: 直近にロード / アンロードした時点の値
+  double sampleRate() const noexcept { return loadedInfo_.sampleRate; }
+  double durationSec() const noexcept { return loadedInfo_.durationSec; }
+
+  /// メッセージスレッド専用: ロード中サンプルの波形ピラミッド（未ロードなら
+  /// nullptr）。不変なので受け取った側はそのまま持ち続けてよい
+  std::shared_ptr<const PeakPyramid> peaks() const noexcept;
+
+  // ── デコード / 差し込み ──
+  /// 常駐形式の選び方。automatic は 16bit 以下の整数ソースを int16、
+  /// それ以外を float で持つ（どちらも無損失）。half は 24bit / float
+  /// ソースでもメモリを半分にしたいとき用（仮数 11bit に丸める）。
+  enum class Residency { automatic, float32, int16, half };
+
+  /// デコード済みサンプル一式（モノは 1ch のまま持つ）
+  struct Decoded {
+    SampleStorage samples;
+    std::shared_ptr<const PeakPyramid> peaks; ///< 波形表示用（デコード時に作る）
+    Info info;
+    juce::String source; ///< デコード元（ファイルならフルパス）
+    juce::Time modified; ///< デコード時点のファイル更新時刻（ストリームは空）
+  };
+
+  /// file をデコードだけして返す（失敗なら nullopt）。SamplePlayer の状態に
+  /// 触れないので、formatManager を別に持てばワーカースレッドから呼べる。
+  /// 持つ範囲は trim で決まる（既定は無音を削って届く範囲まで）。
+  static std::optional<Decoded>
+  decode(const juce::File &file, juce::AudioFormatManager &formatManager,
+         Residency residency = Residency::automatic,
+         const SampleTrim::Options &trim = {});
+
+  /// ストリーム版の decode()
+  static std::optional<Decoded>
+  decode(std::unique_ptr<juce::InputStream> stream,
+         const juce::String &sourceId,
+         juce::AudioFormatManager &formatManager,
+         Residency residency = Residency::automatic,
+         const SampleTrim::Options &trim = {});
+
+  /// decode() 済みのデータを差し込む（メッセージスレッドから呼ぶこと）。
+  /// プリセットの先読み結果やプールの共有サンプルをディスク I/O 無しで
+  /// ロードするのに使う。nullptr なら何もしない。
+  void loadDecoded(std::shared_ptr<const Decoded> decoded);
+
+  /// ロード中の共有サンプル（メッセージスレッド専用、未ロードなら nullptr）
+  const std::shared_ptr<const Decoded> &loadedSample() const noexcept {
+    return sample_;
+  }
 
 private:
+  static Decoded decodeReader(juce::AudioFormatReader &reader,
+                              Residency residency,
+                              const SampleTrim::Options &trim);
+
   juce::AudioFormatManager formatManager_;
   juce::SpinLock sampleLock_;
-  juce::AudioBuffer<float> buffer_;
+  /// 共有サンプル。差し替えはメッセージスレッドが sampleLock_ 下で行い、
+  /// 手放した側の解放はロックの外（メッセージスレッド）で起きる。
+  std::shared_ptr<const Decoded> sample_;
   std::atomic<bool> loaded_{false};
-  double sampleSampleRate_{44100.0};
   double playheadSamples_{0.0};
 
-  // 波形サムネイル（メッセージスレッド専用）
-  std::vector<float> thumbMin_;
-  std::vector<float> thumbMax_;
-  std::atomic<double> durationSec_{0.0};
+  // メタ情報（loadedInfo_ は書き手 = メッセージスレッド側の控え）
+  Info loadedInfo_;
+  TripleBuffer<Info> info_;
 };
@@ -0,0 +1,67 @@
+#include "SamplePool.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+struct Pool {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::weak_ptr<const SamplePlayer::Decoded>>
+      entries;
+
+  /// 解放済みのエントリを掃除する（mutex を持って呼ぶこと）
+  void prune() {
+    std::erase_if(entries, [](const auto &kv) { return kv.second.expired(); });
+  }
+};
+
+Pool &pool() {
+  static Pool p;
+  return p;
+}
+} // namespace
+
+namespace SamplePool {
+
+juce::String keyFor(const juce::File &file) {
+  return file.getFullPathName() + "@" +
+         juce::String(file.getLastModificationTime().toMilliseconds());
+}
+
+Sample find(const juce::String &key) {
+  auto &p = pool();
+  const std::scoped_lock lock(p.mutex);
+  const auto it = p.entries.find(key.toStdString());
+  return it != p.entries.end() ? it->second.lock() : nullptr;
+}
+
+Sample acquire(
+    const juce::String &key,
+    const std::function<std::optional<SamplePlayer::Decoded>()> &decode) {
+  if (auto hit = find(key))
+    return hit;
+
+  auto decoded = decode();
+  if (!decoded)
+    return nullptr;
+  auto sample =
+      std::make_shared<const SamplePlayer::Decoded>(std::move(*decoded));
+
+  auto &p = pool();
+  const std::scoped_lock lock(p.mutex);
+  auto &entry = p.entries[key.toStdString()];
+  if (auto raced = entry.lock())
+    return raced;
+  entry = sample;
+  p.prune();
+  return sample;
+}
+
+std::size_t size() {
+  auto &p = pool();
+  const std::scoped_lock lock(p.mutex);
+  p.prune();
+  return p.entries.size();
+}
+
+} // namespace SamplePool
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "SamplePlayer.h"
+
+#include <functional>
+#include <memory>
+#include <optional>
+
+/// デコード済みサンプルのプロセス共通プール。
+///
+/// 同じサンプル（ファイルはパス + 更新時刻、埋め込み / ストアのサンプルは
+/// 参照文字列）を使う SamplePlayer 同士は、不変のバッファとサムネイルを
+/// 1 つだけ共有する。プールは弱参照しか持たないので、最後の利用者が
+/// 手放した時点で解放される。
+namespace SamplePool {
+
+using Sample = std::shared_ptr<const SamplePlayer::Decoded>;
+
+/// file 用のキー（パス + 更新時刻。書き換えられたら別のサンプル扱い）
+juce::String keyFor(const juce::File &file);
+
+/// key のサンプルが生きていれば返す（無ければ nullptr）
+Sample find(const juce::String &key);
+
+/// key のサンプルを返す。生きていなければ decode() の結果を登録して返す
+/// （失敗なら nullptr）。decode() はプールのロック外で呼ぶので、どの
+/// スレッドからでも呼べる。同時に同じ key をデコードした場合は先に
+/// 登録された方を返す。
+Sample acquire(
+    const juce::String &key,
+    const std::function<std::optional<SamplePlayer::Decoded>()> &decode);
+
+/// 生きているサンプルの数（テスト用）
+std::size_t size();
+
+} // namespace SamplePool
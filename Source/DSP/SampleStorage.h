@@ -0,0 +1,171 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/// 再生用に常駐させるサンプルの形式
+enum class SampleFormat : std::uint8_t { float32, int16, half };
+
+/// 常駐形式と float の相互変換（ヘッダオンリー）。
+/// 再生時の float 化は SamplePlayer の読み出しカーネルがこれで行う。
+namespace SampleConvert {
+
+/// half（IEEE 754 binary16）のビット列。int16 と区別するための型
+struct Half {
+  std::uint16_t bits;
+};
+
+inline float toFloat(float v) noexcept { return v; }
+
+inline float toFloat(std::int16_t v) noexcept {
+  return static_cast<float>(v) * (1.0f / 32768.0f);
+}
+
+/// 指数部をそのまま float の位置へずらして 2^112 倍する（非正規化数も
+/// 同じ式で正しくなる）。Inf / NaN は toHalf() が作らないので扱わない。
+inline float toFloat(Half h) noexcept {
+  const std::uint32_t sign = (h.bits & 0x8000u) << 16;
+  const auto magnitude =
+      std::bit_cast<float>(static_cast<std::uint32_t>(h.bits & 0x7fffu)
+                           << 13) *
+      0x1.0p112f;
+  return std::bit_cast<float>(std::bit_cast<std::uint32_t>(magnitude) | sign);
+}
+
+/// 16bit 整数化（32768 倍して丸め、範囲外は飽和）。16bit ソースは無損失
+inline std::int16_t toInt16(float v) noexcept {
+  const float scaled = std::nearbyint(v * 32768.0f);
+  return static_cast<std::int16_t>(std::clamp(scaled, -32768.0f, 32767.0f));
+}
+
+/// half 化（最近接偶数丸め）。NaN は 0、範囲外は ±65504 に飽和させ、
+/// 読み出し側で Inf / NaN を扱わずに済むようにする。
+inline Half toHalf(float v) noexcept {
+  if (std::isnan(v))
+    v = 0.0f;
+  v = std::clamp(v, -65504.0f, 65504.0f);
+  const auto bits = std::bit_cast<std::uint32_t>(v);
+  const auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000u);
+  std::uint32_t f = bits & 0x7fffffffu;
+  std::uint32_t out;
+  if (f < 0x38800000u) {
+    // 非正規化数 / 0: 丸めは float の加算に任せる
+    constexpr std::uint32_t kDenormMagic = 126u << 23;
+    out = std::bit_cast<std::uint32_t>(std::bit_cast<float>(f) +
+                                       std::bit_cast<float>(kDenormMagic)) -
+          kDenormMagic;
+  } else {
+    const std::uint32_t mantOdd = (f >> 13) & 1u;
+    f += (static_cast<std::uint32_t>(15 - 127) << 23) + 0xfffu;
+    f += mantOdd;
+    out = f >> 13;
+  }
+  return {static_cast<std::uint16_t>(out | sign)};
+}
+
+} // namespace SampleConvert
+
+/// 再生用のサンプル本体（不変、ヘッダオンリー）。
+///
+/// チャンネルごとに連続して持つ。モノは 1ch 分だけ持ち、R は L と同じ
+/// 領域を指す（2ch に複製しない）。形式は float / 16bit 整数 / half。
+class SampleStorage {
+public:
+  /// 読み出し用ビュー（SamplePlayer::LockedView 経由でオーディオスレッドへ）
+  struct View {
+    SampleFormat format = SampleFormat::float32;
+    const void *left = nullptr;
+    const void *right = nullptr; ///< モノなら left と同じ
+    int length = 0;
+
+    explicit operator bool() const noexcept {
+      return left != nullptr && length > 0;
+    }
+    bool isMono() const noexcept { return left == right; }
+
+    /// 1 サンプルを float で読む（テスト・表示用。再生はカーネルで読む）
+    float sample(int ch, int i) const noexcept {
+      const void *base = ch == 0 ? left : right;
+      switch (format) {
+      case SampleFormat::int16:
+        return SampleConvert::toFloat(
+            static_cast<const std::int16_t *>(base)[i]);
+      case SampleFormat::half:
+        return SampleConvert::toFloat(
+            static_cast<const SampleConvert::Half *>(base)[i]);
+      case SampleFormat::float32:
+        break;
+      }
+      return static_cast<const float *>(base)[i];
+    }
+  };
+
+  SampleStorage() = default;
+
+  /// src の先頭 numChannels ch（1 か 2）× length サンプルを format で持つ
+  SampleStorage(const juce::AudioBuffer<float> &src, int numChannels,
+                int length, SampleFormat format)
+      : format_(format), numChannels_(std::clamp(numChannels, 1, 2)),
+        length_(std::max(length, 0)) {
+    bytes_.resize(static_cast<std::size_t>(numChannels_) * channelBytes());
+    for (int ch = 0; ch < numChannels_; ++ch) {
+      const float *in = src.getReadPointer(ch);
+      std::byte *out = bytes_.data() + static_cast<std::size_t>(ch) *
+                                           channelBytes();
+      switch (format_) {
+      case SampleFormat::float32:
+        std::memcpy(out, in, channelBytes());
+        break;
+      case SampleFormat::int16:
+        store(reinterpret_cast<std::int16_t *>(out), in,
+              SampleConvert::toInt16);
+        break;
+      case SampleFormat::half:
+        store(reinterpret_cast<SampleConvert::Half *>(out), in,
+              SampleConvert::toHalf);
+        break;
+      }
+    }
+  }
+
+  SampleFormat format() const noexcept { return format_; }
+  int numChannels() const noexcept { return numChannels_; }
+  int length() const noexcept { return length_; }
+  std::size_t sizeInBytes() const noexcept { return bytes_.size(); }
+
+  static std::size_t bytesPerSample(SampleFormat format) noexcept {
+    return format == SampleFormat::float32 ? sizeof(float)
+                                           : sizeof(std::int16_t);
+  }
+
+  View view() const noexcept {
+    if (bytes_.empty())
+      return {};
+    const std::byte *l = bytes_.data();
+    const std::byte *r = numChannels_ >= 2 ? l + channelBytes() : l;
+    return {format_, l, r, length_};
+  }
+
+private:
+  SampleFormat format_ = SampleFormat::float32;
+  int numChannels_ = 0;
+  int length_ = 0;
+  std::vector<std::byte> bytes_;
+
+  std::size_t channelBytes() const noexcept {
+    return static_cast<std::size_t>(length_) * bytesPerSample(format_);
+  }
+
+  template <typename T, typename Convert>
+  void store(T *out, const float *in, Convert convert) const noexcept {
+    for (int i = 0; i < length_; ++i)
+      out[i] = convert(in[i]);
+  }
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../ParamIDs.h"
+
+#include <cmath>
+
+/// ロード時にサンプルのどこからどこまでを持つかを決める解析
+/// （ヘッダオンリー）。SamplePlayer::decodeReader が読んだブロックに
+/// 対して使う。
+namespace SampleTrim {
+
+/// これ以下は無音とみなす（-60 dBFS）
+inline constexpr float kSilenceThreshold = 0.001f;
+
+/// 見つけた位置からこれだけ手前を開始位置にする（立ち上がりを削らない）
+inline constexpr double kPreRollSec = 0.001;
+
+/// Pitch 上限での再生速度（12 st ごとに 2 倍）
+inline constexpr double kMaxPlayRate = [] {
+  static_assert(static_cast<int>(ParamRanges::samplePitchMaxSt) % 12 == 0,
+                "Pitch の上限はオクターブ単位");
+  double rate = 1.0;
+  for (int st = 12; st <= static_cast<int>(ParamRanges::samplePitchMaxSt);
+       st += 12)
+    rate *= 2.0;
+  return rate;
+}();
+
+/// Decay の上限を Pitch の上限で再生したときに届くソース上の長さ。
+/// これより後ろは鳴らない
+inline constexpr double kMaxReachSec =
+    ParamRanges::sampleDecayMaxMs / 1000.0 * kMaxPlayRate;
+
+/// 切り詰め方
+struct Options {
+  bool skipSilence = true;            ///< 先頭の無音を削る
+  double maxLengthSec = kMaxReachSec; ///< 開始位置から持つ長さ（ソース秒）
+};
+
+/// 先頭 numFrames のうち、いずれかの ch の絶対値が threshold を超える
+/// 最初のフレーム。無ければ -1
+inline int firstAbove(const float *const *channels, int numChannels,
+                      int numFrames, float threshold) noexcept {
+  for (int i = 0; i < numFrames; ++i)
+    for (int ch = 0; ch < numChannels; ++ch)
+      if (std::abs(channels[ch][i]) > threshold)
+        return i;
+  return -1;
+}
+
+} // namespace SampleTrim
@@ -1,15 +1,23 @@
 #include "SubEngine.h"
 #include <cmath>
 
+std::size_t SubEngine::arenaBytes(int samplesPerBlock) noexcept {
+  return DspArena::bytesFor<float>(static_cast<std::size_t>(samplesPerBlock)) +
+         SubOscillator::arenaBytes();
+}
+
 void SubEngine::prepareToPlay(double sampleRate, int samplesPerBlock) {
-  osc_.prepareToPlay(sampleRate);
-  scratchBuffer_.resize(static_cast<size_t>(samplesPerBlock));
+  localArena_.reset(arenaBytes(samplesPerBlock));
+  prepareToPlay(sampleRate, samplesPerBlock, localArena_);
+}
+
+void SubEngine::prepareToPlay(double sampleRate, int samplesPerBlock,
+                              DspArena &arena) {
+  osc_.prepareToPlay(sampleRate, arena);
+  scratchBuffer_ = arena.take<float>(static_cast<size_t>(samplesPerBlock));
   noteTimeSamples_ = 0.0f;
   startOffset_ = 0;
-  envLut_.reset();
-  freqLut_.reset();
-  distLut_.reset();
-  mixLut_.reset();
+  luts_.reset();
 }
 
 void SubEngine::triggerNote(int sampleOffset) {
@@ -27,15 +35,16 @@ void SubEngine::render(juce::AudioBuffer<float> &buffer, int numSamples,
 
   const float gain = juce::Decibels::decibelsToGain(gainDb_.load());
   const int numChannels = buffer.getNumChannels();
-  const auto &ampLut = envLut_.getActiveLut();
-  const float ampDurMs = envLut_.getDurationMs();
-  const auto &pLut = freqLut_.getActiveLut();
-  const float freqDurMs = freqLut_.getDurationMs();
-  const auto &dLut = distLut_.getActiveLut();
-  const float distDurMs = distLut_.getDurationMs();
-  const auto &bLut = mixLut_.getActiveLut();
-  const float mixDurMs = mixLut_.getDurationMs();
+  const auto &luts = luts_.acquire();
+  const auto &ampLut = luts[kAmpLut];
+  const auto &pLut = luts[kFreqLut];
+  const auto &dLut = luts[kDistLut];
+  const auto &bLut = luts[kMixLut];
   const auto sr = static_cast<float>(sampleRate);
+  int ampCursor = -1;
+  int freqCursor = -1;
+  int distCursor = -1;
+  int mixCursor = -1;
 
   const float lengthMs = lengthMs_.load();
   constexpr float fadeOutMs = 5.0f;
@@ -65,46 +74,11 @@ void SubEngine::render(juce::AudioBuffer<float> &buffer, int numSamples,
       fadeGain = 0.5f * (1.0f + std::cos(t * juce::MathConstants<float>::pi));
     }
 
-    // Freq LUT → Hz
-    const float freqLutPos =
-        (freqDurMs > 0.0f)
-            ? (noteTimeMs / freqDurMs) *
-                  static_cast<float>(EnvelopeLutManager::lutSize - 1)
-            : 0.0f;
-    const auto freqLutIdx = std::min(static_cast<int>(freqLutPos),
-                                     EnvelopeLutManager::lutSize - 1);
-    const float freqHz = pLut[static_cast<size_t>(freqLutIdx)];
-    osc_.setFrequencyHz(freqHz);
-
-    // Saturate LUT → drive01
-    const float distLutPos =
-        (distDurMs > 0.0f)
-            ? (noteTimeMs / distDurMs) *
-                  static_cast<float>(EnvelopeLutManager::lutSize - 1)
-            : 0.0f;
-    const auto distLutIdx =
-        std::min(static_cast<int>(distLutPos), EnvelopeLutManager::lutSize - 1);
-    osc_.setDist(dLut[static_cast<size_t>(distLutIdx)]);
-
-    // Mix LUT → mix
-    const float mixLutPos =
-        (mixDurMs > 0.0f)
-            ? (noteTimeMs / mixDurMs) *
-                  static_cast<float>(EnvelopeLutManager::lutSize - 1)
-            : 0.0f;
-    const auto mixLutIdx =
-        std::min(static_cast<int>(mixLutPos), EnvelopeLutManager::lutSize - 1);
-    osc_.setMix(bLut[static_cast<size_t>(mixLutIdx)]);
-
-    // Gain LUT → エンベロープゲイン
-    const float lutPos =
-        (ampDurMs > 0.0f)
-            ? (noteTimeMs / ampDurMs) *
-                  static_cast<float>(EnvelopeLutManager::lutSize - 1)
-            : 0.0f;
-    const auto lutIndex =
-        std::min(static_cast<int>(lutPos), EnvelopeLutManager::lutSize - 1);
-    const float envGain = ampLut[static_cast<size_t>(lutIndex)];
+    // 各 LUT を線形補間で読む（カーソルはブロック内で単調に進む）
+    osc_.setFrequencyHz(pLut.evaluateMs(noteTimeMs, freqCursor));
+    osc_.setDist(dLut.evaluateMs(noteTimeMs, distCursor));
+    osc_.setMix(bLut.evaluateMs(noteTimeMs, mixCursor));
+    const float envGain = ampLut.evaluateMs(noteTimeMs, ampCursor);
 
     const float oscSample = osc_.getNextSample() * gain * envGain * fadeGain;
     scratchBuffer_[static_cast<size_t>(sample)] = oscSample;
@@ -1,10 +1,12 @@
 #pragma once
 
+#include "DspArena.h"
 #include "EnvelopeLutManager.h"
 #include "SubOscillator.h"
 #include <atomic>
+#include <cstddef>
 #include <juce_audio_basics/juce_audio_basics.h>
-#include <vector>
+#include <span>
 
 /// Sub チャンネルの DSP を一括管理するエンジン。
 /// PluginProcessor から renderSub / 関連フィールドを分離し、
@@ -12,6 +14,13 @@
 class SubEngine {
 public:
   // ── lifecycle ──
+  /// prepareToPlay(..., arena) が切り出すバイト数
+  static std::size_t arenaBytes(int samplesPerBlock) noexcept;
+
+  /// スクラッチと OSC テーブルを arena から切り出して初期化する。
+  void prepareToPlay(double sampleRate, int samplesPerBlock, DspArena &arena);
+
+  /// 単体利用（テスト等）: 自前のアリーナで prepareToPlay する。
   void prepareToPlay(double sampleRate, int samplesPerBlock);
 
   /// MIDI NoteOn / トランジェント検出時のトリガー
@@ -28,26 +37,30 @@ public:
   void setLengthMs(float ms) { lengthMs_.store(ms); }
 
   // ── 委譲先アクセサ ──
-  EnvelopeLutManager &envLut() noexcept { return envLut_; }
-  EnvelopeLutManager &freqLut() noexcept { return freqLut_; }
-  EnvelopeLutManager &distLut() noexcept { return distLut_; }
-  EnvelopeLutManager &mixLut() noexcept { return mixLut_; }
+  /// Amp / Freq / Dist / Mix の 4 本を 1 組として公開する LUT バンク。
+  /// 複数本を変えるときは luts().update() の中でまとめて焼くこと。
+  enum LutSlot : std::size_t { kAmpLut, kFreqLut, kDistLut, kMixLut, kNumLuts };
+  using LutBank = EnvelopeLutManager::Bank<kNumLuts>;
+  LutBank &luts() noexcept { return luts_; }
   SubOscillator &oscillator() noexcept { return osc_; }
 
+  /// 発音中（トリガー待ちを含む）かどうか（アイドル判定用）
+  bool isActive() const noexcept { return osc_.isActive(); }
+
   /// レベル計測用 scratchBuffer の先頭ポインタ
   const float *scratchData() const noexcept { return scratchBuffer_.data(); }
 
 private:
-  SubOscillator osc_;
-  EnvelopeLutManager envLut_;
-  EnvelopeLutManager freqLut_;
-  EnvelopeLutManager distLut_;
-  EnvelopeLutManager mixLut_;
-
-  std::vector<float> scratchBuffer_;
+  // ── オーディオスレッドが書く再生状態 ──
   float noteTimeSamples_{0.0f};
   int startOffset_{0};
+  std::span<float> scratchBuffer_; ///< DspArena 上
+  SubOscillator osc_;
+  LutBank luts_;
 
-  std::atomic<float> gainDb_{0.0f};
+  // ── UI スレッドが書くパラメータ（再生状態とはキャッシュラインを分ける）──
+  alignas(kCacheLineSize) std::atomic<float> gainDb_{0.0f};
   std::atomic<float> lengthMs_{300.0f};
+
+  DspArena localArena_; ///< 単体利用時のみ使う
 };
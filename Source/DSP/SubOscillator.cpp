@@ -14,15 +14,25 @@ static constexpr std::array<float, SubOscillator::numBands + 1> bandEdges = {
 // ────────────────────────────────────────────────────
 // prepareToPlay
 // ────────────────────────────────────────────────────
-void SubOscillator::prepareToPlay(double newSampleRate) {
+std::size_t SubOscillator::arenaBytes() noexcept {
+  return static_cast<std::size_t>(numShapes * numBands) *
+         DspArena::bytesFor<float>(static_cast<std::size_t>(tableSize + 1));
+}
+
+void SubOscillator::prepareToPlay(double newSampleRate, DspArena &arena) {
   sampleRate = newSampleRate;
   currentIndex = 0.0f;
-  buildAllTables();
+  buildAllTables(arena);
   // デフォルトポインタを Sine band-0 に設定
   activeSineTable = tables[0][0].data();
   activeShapeTable = activeSineTable;
 }
 
+void SubOscillator::prepareToPlay(double newSampleRate) {
+  localArena_.reset(arenaBytes());
+  prepareToPlay(newSampleRate, localArena_);
+}
+
 // ── 各波形の1サンプル計算ヘルパー（file-scope static） ──
 
 static double computeTriSample(double phase, int maxHarmonic) {
@@ -54,7 +64,7 @@ static double computeSawSample(double phase, int maxHarmonic) {
 }
 
 /// 1波形 × 1帯域のテーブルを埋める
-static void buildShapeBandTable(std::vector<float> &tbl, WaveShape ws,
+static void buildShapeBandTable(std::span<float> tbl, WaveShape ws,
                                 int maxHarmonic) {
   constexpr auto twoPi = juce::MathConstants<double>::twoPi;
   for (int i = 0; i < SubOscillator::tableSize; ++i) {
@@ -83,14 +93,14 @@ static void buildShapeBandTable(std::vector<float> &tbl, WaveShape ws,
 // ────────────────────────────────────────────────────
 // buildAllTables — 4波形 × 10帯域を事前計算
 // ────────────────────────────────────────────────────
-void SubOscillator::buildAllTables() {
+void SubOscillator::buildAllTables(DspArena &arena) {
   const auto nyquist = static_cast<float>(sampleRate * 0.5);
 
   for (int shape = 0; shape < numShapes; ++shape) {
     const auto ws = static_cast<WaveShape>(shape);
     for (int band = 0; band < numBands; ++band) {
       auto &tbl = tables[static_cast<size_t>(shape)][static_cast<size_t>(band)];
-      tbl.assign(static_cast<size_t>(tableSize + 1), 0.0f);
+      tbl = arena.take<float>(static_cast<size_t>(tableSize + 1));
 
       const float bandTop = bandEdges[static_cast<size_t>(band + 1)];
       const int maxHarmonic =
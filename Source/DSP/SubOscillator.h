@@ -1,8 +1,9 @@
 #pragma once
 
+#include "DspArena.h"
 #include <array>
 #include <atomic>
-#include <vector>
+#include <span>
 
 /// 波形選択 enum（Sine / Tri / Square / Saw）
 enum class WaveShape { Sine = 0, Tri = 1, Square = 2, Saw = 3 };
@@ -16,7 +17,14 @@ public:
   SubOscillator() = default;
   ~SubOscillator() = default;
 
-  /// processBlock 前に呼び出し（サンプルレート設定 + 全テーブル構築）
+  /// prepareToPlay(sampleRate, arena) が切り出すバイト数
+  static std::size_t arenaBytes() noexcept;
+
+  /// processBlock 前に呼び出し（サンプルレート設定 + 全テーブル構築）。
+  /// テーブルは arena から切り出す。
+  void prepareToPlay(double sampleRate, DspArena &arena);
+
+  /// 単体利用（テスト等）: 自前のアリーナで prepareToPlay する。
   void prepareToPlay(double sampleRate);
 
   /// 発音開始（トリガーのみ、ピッチは setFrequencyHz で制御）
@@ -62,8 +70,8 @@ public:
   static constexpr int numShapes = 4; // Sine / Tri / Square / Saw
 
 private:
-  /// [shape][band] → tableSize+1 要素（wrap用に +1）
-  std::array<std::array<std::vector<float>, numBands>, numShapes> tables;
+  /// [shape][band] → tableSize+1 要素（wrap用に +1、DspArena 上）
+  std::array<std::array<std::span<float>, numBands>, numShapes> tables;
 
   // ── 再生状態 ──
   bool active = false;
@@ -76,15 +84,11 @@ private:
   /// setFrequencyHz() が算出した帯域テーブルへのポインタ（選択波形用）
   const float *activeShapeTable = nullptr;
 
-  std::atomic<int> currentShape{0}; // WaveShape の int 値
   int activeBand = 0;
 
-  // ── Mix ──
-  std::atomic<float> mix_{0.0f}; // -1.0〜+1.0
-
-  // ── Saturate ──
+  // ── Mix / Saturate（SubEngine がオーディオスレッドから毎サンプル更新）──
+  std::atomic<float> mix_{0.0f};  // -1.0〜+1.0
   std::atomic<float> dist_{0.0f}; // 0.0〜1.0（UI値そのまま）
-  std::atomic<int> clipType_{0};  // 0=Soft, 1=Hard, 2=Tube
 
   // ── Tone1〜Tone4 加算合成 ──
   static constexpr int numHarmonics = 4;
@@ -92,11 +96,17 @@ private:
     float phase = 0.0f;
   };
   std::array<HarmonicOsc, numHarmonics> harmonics{};
+
+  // ── UI スレッドが書くパラメータ（上の再生状態とはキャッシュラインを分ける）──
+  alignas(kCacheLineSize) std::atomic<int> currentShape{0}; // WaveShape の値
+  std::atomic<int> clipType_{0}; // 0=Soft, 1=Hard, 2=Tube
   std::array<std::atomic<float>, numHarmonics> harmonicGains{0.0f, 0.0f, 0.0f,
                                                              0.0f};
 
+  DspArena localArena_; ///< 単体利用時のみ使う
+
   // ── テーブル構築 ──
-  void buildAllTables();
+  void buildAllTables(DspArena &arena);
   static int bandIndexForFreq(float hz);
 
   /// テーブルから線形補間で1サンプル読み出す
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "OnsetFilterbank.h"
+#include <array>
 #include <atomic>
 #include <cmath>
 #include <span>
@@ -14,19 +16,63 @@
 ///   3. onset = envFast − envSlow  が threshold を超えたら TRIGGER
 ///   4. ヒステリシス: onset が threshold×30% を下回ったら再アーム
 ///   5. Hold time（デフォルト 50ms）で多重発火防止
+///   6. 立ち上がり開始（onset がヒステリシス水準を超えた点）から検出までの
+///      遅れを Onset::lag に記録（ルックアヘッド時の位置補正用）
+///
+/// 検出帯域（setBand）: Full はフル レートの全帯域。Low / Mid は
+/// OnsetFilterbank で分割した帯域を 1/8 レートで検出する（他楽器の
+/// かぶりによる誤検出を避けつつ、1 サンプルあたりの処理も軽い）。
+///
+/// 1 ブロック内の全オンセットを固定容量の Onsets へ追記する（ヒープ確保なし）。
 class TransientDetector {
 public:
+  /// 検出した 1 オンセット
+  struct Onset {
+    int position; ///< ブロック先頭からのサンプル位置
+    int lag;      ///< 立ち上がり開始から検出までの遅れ（サンプル）
+  };
+
+  /// オンセットの固定容量バッファ（満杯時は以降を破棄）
+  class Onsets {
+  public:
+    static constexpr int kCapacity = 16;
+
+    void clear() noexcept { size_ = 0; }
+    void push(Onset o) noexcept {
+      if (size_ < kCapacity)
+        items_[static_cast<std::size_t>(size_++)] = o;
+    }
+    int size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    const Onset &operator[](int i) const noexcept {
+      return items_[static_cast<std::size_t>(i)];
+    }
+    const Onset *begin() const noexcept { return items_.data(); }
+    const Onset *end() const noexcept { return items_.data() + size_; }
+
+  private:
+    std::array<Onset, kCapacity> items_{};
+    int size_ = 0;
+  };
+
+  /// 検出帯域（APVTS Choice と同順）
+  enum class Band { full = 0, low, mid };
+
   /// オーディオスレッド開始前に呼ぶ
   void prepare(double sampleRate) noexcept {
     sr_ = sampleRate;
+    filterbank_.prepare(sampleRate);
+    activeBand_ = band_.load();
     updateCoeffs();
     reset();
   }
 
   void reset() noexcept {
+    filterbank_.reset();
     envFast_ = 0.0f;
     envSlow_ = 0.0f;
     holdCounter_ = 0;
+    riseSamples_ = 0;
     armed_ = true;
   }
 
@@ -40,56 +86,98 @@ public:
     holdSamples_ = static_cast<int>(ms * 0.001f * static_cast<float>(sr_));
   }
 
+  /// 検出帯域を設定（UI スレッドから。反映は次の process() 先頭）
+  void setBand(Band b) noexcept { band_.store(b); }
+  Band getBand() const noexcept { return band_.load(); }
+
   /// 有効／無効
   void setEnabled(bool on) noexcept { enabled_.store(on); }
   bool isEnabled() const noexcept { return enabled_.load(); }
 
-  /// 1 ブロック分を解析し、トランジェントのサンプル位置を返す。
+  /// 両エンベロープが減衰しきり hold も明けているか。
+  /// true の間は無音ブロックの process() を省略しても検出結果が変わらない。
+  bool isSettled() const noexcept {
+    return envFast_ < kSettledLevel && envSlow_ < kSettledLevel &&
+           holdCounter_ <= 0;
+  }
+
+  /// 1 ブロック分を解析し、検出した全オンセットを out へ追記する。
   /// @param input  モノ入力（呼び出し側でステレオから合成しておく）
-  /// @return 検出位置（0〜N-1）。未検出時は -1。
-  int process(std::span<const float> input) noexcept {
+  /// @param out    追記先（clear は呼び出し側の責任）
+  void process(std::span<const float> input, Onsets &out) noexcept {
     if (!enabled_.load())
-      return -1;
-
-    int triggerPos = -1;
-    int idx = 0;
-
-    for (const float x_raw : input) {
-      const float x = std::abs(x_raw);
+      return;
 
-      // ── Fast envelope（attack 0.2ms / release 10ms） ──
-      const float cfA = (x > envFast_) ? attackFast_ : releaseFast_;
-      envFast_ += cfA * (x - envFast_);
-
-      // ── Slow envelope（attack 10ms / release 200ms） ──
-      const float csA = (x > envSlow_) ? attackSlow_ : releaseSlow_;
-      envSlow_ += csA * (x - envSlow_);
-
-      // ── onset = 差分 ──
-      const float onset = envFast_ - envSlow_;
-
-      if (onset > threshLin_ && armed_ && holdCounter_ <= 0) {
-        triggerPos = idx;
-        armed_ = false;
-        holdCounter_ = holdSamples_;
-      }
-
-      // ヒステリシス: onset が閾値の 30% 以下まで落ちたら再アーム
-      if (onset < threshLin_ * kHysteresisRatio)
-        armed_ = true;
+    // 帯域切り替え: 検出レートが変わるため係数と状態を作り直す
+    if (const auto band = band_.load(); band != activeBand_) {
+      activeBand_ = band;
+      updateCoeffs();
+      reset();
+    }
 
-      if (holdCounter_ > 0)
-        --holdCounter_;
+    int idx = 0;
+    if (activeBand_ == Band::full) {
+      for (const float x : input)
+        detectStep(std::abs(x), idx++, 1, out);
+      return;
+    }
 
+    const auto fbBand = activeBand_ == Band::low ? OnsetFilterbank::Band::low
+                                                 : OnsetFilterbank::Band::mid;
+    float frame = 0.0f;
+    for (const float x : input) {
+      if (filterbank_.push(x, fbBand, frame))
+        detectStep(std::abs(frame), idx, OnsetFilterbank::kDecimation, out);
       ++idx;
     }
+  }
 
-    return triggerPos;
+  /// 簡易版: 最初のオンセット位置のみ返す。未検出時は -1。
+  int process(std::span<const float> input) noexcept {
+    Onsets onsets;
+    process(input, onsets);
+    return onsets.empty() ? -1 : onsets[0].position;
   }
 
 private:
+  /// 検出レートでの 1 ステップ。step = 1 ステップあたりの入力サンプル数。
+  void detectStep(float x, int idx, int step, Onsets &out) noexcept {
+    // ── Fast envelope（attack 0.2ms / release 10ms） ──
+    const float cfA = (x > envFast_) ? attackFast_ : releaseFast_;
+    envFast_ += cfA * (x - envFast_);
+
+    // ── Slow envelope（attack 10ms / release 200ms） ──
+    const float csA = (x > envSlow_) ? attackSlow_ : releaseSlow_;
+    envSlow_ += csA * (x - envSlow_);
+
+    // ── onset = 差分 ──
+    const float onset = envFast_ - envSlow_;
+
+    // 立ち上がり開始からの経過サンプル（ヒステリシス水準未満で 0 に戻す）
+    if (onset < threshLin_ * kHysteresisRatio)
+      riseSamples_ = 0;
+    else if (riseSamples_ < kMaxRiseSamples)
+      riseSamples_ += step;
+
+    if (onset > threshLin_ && armed_ && holdCounter_ <= 0) {
+      out.push({idx, riseSamples_ - step});
+      armed_ = false;
+      holdCounter_ = holdSamples_;
+    }
+
+    // ヒステリシス: onset が閾値の 30% 以下まで落ちたら再アーム
+    if (onset < threshLin_ * kHysteresisRatio)
+      armed_ = true;
+
+    if (holdCounter_ > 0)
+      holdCounter_ -= step;
+  }
+
   void updateCoeffs() noexcept {
-    const auto fs = static_cast<float>(sr_);
+    // 帯域検出は間引き後のレートでエンベロープを回す
+    const int decim =
+        activeBand_ == Band::full ? 1 : OnsetFilterbank::kDecimation;
+    const auto fs = static_cast<float>(sr_) / static_cast<float>(decim);
     // alpha = 1 − exp(−1 / (tau × fs))
     attackFast_ = 1.0f - std::exp(-1.0f / (0.0002f * fs)); // 0.2ms
     releaseFast_ = 1.0f - std::exp(-1.0f / (0.010f * fs)); // 10ms
@@ -98,6 +186,8 @@ private:
   }
 
   static constexpr float kHysteresisRatio = 0.3f;
+  static constexpr float kSettledLevel = 1.0e-5f; ///< -100 dBFS
+  static constexpr int kMaxRiseSamples = 1 << 20;
 
   double sr_ = 44100.0;
   float envFast_ = 0.0f;
@@ -109,6 +199,10 @@ private:
   float threshLin_ = 0.063f; // ≈ −24 dBFS
   int holdSamples_ = 2205;   // ≈ 50ms @ 44.1kHz
   int holdCounter_ = 0;
+  int riseSamples_ = 0;
   bool armed_ = true;
   std::atomic<bool> enabled_{false};
+  std::atomic<Band> band_{Band::full};
+  Band activeBand_ = Band::full; ///< オーディオスレッドで適用中の帯域
+  OnsetFilterbank filterbank_;
 };
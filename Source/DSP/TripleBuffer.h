@@ -0,0 +1,76 @@
+#pragma once
+
+#include "CacheLine.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/// 書き手 1 スレッド・読み手 1 スレッドのロックフリー トリプルバッファ
+/// （ヘッダオンリー）。
+///
+/// 3 面のうち書き手（back）と読み手（front）が 1 面ずつ専有し、残りの
+/// 1 面（middle）をアトミック交換で受け渡す。
+///   - 書き手は back() に 1 組ぶんを書き終えてから publish() する
+///   - 読み手は acquire() で最新の公開面を取り込み、次の acquire() まで
+///     その面を読み続ける（連続で publish されても入れ替わるのは middle
+///     だけなので、参照中の面が書き換えられることはない）
+/// どちらの側も待たない。オーディオスレッドではブロック先頭で 1 回だけ
+/// acquire() し、ブロック内は同じスナップショットを使う。
+/// 各面と書き手 / 読み手のインデックスは別キャッシュラインに置く。
+template <typename T> class TripleBuffer {
+public:
+  TripleBuffer() = default;
+  explicit TripleBuffer(const T &initial) { reset(initial); }
+
+  /// 書き手専用: 次に公開する面（直前の公開値が入っているとは限らない）
+  T &back() noexcept {
+    return buffers_[static_cast<std::size_t>(back_)].value;
+  }
+
+  /// 書き手専用: back() を公開する
+  void publish() noexcept {
+    back_ = middle_.exchange(back_ | kFreshBit, std::memory_order_acq_rel) &
+            kIndexMask;
+  }
+
+  /// 書き手専用: value を back() へコピーして公開する
+  void publish(const T &value) {
+    back() = value;
+    publish();
+  }
+
+  /// 読み手専用: 新しい公開があれば取り込み、最新の面を返す
+  const T &acquire() noexcept {
+    if ((middle_.load(std::memory_order_relaxed) & kFreshBit) != 0)
+      front_ =
+          middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+    return buffers_[static_cast<std::size_t>(front_)].value;
+  }
+
+  /// 読み手専用: 直近の acquire() で取り込んだ面
+  const T &current() const noexcept {
+    return buffers_[static_cast<std::size_t>(front_)].value;
+  }
+
+  /// 全面を value で初期化する（読み書きが止まっているときだけ呼ぶこと）
+  void reset(const T &value) {
+    for (auto &b : buffers_)
+      b.value = value;
+    back_ = 0;
+    front_ = 1;
+    middle_.store(2);
+  }
+
+private:
+  static constexpr int kFreshBit = 4;
+  static constexpr int kIndexMask = 3;
+
+  struct alignas(kCacheLineSize) Slot {
+    T value{};
+  };
+
+  std::array<Slot, 3> buffers_{};
+  alignas(kCacheLineSize) int back_ = 0; ///< 書き手専用
+  alignas(kCacheLineSize) std::atomic<int> middle_{2};
+  alignas(kCacheLineSize) int front_ = 1; ///< 読み手専用
+};
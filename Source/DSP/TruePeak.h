@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+
+/// 4× オーバーサンプリング True Peak 推定（ITU-R BS.1770 方式）
+/// ヘッダオンリー。MeterEngine（レーン並列）と BrickwallLimiter
+/// （スカラー）で同じ係数を共有する。
+namespace TruePeak {
+
+inline constexpr int kPhases = 4;
+inline constexpr int kTaps = 12; ///< 1 位相あたりのタップ数（計 48 タップ）
+/// FIR の群遅延（元レートのサンプル数、切り上げ）
+inline constexpr int kGroupDelay = kTaps / 2;
+
+/// [位相][タップ]。履歴が新しい順に並ぶ前提で逆順に格納済み。
+using Coeffs = std::array<std::array<float, kTaps>, kPhases>;
+
+/// 4× 補間用ローパス（Blackman 窓付き sinc）をポリフェーズ分解。
+/// 各位相の DC ゲインを 1 に正規化する。
+inline Coeffs designCoeffs() noexcept {
+  constexpr int kLen = kPhases * kTaps;
+  constexpr double kCutoff = 0.9; ///< 元レートのナイキストに対する比
+  constexpr double centre = (kLen - 1) * 0.5;
+  Coeffs out{};
+  for (int p = 0; p < kPhases; ++p) {
+    std::array<double, kTaps> taps{};
+    double sum = 0.0;
+    for (int k = 0; k < kTaps; ++k) {
+      const int n = p + k * kPhases;
+      const double t = (n - centre) / kPhases * kCutoff;
+      const double sinc =
+          t == 0.0 ? 1.0
+                   : std::sin(std::numbers::pi * t) / (std::numbers::pi * t);
+      const double w =
+          0.42 - 0.5 * std::cos(2.0 * std::numbers::pi * n / (kLen - 1)) +
+          0.08 * std::cos(4.0 * std::numbers::pi * n / (kLen - 1));
+      taps[static_cast<std::size_t>(k)] = sinc * w;
+      sum += sinc * w;
+    }
+    for (int k = 0; k < kTaps; ++k)
+      out[static_cast<std::size_t>(p)]
+         [static_cast<std::size_t>(kTaps - 1 - k)] =
+             static_cast<float>(taps[static_cast<std::size_t>(k)] / sum);
+  }
+  return out;
+}
+
+/// 1 チャンネル分のスカラー推定器。
+/// push() は kGroupDelay サンプル前後の区間の補間ピーク（絶対値）を返す。
+class Estimator {
+public:
+  void prepare() noexcept {
+    coeffs_ = designCoeffs();
+    reset();
+  }
+
+  void reset() noexcept {
+    hist_.fill(0.0f);
+    pos_ = 0;
+  }
+
+  float push(float x) noexcept {
+    pos_ = pos_ == 0 ? kTaps - 1 : pos_ - 1;
+    hist_[static_cast<std::size_t>(pos_)] = x;
+    hist_[static_cast<std::size_t>(pos_ + kTaps)] = x;
+    const float *h = hist_.data() + pos_;
+    float peak = 0.0f;
+    for (const auto &c : coeffs_) {
+      float acc = 0.0f;
+      for (std::size_t k = 0; k < kTaps; ++k)
+        acc += c[k] * h[k];
+      peak = std::max(peak, std::abs(acc));
+    }
+    return peak;
+  }
+
+private:
+  Coeffs coeffs_{};
+  std::array<float, 2 * kTaps> hist_{}; ///< 二重化リング（新しい順に読む）
+  int pos_ = 0;
+};
+
+} // namespace TruePeak
@@ -0,0 +1,101 @@
+#include "FactoryPresets.h"
+#include "BinaryData.h"
+#include "StateCodec.h"
+
+#include <array>
+
+namespace {
+constexpr const char *kClickSampleFile = "click_sample.wav";
+constexpr const char *kDirectSampleFile = "direct_sample.wav";
+
+// 追加するときは名前順を保つこと
+const std::array<FactoryPresets::Preset, 3> kPresets = {{
+    {"default",      BinaryData::default_state_xml,
+     BinaryData::default_state_xmlSize},
+    {"junglist",     BinaryData::junglist_state_xml,
+     BinaryData::junglist_state_xmlSize,
+     nullptr, 0,
+     BinaryData::junglist_direct_wav, BinaryData::junglist_direct_wavSize},
+    {"sub osc only", BinaryData::sub_osc_only_state_xml,
+     BinaryData::sub_osc_only_state_xmlSize},
+}};
+} // namespace
+
+namespace FactoryPresets {
+
+std::span<const Preset> all() noexcept { return kPresets; }
+
+const Preset *find(const juce::String &name) noexcept {
+  for (const auto &p : kPresets)
+    if (name == p.name)
+      return &p;
+  return nullptr;
+}
+
+juce::ValueTree readState(const Preset &preset) {
+  const auto xml = juce::XmlDocument::parse(juce::String::fromUTF8(
+      preset.stateData, preset.stateSize));
+  if (!xml)
+    return {};
+
+  auto state = juce::ValueTree::fromXml(*xml);
+  if (!state.isValid())
+    return {};
+
+  // ./click_sample.wav → factory:<name>/click_sample.wav
+  for (const auto *prop : StateCodec::kSamplePathProps) {
+    if (const auto path = state.getProperty(prop).toString();
+        path.startsWith("./"))
+      state.setProperty(prop,
+                        kSampleScheme + juce::String(preset.name) + "/" +
+                            path.substring(2),
+                        nullptr);
+  }
+  return state;
+}
+
+bool isSampleRef(const juce::String &ref) noexcept {
+  return ref.startsWith(kSampleScheme);
+}
+
+juce::String fromLegacyPath(const juce::String &path) {
+  // 保存した OS に依らず読めるよう、区切りは / と \ の両方を見る
+  const auto parts =
+      juce::StringArray::fromTokens(path.replaceCharacter('\\', '/'), "/",
+                                    "");
+  const int n = parts.size();
+  if (n < 3 || parts[n - 3] != "Factory" ||
+      !parts[n - 2].endsWithIgnoreCase(".bbpreset"))
+    return {};
+  const auto ref = kSampleScheme +
+                   parts[n - 2].dropLastCharacters(
+                       juce::String(".bbpreset").length()) +
+                   "/" + parts[n - 1];
+  return openSample(ref) != nullptr ? ref : juce::String{};
+}
+
+std::unique_ptr<juce::InputStream> openSample(const juce::String &ref) {
+  if (!isSampleRef(ref))
+    return nullptr;
+  const auto body = ref.substring(juce::String(kSampleScheme).length());
+  const auto *preset = find(body.upToLastOccurrenceOf("/", false, false));
+  if (preset == nullptr)
+    return nullptr;
+
+  const auto fileName = body.fromLastOccurrenceOf("/", false, false);
+  const char *data = nullptr;
+  int size = 0;
+  if (fileName == kClickSampleFile) {
+    data = preset->clickData;
+    size = preset->clickSize;
+  } else if (fileName == kDirectSampleFile) {
+    data = preset->directData;
+    size = preset->directSize;
+  }
+  if (data == nullptr)
+    return nullptr;
+  return std::make_unique<juce::MemoryInputStream>(
+      data, static_cast<size_t>(size), false);
+}
+
+} // namespace FactoryPresets
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_data_structures/juce_data_structures.h>
+
+#include <memory>
+#include <span>
+
+/// BinaryData に埋め込んだ Factory プリセット。
+///
+/// ディスクへ展開せず、state.xml はメモリから直接解析し、サンプルは
+/// MemoryInputStream で読む（インスタンス生成時にディスク I/O をしない）。
+/// 埋め込みサンプルは state 上で "factory:<プリセット名>/<ファイル名>"
+/// という参照で表す。
+namespace FactoryPresets {
+
+inline constexpr const char *kSampleScheme = "factory:";
+
+struct Preset {
+  const char *name;
+  const char *stateData;
+  int stateSize;
+  // サンプル付きプリセット用
+  const char *clickData = nullptr;
+  int clickSize = 0;
+  const char *directData = nullptr;
+  int directSize = 0;
+};
+
+/// 全 Factory プリセット（名前順）
+std::span<const Preset> all() noexcept;
+
+/// name の Factory プリセット（無ければ nullptr）
+const Preset *find(const juce::String &name) noexcept;
+
+/// preset の state を解析し、./ 始まりのサンプルパスを埋め込みサンプルへの
+/// 参照に置き換えて返す（解析できなければ無効な ValueTree）
+juce::ValueTree readState(const Preset &preset);
+
+/// ref が埋め込みサンプルへの参照なら true（中身の有無は問わない）
+bool isSampleRef(const juce::String &ref) noexcept;
+
+/// 旧版がディスクへ展開していた Factory サンプルのパス
+/// （…/Presets/Factory/<プリセット名>.bbpreset/<ファイル名>）を、対応する
+/// 埋め込みサンプルの参照に読み替える。該当しなければ空。
+juce::String fromLegacyPath(const juce::String &path);
+
+/// 埋め込みサンプルを読むストリーム（参照先が無ければ nullptr）
+std::unique_ptr<juce::InputStream> openSample(const juce::String &ref);
+
+} // namespace FactoryPresets
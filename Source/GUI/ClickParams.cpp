@@ -3,6 +3,8 @@
 #include "../DSP/Saturator.h"
 #include "../ParamIDs.h"
 #include "../PluginEditor.h"
+#include "../SampleRef.h"
+#include "../StateCodec.h"
 #include "ClickModeStateUtils.h"
 #include "InfoBoxText.h"
 #include "LutBaker.h"
@@ -124,7 +126,7 @@ void BoomBabyAudioProcessorEditor::setupClickParams() {
     processorRef.clickEngine().setBpf1Slope(dboct);
     syncParam(ParamIDs::clickBpf1Slope,
               static_cast<float>(slopeToIndex(dboct)));
-    envelopeCurveEditor.repaint();
+    envelopeCurveEditor.invalidatePreviews();
   });
   styleKnobLabel(clickUI.noise.bpf1.qLabel, "Q", tinyFont);
   // ClipTypeセレクターはノブ上部ラベルを兼ねるため別途KnobLabel設定不要
@@ -189,7 +191,7 @@ void BoomBabyAudioProcessorEditor::setupClickParams() {
         static_cast<float>(clickUI.noise.bpf1.freqSlider.getValue()));
     syncParam(ParamIDs::clickBpf1Freq,
               static_cast<float>(clickUI.noise.bpf1.freqSlider.getValue()));
-    envelopeCurveEditor.repaint();
+    envelopeCurveEditor.invalidatePreviews();
   };
   addAndMakeVisible(clickUI.noise.bpf1.freqSlider);
 
@@ -209,7 +211,7 @@ void BoomBabyAudioProcessorEditor::setupClickParams() {
         static_cast<float>(clickUI.noise.bpf1.qSlider.getValue()));
     syncParam(ParamIDs::clickBpf1Q,
               static_cast<float>(clickUI.noise.bpf1.qSlider.getValue()));
-    envelopeCurveEditor.repaint();
+    envelopeCurveEditor.invalidatePreviews();
   };
   addAndMakeVisible(clickUI.noise.bpf1.qSlider);
 
@@ -326,7 +328,8 @@ void BoomBabyAudioProcessorEditor::setupClickParams() {
   // ── Sample モード専用: Pitch / A / D / R ──
   // Pitch: -24 〜 +24 半音
   styleClickKnob(clickUI.sample.pitch.slider, clickKnobLAF);
-  clickUI.sample.pitch.slider.setRange(-24.0, 24.0, 1.0);
+  clickUI.sample.pitch.slider.setRange(-ParamRanges::samplePitchMaxSt,
+                                       ParamRanges::samplePitchMaxSt, 1.0);
   clickUI.sample.pitch.slider.setDoubleClickReturnValue(true, 0.0);
   clickUI.sample.pitch.slider.setValue(0.0, juce::dontSendNotification);
   clickUI.sample.pitch.slider.onDragStart = [this] {
@@ -369,7 +372,7 @@ void BoomBabyAudioProcessorEditor::setupClickParams() {
               static_cast<float>(clickUI.sample.amp.slider.getValue()), true);
     bakeLut(envDatas.clickAmp, processorRef.clickEngine().clickAmpLut(),
             static_cast<float>(clickUI.sample.decay.slider.getValue()));
-    envelopeCurveEditor.repaint();
+    envelopeCurveEditor.invalidatePreviews();
   };
   // 初期デフォルトポイント（1点：ノブ制御状態）
   envDatas.clickAmp.addPoint(0.0f, envDatas.clickAmp.getDefaultValue());
@@ -389,7 +392,8 @@ void BoomBabyAudioProcessorEditor::setupClickParams() {
   // Sample Decay: エンベロープ LUT の期間を制御（Noiseモードの Decay
   // とは完全別） 初期値 = Sub lengthのデフォルト 300 ms
   styleClickKnob(clickUI.sample.decay.slider, clickKnobLAF);
-  clickUI.sample.decay.slider.setRange(10.0, 2000.0, 1.0);
+  clickUI.sample.decay.slider.setRange(ParamRanges::sampleDecayMinMs,
+                                       ParamRanges::sampleDecayMaxMs, 1.0);
   clickUI.sample.decay.slider.setSkewFactorFromMidPoint(300.0);
   clickUI.sample.decay.slider.setDoubleClickReturnValue(true, 300.0);
   clickUI.sample.decay.slider.setValue(300.0, juce::dontSendNotification);
@@ -432,13 +436,13 @@ void BoomBabyAudioProcessorEditor::setupClickParams() {
   clickUI.sample.loadButton.setOnClear([this] {
     processorRef.clickEngine().sampler().unloadSample();
     clickUI.sample.loadedFilePath.clear();
-    clickUI.sample.thumbMin.clear();
-    clickUI.sample.thumbMax.clear();
+    clickUI.sample.peaks.reset();
     clickUI.sample.thumbDurSec = 0.0;
     clickUI.sample.loadButton.setButtonText("Drop or Click to Load");
     clickUI.sample.loadButton.setTooltip({});
     clickUI.sample.loadButton.setHasFile(false);
-    processorRef.getAPVTS().state.setProperty("clickSamplePath", "", nullptr);
+    StateCodec::setSamplePath(processorRef.getAPVTS().state, "clickSamplePath",
+                              {});
     envelopeCurveEditor.setClickPreviewProvider(nullptr);
   });
   addAndMakeVisible(clickUI.sample.loadButton);
@@ -653,16 +657,22 @@ void BoomBabyAudioProcessorEditor::applyClickMode(int modeId) {
 
 void BoomBabyAudioProcessorEditor::onClickSampleFileChosen(
     const juce::File &file) {
-  clickUI.sample.loadedFilePath = file.getFullPathName();
-  clickUI.sample.loadButton.setButtonText(file.getFileNameWithoutExtension());
+  onClickSampleRefChosen(file.getFullPathName());
+}
+
+void BoomBabyAudioProcessorEditor::onClickSampleRefChosen(
+    const juce::String &ref) {
+  clickUI.sample.loadedFilePath = ref;
+  clickUI.sample.loadButton.setButtonText(SampleRef::displayName(ref));
   clickUI.sample.loadButton.setTooltip(clickUI.sample.loadedFilePath);
   clickUI.sample.loadButton.setHasFile(true);
-  processorRef.getAPVTS().state.setProperty(
-      "clickSamplePath", clickUI.sample.loadedFilePath, nullptr);
-  processorRef.clickEngine().sampler().loadSample(file);
+  StateCodec::setSamplePath(processorRef.getAPVTS().state, "clickSamplePath",
+                            clickUI.sample.loadedFilePath);
+  // プリセット切り替えで同じサンプルが来た場合はデコードし直さない
+  SampleRef::loadInto(processorRef.clickEngine().sampler(), ref);
 
-  if (!processorRef.clickEngine().sampler().copyThumbnail(
-          clickUI.sample.thumbMin, clickUI.sample.thumbMax))
+  clickUI.sample.peaks = processorRef.clickEngine().sampler().peaks();
+  if (clickUI.sample.peaks == nullptr)
     return;
   clickUI.sample.thumbDurSec =
       processorRef.clickEngine().sampler().durationSec();
@@ -670,7 +680,7 @@ void BoomBabyAudioProcessorEditor::onClickSampleFileChosen(
 }
 
 void BoomBabyAudioProcessorEditor::refreshClickSampleProvider() {
-  if (clickUI.sample.thumbMin.empty() || clickUI.sample.thumbDurSec <= 0.0)
+  if (clickUI.sample.peaks == nullptr || clickUI.sample.thumbDurSec <= 0.0)
     return;
 
   const auto semitones =
@@ -684,14 +694,14 @@ void BoomBabyAudioProcessorEditor::refreshClickSampleProvider() {
   const auto driveDb =
       static_cast<float>(clickUI.noise.saturator.driveSlider.getValue());
   const int clipType = clickUI.noise.saturator.clipType.getSelected();
-  const std::size_t n = clickUI.sample.thumbMin.size();
+  const auto &thumb = clickUI.sample.peaks->level(
+      PeakPyramid::levelFor(WaveformUtils::kPreviewMinBins));
+  const std::size_t n = thumb.min.size();
   auto minPtr = std::make_shared<std::vector<float>>(n);
   auto maxPtr = std::make_shared<std::vector<float>>(n);
   for (std::size_t i = 0; i < n; ++i) {
-    (*minPtr)[i] =
-        Saturator::process(clickUI.sample.thumbMin[i], driveDb, clipType);
-    (*maxPtr)[i] =
-        Saturator::process(clickUI.sample.thumbMax[i], driveDb, clipType);
+    (*minPtr)[i] = Saturator::process(thumb.min[i], driveDb, clipType);
+    (*maxPtr)[i] = Saturator::process(thumb.max[i], driveDb, clipType);
   }
 
   // HPF / LPF を thumb データに適用（DSP: Saturator → HPF → LPF の順）
@@ -729,5 +739,5 @@ void BoomBabyAudioProcessorEditor::refreshClickSampleProvider() {
                                              static_cast<float>(durSec) + 1.0f,
                                              0.0f, timeSec);
       });
-  envelopeCurveEditor.repaint();
+  envelopeCurveEditor.invalidatePreviews();
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <span>
+
+namespace Polyline {
+
+/// anchor から見た点の方向と、その点の許容範囲が張る半幅
+struct Cone {
+  float dir = 0.0f;
+  float halfWidth = 0.0f;
+};
+
+/// 折れ線の頂点を 1 パスで間引く（コーン交差法、ヘッダオンリー）。
+///
+/// 確定済み頂点（anchor）から見て「各点の許容範囲が張る方向範囲」（コーン）
+/// の共通部分を保持し、次の点の方向がその範囲を外れたら直前の点を頂点として
+/// 確定する。間引いた点はすべて、確定した線分から各点の許容誤差以内に収まる。
+/// LUT のコンパイル（LutBaker.h、値方向の誤差）とカーブエディタの Path 描画
+/// （EnvelopeCurveEditor.cpp、線分からの距離）で共用する。
+///
+/// cone(anchor, p) は Cone を返す。wrap > 0 なら方向を角度とみなし、
+/// 比較時に ±wrap/2 へ折り返す。始点と終点を含む残す点を順に emit へ渡す。
+template <typename Point, typename ConeFn, typename Emit>
+void simplify(std::span<const Point> pts, const ConeFn &cone, Emit &&emit,
+              float wrap = 0.0f) {
+  if (pts.empty())
+    return;
+  emit(pts[0]);
+
+  std::size_t anchor = 0;
+  std::size_t i = 1;
+  while (i < pts.size()) {
+    const Cone first = cone(pts[anchor], pts[i]);
+    float lo = -first.halfWidth;
+    float hi = first.halfWidth;
+    for (++i; i < pts.size(); ++i) {
+      const Cone c = cone(pts[anchor], pts[i]);
+      float d = c.dir - first.dir;
+      if (wrap > 0.0f)
+        d = std::remainder(d, wrap);
+      if (d < lo || d > hi)
+        break;
+      lo = std::max(lo, d - c.halfWidth);
+      hi = std::min(hi, d + c.halfWidth);
+    }
+    anchor = i - 1;
+    emit(pts[anchor]);
+  }
+}
+
+} // namespace Polyline
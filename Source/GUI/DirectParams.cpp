@@ -3,6 +3,8 @@
 #include "../DSP/Saturator.h"
 #include "../ParamIDs.h"
 #include "../PluginEditor.h"
+#include "../SampleRef.h"
+#include "../StateCodec.h"
 #include "InfoBoxText.h"
 #include "LutBaker.h"
 #include "SampleChooserUtils.h"
@@ -69,13 +71,13 @@ void BoomBabyAudioProcessorEditor::setupDirectParams() {
   directUI.sample.loadButton.setOnClear([this] {
     processorRef.directEngine().sampler().unloadSample();
     directUI.sample.loadedFilePath.clear();
-    directUI.sample.thumbMin.clear();
-    directUI.sample.thumbMax.clear();
+    directUI.sample.peaks.reset();
     directUI.sample.thumbDurSec = 0.0;
     directUI.sample.loadButton.setButtonText("Drop or Click to Load");
     directUI.sample.loadButton.setTooltip({});
     directUI.sample.loadButton.setHasFile(false);
-    processorRef.getAPVTS().state.setProperty("directSamplePath", "", nullptr);
+    StateCodec::setSamplePath(processorRef.getAPVTS().state,
+                              "directSamplePath", {});
     envelopeCurveEditor.setDirectProvider(nullptr);
   });
   addAndMakeVisible(directUI.sample.loadButton);
@@ -88,7 +90,8 @@ void BoomBabyAudioProcessorEditor::setupDirectParams() {
 
   // Pitch: -24 〜 +24 半音
   styleDirectKnob(directUI.pitch.slider, directKnobLAF);
-  directUI.pitch.slider.setRange(-24.0, 24.0, 1.0);
+  directUI.pitch.slider.setRange(-ParamRanges::samplePitchMaxSt,
+                                 ParamRanges::samplePitchMaxSt, 1.0);
   directUI.pitch.slider.setDoubleClickReturnValue(true, 0.0);
   directUI.pitch.slider.setValue(0.0, juce::dontSendNotification);
   directUI.pitch.slider.onDragStart = [this] {
@@ -177,7 +180,8 @@ void BoomBabyAudioProcessorEditor::setupDirectParams() {
 
   // Decay: 10 〜 2000 ms（LUT の再生期間を制御 — Click の Sample Decay と同一）
   styleDirectKnob(directUI.decay.slider, directKnobLAF);
-  directUI.decay.slider.setRange(10.0, 2000.0, 1.0);
+  directUI.decay.slider.setRange(ParamRanges::sampleDecayMinMs,
+                                 ParamRanges::sampleDecayMaxMs, 1.0);
   directUI.decay.slider.setSkewFactorFromMidPoint(300.0);
   directUI.decay.slider.setDoubleClickReturnValue(true, 300.0);
   directUI.decay.slider.setValue(300.0, juce::dontSendNotification);
@@ -318,8 +322,15 @@ void BoomBabyAudioProcessorEditor::setupDirectParams() {
               static_cast<float>(directUI.threshold.slider.getValue()));
   };
   addAndMakeVisible(directUI.threshold.slider);
-  styleKnobLabelDirect(directUI.threshold.label, "Thresh", knobFont);
-  addAndMakeVisible(directUI.threshold.label);
+
+  // 検出帯域セレクター（Full / Low / Mid）— Threshold ノブのラベルを兼ねる。
+  // 適用は parameterChanged 経由（Lookahead と同じ）
+  directUI.threshold.band.setOnChange([this](int b) {
+    syncParam(ParamIDs::directDetectBand, static_cast<float>(b));
+  });
+  directUI.threshold.band.setOnClicked(
+      [this] { switchEditTarget(EnvelopeCurveEditor::EditTarget::none); });
+  addAndMakeVisible(directUI.threshold.band);
 
   // ── Hold スライダー（mode ドロップダウン右） ──
   directUI.hold.slider.setSliderStyle(juce::Slider::LinearHorizontal);
@@ -360,6 +371,14 @@ void BoomBabyAudioProcessorEditor::setupDirectParams() {
   directUI.hold.label.setJustificationType(juce::Justification::centredRight);
   addAndMakeVisible(directUI.hold.label);
 
+  // Lookahead セレクター（Off / 2ms / 5ms）— 選択値はレイテンシとして報告
+  directUI.lookahead.setOnChange([this](int idx) {
+    syncParam(ParamIDs::directLookahead, static_cast<float>(idx));
+  });
+  directUI.lookahead.setOnClicked(
+      [this] { switchEditTarget(EnvelopeCurveEditor::EditTarget::none); });
+  addAndMakeVisible(directUI.lookahead);
+
   // 起動時のパススルー UI 状態を設定
   {
     const bool isPt = processorRef.directMode().isPassthrough();
@@ -381,7 +400,9 @@ void BoomBabyAudioProcessorEditor::setupDirectParams() {
   InfoBox::setInfo(directUI.lpf.qSlider, InfoText::directLpfQ);
   InfoBox::setInfo(directUI.lpf.slope, InfoText::directLpfSlope);
   InfoBox::setInfo(directUI.threshold.slider, InfoText::directThreshold);
+  InfoBox::setInfo(directUI.threshold.band, InfoText::directDetectBand);
   InfoBox::setInfo(directUI.hold.slider, InfoText::directHold);
+  InfoBox::setInfo(directUI.lookahead, InfoText::directLookahead);
   InfoBox::setInfo(directUI.sample.loadButton, InfoText::directSampleLoad);
 }
 
@@ -393,8 +414,7 @@ void BoomBabyAudioProcessorEditor::onDirectModeChanged() {
     // サンプルが既にロード済みならファイル名を復元
     if (directUI.sample.loadedFilePath.isNotEmpty()) {
       directUI.sample.loadButton.setButtonText(
-          juce::File(directUI.sample.loadedFilePath)
-              .getFileNameWithoutExtension());
+          SampleRef::displayName(directUI.sample.loadedFilePath));
       directUI.sample.loadButton.setHasFile(true);
     } else {
       directUI.sample.loadButton.setButtonText("Drop or Click to Load");
@@ -426,12 +446,15 @@ void BoomBabyAudioProcessorEditor::layoutDirectParams(
   directUI.modeCombo.setBounds(topRow.removeFromLeft(modeComboW));
 
   if (isPassthrough) {
-    // Hold ラベル + スライダーを mode 右に配置（残り幅いっぱい使用）
+    // Hold ラベル + スライダーを mode 右に配置し、右端に Lookahead
     topRow.removeFromLeft(4);
+    constexpr int lookaheadW = 90;
+    directUI.lookahead.setBounds(topRow.removeFromRight(lookaheadW));
+    topRow.removeFromRight(4);
     constexpr int holdLabelW = 30;
     directUI.hold.label.setBounds(topRow.removeFromLeft(holdLabelW));
     topRow.removeFromLeft(2);
-    directUI.hold.slider.setBounds(topRow); // 残り全幅
+    directUI.hold.slider.setBounds(topRow); // 残り幅
   } else {
     topRow.removeFromLeft(4);
     directUI.sample.loadButton.setBounds(topRow);
@@ -448,7 +471,7 @@ void BoomBabyAudioProcessorEditor::layoutDirectParams(
         isPassthrough ? &directUI.threshold.slider : &directUI.pitch.slider;
     juce::Component *col0Label =
         isPassthrough
-            ? static_cast<juce::Component *>(&directUI.threshold.label)
+            ? static_cast<juce::Component *>(&directUI.threshold.band)
             : static_cast<juce::Component *>(&directUI.pitch.label);
 
     const std::array<juce::Slider *, 4> rowKnobs = {{
@@ -502,25 +525,31 @@ void BoomBabyAudioProcessorEditor::DirectUI::applyPassthroughVisibility(
   pitch.slider.setVisible(!isPassthrough);
   pitch.label.setVisible(!isPassthrough);
   threshold.slider.setVisible(isPassthrough);
-  threshold.label.setVisible(isPassthrough);
+  threshold.band.setVisible(isPassthrough);
 
   // Hold: パススルーモード時のみ表示
   hold.label.setVisible(isPassthrough);
   hold.slider.setVisible(isPassthrough);
+  lookahead.setVisible(isPassthrough);
 }
 
 void BoomBabyAudioProcessorEditor::onSampleFileChosen(const juce::File &file) {
-  directUI.sample.loadedFilePath = file.getFullPathName();
-  directUI.sample.loadButton.setButtonText(file.getFileNameWithoutExtension());
+  onSampleRefChosen(file.getFullPathName());
+}
+
+void BoomBabyAudioProcessorEditor::onSampleRefChosen(const juce::String &ref) {
+  directUI.sample.loadedFilePath = ref;
+  directUI.sample.loadButton.setButtonText(SampleRef::displayName(ref));
   directUI.sample.loadButton.setTooltip(directUI.sample.loadedFilePath);
   directUI.sample.loadButton.setHasFile(true);
-  processorRef.getAPVTS().state.setProperty(
-      "directSamplePath", directUI.sample.loadedFilePath, nullptr);
-  processorRef.directEngine().sampler().loadSample(file);
-
-  // サムネイルデータをメンバーに保存してプロバイダーを登録
-  if (!processorRef.directEngine().sampler().copyThumbnail(
-          directUI.sample.thumbMin, directUI.sample.thumbMax))
+  StateCodec::setSamplePath(processorRef.getAPVTS().state, "directSamplePath",
+                            directUI.sample.loadedFilePath);
+  // プリセット切り替えで同じサンプルが来た場合はデコードし直さない
+  SampleRef::loadInto(processorRef.directEngine().sampler(), ref);
+
+  // 波形ピラミッドを（コピーせずに）受け取ってプロバイダーを登録
+  directUI.sample.peaks = processorRef.directEngine().sampler().peaks();
+  if (directUI.sample.peaks == nullptr)
     return;
   directUI.sample.thumbDurSec =
       processorRef.directEngine().sampler().durationSec();
@@ -528,7 +557,7 @@ void BoomBabyAudioProcessorEditor::onSampleFileChosen(const juce::File &file) {
 }
 
 void BoomBabyAudioProcessorEditor::refreshDirectProvider() {
-  if (directUI.sample.thumbMin.empty() || directUI.sample.thumbDurSec <= 0.0)
+  if (directUI.sample.peaks == nullptr || directUI.sample.thumbDurSec <= 0.0)
     return;
 
   // Pitch (semitones) → 再生速度倍率
@@ -546,14 +575,14 @@ void BoomBabyAudioProcessorEditor::refreshDirectProvider() {
   const auto driveDb =
       static_cast<float>(directUI.saturator.driveSlider.getValue());
   const int clipType = directUI.saturator.clipType.getSelected();
-  const std::size_t n = directUI.sample.thumbMin.size();
+  const auto &thumb = directUI.sample.peaks->level(
+      PeakPyramid::levelFor(WaveformUtils::kPreviewMinBins));
+  const std::size_t n = thumb.min.size();
   auto minPtr = std::make_shared<std::vector<float>>(n);
   auto maxPtr = std::make_shared<std::vector<float>>(n);
   for (std::size_t i = 0; i < n; ++i) {
-    (*minPtr)[i] =
-        Saturator::process(directUI.sample.thumbMin[i], driveDb, clipType);
-    (*maxPtr)[i] =
-        Saturator::process(directUI.sample.thumbMax[i], driveDb, clipType);
+    (*minPtr)[i] = Saturator::process(thumb.min[i], driveDb, clipType);
+    (*maxPtr)[i] = Saturator::process(thumb.max[i], driveDb, clipType);
   }
 
   // HPF / LPF を thumb データに適用（DSP: Saturator → HPF → LPF の順）
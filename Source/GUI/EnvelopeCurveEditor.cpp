@@ -1,12 +1,18 @@
 #include "EnvelopeCurveEditor.h"
 #include "../DSP/EnvelopeData.h"
+#include "ConeSimplifier.h"
 #include "CustomSliderLAF.h"
 #include "InfoBoxText.h"
 #include "UIConstants.h"
+#include "WavePaint.h"
 
 #include <array>
 #include <cmath>
+#include <optional>
+#include <span>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace {
 
@@ -43,6 +49,112 @@ std::pair<float, float> editValueRange(EnvelopeCurveEditor::EditTarget target) {
   return {0.0f, 2.0f}; // amp / clickAmp
 }
 
+/// x = 0..numPixels（dtMs 間隔）のエンベロープ値を一括評価する。
+/// ポイントが 1 個以下（ノブ制御）のときは fallback で埋める。
+std::vector<float> sampleEnvelope(const EnvelopeData &env, float dtMs,
+                                  int numPixels, float fallback) {
+  std::vector<float> out(static_cast<std::size_t>(numPixels + 1), fallback);
+  if (env.isEnvelopeControlled())
+    env.evaluateRange(0.0f, dtMs, numPixels + 1, out.data());
+  return out;
+}
+
+/// レイヤーキャッシュのキー（描画入力の FNV-1a 64bit ハッシュ）
+class LayerKey {
+public:
+  template <typename T> LayerKey &add(const T &v) noexcept {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto *bytes = reinterpret_cast<const unsigned char *>(&v);
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+      hash_ ^= bytes[i];
+      hash_ *= 1099511628211ULL;
+    }
+    return *this;
+  }
+
+  LayerKey &add(const EnvelopeData &env) noexcept {
+    add(env.getDefaultValue());
+    for (const auto &pt : env.getPoints())
+      add(pt.timeMs).add(pt.value).add(pt.curve);
+    return add(env.getPoints().size());
+  }
+
+  std::uint64_t value() const noexcept { return hash_; }
+
+private:
+  std::uint64_t hash_ = 14695981039346656037ULL;
+};
+
+/// 1 px 刻みの折れ線を Path に積む際、ほぼ一直線に並ぶ頂点を間引く
+/// （ConeSimplifier.h、方向は角度なので右→左へ戻る折れ線でも折り返さない）。
+/// サブパスごとに点を溜め、flush() で間引いた結果を Path に書く。
+/// 間引いた点はすべて確定した線分から tolerance 以内に収まる。
+class PolylineSimplifier {
+public:
+  explicit PolylineSimplifier(juce::Path &path, float tolerance = 0.3f)
+      : path_(path), tolerance_(tolerance) {}
+
+  void startNewSubPath(float x, float y) {
+    flush();
+    points_.push_back({x, y});
+  }
+
+  void lineTo(float x, float y) { points_.push_back({x, y}); }
+
+  /// 溜めた点を Path に確定する（Path を使う前に必ず呼ぶ）
+  void flush() {
+    if (points_.empty())
+      return;
+    // 頂点のすぐ近くの点はどの方向の線分からも誤差内（半幅 π）
+    const auto distanceCone = [tol = tolerance_](juce::Point<float> anchor,
+                                                 juce::Point<float> p) {
+      const float dist = anchor.getDistanceFrom(p);
+      const float dir = std::atan2(p.y - anchor.y, p.x - anchor.x);
+      return Polyline::Cone{dir, dist <= tol
+                                     ? juce::MathConstants<float>::pi
+                                     : std::asin(tol / dist)};
+    };
+    bool first = true;
+    Polyline::simplify(
+        std::span<const juce::Point<float>>(points_), distanceCone,
+        [this, &first](juce::Point<float> p) {
+          if (first)
+            path_.startNewSubPath(p);
+          else
+            path_.lineTo(p);
+          first = false;
+        },
+        juce::MathConstants<float>::twoPi);
+    points_.clear();
+  }
+
+private:
+  juce::Path &path_;
+  float tolerance_;
+  std::vector<juce::Point<float>> points_;
+};
+
+/// 論理サイズ w×h のレイヤーを物理解像度（scale 倍）の Image に描き直す。
+/// サイズが変わらなければ既存 Image を再利用する。
+template <typename PaintFn>
+void renderLayer(juce::Image &image, juce::Image::PixelFormat format, int w,
+                 int h, float scale, PaintFn &&paintFn) {
+  const int pw = std::max(1, juce::roundToInt(static_cast<float>(w) * scale));
+  const int ph = std::max(1, juce::roundToInt(static_cast<float>(h) * scale));
+  if (image.isNull() || image.getWidth() != pw || image.getHeight() != ph ||
+      image.getFormat() != format)
+    image = juce::Image(format, pw, ph, true);
+  else
+    image.clear(image.getBounds());
+
+  juce::Graphics lg(image);
+  lg.addTransform(juce::AffineTransform::scale(static_cast<float>(pw) /
+                                                   static_cast<float>(w),
+                                               static_cast<float>(ph) /
+                                                   static_cast<float>(h)));
+  paintFn(lg);
+}
+
 } // namespace
 
 // ── PointValueEditor
@@ -137,39 +249,110 @@ EnvelopeCurveEditor::EnvelopeCurveEditor(EnvelopeData &ampData,
 }
 
 void EnvelopeCurveEditor::paint(juce::Graphics &g) {
-  const auto bounds = getLocalBounds().toFloat();
-  const float totalH = bounds.getHeight();
+  const int width = getWidth();
+  const int height = getHeight();
+  const auto totalH = static_cast<float>(height);
   const auto c = makeCoords();
   const float centreY = c.plotH * 0.5f;
 
-  g.fillAll(UIConstants::Colours::waveformBg);
-
-  if (c.w < 1.0f || c.plotH < 1.0f)
+  if (c.w < 1.0f || c.plotH < 1.0f) {
+    g.fillAll(UIConstants::Colours::waveformBg);
     return;
+  }
 
+  const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
   const bool anySolo = channelVis_.subSoloed || channelVis_.clickSoloed ||
                        channelVis_.directSoloed;
-  if (!channelVis_.subMuted && (!anySolo || channelVis_.subSoloed)) {
-    g.beginTransparencyLayer(UIConstants::subWaveOpacity);
-    PaintHelper::waveform(*this, g, c, centreY);
-    g.endTransparencyLayer();
-  }
-  if (!channelVis_.clickMuted && (!anySolo || channelVis_.clickSoloed)) {
-    g.beginTransparencyLayer(UIConstants::clickWaveOpacity);
-    if (clickPreview_.noiseEnvFn)
-      PaintHelper::clickNoiseBand(*this, g, c, centreY);
-    else
-      PaintHelper::clickSampleWave(*this, g, c, centreY);
-    g.endTransparencyLayer();
+  const bool showSub =
+      !channelVis_.subMuted && (!anySolo || channelVis_.subSoloed);
+  const bool showClick =
+      !channelVis_.clickMuted && (!anySolo || channelVis_.clickSoloed);
+  const bool showDirect =
+      !channelVis_.directMuted && (!anySolo || channelVis_.directSoloed);
+  // リアルタイム入力は RealtimeWaveRenderer が独自にスクロールキャッシュする
+  const bool realtimeDirect =
+      directPreview_.useRealtime && !directPreview_.realtime.empty();
+  const juce::Rectangle<float> area(0.0f, 0.0f, c.w, totalH);
+
+  // ① 背景 + 波形プレビュー（Sub / Click / サンプル Direct）
+  LayerKey previewKey;
+  previewKey.add(scale).add(width).add(height).add(c.durationMs);
+  previewKey.add(showSub).add(showClick).add(showDirect).add(realtimeDirect);
+  for (const auto *env : envDatas_)
+    previewKey.add(*env);
+  previewKey.add(wavePreview_.shape)
+      .add(wavePreview_.mix)
+      .add(wavePreview_.harmonicGains)
+      .add(wavePreview_.displayCycles)
+      .add(clickPreview_.decayMs);
+  if (layers_.previewDirty || previewKey.value() != layers_.previewKey) {
+    renderLayer(layers_.preview, juce::Image::RGB, width, height, scale,
+                [&](juce::Graphics &lg) {
+                  lg.fillAll(UIConstants::Colours::waveformBg);
+                  if (showSub) {
+                    lg.beginTransparencyLayer(UIConstants::subWaveOpacity);
+                    PaintHelper::waveform(*this, lg, c, centreY);
+                    lg.endTransparencyLayer();
+                  }
+                  if (showClick) {
+                    lg.beginTransparencyLayer(UIConstants::clickWaveOpacity);
+                    if (clickPreview_.noiseEnvFn)
+                      PaintHelper::clickNoiseBand(*this, lg, c, centreY);
+                    else
+                      PaintHelper::clickSampleWave(*this, lg, c, centreY);
+                    lg.endTransparencyLayer();
+                  }
+                  if (showDirect && !realtimeDirect) {
+                    lg.beginTransparencyLayer(UIConstants::directWaveOpacity);
+                    PaintHelper::directWaveform(*this, lg, c, centreY);
+                    lg.endTransparencyLayer();
+                  }
+                });
+    layers_.previewKey = previewKey.value();
+    layers_.previewDirty = false;
   }
-  if (!channelVis_.directMuted && (!anySolo || channelVis_.directSoloed)) {
+  g.drawImage(layers_.preview, area);
+
+  // ② リアルタイム入力波形
+  if (showDirect && realtimeDirect) {
     g.beginTransparencyLayer(UIConstants::directWaveOpacity);
     PaintHelper::directWaveform(*this, g, c, centreY);
     g.endTransparencyLayer();
   }
-  PaintHelper::envelopeOverlay(*this, g, c);
+
+  // ③ 編集中エンベロープの曲線
+  if (editTarget != EditTarget::none && editEnvData->hasPoints()) {
+    LayerKey envKey;
+    envKey.add(scale).add(width).add(height).add(c.durationMs).add(editTarget);
+    envKey.add(*editEnvData);
+    if (envKey.value() != layers_.envLineKey) {
+      renderLayer(
+          layers_.envLine, juce::Image::ARGB, width, height, scale,
+          [&](juce::Graphics &lg) { PaintHelper::envelopeLine(*this, lg, c); });
+      layers_.envLineKey = envKey.value();
+    }
+    g.drawImage(layers_.envLine, area);
+  }
+
+  // ④ 制御点・カーブハンドル・ツールチップ（ホバー/ドラッグ依存のため毎回）
+  PaintHelper::envelopePoints(*this, g, c);
   PaintHelper::pointTooltip(*this, g, c);
-  PaintHelper::timeline(g, c, totalH);
+
+  // ⑤ タイムライン
+  LayerKey timelineKey;
+  timelineKey.add(scale).add(width).add(height).add(c.durationMs);
+  if (timelineKey.value() != layers_.timelineKey) {
+    renderLayer(
+        layers_.timeline, juce::Image::ARGB, width, height, scale,
+        [&](juce::Graphics &lg) { PaintHelper::timeline(lg, c, totalH); });
+    layers_.timelineKey = timelineKey.value();
+  }
+  g.drawImage(layers_.timeline, area);
+}
+
+void EnvelopeCurveEditor::invalidatePreviews() {
+  layers_.previewDirty = true;
+  repaint();
 }
 
 // ── PaintHelper メソッド ──
@@ -183,48 +366,51 @@ void EnvelopeCurveEditor::PaintHelper::waveform(const EnvelopeCurveEditor &e,
   const auto &freqEnv = *e.envDatas_[1];
   const auto &distEnv = *e.envDatas_[2];
   const auto &mixEnv = *e.envDatas_[3];
-  const bool hasAmpPoints = ampEnv.isEnvelopeControlled();
-  const bool hasFreqPoints = freqEnv.isEnvelopeControlled();
-  const bool hasMixPoints = mixEnv.isEnvelopeControlled();
-  const bool hasDistPoints = distEnv.isEnvelopeControlled();
 
   juce::Path fillPath;
   juce::Path waveLine;
-  fillPath.startNewSubPath(0.0f, centreY);
+  PolylineSimplifier fill(fillPath);
+  PolylineSimplifier line(waveLine);
+  fill.startNewSubPath(0.0f, centreY);
 
   float phase = 0.0f;
   const float dtMs = c.durationMs / c.w;
 
+  const auto hzCurve =
+      sampleEnvelope(freqEnv, dtMs, numPixels, freqEnv.getValue());
+  const auto mixCurve =
+      sampleEnvelope(mixEnv, dtMs, numPixels, e.wavePreview_.mix);
+  const auto distCurve =
+      sampleEnvelope(distEnv, dtMs, numPixels, distEnv.getValue());
+  const auto ampCurve =
+      sampleEnvelope(ampEnv, dtMs, numPixels, ampEnv.getValue());
+
   constexpr float fadeOutMs = 5.0f;
   const float fadeStartMs = std::max(0.0f, c.durationMs - fadeOutMs);
 
   for (int i = 0; i <= numPixels; ++i) {
     const auto x = static_cast<float>(i);
     const float timeMs = x * dtMs;
+    const auto idx = static_cast<std::size_t>(i);
 
-    const float hz =
-        hasFreqPoints ? freqEnv.evaluate(timeMs) : freqEnv.getValue();
+    const float hz = hzCurve[idx];
     if (i > 0)
       phase += hz * (dtMs / 1000.0f) * juce::MathConstants<float>::twoPi;
 
-    const float mix =
-        hasMixPoints ? mixEnv.evaluate(timeMs) : e.wavePreview_.mix;
+    const float mix = mixCurve[idx];
 
     const float sinVal = std::sin(phase);
     float waveVal = PaintHelper::previewWaveValue(e, sinVal, mix, phase);
 
     // Saturate: tanh ソフトクリップ（drive01=0〜1 → driveAmount=1〜10）
     // make-up gain で drive に依らずピーク振幅を一定に保つ
-    if (const float drive01 =
-            hasDistPoints ? distEnv.evaluate(timeMs) : distEnv.getValue();
-        drive01 > 0.001f) {
+    if (const float drive01 = distCurve[idx]; drive01 > 0.001f) {
       const float driveAmount = 1.0f + drive01 * 9.0f;
       waveVal = std::tanh(waveVal * driveAmount) / std::tanh(driveAmount);
     }
 
     // Gain: 振幅
-    const float amplitude =
-        hasAmpPoints ? ampEnv.evaluate(timeMs) : ampEnv.getValue();
+    const float amplitude = ampCurve[idx];
 
     // 末尾 fadeout ゲイン
     float fadeGain = 1.0f;
@@ -236,15 +422,17 @@ void EnvelopeCurveEditor::PaintHelper::waveform(const EnvelopeCurveEditor &e,
     const float scaledAmp = std::min(amplitude, 2.0f) * centreY * fadeGain;
     const float y = juce::jlimit(0.0f, c.plotH, centreY - waveVal * scaledAmp);
 
-    fillPath.lineTo(x, y);
+    fill.lineTo(x, y);
 
     if (i == 0)
-      waveLine.startNewSubPath(x, y);
+      line.startNewSubPath(x, y);
     else
-      waveLine.lineTo(x, y);
+      line.lineTo(x, y);
   }
 
-  fillPath.lineTo(c.w, centreY);
+  fill.lineTo(c.w, centreY);
+  fill.flush();
+  line.flush();
   fillPath.closeSubPath();
 
   const juce::Colour baseBlue = UIConstants::Colours::subArc;
@@ -271,17 +459,23 @@ void EnvelopeCurveEditor::PaintHelper::waveform(const EnvelopeCurveEditor &e,
 void EnvelopeCurveEditor::setDirectProvider(
     std::function<std::pair<float, float>(float)> fn) {
   directPreview_.fn = std::move(fn);
-  repaint();
+  invalidatePreviews();
 }
 
-void EnvelopeCurveEditor::setRealtimePixels(
-    std::vector<std::pair<float, float>> pixels) {
-  directPreview_.realtimePixels = std::move(pixels);
-  // repaint は呼び出し元 (Timer) が責任を持つ
+void EnvelopeCurveEditor::setRealtimeStyle(
+    const RealtimeWaveRenderer::Style &style) {
+  directPreview_.realtime.setStyle(style);
 }
 
-void EnvelopeCurveEditor::setUseRealtimeInput(bool use) noexcept {
+bool EnvelopeCurveEditor::updateRealtimeInput(const PeakColumnRing &columns) {
+  return directPreview_.realtime.update(columns);
+}
+
+void EnvelopeCurveEditor::setUseRealtimeInput(bool use) {
+  if (directPreview_.useRealtime == use)
+    return;
   directPreview_.useRealtime = use;
+  repaint();
 }
 
 void EnvelopeCurveEditor::setChannelMuted(Channel ch, bool muted) {
@@ -320,7 +514,7 @@ void EnvelopeCurveEditor::setClickPreviewProvider(
     std::function<std::pair<float, float>(float)> fn) {
   clickPreview_.noiseEnvFn = nullptr;
   clickPreview_.sampleFn = std::move(fn);
-  repaint();
+  invalidatePreviews();
 }
 
 void EnvelopeCurveEditor::setClickDecayMs(float ms) {
@@ -332,50 +526,54 @@ void EnvelopeCurveEditor::setClickNoiseEnvProvider(
     std::function<float(float)> fn) {
   clickPreview_.sampleFn = nullptr;
   clickPreview_.noiseEnvFn = std::move(fn);
-  repaint();
+  invalidatePreviews();
 }
 
-template <typename GetSample, typename GetAmpMul>
+template <typename GetSample>
 void EnvelopeCurveEditor::PaintHelper::buildStereoWavePaths(
     juce::Path &fillPath, juce::Path &topLine, juce::Path &botLine,
     const CoordMapper &c, float centreY, GetSample getSample,
-    GetAmpMul getAmpMul) {
+    const std::vector<float> &ampCurve) {
   const auto numPixels = static_cast<int>(c.w);
+  PolylineSimplifier fill(fillPath);
+  PolylineSimplifier top(topLine);
+  PolylineSimplifier bot(botLine);
   for (int i = 0; i <= numPixels; ++i) {
     const auto x = static_cast<float>(i);
-    const float timeMs = (x / c.w) * c.durationMs;
-    const float ampMul = getAmpMul(timeMs);
+    const float ampMul = ampCurve[static_cast<std::size_t>(i)];
     const auto [mn, mx] = getSample(i);
     const float yTop =
         juce::jlimit(0.0f, c.plotH, centreY - mx * ampMul * centreY);
     if (i == 0) {
-      fillPath.startNewSubPath(x, yTop);
-      topLine.startNewSubPath(x, yTop);
+      fill.startNewSubPath(x, yTop);
+      top.startNewSubPath(x, yTop);
     } else {
-      fillPath.lineTo(x, yTop);
-      topLine.lineTo(x, yTop);
+      fill.lineTo(x, yTop);
+      top.lineTo(x, yTop);
     }
   }
   for (int i = numPixels; i >= 0; --i) {
     const auto x = static_cast<float>(i);
-    const float timeMs = (x / c.w) * c.durationMs;
-    const float ampMul = getAmpMul(timeMs);
+    const float ampMul = ampCurve[static_cast<std::size_t>(i)];
     const auto [mn, mx] = getSample(i);
     const float yBot =
         juce::jlimit(0.0f, c.plotH, centreY - mn * ampMul * centreY);
-    fillPath.lineTo(x, yBot);
+    fill.lineTo(x, yBot);
     if (i == numPixels)
-      botLine.startNewSubPath(x, yBot);
+      bot.startNewSubPath(x, yBot);
     else
-      botLine.lineTo(x, yBot);
+      bot.lineTo(x, yBot);
   }
+  fill.flush();
+  top.flush();
+  bot.flush();
 }
 
 void EnvelopeCurveEditor::PaintHelper::directWaveform(
     const EnvelopeCurveEditor &e, juce::Graphics &g, const CoordMapper &c,
     float centreY) {
-  const bool hasRealtime =
-      e.directPreview_.useRealtime && !e.directPreview_.realtimePixels.empty();
+  auto &realtime = e.directPreview_.realtime;
+  const bool hasRealtime = e.directPreview_.useRealtime && !realtime.empty();
   if (!hasRealtime && !e.directPreview_.fn)
     return;
 
@@ -385,42 +583,35 @@ void EnvelopeCurveEditor::PaintHelper::directWaveform(
   const auto &directAmpEnv = *e.envDatas_[5];
   const bool hasDirectAmpEnv = directAmpEnv.isEnvelopeControlled();
 
-  auto getSample = [hasRealtime, &e, dtSec](int i) -> std::pair<float, float> {
+  // 振幅が一定ならスクロールする offscreen Image から転写するだけ
+  if (hasRealtime && !hasDirectAmpEnv) {
+    realtime.draw(g, static_cast<int>(c.w), static_cast<int>(c.plotH),
+                  directAmpEnv.getDefaultValue(), baseColour);
+    return;
+  }
+
+  // 振幅エンベロープ付き: x 毎に倍率が変わるため処理済み列から Path を組む
+  auto getSample = [hasRealtime, &e, &realtime,
+                    dtSec](int i) -> std::pair<float, float> {
     if (hasRealtime) {
-      if (i < static_cast<int>(e.directPreview_.realtimePixels.size()))
-        return e.directPreview_.realtimePixels[static_cast<std::size_t>(i)];
-      return {0.0f, 0.0f};
+      const auto col = realtime.column(i);
+      return {col.min, col.max};
     }
     return e.directPreview_.fn(static_cast<float>(i) * dtSec);
   };
 
-  auto getAmpMul = [hasDirectAmpEnv, &directAmpEnv](float timeMs) {
-    return hasDirectAmpEnv ? directAmpEnv.evaluate(timeMs)
-                           : directAmpEnv.getDefaultValue();
-  };
+  const auto ampCurve =
+      sampleEnvelope(directAmpEnv, c.durationMs / c.w, static_cast<int>(c.w),
+                     directAmpEnv.getDefaultValue());
 
   juce::Path fillPath;
   juce::Path topLine;
   juce::Path botLine;
 
   buildStereoWavePaths(fillPath, topLine, botLine, c, centreY, getSample,
-                       getAmpMul);
+                       ampCurve);
   fillPath.closeSubPath();
-
-  juce::ColourGradient fillGrad(baseColour.withAlpha(0.25f), 0.0f, 0.0f,
-                                baseColour.withAlpha(0.03f), 0.0f, c.plotH,
-                                false);
-  g.setGradientFill(fillGrad);
-  g.fillPath(fillPath);
-
-  for (const auto *line : {&topLine, &botLine}) {
-    g.setColour(baseColour.withAlpha(0.07f));
-    g.strokePath(*line, juce::PathStrokeType(6.0f));
-    g.setColour(baseColour.withAlpha(0.30f));
-    g.strokePath(*line, juce::PathStrokeType(3.5f));
-    g.setColour(baseColour.withAlpha(0.90f));
-    g.strokePath(*line, juce::PathStrokeType(1.2f));
-  }
+  WavePaint::directBand(g, fillPath, topLine, botLine, baseColour, c.plotH);
 }
 
 void EnvelopeCurveEditor::PaintHelper::clickNoiseBand(
@@ -433,6 +624,9 @@ void EnvelopeCurveEditor::PaintHelper::clickNoiseBand(
   juce::Path bandPath;
   juce::Path upperLine;
   juce::Path lowerLine;
+  PolylineSimplifier band(bandPath);
+  PolylineSimplifier upper(upperLine);
+  PolylineSimplifier lower(lowerLine);
 
   for (int i = 0; i <= numPixels; ++i) {
     const auto x = static_cast<float>(i);
@@ -440,11 +634,11 @@ void EnvelopeCurveEditor::PaintHelper::clickNoiseBand(
         juce::jlimit(0.0f, 1.0f, e.clickPreview_.noiseEnvFn(x * dtSec));
     const float y = juce::jlimit(0.0f, c.plotH, centreY - env * centreY);
     if (i == 0) {
-      bandPath.startNewSubPath(x, y);
-      upperLine.startNewSubPath(x, y);
+      band.startNewSubPath(x, y);
+      upper.startNewSubPath(x, y);
     } else {
-      bandPath.lineTo(x, y);
-      upperLine.lineTo(x, y);
+      band.lineTo(x, y);
+      upper.lineTo(x, y);
     }
   }
   for (int i = numPixels; i >= 0; --i) {
@@ -452,12 +646,15 @@ void EnvelopeCurveEditor::PaintHelper::clickNoiseBand(
     const float env =
         juce::jlimit(0.0f, 1.0f, e.clickPreview_.noiseEnvFn(x * dtSec));
     const float y = juce::jlimit(0.0f, c.plotH, centreY + env * centreY);
-    bandPath.lineTo(x, y);
+    band.lineTo(x, y);
     if (i == numPixels)
-      lowerLine.startNewSubPath(x, y);
+      lower.startNewSubPath(x, y);
     else
-      lowerLine.lineTo(x, y);
+      lower.lineTo(x, y);
   }
+  band.flush();
+  upper.flush();
+  lower.flush();
   bandPath.closeSubPath();
 
   juce::ColourGradient fillGrad(baseYellow.withAlpha(0.18f), 0.0f, 0.0f,
@@ -483,24 +680,26 @@ void EnvelopeCurveEditor::PaintHelper::clickSampleWave(
   const juce::Colour baseYellow = UIConstants::Colours::clickArc;
   const float dtSec = (c.durationMs / 1000.0f) / c.w;
   const auto &clickAmpEnv = *e.envDatas_[4];
-  const bool hasClickAmpEnv = clickAmpEnv.isEnvelopeControlled();
+  const auto numPixels = static_cast<int>(c.w);
+  const float dtMs = c.durationMs / c.w;
 
   constexpr float clickFadeOutMs = 5.0f;
   const float clickFadeStartMs =
       std::max(0.0f, e.clickPreview_.decayMs - clickFadeOutMs);
 
-  auto getAmpMul = [hasClickAmpEnv, &clickAmpEnv, &e,
-                    clickFadeStartMs](float timeMs) {
-    float ampMul = hasClickAmpEnv ? clickAmpEnv.evaluate(timeMs)
-                                  : clickAmpEnv.getDefaultValue();
+  // 振幅エンベロープ × 末尾フェードアウト（Decay 以降は 0）
+  auto ampCurve = sampleEnvelope(clickAmpEnv, dtMs, numPixels,
+                                 clickAmpEnv.getDefaultValue());
+  for (int i = 0; i <= numPixels; ++i) {
+    const float timeMs = static_cast<float>(i) * dtMs;
+    auto &ampMul = ampCurve[static_cast<std::size_t>(i)];
     if (timeMs >= e.clickPreview_.decayMs) {
       ampMul = 0.0f;
     } else if (timeMs > clickFadeStartMs && clickFadeOutMs > 0.0f) {
       const float t = (timeMs - clickFadeStartMs) / clickFadeOutMs;
       ampMul *= 0.5f * (1.0f + std::cos(t * juce::MathConstants<float>::pi));
     }
-    return ampMul;
-  };
+  }
 
   juce::Path fillPath;
   juce::Path topLine;
@@ -510,7 +709,7 @@ void EnvelopeCurveEditor::PaintHelper::clickSampleWave(
     return e.clickPreview_.sampleFn(static_cast<float>(i) * dtSec);
   };
   buildStereoWavePaths(fillPath, topLine, botLine, c, centreY, getSample,
-                       getAmpMul);
+                       ampCurve);
   fillPath.closeSubPath();
 
   juce::ColourGradient fillGrad(baseYellow.withAlpha(0.28f), 0.0f, 0.0f,
@@ -570,52 +769,61 @@ float EnvelopeCurveEditor::PaintHelper::previewWaveValue(
   return std::lerp(sinVal, addVal, mix);
 }
 
-void EnvelopeCurveEditor::PaintHelper::envelopeOverlay(
+juce::Colour EnvelopeCurveEditor::PaintHelper::envelopeColour(EditTarget target) {
+  using enum EditTarget;
+  switch (target) {
+  case amp:
+    return UIConstants::Colours::subArc.brighter(0.4f);
+  case freq:
+    return juce::Colours::cyan;
+  case saturate:
+    return juce::Colour(0xFFFF9500);
+  case mix:
+    return juce::Colour(0xFF4CAF50);
+  case clickAmp:
+    return UIConstants::Colours::clickArc;
+  case directAmp:
+    return UIConstants::Colours::directArc;
+  case none:
+    break;
+  }
+  return juce::Colours::white;
+}
+
+void EnvelopeCurveEditor::PaintHelper::envelopeLine(
     const EnvelopeCurveEditor &e, juce::Graphics &g, const CoordMapper &c) {
   if (!e.editEnvData->hasPoints() || e.editTarget == EditTarget::none)
     return;
 
   const auto numPixels = static_cast<int>(c.w);
 
+  std::vector<float> values(static_cast<std::size_t>(numPixels + 1));
+  e.editEnvData->evaluateRange(0.0f, c.durationMs / c.w, numPixels + 1,
+                               values.data());
+
   juce::Path envLine;
+  PolylineSimplifier line(envLine);
   for (int i = 0; i <= numPixels; ++i) {
     const auto x = static_cast<float>(i);
-    const float timeMs = (x / c.w) * c.durationMs;
-    const float ey = c.valueToY(e.editEnvData->evaluate(timeMs));
+    const float ey = c.valueToY(values[static_cast<std::size_t>(i)]);
 
     if (i == 0)
-      envLine.startNewSubPath(x, ey);
+      line.startNewSubPath(x, ey);
     else
-      envLine.lineTo(x, ey);
+      line.lineTo(x, ey);
   }
+  line.flush();
 
-  using enum EditTarget;
-  juce::Colour envColour;
-  switch (e.editTarget) {
-  case amp:
-    envColour = UIConstants::Colours::subArc.brighter(0.4f);
-    break;
-  case freq:
-    envColour = juce::Colours::cyan;
-    break;
-  case saturate:
-    envColour = juce::Colour(0xFFFF9500);
-    break;
-  case mix:
-    envColour = juce::Colour(0xFF4CAF50);
-    break;
-  case clickAmp:
-    envColour = UIConstants::Colours::clickArc;
-    break;
-  case directAmp:
-    envColour = UIConstants::Colours::directArc;
-    break;
-  case none:
-    return;
-  }
-  g.setColour(envColour);
+  g.setColour(envelopeColour(e.editTarget));
   g.strokePath(envLine, juce::PathStrokeType(1.5f));
+}
+
+void EnvelopeCurveEditor::PaintHelper::envelopePoints(
+    const EnvelopeCurveEditor &e, juce::Graphics &g, const CoordMapper &c) {
+  if (!e.editEnvData->hasPoints() || e.editTarget == EditTarget::none)
+    return;
 
+  const juce::Colour envColour = envelopeColour(e.editTarget);
   const auto &pts = e.editEnvData->getPoints();
   for (int i = 0; i < static_cast<int>(pts.size()); ++i) {
     const auto idx = static_cast<size_t>(i);
@@ -1,11 +1,14 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <functional>
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <optional>
+#include <vector>
 
 #include "../DSP/SubOscillator.h" // WaveShape enum
+#include "RealtimeWaveRenderer.h"
 
 class EnvelopeData;
 
@@ -40,12 +43,15 @@ public:
   /// nullptr を渡すとオーバーレイを無効化。
   void setDirectProvider(std::function<std::pair<float, float>(float)> fn);
 
-  /// リアルタイム入力波形データを設定（Direct パススルーモード用、UI
-  /// スレッドから呼ぶ） pixels: コンポーネント幅分の {min, max} ペア配列。
-  void setRealtimePixels(std::vector<std::pair<float, float>> pixels);
+  /// リアルタイム入力波形の列処理設定（Drive / Clip / HPF / LPF）。
+  /// 変化したときだけ全列を再処理・再描画する。
+  void setRealtimeStyle(const RealtimeWaveRenderer::Style &style);
+  /// リアルタイム入力波形の新着列を取り込む（Direct パススルーモード用、UI
+  /// スレッドから呼ぶ）。表示が変わったら true（repaint は呼び出し元）。
+  bool updateRealtimeInput(const PeakColumnRing &columns);
   /// リアルタイム入力波形表示モード切り替え（true: 入力波形 / false:
-  /// サンプルプレビュー）
-  void setUseRealtimeInput(bool use) noexcept;
+  /// サンプルプレビュー）。切り替わったときは repaint する。
+  void setUseRealtimeInput(bool use);
 
   /// Click 波形オーバーレイ用プロバイダーを設定。
   /// fn(timeSec) → {min, max}（-1〜1）の波形値を返すラムダ。
@@ -74,6 +80,10 @@ public:
   void setChannelMuted(Channel ch, bool muted);
   void setChannelSoloed(Channel ch, bool soloed);
 
+  /// プロバイダーが参照する外部状態（ノブ値・サンプル等）が変わったことを
+  /// 通知する。キャッシュ済みの波形プレビュー層を捨てて再描画する。
+  void invalidatePreviews();
+
   /// ポイント変更時コールバック（LUT ベイク等に使用）
   void setOnChange(std::function<void()> cb);
 
@@ -137,8 +147,13 @@ private:
                                 const CoordMapper &c, float centreY);
     static void directWaveform(const EnvelopeCurveEditor &e, juce::Graphics &g,
                                const CoordMapper &c, float centreY);
-    static void envelopeOverlay(const EnvelopeCurveEditor &e, juce::Graphics &g,
-                                const CoordMapper &c);
+    /// 編集中エンベロープの曲線（キャッシュ層に描く）
+    static void envelopeLine(const EnvelopeCurveEditor &e, juce::Graphics &g,
+                             const CoordMapper &c);
+    /// 制御点とカーブハンドル（ホバー/ドラッグで変わるため毎回描く）
+    static void envelopePoints(const EnvelopeCurveEditor &e, juce::Graphics &g,
+                               const CoordMapper &c);
+    static juce::Colour envelopeColour(EditTarget target);
     static void timeline(juce::Graphics &g, const CoordMapper &c, float totalH);
     /// Mix + 波形選択に応じた1サンプルを返す
     static float previewWaveValue(const EnvelopeCurveEditor &e, float sinVal,
@@ -147,11 +162,12 @@ private:
     static void pointTooltip(const EnvelopeCurveEditor &e, juce::Graphics &g,
                              const CoordMapper &c);
     /// fillPath / topLine / botLine を構築する共通ループ
-    template <typename GetSample, typename GetAmpMul>
+    /// （ampCurve は x = 0..w の振幅倍率）
+    template <typename GetSample>
     static void buildStereoWavePaths(juce::Path &fillPath, juce::Path &topLine,
                                      juce::Path &botLine, const CoordMapper &c,
                                      float centreY, GetSample getSample,
-                                     GetAmpMul getAmpMul);
+                                     const std::vector<float> &ampCurve);
   };
 
   // [0]=amp, [1]=freq, [2]=dist, [3]=mix, [4]=clickAmp, [5]=directAmp
@@ -192,8 +208,8 @@ private:
   // ── Direct プレビュー状態 ──
   struct DirectPreview {
     std::function<std::pair<float, float>(float)> fn;
-    std::vector<std::pair<float, float>>
-        realtimePixels; ///< リアルタイム per-pixel {min,max}
+    /// リアルタイム入力波形（paint 中に描画キャッシュを更新するため mutable）
+    mutable RealtimeWaveRenderer realtime;
     bool useRealtime = false;
   };
   DirectPreview directPreview_;
@@ -212,6 +228,22 @@ private:
   };
   ChannelVisibility channelVis_;
 
+  // ── paint() のレイヤーキャッシュ ──
+  //   重い層（波形プレビュー・エンベロープ曲線・タイムライン）を物理解像度の
+  //   Image に描き、入力のハッシュが変わったときだけ描き直す。ホバー/ドラッグ
+  //   中の制御点やツールチップはその上に毎回描く。
+  struct LayerCache {
+    juce::Image preview;  ///< 背景 + Sub / Click / Direct（サンプル）波形
+    juce::Image envLine;  ///< 編集中エンベロープの曲線
+    juce::Image timeline; ///< セクション塗り・目盛り・ラベル
+    std::uint64_t previewKey = 0;
+    std::uint64_t envLineKey = 0;
+    std::uint64_t timelineKey = 0;
+    /// プロバイダー経由の入力はハッシュできないため明示的に無効化する
+    bool previewDirty = true;
+  };
+  LayerCache layers_;
+
   struct PointValueEditor;
   std::unique_ptr<PointValueEditor> pointValueEditor_;
 
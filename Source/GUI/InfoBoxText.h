@@ -7,6 +7,11 @@ namespace InfoText {
 // ── Master ──
 inline constexpr const char *masterGain =
     "Master output level (-60 ... +12 dB)";
+inline constexpr const char *masterLimiter =
+    "Brickwall limiter on/off (~1.6 ms latency, always reported)"
+    "\nGR shows the gain reduction while limiting.";
+inline constexpr const char *masterCeiling =
+    "Limiter ceiling (0 ... -6 dB)\nTP = True Peak (4x oversampled) detection";
 
 // ── Sub ──
 inline constexpr const char *subLength = "Sub note duration (10-2000 ms)";
@@ -84,6 +89,14 @@ inline constexpr const char *directHold =
     "Transient gate hold time (20-500 ms)\n"
     "Set it long enough to avoid double-triggering.\n"
     "For fast kick rolls, use sample mode with MIDI trigger instead.";
+inline constexpr const char *directDetectBand =
+    "Transient detect band (Full / Low / Mid)\n"
+    "Low: below 150 Hz, Mid: 150 Hz-2 kHz.\n"
+    "Use Low to ignore hats and snare bleeding into a kick mic.";
+inline constexpr const char *directLookahead =
+    "Transient detect lookahead (Off / 2 ms / 5 ms)\n"
+    "Delays the input so triggers land on the attack.\n"
+    "Adds the same amount of plugin latency.";
 inline constexpr const char *directSampleLoad =
     "Load audio sample (drop or click)";
 
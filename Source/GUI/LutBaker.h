@@ -2,12 +2,19 @@
 
 #include "../DSP/EnvelopeData.h"
 #include "../DSP/EnvelopeLutManager.h"
+#include "ConeSimplifier.h"
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
 
 /// エンベロープの実効区間（最終ポイントの timeMs）を LUT 期間として返す。
 /// 1 点以下（＝ノブ制御 or 未設定）の場合は fallbackMs を使う。
-/// これにより LUT の 512 点をエンベロープ区間に集中させ、
+/// これにより LUT の頂点をエンベロープ区間に集中させ、
 /// Length 変更時の解像度劣化を防ぐ。
 inline float effectiveLutDuration(const EnvelopeData &envData,
                                   float fallbackMs) {
@@ -17,18 +24,171 @@ inline float effectiveLutDuration(const EnvelopeData &envData,
   return fallbackMs;
 }
 
-/// EnvelopeData を評価して EnvelopeLutManager に焼き込むユーティリティ。
-/// BoomBabyAudioProcessorEditor のメンバー関数を分割した複数の翻訳単位から
-/// 呼び出せるよう inline free function として提供する。
-inline void bakeLut(const EnvelopeData &envData, EnvelopeLutManager &lut,
-                    float durationMs) {
-  constexpr int lutSize = EnvelopeLutManager::lutSize;
-  std::array<float, lutSize> buf{};
-  for (int i = 0; i < lutSize; ++i) {
-    const float t =
-        static_cast<float>(i) / static_cast<float>(lutSize - 1) * durationMs;
-    buf[static_cast<size_t>(i)] = envData.evaluate(t);
+namespace LutCompiler {
+
+struct Vertex {
+  float timeMs;
+  float value;
+};
+
+/// カーブ付きセグメント 1 本あたりの候補点数（時間等分 + 値等分）
+inline constexpr int kCurveSamples = 128;
+/// 許容誤差（|値| に対する相対 / 絶対の大きい方）。Freq では ≈0.9 cent。
+inline constexpr float kRelTolerance = 5.0e-4f;
+inline constexpr float kAbsTolerance = 1.0e-4f;
+
+/// [0, durationMs] の候補頂点列を作る。
+/// 制御点はそのまま（角・ステップを正確に保持）、直線セグメントは両端のみ、
+/// カーブ付きセグメントは時間等分と値等分の両方で標本化する
+/// （t^e の急峻な側にも点が入るように）。
+inline std::vector<Vertex> candidates(const EnvelopeData &env,
+                                      float durationMs) {
+  const auto &pts = env.getPoints();
+  std::vector<Vertex> out;
+  out.reserve(pts.size() * 2 + 2);
+  out.push_back({0.0f, pts.front().value});
+
+  for (std::size_t i = 0; i < pts.size(); ++i) {
+    const auto &p = pts[i];
+    if (p.timeMs >= durationMs)
+      break;
+    if (p.timeMs > 0.0f || i > 0)
+      out.push_back({p.timeMs, p.value});
+
+    if (i + 1 >= pts.size() || std::abs(p.curve) < 1e-4f)
+      continue;
+    const float t0 = p.timeMs;
+    const float t1 = std::min(pts[i + 1].timeMs, durationMs);
+    if (t1 <= t0)
+      continue;
+    const float span = pts[i + 1].timeMs - t0;
+    const float invExp = 1.0f / EnvelopeData::curveExponent(p.curve);
+    std::vector<float> ts;
+    ts.reserve(2 * kCurveSamples);
+    for (int k = 1; k < kCurveSamples; ++k) {
+      const float s = static_cast<float>(k) / static_cast<float>(kCurveSamples);
+      ts.push_back(t0 + s * span);
+      ts.push_back(t0 + std::pow(s, invExp) * span);
+    }
+    std::ranges::sort(ts);
+    for (const float t : ts)
+      if (t > t0 && t < t1)
+        out.push_back({t, env.evaluate(t)});
+  }
+
+  if (out.back().timeMs < durationMs)
+    out.push_back({durationMs, env.evaluate(durationMs)});
+  return out;
+}
+
+/// 頂点間を直線で結んだとき、間引いた点の縦方向誤差が各点の許容誤差
+/// （|値| に対する相対 / 絶対の大きい方）以内に収まるよう頂点を間引く
+/// （ConeSimplifier.h、方向は傾き）。in は時刻昇順。同時刻の点（ステップ）
+/// で区間を分けて間引くので、ステップの両側の点は必ず残る。
+inline std::vector<Vertex> simplify(const std::vector<Vertex> &in,
+                                    float relTol, float absTol) {
+  std::vector<Vertex> out;
+  const auto slopeCone = [relTol, absTol](const Vertex &anchor,
+                                          const Vertex &p) {
+    const float dt = p.timeMs - anchor.timeMs;
+    const float tol = std::max(absTol, relTol * std::abs(p.value));
+    return Polyline::Cone{(p.value - anchor.value) / dt, tol / dt};
+  };
+  const auto push = [&out](const Vertex &v) { out.push_back(v); };
+
+  const std::span<const Vertex> all(in);
+  std::size_t begin = 0;
+  for (std::size_t k = 1; k <= all.size(); ++k) {
+    if (k < all.size() && all[k].timeMs > all[k - 1].timeMs)
+      continue;
+    Polyline::simplify(all.subspan(begin, k - begin), slopeCone, push);
+    begin = k;
+  }
+  return out;
+}
+
+/// EnvelopeData を最大 lutSize 頂点の折れ線に変換し、pos（0〜1）/ value に
+/// 書き込んで頂点数を返す。頂点数が収まらなければ許容誤差を倍々に緩め、
+/// それでも収まらない（同時刻ステップだらけ）ときは等間隔で標本化する。
+inline int compile(const EnvelopeData &env, float durationMs,
+                   std::array<float, EnvelopeLutManager::lutSize> &pos,
+                   std::array<float, EnvelopeLutManager::lutSize> &value) {
+  constexpr int cap = EnvelopeLutManager::lutSize;
+  if (!env.isEnvelopeControlled() || durationMs <= 0.0f) {
+    const float v = env.evaluate(0.0f);
+    pos[0] = 0.0f;
+    pos[1] = 1.0f;
+    value[0] = v;
+    value[1] = v;
+    return 2;
   }
-  lut.setDurationMs(durationMs);
-  lut.bake(buf.data(), lutSize);
+
+  const auto cand = candidates(env, durationMs);
+  float relTol = kRelTolerance;
+  float absTol = kAbsTolerance;
+  for (int attempt = 0; attempt < 24; ++attempt) {
+    if (const auto verts = simplify(cand, relTol, absTol);
+        static_cast<int>(verts.size()) <= cap) {
+      for (std::size_t i = 0; i < verts.size(); ++i) {
+        pos[i] = std::clamp(verts[i].timeMs / durationMs, 0.0f, 1.0f);
+        value[i] = verts[i].value;
+      }
+      return static_cast<int>(verts.size());
+    }
+    relTol *= 2.0f;
+    absTol *= 2.0f;
+  }
+
+  const float dt = durationMs / static_cast<float>(cap - 1);
+  env.evaluateRange(0.0f, dt, cap, value.data());
+  for (int i = 0; i < cap; ++i)
+    pos[static_cast<std::size_t>(i)] =
+        static_cast<float>(i) / static_cast<float>(cap - 1);
+  return cap;
+}
+
+} // namespace LutCompiler
+
+/// EnvelopeData を折れ線 LUT にコンパイルし、期間と合わせて lut に書く
+/// （公開はしない）。バンクの update() の中から複数本まとめて焼くときに使う。
+inline void bakeLut(const EnvelopeData &envData, EnvelopeLutManager::Lut &lut,
+                    float durationMs) {
+  lut.table.size = LutCompiler::compile(envData, durationMs, lut.table.pos,
+                                        lut.table.value);
+  lut.durationMs = durationMs;
+}
+
+/// EnvelopeData を折れ線 LUT にコンパイルして EnvelopeLutManager に
+/// 焼き込むユーティリティ。BoomBabyAudioProcessorEditor のメンバー関数を
+/// 分割した複数の翻訳単位から呼び出せるよう inline free function として
+/// 提供する。期間とテーブルは 1 回の公開で同時に切り替わる。
+/// 公開後の LUT 世代を返す。
+inline std::uint64_t bakeLut(const EnvelopeData &envData,
+                             EnvelopeLutManager &lut, float durationMs) {
+  return lut.update([&](EnvelopeLutManager::Lut &dst) {
+    bakeLut(envData, dst, durationMs);
+  });
+}
+
+/// バンクの 1 本だけを焼き直して公開する（他の slot はそのまま）。
+template <std::size_t N>
+std::uint64_t bakeLut(const EnvelopeData &envData,
+                      EnvelopeLutManager::Bank<N> &bank, std::size_t slot,
+                      float durationMs) {
+  return bank.update([&](typename EnvelopeLutManager::Bank<N>::Luts &luts) {
+    bakeLut(envData, luts[slot], durationMs);
+  });
+}
+
+/// バンクの全 slot を各エンベロープの実効区間（effectiveLutDuration）で
+/// 焼き、1 組として公開する。envs は slot 順に並べること。
+/// 公開後のバンク世代を返す。
+template <std::size_t N>
+std::uint64_t bakeLutBank(EnvelopeLutManager::Bank<N> &bank,
+                          const std::array<const EnvelopeData *, N> &envs,
+                          float fallbackMs) {
+  return bank.update([&](typename EnvelopeLutManager::Bank<N>::Luts &luts) {
+    for (std::size_t i = 0; i < N; ++i)
+      bakeLut(*envs[i], luts[i], effectiveLutDuration(*envs[i], fallbackMs));
+  });
 }
@@ -1,6 +1,15 @@
 #include "MasterFader.h"
+#include "InfoBoxText.h"
 #include "UIConstants.h"
 
+namespace {
+/// 天井メニューの選択肢（dB）
+constexpr std::array kCeilingChoicesDb = {0.0f,  -0.1f, -0.3f, -0.5f,
+                                          -1.0f, -2.0f, -3.0f, -6.0f};
+/// これより浅いリダクションは表示しない（dB）
+constexpr float kReductionShowDb = -0.1f;
+} // namespace
+
 // ────────────────────────────────────────────────────
 // コンストラクタ
 // ────────────────────────────────────────────────────
@@ -12,6 +21,29 @@ MasterFader::MasterFader() {
   label.setJustificationType(juce::Justification::centred);
   addAndMakeVisible(label);
 
+  // ── リミッター トグル ──
+  limiterButton.setClickingTogglesState(true);
+  limiterButton.setLookAndFeel(&limiterButtonLAF_);
+  limiterButton.setColour(juce::TextButton::textColourOffId,
+                          UIConstants::Colours::labelText);
+  limiterButton.setColour(juce::TextButton::textColourOnId,
+                          juce::Colours::white);
+  limiterButton.onClick = [this] {
+    if (onLimiterChanged)
+      onLimiterChanged(limiterButton.getToggleState());
+  };
+  limiterButton.getProperties().set("info", InfoText::masterLimiter);
+  addAndMakeVisible(limiterButton);
+
+  // ── 天井 / True Peak（クリックでメニュー） ──
+  ceilingButton.setLookAndFeel(&limiterButtonLAF_);
+  ceilingButton.setColour(juce::TextButton::textColourOffId,
+                          UIConstants::Colours::labelText);
+  ceilingButton.onClick = [this] { showCeilingMenu(); };
+  ceilingButton.getProperties().set("info", InfoText::masterCeiling);
+  updateCeilingButton();
+  addAndMakeVisible(ceilingButton);
+
   // ── フェーダー ──
   fader.setSliderStyle(juce::Slider::LinearHorizontal);
   fader.setTextBoxStyle(juce::Slider::NoTextBox, true, 0, 0);
@@ -54,7 +86,11 @@ MasterFader::MasterFader() {
   startTimerHz(timerHz);
 }
 
-MasterFader::~MasterFader() { stopTimer(); }
+MasterFader::~MasterFader() {
+  stopTimer();
+  limiterButton.setLookAndFeel(nullptr);
+  ceilingButton.setLookAndFeel(nullptr);
+}
 
 // ────────────────────────────────────────────────────
 // API
@@ -67,6 +103,68 @@ void MasterFader::setLevelProvider(int ch, std::function<float()> provider) {
   levelProvider[static_cast<std::size_t>(ch & 1)] = std::move(provider);
 }
 
+void MasterFader::setReadoutProvider(std::function<Readout()> provider) {
+  readoutProvider = std::move(provider);
+}
+
+void MasterFader::setOnLimiterChanged(std::function<void(bool)> cb) {
+  onLimiterChanged = std::move(cb);
+}
+
+void MasterFader::setLimiterState(bool on) {
+  limiterButton.setToggleState(on, juce::dontSendNotification);
+}
+
+void MasterFader::setOnLimiterSettingsChanged(
+    std::function<void(float, bool)> cb) {
+  onLimiterSettingsChanged = std::move(cb);
+}
+
+void MasterFader::setLimiterSettings(float ceilingDb, bool truePeak) {
+  if (ceilingDb == ceilingDb_ && truePeak == truePeak_)
+    return;
+  ceilingDb_ = ceilingDb;
+  truePeak_ = truePeak;
+  updateCeilingButton();
+}
+
+// ────────────────────────────────────────────────────
+// 天井メニュー
+// ────────────────────────────────────────────────────
+void MasterFader::updateCeilingButton() {
+  const auto text = juce::String(ceilingDb_, 1) + (truePeak_ ? "TP" : "");
+  ceilingButton.setButtonText(text);
+  ceilingButton.setTooltip("Limiter ceiling " + juce::String(ceilingDb_, 1) +
+                           (truePeak_ ? " dBTP" : " dBFS"));
+}
+
+void MasterFader::showCeilingMenu() {
+  juce::PopupMenu menu;
+  for (std::size_t i = 0; i < kCeilingChoicesDb.size(); ++i) {
+    const float db = kCeilingChoicesDb[i];
+    menu.addItem(static_cast<int>(i) + 1, juce::String(db, 1) + " dB", true,
+                 std::abs(db - ceilingDb_) < 0.05f);
+  }
+  menu.addSeparator();
+  constexpr int truePeakId = 100;
+  menu.addItem(truePeakId, "True Peak", true, truePeak_);
+
+  menu.showMenuAsync(
+      juce::PopupMenu::Options().withTargetComponent(&ceilingButton),
+      [this](int result) {
+        if (result == truePeakId)
+          truePeak_ = !truePeak_;
+        else if (result >= 1 &&
+                 result <= static_cast<int>(kCeilingChoicesDb.size()))
+          ceilingDb_ = kCeilingChoicesDb[static_cast<std::size_t>(result - 1)];
+        else
+          return;
+        updateCeilingButton();
+        if (onLimiterSettingsChanged)
+          onLimiterSettingsChanged(ceilingDb_, truePeak_);
+      });
+}
+
 // ────────────────────────────────────────────────────
 // gainEditor ヘルパー
 // ────────────────────────────────────────────────────
@@ -102,6 +200,7 @@ void MasterFader::mouseDown(const juce::MouseEvent &e) {
       m.peakHoldFrames = 0;
       m.peakFallVelocity = 0.0f;
     }
+    truePeakHoldDb = minDb;
     repaint();
   }
 }
@@ -132,6 +231,11 @@ void MasterFader::timerCallback() {
       }
     }
   }
+  if (readoutProvider) {
+    readout = readoutProvider();
+    truePeakHoldDb = juce::jmax(truePeakHoldDb, readout.truePeakDb);
+    anyActive = true;
+  }
   if (anyActive) {
     repaint();
   }
@@ -233,13 +337,17 @@ void MasterFader::paint(juce::Graphics &g) {
         maxDb, 0.0f, 1.0f);
     const float thumbX = meterArea.getX() + meterArea.getWidth() * faderNorm;
 
-    // L/R のピーク最大値
+    // L/R のピーク最大値（True Peak があればそちらを表示）
     float maxPeak = minDb;
     for (const auto &m : meter)
       maxPeak = juce::jmax(maxPeak, m.peakDb);
+    const bool showTruePeak = static_cast<bool>(readoutProvider);
+    if (showTruePeak)
+      maxPeak = truePeakHoldDb;
 
     if (maxPeak > minDb) {
-      const juce::String peakText = juce::String(maxPeak, 1) + "dB";
+      const juce::String peakText =
+          juce::String(maxPeak, 1) + (showTruePeak ? "dBTP" : "dB");
       static constexpr float peakTextW = 56.0f;
       const float minX = meterArea.getX();
       const float maxX = static_cast<float>(getWidth()) - 4.0f - peakTextW;
@@ -252,6 +360,16 @@ void MasterFader::paint(juce::Graphics &g) {
       g.drawText(peakText, textBounds, juce::Justification::centred, false);
     }
 
+    // ── リミッターのゲインリダクション（出力レベル行の左端） ──
+    if (limiterButton.getToggleState() &&
+        readout.reductionDb < kReductionShowDb) {
+      g.setFont(juce::Font(juce::FontOptions(UIConstants::fontSizeSmall)));
+      g.setColour(UIConstants::Colours::soloOn);
+      g.drawText("GR " + juce::String(readout.reductionDb, 1),
+                 peakTextRow.withX(meterArea.getX()).withWidth(48.0f),
+                 juce::Justification::centredLeft, false);
+    }
+
     // ── ▲インジケーター（triRow 内） ──
     const float triTop = triRow.getY() + 1.0f;
     const float triH = triRow.getHeight() - 2.0f;
@@ -262,6 +380,16 @@ void MasterFader::paint(juce::Graphics &g) {
     g.setColour(UIConstants::Colours::text);
     g.fillPath(tri);
   }
+
+  // ── Short-term LUFS（ラベル行の右端） ──
+  if (readoutProvider && readout.shortTermLufs > minDb) {
+    const auto lufsRow =
+        getLocalBounds().removeFromTop(labelHeight).reduced(4, 0).toFloat();
+    g.setFont(juce::Font(juce::FontOptions(UIConstants::fontSizeSmall)));
+    g.setColour(UIConstants::Colours::labelText);
+    g.drawText(juce::String(readout.shortTermLufs, 1) + " LUFS", lufsRow,
+               juce::Justification::centredRight, false);
+  }
 }
 
 // ────────────────────────────────────────────────────
@@ -269,7 +397,12 @@ void MasterFader::paint(juce::Graphics &g) {
 // ────────────────────────────────────────────────────
 void MasterFader::resized() {
   auto area = getLocalBounds();
-  label.setBounds(area.removeFromTop(labelHeight));
+  auto labelRow = area.removeFromTop(labelHeight);
+  limiterButton.setBounds(
+      labelRow.removeFromLeft(limiterButtonWidth).reduced(1, 1));
+  ceilingButton.setBounds(
+      labelRow.removeFromLeft(ceilingButtonWidth).reduced(1, 1));
+  label.setBounds(labelRow.withTrimmedRight(limiterButtonWidth));
   // gainClickArea を paint() と同じ計算で保存
   static constexpr int peakTextSpace = 14;
   static constexpr int triSpace = 9;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "CustomSliderLAF.h"
+#include "UIConstants.h"
 #include <array>
 #include <functional>
 #include <juce_gui_basics/juce_gui_basics.h>
@@ -9,9 +10,11 @@
 // MasterFader
 //   出力マスターゲイン用横向きフェーダーコンポーネント。
 //   "MASTER" ラベル + 横向きレベルメーターバー + フェーダーサムを内包。
+//   ラベル行左端にリミッター ON/OFF（LIM）トグルと、天井 / True Peak を
+//   選ぶボタンを持つ。リミット中はゲインリダクションを表示する。
 //
 //   レイアウト (resized 内部で完結):
-//     [ MASTER ラベル                ]
+//     [ LIM | 天井 | MASTER ラベル   ]
 //     [ ═════════ メーターバー + サム ═══ ]
 // ────────────────────────────────────────────────────────────────
 class MasterFader : public juce::Component, private juce::Timer {
@@ -29,6 +32,27 @@ public:
   /// L/Rレベルメーター用プロバイダーを登録する (0=L, 1=R)
   void setLevelProvider(int ch, std::function<float()> provider);
 
+  /// True Peak / ラウドネス表示用の読み出し値
+  struct Readout {
+    float truePeakDb;         ///< L/R の大きい方
+    float shortTermLufs;      ///< Short-term（3s）
+    float reductionDb = 0.0f; ///< リミッターの最大ゲインリダクション（0 以下）
+  };
+  /// True Peak / LUFS 表示用プロバイダーを登録する（未登録時はピーク表示）
+  void setReadoutProvider(std::function<Readout()> provider);
+
+  /// リミッター ON/OFF 変更時のコールバックを登録する
+  void setOnLimiterChanged(std::function<void(bool)> cb);
+
+  /// リミッター トグルを外部から更新（通知なし）
+  void setLimiterState(bool on);
+
+  /// 天井（dB）/ True Peak 変更時のコールバックを登録する
+  void setOnLimiterSettingsChanged(std::function<void(float, bool)> cb);
+
+  /// 天井（dB）/ True Peak を外部から更新（通知なし）
+  void setLimiterSettings(float ceilingDb, bool truePeak);
+
   /// 現在値を dB で取得
   float getValueDb() const { return static_cast<float>(fader.getValue()); }
 
@@ -39,15 +63,28 @@ public:
   static constexpr float minDb = -60.0f;
   static constexpr float maxDb = 12.0f;
   static constexpr int labelHeight = 16;
+  static constexpr int limiterButtonWidth = 30;
+  static constexpr int ceilingButtonWidth = 44;
 
 private:
   void timerCallback() override;
   void showGainEditor();
   void commitGainEditor();
+  void showCeilingMenu();
+  void updateCeilingButton();
 
   std::function<void(float)> onValueChange;
   std::array<std::function<float()>, 2> levelProvider;
+  std::function<Readout()> readoutProvider;
+  std::function<void(bool)> onLimiterChanged;
+  std::function<void(float, bool)> onLimiterSettingsChanged;
 
+  UIConstants::GradientButtonLAF limiterButtonLAF_{
+      UIConstants::Colours::muteOff, UIConstants::Colours::soloOn};
+  juce::TextButton limiterButton{"LIM"};
+  juce::TextButton ceilingButton;
+  float ceilingDb_{-1.0f};
+  bool truePeak_{true};
   juce::Label label;
   CustomSlider fader;
   juce::TextEditor gainEditor_;
@@ -61,6 +98,8 @@ private:
     float peakFallVelocity{0.0f};
   };
   std::array<MeterState, 2> meter;
+  Readout readout{minDb, -100.0f};
+  float truePeakHoldDb{minDb}; ///< True Peak 最大値（クリックでリセット）
 
   static constexpr int timerHz = 30;
   static constexpr int peakHoldFrames_ = timerHz * 1;
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "../DSP/PeakDecimator.h"
+#include <algorithm>
+#include <vector>
+
+// ────────────────────────────────────────────────────────────────
+// PeakColumnRing
+//   リアルタイム入力波形のピクセル列リング（UI スレッド専用）。
+//   PeakDecimator のビンを binsPerColumn 個ずつ束ねて 1 列とし、
+//   固定容量のリングへ積む。binsPerColumn は小数でよく、列の幅を
+//   切り捨て / 切り上げで交互に変えて平均を合わせる（表示の時間幅が
+//   丸めでずれない）。確保はコンストラクタの 1 回のみ。
+// ────────────────────────────────────────────────────────────────
+class PeakColumnRing {
+public:
+  using MinMax = PeakDecimator::MinMax;
+  static constexpr int kMaxColumns = 4096;
+
+  PeakColumnRing() : cols_(static_cast<std::size_t>(kMaxColumns)) {}
+
+  /// 表示列数と 1 列あたりのビン数を設定。どちらかが変われば履歴を破棄する。
+  void configure(int numColumns, double binsPerColumn) noexcept {
+    numColumns = std::clamp(numColumns, 1, kMaxColumns);
+    binsPerColumn = std::max(1.0, binsPerColumn);
+    if (numColumns == numColumns_ && binsPerColumn == binsPerColumn_)
+      return;
+    numColumns_ = numColumns;
+    binsPerColumn_ = binsPerColumn;
+    clear();
+  }
+
+  void clear() noexcept {
+    ++generation_;
+    pos_ = 0;
+    filled_ = 0;
+    pendingBins_ = 0;
+    pending_ = {};
+    binsSeen_ = 0;
+    columnEnd_ = binsPerColumn_;
+  }
+
+  /// ビンを 1 つ取り込む。列が揃ったらリングへ確定する。
+  void pushBin(MinMax bin) noexcept {
+    if (pendingBins_ == 0) {
+      pending_ = bin;
+    } else {
+      pending_.min = std::min(pending_.min, bin.min);
+      pending_.max = std::max(pending_.max, bin.max);
+    }
+    ++pendingBins_;
+    if (static_cast<double>(++binsSeen_) < columnEnd_)
+      return;
+    columnEnd_ += binsPerColumn_;
+    cols_[static_cast<std::size_t>(pos_)] = pending_;
+    pos_ = (pos_ + 1) % numColumns_;
+    filled_ = std::min(filled_ + 1, numColumns_);
+    ++totalColumns_;
+    pendingBins_ = 0;
+  }
+
+  [[nodiscard]] int numColumns() const noexcept { return numColumns_; }
+  [[nodiscard]] int filled() const noexcept { return filled_; }
+  /// clear() 毎に増える（履歴の破棄を利用側が検出する用）
+  [[nodiscard]] int generation() const noexcept { return generation_; }
+  /// 確定した列の累計（利用側は差分で新着列数を得る）
+  [[nodiscard]] long long totalColumns() const noexcept {
+    return totalColumns_;
+  }
+
+  /// 右詰めで i 列目（0 = 左端）の値。未充填の列は {0, 0}。
+  [[nodiscard]] MinMax column(int i) const noexcept {
+    const int age = numColumns_ - 1 - i; // 0 = 最新
+    if (age < 0 || age >= filled_)
+      return {};
+    const int idx = (pos_ - 1 - age + numColumns_) % numColumns_;
+    return cols_[static_cast<std::size_t>(idx)];
+  }
+
+private:
+  std::vector<MinMax> cols_;
+  int numColumns_ = 1;
+  double binsPerColumn_ = 1.0;
+  int pos_ = 0;    ///< 次の書き込み位置
+  int filled_ = 0; ///< 確定済み列数
+  MinMax pending_{};
+  int pendingBins_ = 0;
+  long long binsSeen_ = 0; ///< clear() 以降に取り込んだビン数
+  double columnEnd_ = 1.0; ///< 今の列を確定する binsSeen_
+  int generation_ = 0;
+  long long totalColumns_ = 0;
+};
@@ -74,6 +74,7 @@ private:
   juce::TextButton nextButton_{juce::String::charToString(0x25B6)};
   juce::TextButton saveButton_{"Save"};
   juce::Label nameLabel_;
+  std::unique_ptr<juce::FileChooser> fileChooser_;
 
   void showPresetMenu() {
     juce::PopupMenu menu;
@@ -82,8 +83,7 @@ private:
     if (!factoryPresets.isEmpty()) {
       juce::PopupMenu factorySub;
       for (int i = 0; i < factoryPresets.size(); ++i)
-        factorySub.addItem(1000 + i,
-                           factoryPresets[i].getFileNameWithoutExtension());
+        factorySub.addItem(1000 + i, factoryPresets[i]);
       menu.addSubMenu("Factory", factorySub);
       menu.addSeparator();
     }
@@ -97,6 +97,10 @@ private:
     if (menu.getNumItems() == 0)
       menu.addItem(-1, "(No presets)", false, false);
 
+    menu.addSeparator();
+    menu.addItem(1, "Import...");
+    menu.addItem(2, "Export...");
+
     menu.showMenuAsync(
         juce::PopupMenu::Options().withTargetComponent(&nameLabel_),
         [this, factoryPresets, userPresets](int result) {
@@ -104,12 +108,46 @@ private:
             presetManager_.loadPreset(userPresets[result - 2000]);
             refreshPresetName();
           } else if (result >= 1000 && result - 1000 < factoryPresets.size()) {
-            presetManager_.loadPreset(factoryPresets[result - 1000]);
+            presetManager_.loadFactoryPreset(factoryPresets[result - 1000]);
             refreshPresetName();
+          } else if (result == 1) {
+            onImportClicked();
+          } else if (result == 2) {
+            onExportClicked();
           }
         });
   }
 
+  /// 自己完結の .bbpreset フォルダを User プリセットに取り込む
+  void onImportClicked() {
+    fileChooser_ = std::make_unique<juce::FileChooser>(
+        "Import Preset",
+        juce::File::getSpecialLocation(juce::File::userDocumentsDirectory));
+    fileChooser_->launchAsync(
+        juce::FileBrowserComponent::openMode |
+            juce::FileBrowserComponent::canSelectDirectories,
+        [this](const juce::FileChooser &fc) {
+          if (const auto dir = fc.getResult(); dir.isDirectory())
+            presetManager_.importPreset(dir);
+        });
+  }
+
+  /// 現在の状態をサンプル込みの .bbpreset フォルダとして書き出す
+  void onExportClicked() {
+    fileChooser_ = std::make_unique<juce::FileChooser>(
+        "Export Preset",
+        juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+            .getChildFile(presetManager_.getCurrentPresetName() +
+                          ".bbpreset"));
+    fileChooser_->launchAsync(
+        juce::FileBrowserComponent::saveMode |
+            juce::FileBrowserComponent::canSelectFiles,
+        [this](const juce::FileChooser &fc) {
+          if (const auto dest = fc.getResult(); dest != juce::File{})
+            presetManager_.exportPreset(dest.withFileExtension("bbpreset"));
+        });
+  }
+
   void onSaveClicked() {
     // NOSONAR: JUCE の AlertWindow は enterModalState(deleteWhenDismissed)
     // で安全に管理される
@@ -0,0 +1,176 @@
+#include "RealtimeWaveRenderer.h"
+#include "../DSP/Saturator.h"
+#include "WavePaint.h"
+
+#include <cmath>
+
+namespace {
+/// スクロール時に右端から再描画する余白（太いグローの線幅 + マイター分）
+constexpr int kStrokePad = static_cast<int>(WavePaint::kGlowWidth) + 2;
+} // namespace
+
+// ────────────────────────────────────────────────────
+// 列処理
+// ────────────────────────────────────────────────────
+void RealtimeWaveRenderer::setStyle(const Style &style) {
+  if (style == style_ && !styleDirty_)
+    return;
+  style_ = style;
+  styleDirty_ = true;
+  const float sr = style.sampleRate > 0.0f ? style.sampleRate : 44100.0f;
+  filters_[0].setup(style.hpfFreq, style.hpfQ, style.hpfStages, 0, sr);
+  filters_[1].setup(style.hpfFreq, style.hpfQ, style.hpfStages, 0, sr);
+  filters_[2].setup(style.lpfFreq, style.lpfQ, style.lpfStages, 1, sr);
+  filters_[3].setup(style.lpfFreq, style.lpfQ, style.lpfStages, 1, sr);
+}
+
+RealtimeWaveRenderer::MinMax
+RealtimeWaveRenderer::processColumn(MinMax raw) noexcept {
+  // DSP と同じ Saturator → HPF → LPF の順
+  const float mn =
+      Saturator::process(raw.min, style_.driveDb, style_.clipType);
+  const float mx =
+      Saturator::process(raw.max, style_.driveDb, style_.clipType);
+  return {filters_[2].process(filters_[0].process(mn)),
+          filters_[3].process(filters_[1].process(mx))};
+}
+
+void RealtimeWaveRenderer::resetFilters() noexcept {
+  for (auto &f : filters_)
+    f.reset();
+}
+
+void RealtimeWaveRenderer::reprocessAll(const PeakColumnRing &raw) {
+  styleDirty_ = false;
+  rawGeneration_ = raw.generation();
+  rawTotal_ = raw.totalColumns();
+  processed_.configure(raw.numColumns(), 1);
+  processed_.clear();
+  resetFilters();
+  for (int i = raw.numColumns() - raw.filled(); i < raw.numColumns(); ++i)
+    processed_.pushBin(processColumn(raw.column(i)));
+  pendingShift_ = 0;
+  imageDirty_ = true;
+}
+
+bool RealtimeWaveRenderer::update(const PeakColumnRing &raw) {
+  if (styleDirty_ || raw.generation() != rawGeneration_ ||
+      raw.numColumns() != processed_.numColumns()) {
+    reprocessAll(raw);
+    return true;
+  }
+  const long long fresh = raw.totalColumns() - rawTotal_;
+  rawTotal_ = raw.totalColumns();
+  if (fresh <= 0)
+    return false;
+  if (fresh >= raw.numColumns()) {
+    reprocessAll(raw);
+    return true;
+  }
+  // 新着列だけを処理（フィルター状態は前の列から継続）
+  const auto n = static_cast<int>(fresh);
+  for (int i = raw.numColumns() - n; i < raw.numColumns(); ++i)
+    processed_.pushBin(processColumn(raw.column(i)));
+  pendingShift_ += n;
+  return true;
+}
+
+// ────────────────────────────────────────────────────
+// 描画
+// ────────────────────────────────────────────────────
+void RealtimeWaveRenderer::renderColumns(juce::Graphics &g, int firstCol,
+                                         int width, float plotH, float ampMul,
+                                         juce::Colour colour) const {
+  const float centreY = plotH * 0.5f;
+  // 列数と描画幅が異なる場合も右端（最新）を揃える
+  const int offset = width - processed_.numColumns();
+  const auto yOf = [&](float v) {
+    return juce::jlimit(0.0f, plotH, centreY - v * ampMul * centreY);
+  };
+
+  juce::Path fillPath;
+  juce::Path topLine;
+  juce::Path botLine;
+  for (int x = firstCol; x < width; ++x) {
+    const float yTop = yOf(processed_.column(x - offset).max);
+    const auto fx = static_cast<float>(x);
+    if (x == firstCol) {
+      fillPath.startNewSubPath(fx, yTop);
+      topLine.startNewSubPath(fx, yTop);
+    } else {
+      fillPath.lineTo(fx, yTop);
+      topLine.lineTo(fx, yTop);
+    }
+  }
+  for (int x = width - 1; x >= firstCol; --x) {
+    const float yBot = yOf(processed_.column(x - offset).min);
+    const auto fx = static_cast<float>(x);
+    fillPath.lineTo(fx, yBot);
+    if (x == width - 1)
+      botLine.startNewSubPath(fx, yBot);
+    else
+      botLine.lineTo(fx, yBot);
+  }
+  fillPath.closeSubPath();
+  WavePaint::directBand(g, fillPath, topLine, botLine, colour, plotH);
+}
+
+void RealtimeWaveRenderer::draw(juce::Graphics &g, int width, int height,
+                                float ampMul, juce::Colour colour) {
+  if (width <= 0 || height <= 0)
+    return;
+  const auto plotH = static_cast<float>(height);
+
+  // 他のレイヤーキャッシュ（EnvelopeCurveEditor の renderLayer）と同じく
+  // 物理ピクセルで持ち、論理座標で描いて等倍に戻して転写する
+  const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+  const int pw =
+      std::max(1, juce::roundToInt(static_cast<float>(width) * scale));
+  const int ph =
+      std::max(1, juce::roundToInt(static_cast<float>(height) * scale));
+  const float sx = static_cast<float>(pw) / static_cast<float>(width);
+  const auto transform = juce::AffineTransform::scale(
+      sx, static_cast<float>(ph) / static_cast<float>(height));
+
+  if (image_.isNull() || image_.getWidth() != pw ||
+      image_.getHeight() != ph) {
+    image_ = juce::Image(juce::Image::ARGB, pw, ph, true);
+    imageDirty_ = true;
+  }
+  if (ampMul != imageAmpMul_ || colour != imageColour_)
+    imageDirty_ = true;
+
+  // スクロール量が物理ピクセルで割り切れない倍率（1.5 倍等）は全再描画
+  const int shift = std::min(pendingShift_, width);
+  const float physShift = static_cast<float>(shift) * sx;
+  if (physShift != std::round(physShift))
+    imageDirty_ = true;
+
+  if (imageDirty_) {
+    image_.clear(image_.getBounds());
+    juce::Graphics ig(image_);
+    ig.addTransform(transform);
+    renderColumns(ig, 0, width, plotH, ampMul, colour);
+  } else if (shift > 0) {
+    // 既存の列を左へずらし、右端（新着列 + 線幅ぶん）だけ描き直す
+    const int pshift = juce::roundToInt(physShift);
+    image_.moveImageSection(0, 0, pshift, 0, pw - pshift, ph);
+    const int redrawFrom = std::max(0, width - shift - kStrokePad);
+    const int physFrom = static_cast<int>(static_cast<float>(redrawFrom) * sx);
+    const juce::Rectangle<int> dirty{physFrom, 0, pw - physFrom, ph};
+    image_.clear(dirty);
+    juce::Graphics ig(image_);
+    ig.reduceClipRegion(dirty); // 物理ピクセルで切ってから倍率を掛ける
+    ig.addTransform(transform);
+    renderColumns(ig, std::max(0, redrawFrom - kStrokePad), width, plotH,
+                  ampMul, colour);
+  }
+  imageAmpMul_ = ampMul;
+  imageColour_ = colour;
+  imageDirty_ = false;
+  pendingShift_ = 0;
+
+  g.drawImage(image_, juce::Rectangle<float>(0.0f, 0.0f,
+                                             static_cast<float>(width),
+                                             plotH));
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "PeakColumnRing.h"
+#include "WaveformUtils.h"
+#include <juce_gui_basics/juce_gui_basics.h>
+
+// ────────────────────────────────────────────────────────────────
+// RealtimeWaveRenderer
+//   Direct パススルー時のリアルタイム入力波形を offscreen Image に保持し、
+//   新着列ぶんだけ左へスクロールして右端を描き足す（UI スレッド専用）。
+//
+//   - update(): 生の列リングから新着列を Drive/Clip → HPF → LPF で処理
+//   - draw():   Image をスクロール + 右端のみ再描画して転写
+//   Style / サイズ / 振幅倍率が変わったときだけ全列を再処理・全再描画する。
+// ────────────────────────────────────────────────────────────────
+class RealtimeWaveRenderer {
+public:
+  using MinMax = PeakColumnRing::MinMax;
+
+  /// 列処理の設定（Direct の Drive / Clip / HPF / LPF）。stages = 0 で OFF。
+  struct Style {
+    float driveDb = 0.0f;
+    int clipType = 0;
+    float hpfFreq = 20.0f;
+    float hpfQ = 0.707f;
+    int hpfStages = 0;
+    float lpfFreq = 20000.0f;
+    float lpfQ = 0.707f;
+    int lpfStages = 0;
+    float sampleRate = 44100.0f;
+    bool operator==(const Style &) const = default;
+  };
+
+  /// 設定を反映。変化していれば次の update() で全列を再処理する。
+  void setStyle(const Style &style);
+
+  /// 生の列リングから新着列を取り込む。表示が変わったら true。
+  bool update(const PeakColumnRing &raw);
+
+  /// 処理済み列（右詰め、0 = 左端）。振幅エンベロープ付きの描画用。
+  [[nodiscard]] MinMax column(int i) const noexcept {
+    return processed_.column(i);
+  }
+  [[nodiscard]] bool empty() const noexcept { return processed_.filled() == 0; }
+
+  /// 一定の振幅倍率 ampMul で (0, 0) から width × height に描画する。
+  /// Image は g の物理ピクセル倍率で持つ（Retina でもぼやけない）。
+  void draw(juce::Graphics &g, int width, int height, float ampMul,
+            juce::Colour colour);
+
+private:
+  MinMax processColumn(MinMax raw) noexcept;
+  void resetFilters() noexcept;
+  void reprocessAll(const PeakColumnRing &raw);
+  /// 列 [firstCol, width) の波形を描く（clip は呼び出し側で設定）
+  void renderColumns(juce::Graphics &g, int firstCol, int width, float plotH,
+                     float ampMul, juce::Colour colour) const;
+
+  Style style_;
+  bool styleDirty_ = true;
+  std::array<SvfPassUtils::SvfCascade, 4> filters_; ///< HP(min,max) LP(min,max)
+
+  PeakColumnRing processed_; ///< 処理済み列（binsPerColumn = 1）
+  int rawGeneration_ = -1;
+  long long rawTotal_ = 0;
+
+  juce::Image image_;
+  float imageAmpMul_ = 0.0f;
+  juce::Colour imageColour_;
+  int pendingShift_ = 0; ///< 前回 draw 以降に増えた列数
+  bool imageDirty_ = true;
+};
@@ -51,14 +51,9 @@ void BoomBabyAudioProcessorEditor::setupLengthBox() {
     updateDisplayDuration();
     processorRef.subEngine().setLengthMs(v);
     // Sub LUT: エンベロープ実効区間に 512 点を集中させる
-    bakeLut(envDatas.amp, processorRef.subEngine().envLut(),
-            effectiveLutDuration(envDatas.amp, v));
-    bakeLut(envDatas.freq, processorRef.subEngine().freqLut(),
-            effectiveLutDuration(envDatas.freq, v));
-    bakeLut(envDatas.dist, processorRef.subEngine().distLut(),
-            effectiveLutDuration(envDatas.dist, v));
-    bakeLut(envDatas.mix, processorRef.subEngine().mixLut(),
-            effectiveLutDuration(envDatas.mix, v));
+    bakeLutBank(processorRef.subEngine().luts(),
+                {&envDatas.amp, &envDatas.freq, &envDatas.dist, &envDatas.mix},
+                v);
   };
   // Click/Direct Decay の初期 LUT ベイク
   const auto initLen =
@@ -123,18 +118,18 @@ void BoomBabyAudioProcessorEditor::setupSubKnobsRow() {
       envDatas.freq.setPointValue(0, hz);
     saveEnvelopesToState();
     syncParam(ParamIDs::subFreq, hz, true);
-    bakeLut(envDatas.freq, processorRef.subEngine().freqLut(),
-            envelopeCurveEditor.getDisplayDurationMs());
+    bakeLut(envDatas.freq, processorRef.subEngine().luts(),
+            SubEngine::kFreqLut, envelopeCurveEditor.getDisplayDurationMs());
     const float cycles =
         hz * envelopeCurveEditor.getDisplayDurationMs() / 1000.0f;
     envelopeCurveEditor.setDisplayCycles(cycles);
-    envelopeCurveEditor.repaint();
+    envelopeCurveEditor.invalidatePreviews();
   };
   constexpr float initHz = 200.0f;
   envelopeCurveEditor.setDisplayCycles(
       initHz * envelopeCurveEditor.getDisplayDurationMs() / 1000.0f);
-  bakeLut(envDatas.freq, processorRef.subEngine().freqLut(),
-          envelopeCurveEditor.getDisplayDurationMs());
+  bakeLut(envDatas.freq, processorRef.subEngine().luts(),
+          SubEngine::kFreqLut, envelopeCurveEditor.getDisplayDurationMs());
   envDatas.freq.addPoint(0.0f, initHz);
 
   // ── Amp ノブ（subUI.knobs[0]） ──
@@ -158,9 +153,9 @@ void BoomBabyAudioProcessorEditor::setupSubKnobsRow() {
     saveEnvelopesToState();
     syncParam(ParamIDs::subAmp, static_cast<float>(subUI.knobs[0].getValue()),
               true);
-    bakeLut(envDatas.amp, processorRef.subEngine().envLut(),
-            envelopeCurveEditor.getDisplayDurationMs());
-    envelopeCurveEditor.repaint();
+    bakeLut(envDatas.amp, processorRef.subEngine().luts(),
+            SubEngine::kAmpLut, envelopeCurveEditor.getDisplayDurationMs());
+    envelopeCurveEditor.invalidatePreviews();
   };
   envDatas.amp.addPoint(0.0f, envDatas.amp.getDefaultValue());
   {
@@ -190,13 +185,13 @@ void BoomBabyAudioProcessorEditor::setupSubKnobsRow() {
     saveEnvelopesToState();
     syncParam(ParamIDs::subMix, static_cast<float>(subUI.knobs[2].getValue()),
               true);
-    bakeLut(envDatas.mix, processorRef.subEngine().mixLut(),
-            envelopeCurveEditor.getDisplayDurationMs());
+    bakeLut(envDatas.mix, processorRef.subEngine().luts(),
+            SubEngine::kMixLut, envelopeCurveEditor.getDisplayDurationMs());
     envelopeCurveEditor.setPreviewMix(v);
   };
   envDatas.mix.setDefaultValue(0.0f);
-  bakeLut(envDatas.mix, processorRef.subEngine().mixLut(),
-          envelopeCurveEditor.getDisplayDurationMs());
+  bakeLut(envDatas.mix, processorRef.subEngine().luts(),
+          SubEngine::kMixLut, envelopeCurveEditor.getDisplayDurationMs());
   envDatas.mix.addPoint(0.0f, 0.0f);
 
   // ── Saturate ノブ（subUI.knobs[3]） ──
@@ -219,13 +214,13 @@ void BoomBabyAudioProcessorEditor::setupSubKnobsRow() {
     saveEnvelopesToState();
     syncParam(ParamIDs::subSatDrive,
               static_cast<float>(subUI.knobs[3].getValue()), true);
-    bakeLut(envDatas.dist, processorRef.subEngine().distLut(),
-            envelopeCurveEditor.getDisplayDurationMs());
-    envelopeCurveEditor.repaint();
+    bakeLut(envDatas.dist, processorRef.subEngine().luts(),
+            SubEngine::kDistLut, envelopeCurveEditor.getDisplayDurationMs());
+    envelopeCurveEditor.invalidatePreviews();
   };
   envDatas.dist.setDefaultValue(0.0f);
-  bakeLut(envDatas.dist, processorRef.subEngine().distLut(),
-          envelopeCurveEditor.getDisplayDurationMs());
+  bakeLut(envDatas.dist, processorRef.subEngine().luts(),
+          SubEngine::kDistLut, envelopeCurveEditor.getDisplayDurationMs());
   envDatas.dist.addPoint(0.0f, 0.0f);
 
   // ClipType セレクター（Soft / Hard / Tube）— Saturate ノブ上部ラベルを兼ねる
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+// ────────────────────────────────────────────────────────────────
+// WavePaint
+//   min/max 波形の塗り + 輪郭グローの描き方（ヘッダオンリー）。
+//   Direct のサンプルプレビュー（EnvelopeCurveEditor の PaintHelper）と
+//   リアルタイム入力（RealtimeWaveRenderer）で同じ見た目にするため共用する。
+// ────────────────────────────────────────────────────────────────
+namespace WavePaint {
+
+/// いちばん太いグロー線の幅（部分再描画の余白計算にも使う）
+inline constexpr float kGlowWidth = 6.0f;
+
+/// fill を上（不透明寄り）→ plotH（透明寄り）のグラデーションで塗り、
+/// top / bottom の輪郭線を外側から 3 層のグローで描く。
+inline void directBand(juce::Graphics &g, const juce::Path &fill,
+                       const juce::Path &top, const juce::Path &bottom,
+                       juce::Colour colour, float plotH) {
+  g.setGradientFill(juce::ColourGradient(colour.withAlpha(0.25f), 0.0f, 0.0f,
+                                         colour.withAlpha(0.03f), 0.0f, plotH,
+                                         false));
+  g.fillPath(fill);
+
+  for (const auto *line : {&top, &bottom}) {
+    g.setColour(colour.withAlpha(0.07f));
+    g.strokePath(*line, juce::PathStrokeType(kGlowWidth));
+    g.setColour(colour.withAlpha(0.30f));
+    g.strokePath(*line, juce::PathStrokeType(3.5f));
+    g.setColour(colour.withAlpha(0.90f));
+    g.strokePath(*line, juce::PathStrokeType(1.2f));
+  }
+}
+
+} // namespace WavePaint
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cmath>
 #include <juce_core/juce_core.h>
 #include <utility>
@@ -12,6 +13,10 @@
 // ────────────────────────────────────────────────────────────────
 namespace WaveformUtils {
 
+/// プレビューに必要なビン数。PeakPyramid::levelFor() でこれ以上の
+/// 最も粗いレベルを選ぶ
+inline constexpr int kPreviewMinBins = 512;
+
 /// 時刻 timeSec における波形サムネイルの振幅 (min, max) を
 /// A → Hold → R エンベロープでスケールして返す。
 /// 範囲外または durSec <= 0 の場合は {0, 0} を返す。
@@ -113,6 +118,56 @@ inline void applySvfPass(std::vector<float> &data, float cutoffHz, float q,
   }
 }
 
+/// スロープ（dB/oct）→ カスケード段数（12:1, 24:2, 48:4）
+inline int stagesForSlope(int slope) noexcept {
+  if (slope >= 48)
+    return 4;
+  if (slope >= 24)
+    return 2;
+  return 1;
+}
+
+/// applySvfPass のストリーミング版（1 値ずつ、段毎の状態を保持）。
+/// 列を 1 本ずつ追記するリアルタイム表示用。
+class SvfCascade {
+public:
+  static constexpr int kMaxStages = 4;
+
+  /// stages = 0 で素通し。
+  void setup(float cutoffHz, float q, int stages, int type, float sr) noexcept {
+    g_ = std::tan(juce::MathConstants<float>::pi * cutoffHz / sr);
+    const float R = 1.0f / (2.0f * q);
+    a1_ = 1.0f / (1.0f + 2.0f * R * g_ + g_ * g_);
+    a2_ = 2.0f * R + g_;
+    stages_ = juce::jlimit(0, kMaxStages, stages);
+    type_ = type;
+    reset();
+  }
+
+  void reset() noexcept { state_ = {}; }
+
+  float process(float s) noexcept {
+    for (int stg = 0; stg < stages_; ++stg) {
+      auto &[ic1eq, ic2eq] = state_[static_cast<std::size_t>(stg)];
+      const float v3 = s - ic2eq;
+      const float v1 = a1_ * (ic1eq + g_ * v3);
+      const float v2 = ic2eq + g_ * v1;
+      ic1eq = 2.0f * v1 - ic1eq;
+      ic2eq = 2.0f * v2 - ic2eq;
+      s = type_ == 0 ? s - a2_ * v1 - v2 : v2;
+    }
+    return s;
+  }
+
+private:
+  float g_ = 0.0f;
+  float a1_ = 1.0f;
+  float a2_ = 0.0f;
+  int stages_ = 0;
+  int type_ = 0;
+  std::array<std::pair<float, float>, kMaxStages> state_{};
+};
+
 } // namespace SvfPassUtils
 
 // ────────────────────────────────────────────────────────────────
@@ -126,24 +181,14 @@ inline void applyDirectFilters(const auto &hpf, const auto &lpf, float sr,
   if (const auto hpfFreq = static_cast<float>(hpf.slider.getValue());
       hpfFreq > 20.5f) {
     const auto hpfQ = static_cast<float>(hpf.qSlider.getValue());
-    const int hpfSlope = hpf.slope.getSlope();
-    int hpfStages = 1;
-    if (hpfSlope >= 48)
-      hpfStages = 4;
-    else if (hpfSlope >= 24)
-      hpfStages = 2;
+    const int hpfStages = SvfPassUtils::stagesForSlope(hpf.slope.getSlope());
     SvfPassUtils::applySvfPass(vecMin, hpfFreq, hpfQ, hpfStages, 0, sr);
     SvfPassUtils::applySvfPass(vecMax, hpfFreq, hpfQ, hpfStages, 0, sr);
   }
   if (const auto lpfFreq = static_cast<float>(lpf.slider.getValue());
       lpfFreq < 19999.5f) {
     const auto lpfQ = static_cast<float>(lpf.qSlider.getValue());
-    const int lpfSlope = lpf.slope.getSlope();
-    int lpfStages = 1;
-    if (lpfSlope >= 48)
-      lpfStages = 4;
-    else if (lpfSlope >= 24)
-      lpfStages = 2;
+    const int lpfStages = SvfPassUtils::stagesForSlope(lpf.slope.getSlope());
     SvfPassUtils::applySvfPass(vecMin, lpfFreq, lpfQ, lpfStages, 1, sr);
     SvfPassUtils::applySvfPass(vecMax, lpfFreq, lpfQ, lpfStages, 1, sr);
   }
@@ -57,11 +57,27 @@ inline constexpr const char *directLpfQ = "direct_lpf_q";
 inline constexpr const char *directLpfSlope = "direct_lpf_slope";
 inline constexpr const char *directThreshold = "direct_threshold";
 inline constexpr const char *directHold = "direct_hold";
+inline constexpr const char *directLookahead = "direct_lookahead";
+inline constexpr const char *directDetectBand = "direct_detect_band";
 inline constexpr const char *directGain = "direct_gain";
 inline constexpr const char *directMute = "direct_mute";
 inline constexpr const char *directSolo = "direct_solo";
 
 // ── Master ──
 inline constexpr const char *masterGain = "master_gain";
+inline constexpr const char *masterLimiter = "master_limiter";
+inline constexpr const char *masterCeiling = "master_ceiling";
+inline constexpr const char *masterTruePeak = "master_true_peak";
 
 } // namespace ParamIDs
+
+// ── パラメータ範囲 ──
+// レイアウトと UI、範囲に依存する DSP（SampleTrim の届く範囲）で共有する。
+namespace ParamRanges {
+
+// Click Sample / Direct 共通の Pitch（±半音）と Decay（ms）
+inline constexpr float samplePitchMaxSt = 24.0f;
+inline constexpr float sampleDecayMinMs = 10.0f;
+inline constexpr float sampleDecayMaxMs = 2000.0f;
+
+} // namespace ParamRanges
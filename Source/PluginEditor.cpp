@@ -1,12 +1,12 @@
 #include "PluginEditor.h"
-#include "DSP/Saturator.h"
 #include "GUI/ClickModeStateUtils.h"
 #include "GUI/InfoBoxText.h"
 #include "GUI/LutBaker.h"
 #include "GUI/WaveformUtils.h"
 #include "ParamIDs.h"
 #include "PluginProcessor.h"
-#include <span>
+#include "SampleRef.h"
+#include "StateCodec.h"
 
 // ────────────────────────────────────────────────────
 // パネルルーティング（Mute/Solo/レベルメーター）
@@ -49,11 +49,11 @@ void BoomBabyAudioProcessorEditor::setupPanelRouting(
   });
 
   subPanel.setLevelProvider(
-      [&p]() { return p.channelState().getChannelLevelDb(sub); });
+      [&p]() { return p.meters().snapshot().peakDb(MeterEngine::kSub); });
   clickPanel.setLevelProvider(
-      [&p]() { return p.channelState().getChannelLevelDb(click); });
+      [&p]() { return p.meters().snapshot().peakDb(MeterEngine::kClick); });
   directPanel.setLevelProvider(
-      [&p]() { return p.channelState().getChannelLevelDb(direct); });
+      [&p]() { return p.meters().snapshot().peakDb(MeterEngine::kDirect); });
 
   // Sub フェーダー → ゲインコントロール
   subPanel.getFader().onValueChange = [this] {
@@ -101,14 +101,9 @@ void BoomBabyAudioProcessorEditor::onEnvelopeChanged() {
   const auto subLenMs = static_cast<float>(subUI.length.slider.getValue());
   updateDisplayDuration();
   // Sub LUT: エンベロープ実効区間に 512 点を集中させる
-  bakeLut(envDatas.amp, processorRef.subEngine().envLut(),
-          effectiveLutDuration(envDatas.amp, subLenMs));
-  bakeLut(envDatas.freq, processorRef.subEngine().freqLut(),
-          effectiveLutDuration(envDatas.freq, subLenMs));
-  bakeLut(envDatas.dist, processorRef.subEngine().distLut(),
-          effectiveLutDuration(envDatas.dist, subLenMs));
-  bakeLut(envDatas.mix, processorRef.subEngine().mixLut(),
-          effectiveLutDuration(envDatas.mix, subLenMs));
+  bakeLutBank(processorRef.subEngine().luts(),
+              {&envDatas.amp, &envDatas.freq, &envDatas.dist, &envDatas.mix},
+              subLenMs);
   const auto clickDecayMs =
       static_cast<float>(clickUI.sample.decay.slider.getValue());
   bakeLut(envDatas.clickAmp, processorRef.clickEngine().clickAmpLut(),
@@ -121,7 +116,7 @@ void BoomBabyAudioProcessorEditor::onEnvelopeChanged() {
   // 1点=ノブ制御（有効化＋ポイント値をノブに反映）、2点以上=エンベロープ制御（無効化）
 
   // ValueTree を先に保存しておく。syncParam(silent) → parameterChanged →
-  // bakeAllLutsFromState が正しいデータを読めるようにするため。
+  // （非同期の）bakeAllLutsFromState が正しいデータを読めるようにするため。
   saveEnvelopesToState();
 
   // Amp
@@ -270,7 +265,7 @@ bool BoomBabyAudioProcessorEditor::keyPressed(const juce::KeyPress &key) {
                                       envDatas);
       envDatas = frame.snapshot;
       onEnvelopeChanged();
-      envelopeCurveEditor.repaint();
+      envelopeCurveEditor.invalidatePreviews();
       return true;
     } else {
       // Parameter フレーム → 現在値を undo
@@ -293,7 +288,7 @@ bool BoomBabyAudioProcessorEditor::keyPressed(const juce::KeyPress &key) {
                                       envDatas);
       envDatas = frame.snapshot;
       onEnvelopeChanged();
-      envelopeCurveEditor.repaint();
+      envelopeCurveEditor.invalidatePreviews();
       return true;
     } else {
       // Parameter フレーム → 現在値を redo
@@ -368,7 +363,7 @@ BoomBabyAudioProcessorEditor::BoomBabyAudioProcessorEditor(
         std::to_underlying(ClickUI::Mode::Sample))
       refreshClickSampleProvider();
     else
-      envelopeCurveEditor.repaint();
+      envelopeCurveEditor.invalidatePreviews();
   };
   setupDirectParams();
   setupSubKnobsRow();
@@ -381,10 +376,28 @@ BoomBabyAudioProcessorEditor::BoomBabyAudioProcessorEditor(
     syncParam(ParamIDs::masterGain, db);
   });
   masterSection.setLevelProvider(0, [this]() {
-    return processorRef.master().getLevelDb(0); // L
+    return processorRef.meters().snapshot().peakDb(MeterEngine::kMasterL);
   });
   masterSection.setLevelProvider(1, [this]() {
-    return processorRef.master().getLevelDb(1); // R
+    return processorRef.meters().snapshot().peakDb(MeterEngine::kMasterR);
+  });
+  masterSection.setReadoutProvider([this]() {
+    const auto &s = processorRef.meters().snapshot();
+    return MasterFader::Readout{
+        juce::jmax(s.truePeakDb(MeterEngine::kMasterL),
+                   s.truePeakDb(MeterEngine::kMasterR)),
+        s.shortTermLufs(MeterEngine::kLoudMaster),
+        processorRef.master().takeReductionDb()};
+  });
+  masterSection.setOnLimiterChanged([this](bool on) {
+    processorRef.master().limiterOn_.store(on);
+    syncParam(ParamIDs::masterLimiter, on ? 1.0f : 0.0f);
+  });
+  masterSection.setOnLimiterSettingsChanged([this](float db, bool truePeak) {
+    processorRef.master().ceilingDb_.store(db);
+    processorRef.master().truePeak_.store(truePeak);
+    syncParam(ParamIDs::masterCeiling, db);
+    syncParam(ParamIDs::masterTruePeak, truePeak ? 1.0f : 0.0f);
   });
   InfoBox::setInfo(masterSection, InfoText::masterGain);
 
@@ -393,13 +406,11 @@ BoomBabyAudioProcessorEditor::BoomBabyAudioProcessorEditor(
               UIConstants::windowHeight + UIConstants::expandedAreaHeight +
               UIConstants::panelGap);
 
-  // 入力波形 Timer 開始（30fps）
-  waveDisplay_.buf.assign(static_cast<std::size_t>(kWaveDisplayCapacity), 0.0f);
-
   // APVTS 状態から UI ウィジェットを復元（DAW が保存した値を反映）
   syncUIFromState();
   waveDisplay_.lastSeenStateVersion = processorRef.nonParamStateVersion();
 
+  // 入力波形 Timer 開始（30fps）
   startTimerHz(30);
 }
 
@@ -542,7 +553,11 @@ void BoomBabyAudioProcessorEditor::syncUIFromState() {
   directUI.lpf.slider.setValue(load(ParamIDs::directLpfFreq), notify);
   directUI.lpf.qSlider.setValue(load(ParamIDs::directLpfQ), notify);
   directUI.threshold.slider.setValue(load(ParamIDs::directThreshold), notify);
+  directUI.threshold.band.setSelected(
+      static_cast<int>(load(ParamIDs::directDetectBand)), false);
   directUI.hold.slider.setValue(load(ParamIDs::directHold), notify);
+  directUI.lookahead.setSelected(
+      static_cast<int>(load(ParamIDs::directLookahead)), false);
   directPanel.getFader().setValue(load(ParamIDs::directGain), notify);
   directPanel.setMuteState(load(ParamIDs::directMute) >= 0.5f);
   directPanel.setSoloState(load(ParamIDs::directSolo) >= 0.5f);
@@ -558,6 +573,9 @@ void BoomBabyAudioProcessorEditor::syncUIFromState() {
 
   // ── Master ──
   masterSection.setValueDb(load(ParamIDs::masterGain));
+  masterSection.setLimiterState(load(ParamIDs::masterLimiter) >= 0.5f);
+  masterSection.setLimiterSettings(load(ParamIDs::masterCeiling),
+                                   load(ParamIDs::masterTruePeak) >= 0.5f);
 
   // ── Mute/Solo: envelopeCurveEditor 同期 ──
   using EC = EnvelopeCurveEditor::Channel;
@@ -586,11 +604,30 @@ void BoomBabyAudioProcessorEditor::syncUIFromState() {
 void BoomBabyAudioProcessorEditor::pollUIFromAPVTS() {
   // DAW Undo/Redo 検出:
   // 非パラメータ状態（エンベロープ等）が復元されたら再読み込み
+  bool changed = false;
   if (const int v = processorRef.nonParamStateVersion();
       v != waveDisplay_.lastSeenStateVersion) {
     waveDisplay_.lastSeenStateVersion = v;
     loadEnvelopesFromState();
     presetBar.refreshPresetName();
+    changed = true;
+  }
+
+  // 前回ポーリングからパラメータが 1 つでも動いたか
+  {
+    const auto &params = processorRef.getParameters();
+    auto &last = waveDisplay_.lastPolledParams;
+    if (last.size() != static_cast<std::size_t>(params.size())) {
+      last.assign(static_cast<std::size_t>(params.size()), -1.0f);
+      changed = true;
+    }
+    for (std::size_t i = 0; i < last.size(); ++i) {
+      const float v = params[static_cast<int>(i)]->getValue();
+      if (v != last[i]) {
+        last[i] = v;
+        changed = true;
+      }
+    }
   }
 
   const auto &apvts = processorRef.getAPVTS();
@@ -708,7 +745,11 @@ void BoomBabyAudioProcessorEditor::pollUIFromAPVTS() {
   directUI.lpf.slope.setSlope(kSlopes[static_cast<std::size_t>(
       static_cast<int>(load(ParamIDs::directLpfSlope)))]);
   directUI.threshold.slider.setValue(load(ParamIDs::directThreshold), silent);
+  directUI.threshold.band.setSelected(
+      static_cast<int>(load(ParamIDs::directDetectBand)), false);
   directUI.hold.slider.setValue(load(ParamIDs::directHold), silent);
+  directUI.lookahead.setSelected(
+      static_cast<int>(load(ParamIDs::directLookahead)), false);
   directPanel.getFader().setValue(load(ParamIDs::directGain), silent);
   directPanel.setMuteState(load(ParamIDs::directMute) >= 0.5f);
   directPanel.setSoloState(load(ParamIDs::directSolo) >= 0.5f);
@@ -719,6 +760,9 @@ void BoomBabyAudioProcessorEditor::pollUIFromAPVTS() {
 
   // ── Master ──
   masterSection.setValueDb(load(ParamIDs::masterGain));
+  masterSection.setLimiterState(load(ParamIDs::masterLimiter) >= 0.5f);
+  masterSection.setLimiterSettings(load(ParamIDs::masterCeiling),
+                                   load(ParamIDs::masterTruePeak) >= 0.5f);
 
   // ── 波形表示 duration 同期 ──
   // DAW Undo/Redo で subLength/clickDecay/directDecay が変わった場合に
@@ -728,12 +772,14 @@ void BoomBabyAudioProcessorEditor::pollUIFromAPVTS() {
 
   // ── 波形プレビュー再構築 ──
   // Drive/HPF/LPF 等の変更が Undo されても onValueChange が発火しないため、
-  // ここで波形プレビューを更新する。
-  // - Noise: repaint だけで OK（provider が live slider 値を参照）
+  // 値が動いたときだけここで波形プレビューを更新する。
+  // - Noise: レイヤーの無効化だけで OK（provider が live slider 値を参照）
   // - Sample: サムネイルに drive/filter をベイクし直す必要あり
   //   （サンプル未ロード時は早期 return するためコスト無し）
-  clickUI.repaintOrRefreshFn();
-  refreshDirectProvider();
+  if (changed) {
+    clickUI.repaintOrRefreshFn();
+    refreshDirectProvider();
+  }
 
   // Sub: tone1-4 の DSP + プレビュー同期（silent 復元では onValueChange
   // 不発火）
@@ -745,7 +791,10 @@ void BoomBabyAudioProcessorEditor::pollUIFromAPVTS() {
     processorRef.subEngine().oscillator().setHarmonicGain(i + 1, gain);
     envelopeCurveEditor.setPreviewHarmonicGain(i + 1, gain);
   }
-  envelopeCurveEditor.repaint();
+  if (changed)
+    envelopeCurveEditor.invalidatePreviews();
+  else
+    envelopeCurveEditor.repaint();
 }
 
 // ────────────────────────────────────────────────────
@@ -847,9 +896,10 @@ void BoomBabyAudioProcessorEditor::saveEnvelopesToState() {
   state.addChild(envelopeToTree("directAmp", envDatas.directAmp), -1, nullptr);
 
   // サンプルファイルパスを保存
-  state.setProperty("directSamplePath", directUI.sample.loadedFilePath,
-                    nullptr);
-  state.setProperty("clickSamplePath", clickUI.sample.loadedFilePath, nullptr);
+  StateCodec::setSamplePath(state, "directSamplePath",
+                            directUI.sample.loadedFilePath);
+  StateCodec::setSamplePath(state, "clickSamplePath",
+                            clickUI.sample.loadedFilePath);
 
   // Click ModeState を保存（アクティブモードはウィジェットから取得）
   const bool clickIsSample = clickUI.modeCombo.getSelectedId() ==
@@ -895,29 +945,25 @@ void BoomBabyAudioProcessorEditor::loadEnvelopesFromState() {
   // で上書きされる前に loadedFilePath をセットしておく）
   if (const auto directPath = state.getProperty("directSamplePath").toString();
       directPath.isNotEmpty()) {
-    const juce::File f{directPath};
-    if (f.existsAsFile())
-      onSampleFileChosen(f);
+    if (SampleRef::exists(directPath))
+      onSampleRefChosen(directPath);
   } else {
     directUI.sample.loadedFilePath = {};
     directUI.sample.loadButton.setButtonText("Drop or Click to Load");
     directUI.sample.loadButton.setHasFile(false);
-    directUI.sample.thumbMin.clear();
-    directUI.sample.thumbMax.clear();
+    directUI.sample.peaks.reset();
     envelopeCurveEditor.setDirectProvider(nullptr);
   }
 
   if (const auto clickPath = state.getProperty("clickSamplePath").toString();
       clickPath.isNotEmpty()) {
-    const juce::File f{clickPath};
-    if (f.existsAsFile())
-      onClickSampleFileChosen(f);
+    if (SampleRef::exists(clickPath))
+      onClickSampleRefChosen(clickPath);
   } else {
     clickUI.sample.loadedFilePath = {};
     clickUI.sample.loadButton.setButtonText("Drop or Click to Load");
     clickUI.sample.loadButton.setHasFile(false);
-    clickUI.sample.thumbMin.clear();
-    clickUI.sample.thumbMax.clear();
+    clickUI.sample.peaks.reset();
     envelopeCurveEditor.setClickPreviewProvider(nullptr);
   }
 
@@ -963,6 +1009,29 @@ void BoomBabyAudioProcessorEditor::loadEnvelopesFromState() {
   refreshDirectProvider();
 }
 
+namespace {
+/// Direct の Drive / Clip / HPF / LPF 設定をリアルタイム波形用に取り出す
+/// （applyDirectFilters と同じ ON/OFF 判定）
+RealtimeWaveRenderer::Style makeRealtimeStyle(const auto &ui, float sr) {
+  RealtimeWaveRenderer::Style st;
+  st.driveDb = static_cast<float>(ui.saturator.driveSlider.getValue());
+  st.clipType = ui.saturator.clipType.getSelected();
+  st.sampleRate = sr;
+  if (const auto f = static_cast<float>(ui.hpf.slider.getValue()); f > 20.5f) {
+    st.hpfFreq = f;
+    st.hpfQ = static_cast<float>(ui.hpf.qSlider.getValue());
+    st.hpfStages = SvfPassUtils::stagesForSlope(ui.hpf.slope.getSlope());
+  }
+  if (const auto f = static_cast<float>(ui.lpf.slider.getValue());
+      f < 19999.5f) {
+    st.lpfFreq = f;
+    st.lpfQ = static_cast<float>(ui.lpf.qSlider.getValue());
+    st.lpfStages = SvfPassUtils::stagesForSlope(ui.lpf.slope.getSlope());
+  }
+  return st;
+}
+} // namespace
+
 void BoomBabyAudioProcessorEditor::timerCallback() {
   // DAW Undo/Redo / オートメーション: APVTS 値とウィジェットを同期
   pollUIFromAPVTS();
@@ -976,85 +1045,49 @@ void BoomBabyAudioProcessorEditor::timerCallback() {
     return;
   }
 
-  // FIFO から利用可能なサンプルをローリング表示バッファに追記
-  auto &fifo = processorRef.inputMonitor().fifo();
-  const auto &src = processorRef.inputMonitor().data();
-  if (const int avail = fifo.getNumReady(); avail > 0) {
-    int s1;
-    int sz1;
-    int s2;
-    int sz2;
-    fifo.prepareToRead(avail, s1, sz1, s2, sz2);
-    const int cap = kWaveDisplayCapacity;
-    auto writeToRing = [&](std::span<const float> data) {
-      for (const float s : data) {
-        waveDisplay_.buf[static_cast<std::size_t>(waveDisplay_.pos)] = s;
-        waveDisplay_.pos = (waveDisplay_.pos + 1) % cap;
-        waveDisplay_.filled = std::min(waveDisplay_.filled + 1, cap);
-      }
-    };
-    writeToRing(
-        std::span<const float>{src.data() + s1, static_cast<std::size_t>(sz1)});
-    if (sz2 > 0)
-      writeToRing(std::span<const float>{src.data() + s2,
-                                         static_cast<std::size_t>(sz2)});
-    fifo.finishedRead(sz1 + sz2);
-  }
-
   const int w = envelopeCurveEditor.getWidth();
-  if (w <= 0 || waveDisplay_.filled == 0)
+  if (w <= 0)
     return;
 
-  // 最新 500ms 分（最大 waveDisplay_.filled サンプル）を幅ピクセルに射影
-  const int cap = kWaveDisplayCapacity;
-  const auto smp500ms =
-      static_cast<int>(processorRef.getSampleRate() * 0.5); // SR に依存
-  const int dispSmp = std::min(waveDisplay_.filled, std::min(smp500ms, cap));
-  const int startPos = (waveDisplay_.pos - dispSmp + cap) % cap;
-  const float spf = static_cast<float>(dispSmp) / static_cast<float>(w);
-
-  std::vector<std::pair<float, float>> pixels(static_cast<std::size_t>(w));
-  for (int px = 0; px < w; ++px) {
-    const auto iStart = static_cast<int>(static_cast<float>(px) * spf);
-    const int iEnd =
-        std::min(static_cast<int>(static_cast<float>(px + 1) * spf), dispSmp);
-    float mn = 0.0f;
-    float mx = 0.0f;
-    for (int si = iStart; si < iEnd; ++si) {
-      const float s =
-          waveDisplay_.buf[static_cast<std::size_t>((startPos + si) % cap)];
-      mn = std::min(mn, s);
-      mx = std::max(mx, s);
-    }
-    pixels[static_cast<std::size_t>(px)] = {mn, mx};
-  }
-
-  // Drive + ClipType をピクセル min/max に適用（Saturator は単調関数）
-  const auto driveDb =
-      static_cast<float>(directUI.saturator.driveSlider.getValue());
-  const int clipType = directUI.saturator.clipType.getSelected();
-  const auto nPx = static_cast<std::size_t>(w);
-  std::vector<float> pxMin(nPx);
-  std::vector<float> pxMax(nPx);
-  for (std::size_t i = 0; i < nPx; ++i) {
-    pxMin[i] = Saturator::process(pixels[i].first, driveDb, clipType);
-    pxMax[i] = Saturator::process(pixels[i].second, driveDb, clipType);
-  }
-
-  // HPF / LPF をピクセルデータに適用
-  {
-    const double rawSr = processorRef.getSampleRate();
-    const float sr = rawSr > 0.0 ? static_cast<float>(rawSr) : 44100.0f;
-    applyDirectFilters(directUI.hpf, directUI.lpf, sr, pxMin, pxMax);
+  // 最新 500ms を幅ピクセルに射影: 1 列 ≥ 1 ビンとなる最も粗いレベルを選ぶ
+  using IM = BoomBabyAudioProcessor::InputMonitor;
+  const double rawSr = processorRef.getSampleRate();
+  const double sr = rawSr > 0.0 ? rawSr : 44100.0;
+  const double smpPerPx = sr * 0.5 / static_cast<double>(w);
+  int level = 0;
+  while (level + 1 < IM::kNumLevels &&
+         PeakDecimator::binSize(level + 1) <= smpPerPx)
+    ++level;
+  const double binsPerPx =
+      smpPerPx / static_cast<double>(PeakDecimator::binSize(level));
+  if (level != waveDisplay_.level)
+    waveDisplay_.columns.clear();
+  waveDisplay_.level = level;
+  waveDisplay_.columns.configure(w, binsPerPx);
+
+  // 選択レベルのビンを列リングへ。他レベルは読み捨てる
+  auto &monitor = processorRef.inputMonitor();
+  for (int lv = 0; lv < IM::kNumLevels; ++lv) {
+    auto &fifo = monitor.fifo(lv);
+    const int avail = fifo.getNumReady();
+    if (avail == 0)
+      continue;
+    const auto scope = fifo.read(avail);
+    if (lv != level)
+      continue;
+    const auto &bins = monitor.data(lv);
+    scope.forEach([&](int i) {
+      waveDisplay_.columns.pushBin(bins[static_cast<std::size_t>(i)]);
+    });
   }
 
-  // 処理済みデータをピクセルに戻す
-  for (std::size_t i = 0; i < nPx; ++i)
-    pixels[i] = {pxMin[i], pxMax[i]};
-
-  envelopeCurveEditor.setRealtimePixels(std::move(pixels));
+  // 列処理の設定（変化したときだけ全列を再処理・再描画）
+  envelopeCurveEditor.setRealtimeStyle(
+      makeRealtimeStyle(directUI, static_cast<float>(sr)));
   envelopeCurveEditor.setUseRealtimeInput(true);
-  envelopeCurveEditor.repaint();
+  // 新着列だけを処理し、変化があったときだけ再描画
+  if (envelopeCurveEditor.updateRealtimeInput(waveDisplay_.columns))
+    envelopeCurveEditor.repaint();
 }
 
 void BoomBabyAudioProcessorEditor::visibilityChanged() {
@@ -1,16 +1,19 @@
 #pragma once
 
 #include "DSP/EnvelopeData.h"
+#include "DSP/PeakPyramid.h"
 #include "GUI/CustomSliderLAF.h"
 #include "GUI/EnvelopeCurveEditor.h"
 #include "GUI/InfoBox.h"
 #include "GUI/KeyboardComponent.h"
 #include "GUI/MasterFader.h"
+#include "GUI/PeakColumnRing.h"
 #include "GUI/PanelComponent.h"
 #include "GUI/PresetBar.h"
 #include "PluginProcessor.h"
 
 #include <array>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -56,12 +59,11 @@ private:
 
   // ── 入力波形リアルタイム表示（30fps Timer）──
   void timerCallback() override;
-  static constexpr int kWaveDisplayCapacity = 192000; // ~1sec @ 192kHz
   struct WaveDisplayState {
-    std::vector<float> buf;
-    int pos = 0;    // 次の書き込み位置
-    int filled = 0; // 実際に充填されたサンプル数
+    PeakColumnRing columns; ///< 入力 min/max のピクセル列リング
+    int level = 0;          ///< 読み出し中の InputMonitor レベル
     int lastSeenStateVersion = 0; // DAW Undo/Redo 検出用
+    std::vector<float> lastPolledParams; ///< 前回ポーリング時の全パラメータ値
   };
   WaveDisplayState waveDisplay_;
 
@@ -75,8 +77,10 @@ private:
   void layoutDirectParams(juce::Rectangle<int> area);
   void onDirectModeChanged();
   void onSampleFileChosen(const juce::File &file);
+  void onSampleRefChosen(const juce::String &ref);
   void refreshDirectProvider();
   void onClickSampleFileChosen(const juce::File &file);
+  void onClickSampleRefChosen(const juce::String &ref);
   void refreshClickSampleProvider();
   void applyClickMode(int modeId);
   void updateDisplayDuration();
@@ -213,10 +217,9 @@ private:
     };
     struct SampleUI {
       UIConstants::SampleDropButton loadButton{"Drop or Click to Load"};
-      juce::String loadedFilePath;
+      juce::String loadedFilePath; ///< サンプル参照（SampleRef）
       std::unique_ptr<juce::FileChooser> fileChooser;
-      std::vector<float> thumbMin;
-      std::vector<float> thumbMax;
+      std::shared_ptr<const PeakPyramid> peaks; ///< ロード中サンプルの波形
       double thumbDurSec = 0.0;
       KnobUI pitch;
       KnobUI amp; ///< 0〜200% 振幅スケーラー（Sub の Amp と同等）
@@ -258,10 +261,9 @@ private:
     // ① サンプル関連をまとめて 1 フィールドへ
     struct SampleData {
       UIConstants::SampleDropButton loadButton{"Drop or Click to Load"};
-      juce::String loadedFilePath;
+      juce::String loadedFilePath; ///< サンプル参照（SampleRef）
       std::unique_ptr<juce::FileChooser> fileChooser;
-      std::vector<float> thumbMin;
-      std::vector<float> thumbMax;
+      std::shared_ptr<const PeakPyramid> peaks; ///< ロード中サンプルの波形
       double thumbDurSec = 0.0;
     };
     SampleData sample; // 3
@@ -280,13 +282,22 @@ private:
     KnobUI amp;            ///< 0〜200% 振幅スケーラー // 5
     SaturatorUI saturator; // 6
     KnobUI decay;          // 7
-    KnobUI threshold; ///< パススルーモード時に Pitch 位置へ表示 // 8
+    /// Threshold + 検出帯域モジュール（SaturatorUI と同形、帯域がラベルを兼ねる）
+    struct ThresholdUI {
+      UIConstants::LabelSelector band{{"Full", "Low", "Mid"},
+                                      UIConstants::Colours::directArc};
+      CustomSlider slider;
+    };
+    ThresholdUI threshold; ///< パススルーモード時に Pitch 位置へ表示 // 8
     // ② Hold をまとめて 1 フィールドへ
     struct HoldUI {
       juce::Label label;
       CustomSlider slider;
     };
     HoldUI hold; // 9
+    // ルックアヘッド量（パススルーモード時のみ Hold の右に表示） // 10
+    UIConstants::LabelSelector lookahead{{"Off", "2ms", "5ms"},
+                                         UIConstants::Colours::directArc};
     // ③ フィルターバンドをまとめて HPF / LPF へ
     struct FilterBand {
       UIConstants::SlopeSelector slope;
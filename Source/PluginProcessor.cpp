@@ -3,6 +3,13 @@
 #include "GUI/LutBaker.h"
 #include "ParamIDs.h"
 #include "PluginEditor.h"
+#include "SampleRef.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
 #include <span>
 
 // ─────────────────────────────────────────────────────────────────────
@@ -76,14 +83,18 @@ BoomBabyAudioProcessor::createParameterLayout() {
   layout.add(
       std::make_unique<ChoiceParam>(ParamIDs::clickBpf1Slope, "Click BPF Slope",
                                     juce::StringArray{"12", "24", "48"}, 0));
-  layout.add(std::make_unique<FloatParam>(ParamIDs::clickSamplePitch,
-                                          "Click Pitch",
-                                          NRange(-24.0f, 24.0f, 1.0f), 0.0f));
+  layout.add(std::make_unique<FloatParam>(
+      ParamIDs::clickSamplePitch, "Click Pitch",
+      NRange(-ParamRanges::samplePitchMaxSt, ParamRanges::samplePitchMaxSt,
+             1.0f),
+      0.0f));
   layout.add(std::make_unique<FloatParam>(ParamIDs::clickSampleAmp, "Click Amp",
                                           NRange(0.0f, 200.0f, 0.1f), 100.0f));
   layout.add(std::make_unique<FloatParam>(
       ParamIDs::clickSampleDecay, "Click Sample Decay",
-      logRangeInt(10.0f, 2000.0f, 300.0f), 300.0f));
+      logRangeInt(ParamRanges::sampleDecayMinMs, ParamRanges::sampleDecayMaxMs,
+                  300.0f),
+      300.0f));
   layout.add(std::make_unique<FloatParam>(ParamIDs::clickDrive, "Click Drive",
                                           NRange(0.0f, 24.0f, 0.1f), 0.0f));
   layout.add(std::make_unique<ChoiceParam>(
@@ -116,8 +127,11 @@ BoomBabyAudioProcessor::createParameterLayout() {
   layout.add(
       std::make_unique<ChoiceParam>(ParamIDs::directMode, "Direct Mode",
                                     juce::StringArray{"Direct", "Sample"}, 0));
-  layout.add(std::make_unique<FloatParam>(ParamIDs::directPitch, "Direct Pitch",
-                                          NRange(-24.0f, 24.0f, 1.0f), 0.0f));
+  layout.add(std::make_unique<FloatParam>(
+      ParamIDs::directPitch, "Direct Pitch",
+      NRange(-ParamRanges::samplePitchMaxSt, ParamRanges::samplePitchMaxSt,
+             1.0f),
+      0.0f));
   layout.add(std::make_unique<FloatParam>(ParamIDs::directAmp, "Direct Amp",
                                           NRange(0.0f, 200.0f, 0.1f), 100.0f));
   layout.add(std::make_unique<FloatParam>(ParamIDs::directDrive, "Direct Drive",
@@ -125,9 +139,11 @@ BoomBabyAudioProcessor::createParameterLayout() {
   layout.add(std::make_unique<ChoiceParam>(
       ParamIDs::directClipType, "Direct Clip",
       juce::StringArray{"Soft", "Hard", "Tube"}, 0));
-  layout.add(std::make_unique<FloatParam>(ParamIDs::directDecay, "Direct Decay",
-                                          logRangeInt(10.0f, 2000.0f, 300.0f),
-                                          300.0f));
+  layout.add(std::make_unique<FloatParam>(
+      ParamIDs::directDecay, "Direct Decay",
+      logRangeInt(ParamRanges::sampleDecayMinMs, ParamRanges::sampleDecayMaxMs,
+                  300.0f),
+      300.0f));
   layout.add(std::make_unique<FloatParam>(ParamIDs::directHpfFreq, "Direct HPF",
                                           logRangeInt(20.0f, 20000.0f, 1000.0f),
                                           20.0f));
@@ -149,6 +165,12 @@ BoomBabyAudioProcessor::createParameterLayout() {
                                           NRange(-60.0f, 0.0f, 0.1f), -24.0f));
   layout.add(std::make_unique<FloatParam>(ParamIDs::directHold, "Direct Hold",
                                           NRange(20.0f, 500.0f, 1.0f), 50.0f));
+  layout.add(std::make_unique<ChoiceParam>(
+      ParamIDs::directLookahead, "Direct Lookahead",
+      juce::StringArray{"Off", "2 ms", "5 ms"}, 0));
+  layout.add(std::make_unique<ChoiceParam>(
+      ParamIDs::directDetectBand, "Direct Detect Band",
+      juce::StringArray{"Full", "Low", "Mid"}, 0));
   layout.add(std::make_unique<FloatParam>(ParamIDs::directGain, "Direct Gain",
                                           NRange(-60.0f, 12.0f, 0.01f), 0.0f));
   layout.add(
@@ -159,11 +181,20 @@ BoomBabyAudioProcessor::createParameterLayout() {
   // ===================== Master =====================
   layout.add(std::make_unique<FloatParam>(ParamIDs::masterGain, "Master Gain",
                                           NRange(-60.0f, 12.0f, 0.01f), 0.0f));
+  layout.add(std::make_unique<BoolParam>(ParamIDs::masterLimiter,
+                                         "Master Limiter", false));
+  layout.add(std::make_unique<FloatParam>(ParamIDs::masterCeiling,
+                                          "Master Ceiling",
+                                          NRange(-12.0f, 0.0f, 0.1f), -1.0f));
+  layout.add(std::make_unique<BoolParam>(ParamIDs::masterTruePeak,
+                                         "Master True Peak", true));
 
   return layout;
 }
 
 namespace {
+/// 全パラメータ ID。この並びはバイナリ状態（StateCodec）の形式の一部なので、
+/// 新しいパラメータは末尾にだけ追加すること。
 constexpr std::array kAllParamIDs = {
     ParamIDs::subWaveShape,   ParamIDs::subLength,
     ParamIDs::subAmp,         ParamIDs::subFreq,
@@ -188,9 +219,20 @@ constexpr std::array kAllParamIDs = {
     ParamIDs::directHpfQ,     ParamIDs::directHpfSlope,
     ParamIDs::directLpfFreq,  ParamIDs::directLpfQ,
     ParamIDs::directLpfSlope, ParamIDs::directThreshold,
-    ParamIDs::directHold,     ParamIDs::directGain,
+    ParamIDs::directHold,     ParamIDs::directLookahead,
+    ParamIDs::directDetectBand, ParamIDs::directGain,
     ParamIDs::directMute,     ParamIDs::directSolo,
-    ParamIDs::masterGain};
+    ParamIDs::masterGain,     ParamIDs::masterLimiter,
+    ParamIDs::masterCeiling,  ParamIDs::masterTruePeak};
+static_assert(kAllParamIDs.size() == BoomBabyAudioProcessor::kNumParams);
+
+/// kAllParamIDs 内の位置（見つからなければ size()）
+std::size_t paramIndex(const juce::String &id) {
+  for (std::size_t i = 0; i < kAllParamIDs.size(); ++i)
+    if (id == kAllParamIDs[i])
+      return i;
+  return kAllParamIDs.size();
+}
 
 /// LUT 駆動パラメータ: DAW Undo/Redo やオートメーション変更時に
 /// bakeAllLutsFromState() を再呼出しする必要があるパラメータ群。
@@ -198,24 +240,38 @@ constexpr std::array kLutAffectedParamIDs = {
     ParamIDs::subLength,        ParamIDs::subAmp,      ParamIDs::subFreq,
     ParamIDs::subMix,           ParamIDs::subSatDrive, ParamIDs::clickSampleAmp,
     ParamIDs::clickSampleDecay, ParamIDs::directAmp,   ParamIDs::directDecay};
+
+/// アイドル判定用の入力無音しきい値（-100 dBFS）
+constexpr float kSilenceLevel = 1.0e-5f;
 } // namespace
 
 BoomBabyAudioProcessor::BoomBabyAudioProcessor()
     : AudioProcessor(
           BusesProperties()
               .withInput("Input", juce::AudioChannelSet::stereo(), true)
-              .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
+              .withOutput("Output", juce::AudioChannelSet::stereo(), true)
+              // ステム出力（デフォルト無効。DAW 側で個別ルーティング用）
+              .withOutput("Sub", juce::AudioChannelSet::stereo(), false)
+              .withOutput("Click", juce::AudioChannelSet::stereo(), false)
+              .withOutput("Direct", juce::AudioChannelSet::stereo(), false)),
       apvts_(*this, nullptr, "BoomBabyState", createParameterLayout()),
       presetManager_(apvts_) {
+  for (auto &v : applied_.params)
+    v.store(std::numeric_limits<float>::quiet_NaN());
   for (const auto *id : kAllParamIDs)
     apvts_.addParameterListener(id, this);
 
+  // 非パラメータ状態の変更を保存キャッシュの無効化に使う
+  apvts_.state.addListener(this);
+
   // PresetManager → Processor 状態復元コールバック
   presetManager_.setOnStateReplaced([this] { applyRestoredState(); });
 }
 
 BoomBabyAudioProcessor::~BoomBabyAudioProcessor() {
+  cancelPendingUpdate();
   // Listener を安全に解除（デストラクタ順序問題を防止）
+  apvts_.state.removeListener(this);
   for (const auto *id : kAllParamIDs)
     apvts_.removeParameterListener(id, this);
 }
@@ -319,6 +375,8 @@ void applyDirectParam(const juce::String &id, float v, int idx,
     td.setThresholdDb(v);
   else if (id == ParamIDs::directHold)
     td.setHoldMs(v);
+  else if (id == ParamIDs::directDetectBand)
+    td.setBand(static_cast<TransientDetector::Band>(std::clamp(idx, 0, 2)));
   else if (id == ParamIDs::directGain)
     direct.setGainDb(v);
   else if (id == ParamIDs::directMute)
@@ -369,32 +427,109 @@ EnvelopeData restoreEnvFromState(const juce::ValueTree &state, const char *name,
   return env;
 }
 
+/// LUT 焼き込みの入力（各エンベロープの既定値・点列と期間）のハッシュ。
+/// 同じ入力なら同じ LUT になるので、一致すれば焼き直しを省ける。
+std::uint64_t lutInputHash(std::initializer_list<const EnvelopeData *> envs,
+                           float durationMs) {
+  std::uint64_t h = 0xcbf29ce484222325ULL; // FNV-1a（32bit 語単位）
+  const auto mix = [&h](float f) {
+    h ^= std::bit_cast<std::uint32_t>(f);
+    h *= 0x100000001b3ULL;
+  };
+  mix(durationMs);
+  for (const auto *e : envs) {
+    mix(e->getDefaultValue());
+    mix(static_cast<float>(e->getPoints().size()));
+    for (const auto &pt : e->getPoints()) {
+      mix(pt.timeMs);
+      mix(pt.value);
+      mix(pt.curve);
+    }
+  }
+  return h;
+}
+
+/// state のサンプル参照を sampler に反映する。同じもの（ファイルなら
+/// パスと更新時刻）が既にロード済みならデコードし直さない。
+/// 参照先のファイルが消えていても、保存時の内容ハッシュ
+/// （"<pathProp>Hash"）と同じ実体がサンプル置き場にあれば、state の参照を
+/// そちらへ付け替えてから読む。
+void restoreSample(SamplePlayer &sampler, juce::ValueTree &state,
+                   const char *pathProp, const PresetManager &presets) {
+  if (auto ref = state.getProperty(pathProp).toString(); ref.isNotEmpty()) {
+    const auto hash = static_cast<juce::uint64>(
+        state.getProperty(StateCodec::hashPropFor(pathProp))
+            .toString()
+            .getHexValue64());
+    if (const auto relocated = SampleRef::relocate(ref, hash);
+        relocated != ref) {
+      state.setProperty(pathProp, relocated, nullptr);
+      ref = relocated;
+    }
+    if (SampleRef::isLoadedIn(sampler, ref))
+      return;
+    // プリセットの先読みでデコード済みなら差し込むだけ
+    if (const auto prepared = presets.preparedSample(ref))
+      sampler.loadDecoded(prepared);
+    else
+      SampleRef::loadInto(sampler, ref);
+  } else if (sampler.isLoaded()) {
+    sampler.unloadSample();
+  }
+}
+
 } // namespace
 
 void BoomBabyAudioProcessor::parameterChanged(const juce::String &parameterID,
                                               float newValue) {
-  const auto v = newValue;
+  stateDirty_.store(true);
+  if (const auto i = paramIndex(parameterID); i < kNumParams)
+    applied_.params[i].store(newValue);
+  applyParam(parameterID, newValue);
+
+  // LUT 駆動パラメータは DAW Undo/Redo 時にも再ベイクが必要。
+  // オートメーションではオーディオスレッドから呼ばれるので、ここでは
+  // 印を付けてメッセージスレッドへ回すだけにする。
+  for (const auto *p : kLutAffectedParamIDs) {
+    if (parameterID == p) {
+      lutsDirty_.store(true);
+      triggerAsyncUpdate();
+      break;
+    }
+  }
+}
+
+void BoomBabyAudioProcessor::handleAsyncUpdate() {
+  if (lutsDirty_.exchange(false))
+    bakeAllLutsFromState();
+}
+
+void BoomBabyAudioProcessor::applyParam(const juce::String &parameterID,
+                                        float value) {
+  const auto v = value;
   const auto idx = static_cast<int>(v);
 
   if (parameterID.startsWith("sub_"))
     applySubParam(parameterID, v, idx, subEngine_, channelState_);
-  else if (parameterID == ParamIDs::directMode)
+  else if (parameterID == ParamIDs::directMode) {
     directMode_.setSampleMode(idx == 1, directEngine_);
-  else if (parameterID.startsWith("click_"))
+    updateLookaheadLatency();
+  } else if (parameterID == ParamIDs::directLookahead) {
+    directMode_.lookaheadIdx_.store(idx);
+    updateLookaheadLatency();
+  } else if (parameterID.startsWith("click_"))
     applyClickParam(parameterID, v, idx, clickEngine_, channelState_);
   else if (parameterID.startsWith("direct_"))
     applyDirectParam(parameterID, v, idx, directEngine_,
                      directMode_.transientDetector_, channelState_);
   else if (parameterID == ParamIDs::masterGain)
     master_.setGain(v);
-
-  // LUT 駆動パラメータは DAW Undo/Redo 時にも再ベイクが必要
-  for (const auto *p : kLutAffectedParamIDs) {
-    if (parameterID == p) {
-      bakeAllLutsFromState();
-      break;
-    }
-  }
+  else if (parameterID == ParamIDs::masterLimiter)
+    master_.limiterOn_.store(v >= 0.5f);
+  else if (parameterID == ParamIDs::masterCeiling)
+    master_.ceilingDb_.store(v);
+  else if (parameterID == ParamIDs::masterTruePeak)
+    master_.truePeak_.store(v >= 0.5f);
 }
 
 const juce::String // NOSONAR: JUCE API
@@ -408,7 +543,30 @@ bool BoomBabyAudioProcessor::producesMidi() const { return false; }
 
 bool BoomBabyAudioProcessor::isMidiEffect() const { return false; }
 
-double BoomBabyAudioProcessor::getTailLengthSeconds() const { return 0.0; }
+double BoomBabyAudioProcessor::getTailLengthSeconds() const {
+  // 最後のトリガーから各チャンネルが鳴り終わるまでの最長時間。
+  // ホストはこの値を使って無入力時に processBlock を止められる。
+  const auto load = [this](const char *id) {
+    return apvts_.getRawParameterValue(id)->load();
+  };
+  const bool clickSample = load(ParamIDs::clickMode) >= 0.5f;
+  const float clickMs = clickSample ? load(ParamIDs::clickSampleDecay)
+                                    : load(ParamIDs::clickNoiseDecay);
+  const float tailMs = std::max({load(ParamIDs::subLength), clickMs,
+                                 load(ParamIDs::directDecay)});
+  double tailSec = static_cast<double>(tailMs) / 1000.0;
+
+  // 出力はルックアヘッドとリミッターの分だけ遅れて出てくる（リミッターは
+  // OFF でも遅延線を通る）。ON なら最後のゲインリダクションが戻り切るまで
+  // （リリース）も含める
+  if (const double sr = getSampleRate(); sr > 0.0)
+    tailSec += static_cast<double>(directMode_.lookaheadSamples(sr) +
+                                   master_.limiterLatency()) /
+               sr;
+  if (master_.limiterOn_.load())
+    tailSec += static_cast<double>(BrickwallLimiter::kReleaseMs) / 1000.0;
+  return tailSec;
+}
 
 int BoomBabyAudioProcessor::getNumPrograms() { return 1; }
 
@@ -431,26 +589,52 @@ void BoomBabyAudioProcessor::changeProgramName(int index,
 
 void BoomBabyAudioProcessor::prepareToPlay(double sampleRate,
                                            int samplesPerBlock) {
-  subEngine_.prepareToPlay(sampleRate, samplesPerBlock);
-  clickEngine_.prepareToPlay(sampleRate, samplesPerBlock);
-  directEngine_.prepareToPlay(sampleRate, samplesPerBlock);
+  juce::ignoreUnused(samplesPerBlock);
+  // インスタンス内の DSP 作業メモリ（スクラッチ・OSC テーブル・遅延線）は
+  // 1 つのアリーナにまとめて確保し、各コンポーネントが順に切り出す。
+  // エンジンとスクラッチはホストのブロック長ではなくサブブロック長で確保する
+  const int limiterLatency = BrickwallLimiter::latencyFor(sampleRate);
+  const int maxLookahead = DirectMode::lookaheadSamplesFor(
+      DirectMode::kMaxLookaheadIdx, sampleRate);
+  constexpr auto scratchLen = static_cast<std::size_t>(kSubBlockSize);
+  arena_.reset(
+      SubEngine::arenaBytes(kSubBlockSize) +
+      ClickEngine::arenaBytes(kSubBlockSize) +
+      DirectEngine::arenaBytes(kSubBlockSize) +
+      MeterEngine::arenaBytes(kSubBlockSize) +
+      BrickwallLimiter::arenaBytes(sampleRate) +
+      master_.stemDelay_.size() * Lookahead::arenaBytes(limiterLatency) +
+      Lookahead::arenaBytes(maxLookahead) +
+      3 * DspArena::bytesFor<float>(scratchLen));
+
+  subEngine_.prepareToPlay(sampleRate, kSubBlockSize, arena_);
+  clickEngine_.prepareToPlay(sampleRate, kSubBlockSize, arena_);
+  directEngine_.prepareToPlay(sampleRate, kSubBlockSize, arena_);
   // sampleMode_ の初期値（false = Input モード）に合わせて passthroughMode_
   // を同期。 未同期のまま triggerNote() が呼ばれるとサンプル未ロード判定で
   // early return し active_ が立たず、renderPassthrough が amp=0
   // で無音になるのを防ぐ。
   directEngine_.setPassthroughMode(!directMode_.sampleMode_.load());
-  channelState_.resetDetectors();
+  meters_.prepare(sampleRate, kSubBlockSize, arena_);
+  // 直前の ON/OFF のまま始める（prepare 直後にクロスフェードさせない）
+  master_.limiter_.setEnabled(master_.limiterOn_.load());
+  master_.limiter_.prepare(sampleRate, arena_);
+  for (auto &d : master_.stemDelay_) {
+    d.prepare(master_.limiter_.latencySamples(), arena_);
+    d.setDelaySamples(master_.limiter_.latencySamples());
+  }
 
   directMode_.transientDetector_.prepare(sampleRate);
   directMode_.transientDetector_.setThresholdDb(-24.0f);
   directMode_.transientDetector_.setHoldMs(50.0f);
-  monoMixBuffer_.resize(static_cast<std::size_t>(samplesPerBlock));
-  passthroughL_.resize(static_cast<std::size_t>(samplesPerBlock));
-  passthroughR_.resize(static_cast<std::size_t>(samplesPerBlock));
+  directMode_.lookahead_.prepare(maxLookahead, arena_);
+  monoMixBuffer_ = arena_.take<float>(scratchLen);
+  passthroughL_ = arena_.take<float>(scratchLen);
+  passthroughR_ = arena_.take<float>(scratchLen);
 
-  inputMonitor_.data_.assign(static_cast<std::size_t>(InputMonitor::kCapacity),
-                             0.0f);
-  inputMonitor_.fifo_.reset();
+  for (auto &level : inputMonitor_.levels_)
+    level.fifo.reset();
+  inputMonitor_.decimator_.reset();
 
   // 全エンジン初期化後に APVTS 値で DSP を復元。
   // setStateInformation が先に呼ばれても prepareToPlay のハードコード値に
@@ -462,6 +646,12 @@ void BoomBabyAudioProcessor::prepareToPlay(double sampleRate,
   bakeAllLutsFromState();
 }
 
+void BoomBabyAudioProcessor::updateLookaheadLatency() {
+  // Sample モードでは入力を遅延しないため Direct 分は 0
+  setLatencySamples(directMode_.lookaheadSamples(getSampleRate()) +
+                    master_.limiterLatency());
+}
+
 void BoomBabyAudioProcessor::releaseResources() {
   // Currently no resources to release - will be populated when adding DSP
   // processing
@@ -469,18 +659,26 @@ void BoomBabyAudioProcessor::releaseResources() {
 
 bool BoomBabyAudioProcessor::isBusesLayoutSupported(
     const BusesLayout &layouts) const {
-  if (layouts.getMainOutputChannelSet() == juce::AudioChannelSet::disabled())
+  const auto mainOut = layouts.getMainOutputChannelSet();
+  if (mainOut == juce::AudioChannelSet::disabled())
     return false;
 
-  if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+  if (mainOut != layouts.getMainInputChannelSet())
     return false;
 
+  // Sub / Click / Direct ステム: 無効、またはメイン出力と同じ構成のみ
+  for (int bus = kSubStemBus; bus < layouts.outputBuses.size(); ++bus) {
+    const auto &stem = layouts.outputBuses.getReference(bus);
+    if (!stem.isDisabled() && stem != mainOut)
+      return false;
+  }
+
   return true;
 }
 
 // ─────────────────────────────────────────────────────────────────────────
 // processBlock ヘルパー（フリー関数: クラスメソッドカウントに含まれない）
-// 将来の拡張（input gain, FFT, latency comp, LUFS 等）は各関数へ追記する
+// 将来の拡張（input gain, FFT 等）は各関数へ追記する
 // ─────────────────────────────────────────────────────────────────────────
 namespace {
 
@@ -491,14 +689,29 @@ struct EngineRefs {
   DirectEngine &direct;
 };
 
-/// パススルーモード時: モノミックス → トランジェント検出 → FIFO 供給
+/// 入力モニターへ min/max ビンを積む。src == nullptr のときは無音として扱う。
+void pushToInputMonitor(BoomBabyAudioProcessor::InputMonitor &im,
+                        const float *src, int numSamples) {
+  im.decimator_.push(src, numSamples,
+                     [&im](int level, PeakDecimator::MinMax bin) {
+                       auto &lv = im.levels_[static_cast<std::size_t>(level)];
+                       // 満杯なら GUI が追いつくまでビンを捨てる
+                       if (lv.fifo.getFreeSpace() == 0)
+                         return;
+                       const auto scope = lv.fifo.write(1);
+                       lv.data[static_cast<std::size_t>(scope.startIndex1)] =
+                           bin;
+                     });
+}
+
+/// パススルーモード時: モノミックス → トランジェント検出 → FIFO 供給。
+/// 検出したオンセットは Lookahead の遅延タイムライン上に予約し、
+/// パススルー入力（ptL/ptR）は同じ量だけ遅延させる。
 void processPassthroughMonitor(BoomBabyAudioProcessor::DirectMode &dm,
                                BoomBabyAudioProcessor::InputMonitor &im,
-                               EngineRefs eng,
                                const juce::AudioBuffer<float> &buffer,
-                               std::vector<float> &monoMixBuf,
-                               std::vector<float> &ptL,
-                               std::vector<float> &ptR) {
+                               std::span<float> monoMixBuf,
+                               std::span<float> ptL, std::span<float> ptR) {
   if (dm.sampleMode_.load() || buffer.getNumChannels() == 0)
     return;
 
@@ -518,36 +731,37 @@ void processPassthroughMonitor(BoomBabyAudioProcessor::DirectMode &dm,
     std::copy_n(ch0, numSamples, ptR.data());
   }
 
+  auto &la = dm.lookahead_;
   if (dm.transientDetector_.isEnabled()) {
-    const int pos = dm.transientDetector_.process(
-        std::span<const float>(mono, static_cast<std::size_t>(numSamples)));
-    if (pos >= 0) {
-      eng.sub.triggerNote(pos);
-      eng.click.triggerNote(pos);
-      eng.direct.triggerNote(pos);
-    }
+    TransientDetector::Onsets onsets;
+    dm.transientDetector_.process(
+        std::span<const float>(mono, static_cast<std::size_t>(numSamples)),
+        onsets);
+    // 遅延後の時間軸で、検出遅れ（立ち上がり開始からの経過）を
+    // ルックアヘッド量の範囲で打ち消した位置に全オンセットを予約する
+    const int delay = la.getDelaySamples();
+    for (const auto &o : onsets)
+      la.schedule(o.position + delay - std::clamp(o.lag, 0, delay));
   }
+  la.delayStereo(ptL.data(), ptR.data(), numSamples);
 
-  const int toWrite = juce::jmin(numSamples, im.fifo_.getFreeSpace());
-  if (toWrite > 0) {
-    int s1;
-    int sz1;
-    int s2;
-    int sz2;
-    im.fifo_.prepareToWrite(toWrite, s1, sz1, s2, sz2);
-    if (sz1 > 0)
-      std::copy_n(mono, sz1, im.data_.data() + s1);
-    if (sz2 > 0)
-      std::copy_n(mono + sz1, sz2, im.data_.data() + s2);
-    im.fifo_.finishedWrite(sz1 + sz2);
-  }
+  pushToInputMonitor(im, mono, numSamples);
+}
+
+/// このサブブロック内に入った予約済みトリガーを全エンジンへ発火
+void fireDueTriggers(Lookahead &la, EngineRefs eng, int numSamples) {
+  la.popDue(numSamples, [&eng](int offset) {
+    eng.sub.triggerNote(offset);
+    eng.click.triggerNote(offset);
+    eng.direct.triggerNote(offset);
+  });
 }
 
 /// Direct エンジンのパススルー vs サンプルモード呼び分け
 void renderDirectEngine(const BoomBabyAudioProcessor::DirectMode &dm,
                         const ChannelState::Passes &passes,
-                        DirectEngine &directEng, const std::vector<float> &ptL,
-                        const std::vector<float> &ptR,
+                        DirectEngine &directEng, std::span<const float> ptL,
+                        std::span<const float> ptR,
                         juce::AudioBuffer<float> &buffer, double sr) {
   const int numSamples = buffer.getNumSamples();
   if (!dm.sampleMode_.load() && passes.direct) {
@@ -563,41 +777,133 @@ void renderDirectEngine(const BoomBabyAudioProcessor::DirectMode &dm,
   }
 }
 
-/// マスター L/R + 各チャンネルのレベル計測
+/// マスター L/R + 各チャンネルのレベル計測（MeterEngine で 1 パス）
 void measureChannelLevels(const ChannelState::Passes &passes,
-                          BoomBabyAudioProcessor::MasterSection &master,
-                          ChannelState &channelState, EngineRefs eng,
+                          MeterEngine &meters, EngineRefs eng,
                           const juce::AudioBuffer<float> &buffer,
                           int numSamples) {
-  for (std::size_t ch = 0; ch < 2; ++ch) {
-    const int bufCh =
-        juce::jmin(static_cast<int>(ch), buffer.getNumChannels() - 1);
-    master.detector_[ch].process(
-        bufCh >= 0 ? buffer.getReadPointer(bufCh) : nullptr, numSamples);
+  const int lastCh = buffer.getNumChannels() - 1;
+  const auto masterCh = [&](int ch) {
+    return lastCh >= 0 ? buffer.getReadPointer(juce::jmin(ch, lastCh))
+                       : nullptr;
+  };
+  meters.process({masterCh(0), masterCh(1),
+                  passes.sub ? eng.sub.scratchData() : nullptr,
+                  passes.click ? eng.click.scratchData() : nullptr,
+                  passes.direct ? eng.direct.scratchData() : nullptr},
+                 numSamples);
+}
+
+/// 全エンジン停止中・ノートオンなし・（パススルー時）入力無音なら true。
+/// このブロックは出力・メーター・検出器状態とも解析的に処理できる。
+bool isIdleBlock(const BoomBabyAudioProcessor::DirectMode &dm, EngineRefs eng,
+                 const juce::AudioBuffer<float> &buffer,
+                 const juce::MidiBuffer &midiMessages) {
+  if (eng.sub.isActive() || eng.click.isActive() || eng.direct.isActive())
+    return false;
+  if (dm.lookahead_.numPending() > 0)
+    return false; // 遅延タイムライン上に未発火のトリガーがある
+  for (const auto metadata : midiMessages) {
+    if (metadata.getMessage().isNoteOn())
+      return false;
   }
+  if (dm.sampleMode_.load())
+    return true; // Sample モードでは入力は使わない
 
-  using enum ChannelState::Channel;
-  channelState.detector(sub).process(
-      passes.sub ? eng.sub.scratchData() : nullptr, numSamples);
-  channelState.detector(click).process(
-      passes.click ? eng.click.scratchData() : nullptr, numSamples);
-  channelState.detector(direct).process(
-      passes.direct ? eng.direct.scratchData() : nullptr, numSamples);
+  if (!dm.transientDetector_.isSettled())
+    return false;
+  const int numSamples = buffer.getNumSamples();
+  for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+    if (buffer.getMagnitude(ch, 0, numSamples) > kSilenceLevel)
+      return false;
+  }
+  return true;
 }
 
-/// MIDI ノートオン → 各エンジン triggerNote
-void handleMidiEvents(juce::MidiKeyboardState &kbState, SubEngine &sub,
-                      ClickEngine &click, DirectEngine &direct,
-                      juce::MidiBuffer &midiMessages, int numSamples) {
-  kbState.processNextMidiBuffer(midiMessages, 0, numSamples, true);
-  for (const auto metadata : midiMessages) {
-    const auto msg = metadata.getMessage();
-    if (msg.isNoteOn()) {
-      const int offset = metadata.samplePosition;
-      sub.triggerNote(offset);
-      click.triggerNote(offset);
-      direct.triggerNote(offset);
-    }
+/// アイドルブロック: 出力をクリアし、メーターを解析的に減衰させる
+void renderIdleBlock(BoomBabyAudioProcessor::DirectMode &dm,
+                     BoomBabyAudioProcessor::InputMonitor &im,
+                     MeterEngine &meters, juce::AudioBuffer<float> &buffer) {
+  const int numSamples = buffer.getNumSamples();
+  buffer.clear();
+
+  // 波形表示がスクロールし続けるよう無音だけは供給する
+  if (!dm.sampleMode_.load())
+    pushToInputMonitor(im, nullptr, numSamples);
+  // 復帰時に古い入力が遅延出力から漏れないよう遅延ラインを無音にする
+  dm.lookahead_.reset();
+
+  meters.decay(numSamples);
+}
+
+/// buf の [start, start + numSamples) を参照する AudioBuffer（コピーなし）
+juce::AudioBuffer<float> sliceBuffer(juce::AudioBuffer<float> &buf, int start,
+                                     int numSamples) {
+  return juce::AudioBuffer<float>(buf.getArrayOfWritePointers(),
+                                  buf.getNumChannels(), start, numSamples);
+}
+
+/// エンジン 1 つ分の描画先振り分け。
+/// ステムバスが有効ならバスへ直接描画してからメインへ加算、
+/// 無効（0ch）ならメインへ直接描画する。
+template <typename RenderFn>
+void renderToStem(juce::AudioBuffer<float> &mainChunk,
+                  juce::AudioBuffer<float> &stemChunk, RenderFn &&render) {
+  const int stemChannels = stemChunk.getNumChannels();
+  if (stemChannels == 0) {
+    render(mainChunk);
+    return;
+  }
+  stemChunk.clear();
+  render(stemChunk);
+  for (int ch = 0; ch < mainChunk.getNumChannels(); ++ch)
+    mainChunk.addFrom(ch, 0, stemChunk, juce::jmin(ch, stemChannels - 1), 0,
+                      mainChunk.getNumSamples());
+}
+
+/// マスター出力段: ゲインとリミッターを 1 パスに融合。リミッターは OFF でも
+/// 遅延線を回し続けてゲインだけクロスフェードで外すので、切り替えで
+/// レイテンシも音も途切れない。ステムも同じだけ遅らせて時間軸を揃える。
+void applyMasterOutput(BoomBabyAudioProcessor::MasterSection &m,
+                       juce::AudioBuffer<float> &chunk,
+                       const std::array<juce::AudioBuffer<float> *, 3> &stems) {
+  const float gain = juce::Decibels::decibelsToGain(m.gainDb_.load());
+  const int numSamples = chunk.getNumSamples();
+  const int numCh = chunk.getNumChannels();
+  if (numCh > 0) {
+    m.limiter_.setEnabled(m.limiterOn_.load());
+    m.limiter_.setCeilingDb(m.ceilingDb_.load());
+    m.limiter_.setTruePeak(m.truePeak_.load());
+    m.limiter_.process(chunk.getWritePointer(0),
+                       numCh > 1 ? chunk.getWritePointer(1) : nullptr,
+                       numSamples, gain);
+    m.publishReduction(m.limiter_.lastReductionDb());
+  }
+  for (std::size_t i = 0; i < stems.size(); ++i) {
+    auto &stem = *stems[i];
+    const int stemCh = stem.getNumChannels();
+    if (stemCh == 0)
+      continue;
+    // モノステムは同じポインタを L/R に渡す（同値なので結果も同じ）
+    m.stemDelay_[i].delayStereo(stem.getWritePointer(0),
+                                stem.getWritePointer(juce::jmin(1, stemCh - 1)),
+                                numSamples);
+  }
+}
+
+/// MIDI ノートオン → Lookahead へトリガー予約
+/// [start, start + numSamples) のイベントのみ拾い、サブブロック相対位置に
+/// ルックアヘッド量を加えて予約する（パススルー入力と時間軸を揃える）
+void handleMidiEvents(Lookahead &la, const juce::MidiBuffer &midiMessages,
+                      int start, int numSamples) {
+  const int end = start + numSamples;
+  for (auto it = midiMessages.findNextSamplePosition(start);
+       it != midiMessages.cend(); ++it) {
+    const auto metadata = *it;
+    if (metadata.samplePosition >= end)
+      break;
+    if (metadata.getMessage().isNoteOn())
+      la.schedule(metadata.samplePosition - start + la.getDelaySamples());
   }
 }
 
@@ -607,32 +913,68 @@ void BoomBabyAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
                                           juce::MidiBuffer &midiMessages) {
   juce::ScopedNoDenormals noDenormals;
 
-  const auto passes = channelState_.computePasses();
   const int numSamples = buffer.getNumSamples();
   const double sr = getSampleRate();
+  const EngineRefs eng{subEngine_, clickEngine_, directEngine_};
 
-  // パススルーモード: モノミックス / トランジェント検出 / FIFO 供給
-  processPassthroughMonitor(directMode_, inputMonitor_,
-                            {subEngine_, clickEngine_, directEngine_}, buffer,
-                            monoMixBuffer_, passthroughL_, passthroughR_);
+  // メイン入出力（同一チャンネルを共有）とステムバス（無効時は 0ch）
+  auto mainIn = getBusBuffer(buffer, true, kMainBus);
+  auto mainOut = getBusBuffer(buffer, false, kMainBus);
+  auto subStem = getBusBuffer(buffer, false, kSubStemBus);
+  auto clickStem = getBusBuffer(buffer, false, kClickStemBus);
+  auto directStem = getBusBuffer(buffer, false, kDirectStemBus);
 
-  // Direct ミュート: 入力信号を消去（Sub はこの後加算。renderPassthrough も
-  // addSample）
-  buffer.clear();
+  keyboardState.processNextMidiBuffer(midiMessages, 0, numSamples, true);
 
-  handleMidiEvents(keyboardState, subEngine_, clickEngine_, directEngine_,
-                   midiMessages, numSamples);
-  subEngine_.render(buffer, numSamples, passes.sub, sr);
-  clickEngine_.render(buffer, numSamples, passes.click, sr);
-  renderDirectEngine(directMode_, passes, directEngine_, passthroughL_,
-                     passthroughR_, buffer, sr);
-
-  // マスターゲイン適用
-  buffer.applyGain(juce::Decibels::decibelsToGain(master_.gainDb_.load()));
+  // アイドル短絡: 何も鳴っておらず入力も無音なら DSP を丸ごと省略
+  if (master_.isSettled() &&
+      isIdleBlock(directMode_, eng, mainIn, midiMessages)) {
+    renderIdleBlock(directMode_, inputMonitor_, meters_, buffer);
+    return;
+  }
 
-  measureChannelLevels(passes, master_, channelState_,
-                       {subEngine_, clickEngine_, directEngine_}, buffer,
-                       numSamples);
+  // ルックアヘッド量はブロック単位で反映（レイテンシ報告と同じ値）
+  directMode_.lookahead_.setDelaySamples(directMode_.lookaheadSamples(sr));
+
+  // ホストのブロック長に依存せず kSubBlockSize 単位で処理する。
+  // トリガー・Mute/Solo・マスターゲインはサブブロック毎に取り直す。
+  for (int start = 0; start < numSamples; start += kSubBlockSize) {
+    const int len = juce::jmin(kSubBlockSize, numSamples - start);
+    auto chunk = sliceBuffer(mainOut, start, len);
+    auto subChunk = sliceBuffer(subStem, start, len);
+    auto clickChunk = sliceBuffer(clickStem, start, len);
+    auto directChunk = sliceBuffer(directStem, start, len);
+
+    const auto passes = channelState_.computePasses();
+
+    // パススルーモード: モノミックス / トランジェント検出 / FIFO 供給
+    processPassthroughMonitor(directMode_, inputMonitor_,
+                              sliceBuffer(mainIn, start, len), monoMixBuffer_,
+                              passthroughL_, passthroughR_);
+
+    // Direct ミュート: 入力信号を消去（Sub はこの後加算。renderPassthrough も
+    // addSample）
+    chunk.clear();
+
+    handleMidiEvents(directMode_.lookahead_, midiMessages, start, len);
+    fireDueTriggers(directMode_.lookahead_, eng, len);
+    renderToStem(chunk, subChunk, [&](juce::AudioBuffer<float> &dst) {
+      subEngine_.render(dst, len, passes.sub, sr);
+    });
+    renderToStem(chunk, clickChunk, [&](juce::AudioBuffer<float> &dst) {
+      clickEngine_.render(dst, len, passes.click, sr);
+    });
+    renderToStem(chunk, directChunk, [&](juce::AudioBuffer<float> &dst) {
+      renderDirectEngine(directMode_, passes, directEngine_, passthroughL_,
+                         passthroughR_, dst, sr);
+    });
+
+    // マスターゲイン / リミッター適用（メインミックスのみ。ステムはプリマスター
+    // で、リミッター ON 時は遅延のみ揃える）
+    applyMasterOutput(master_, chunk, {&subChunk, &clickChunk, &directChunk});
+
+    measureChannelLevels(passes, meters_, eng, chunk, len);
+  }
 }
 
 bool BoomBabyAudioProcessor::hasEditor() const { return true; }
@@ -644,54 +986,89 @@ juce::AudioProcessorEditor *BoomBabyAudioProcessor::createEditor() {
 }
 
 void BoomBabyAudioProcessor::getStateInformation(juce::MemoryBlock &destData) {
-  auto state = apvts_.copyState();
-  state.setProperty("presetName", presetManager_.getCurrentPresetName(),
-                    nullptr);
-  auto xml = state.createXml();
-  copyXmlToBinary(*xml, destData);
+  const std::scoped_lock lock(stateCache_.mutex);
+  // 変更が無ければ前回のバイナリを返す。フラグは書き出し前に下ろすので、
+  // 書き出し中の変更は次回の呼び出しで拾われる。
+  if (const auto &name = presetManager_.getCurrentPresetName();
+      stateDirty_.exchange(false) || name != stateCache_.presetName) {
+    auto state = apvts_.copyState();
+    state.setProperty("presetName", name, nullptr);
+    StateCodec::encode(state, kAllParamIDs, stateCache_.hashes,
+                       stateCache_.blob);
+    stateCache_.presetName = name;
+  }
+  destData = stateCache_.blob;
 }
 
 void BoomBabyAudioProcessor::setStateInformation(
     const void *data, // NOSONAR: JUCE API
     int sizeInBytes) {
-  auto xml = getXmlFromBinary(data, sizeInBytes);
-  if (!xml || !xml->hasTagName(apvts_.state.getType()))
+  juce::ValueTree state;
+  if (StateCodec::isBinaryState(data, sizeInBytes))
+    state = StateCodec::decode(data, sizeInBytes, kAllParamIDs);
+  else if (const auto xml = getXmlFromBinary(data, sizeInBytes))
+    state = juce::ValueTree::fromXml(*xml); // 旧バージョンの XML 状態
+  if (!state.hasType(apvts_.state.getType()))
     return;
 
-  apvts_.replaceState(juce::ValueTree::fromXml(*xml));
+  apvts_.replaceState(state);
   applyRestoredState();
 }
 
+// パラメータ値（PARAM ノード）は parameterChanged で追跡済みなので、
+// ここではそれ以外の変更だけを拾う
+void BoomBabyAudioProcessor::valueTreePropertyChanged(
+    juce::ValueTree &tree, const juce::Identifier &property) {
+  juce::ignoreUnused(property);
+  if (!tree.hasType("PARAM"))
+    stateDirty_.store(true);
+}
+
+void BoomBabyAudioProcessor::valueTreeChildAdded(juce::ValueTree &parent,
+                                                 juce::ValueTree &child) {
+  juce::ignoreUnused(parent, child);
+  stateDirty_.store(true);
+}
+
+void BoomBabyAudioProcessor::valueTreeChildRemoved(juce::ValueTree &parent,
+                                                   juce::ValueTree &child,
+                                                   int index) {
+  juce::ignoreUnused(parent, child, index);
+  stateDirty_.store(true);
+}
+
+void BoomBabyAudioProcessor::valueTreeChildOrderChanged(
+    juce::ValueTree &parent, int oldIndex, int newIndex) {
+  juce::ignoreUnused(parent, oldIndex, newIndex);
+  stateDirty_.store(true);
+}
+
+void BoomBabyAudioProcessor::valueTreeRedirected(juce::ValueTree &tree) {
+  juce::ignoreUnused(tree);
+  stateDirty_.store(true);
+}
+
 void BoomBabyAudioProcessor::applyRestoredState() {
   nonParamStateVersion_.fetch_add(1);
 
-  // replaceState は parameterChanged を発火しないため、
-  // 全パラメータの DSP セッターを手動で呼び出す
-  for (const auto *id : kAllParamIDs)
-    parameterChanged(id, apvts_.getRawParameterValue(id)->load());
+  // replaceState は parameterChanged を発火しないため、前回 DSP へ適用した
+  // 値から変わったパラメータだけセッターを呼ぶ（LUT は下でまとめて判定）
+  for (std::size_t i = 0; i < kAllParamIDs.size(); ++i) {
+    const auto *id = kAllParamIDs[i];
+    if (const float v = apvts_.getRawParameterValue(id)->load();
+        applied_.params[i].exchange(v) != v)
+      applyParam(id, v);
+  }
 
-  // エンベロープ LUT を保存済み状態から再ベイク
+  // エンベロープ LUT を保存済み状態から再ベイク（変わったグループのみ）
   bakeAllLutsFromState();
 
-  // サンプルファイルを復元（エディタ無しでも音が出るように）
-  if (const auto clickPath =
-          apvts_.state.getProperty("clickSamplePath").toString();
-      clickPath.isNotEmpty()) {
-    const juce::File f{clickPath};
-    if (f.existsAsFile())
-      clickEngine_.sampler().loadSample(f);
-  } else {
-    clickEngine_.sampler().unloadSample();
-  }
-  if (const auto directPath =
-          apvts_.state.getProperty("directSamplePath").toString();
-      directPath.isNotEmpty()) {
-    const juce::File f{directPath};
-    if (f.existsAsFile())
-      directEngine_.sampler().loadSample(f);
-  } else {
-    directEngine_.sampler().unloadSample();
-  }
+  // サンプルファイルを復元（エディタ無しでも音が出るように）。
+  // 同じファイルがロード済みならデコードし直さない。
+  restoreSample(clickEngine_.sampler(), apvts_.state, "clickSamplePath",
+                presetManager_);
+  restoreSample(directEngine_.sampler(), apvts_.state, "directSamplePath",
+                presetManager_);
 
   // プリセット名を復元
   if (const auto name = apvts_.state.getProperty("presetName").toString();
@@ -713,26 +1090,44 @@ void BoomBabyAudioProcessor::bakeAllLutsFromState() {
     return apvts_.getRawParameterValue(id)->load();
   };
 
+  const std::scoped_lock lock(applied_.lutMutex);
+  auto &keys = applied_.luts;
+
   // LUT → DSP 単位への変換は Editor 側の knob コールバックと対称にする
   // Sub LUT: エンベロープ実効区間に 512 点を集中させる
   const auto ampEnv = env("amp", load(ParamIDs::subAmp) / 100.0f);
   const auto freqEnv = env("freq", load(ParamIDs::subFreq));
   const auto distEnv = env("dist", load(ParamIDs::subSatDrive) / 24.0f);
   const auto mixEnv = env("mix", load(ParamIDs::subMix) / 100.0f);
-  bakeLut(ampEnv, subEngine_.envLut(), effectiveLutDuration(ampEnv, subLenMs));
-  bakeLut(freqEnv, subEngine_.freqLut(),
-          effectiveLutDuration(freqEnv, subLenMs));
-  bakeLut(distEnv, subEngine_.distLut(),
-          effectiveLutDuration(distEnv, subLenMs));
-  bakeLut(mixEnv, subEngine_.mixLut(), effectiveLutDuration(mixEnv, subLenMs));
+  if (const auto h =
+          lutInputHash({&ampEnv, &freqEnv, &distEnv, &mixEnv}, subLenMs);
+      keys[AppliedState::kSubLuts].needsBake(h,
+                                             subEngine_.luts().generation()))
+    keys[AppliedState::kSubLuts] = {
+        h,
+        bakeLutBank(subEngine_.luts(), {&ampEnv, &freqEnv, &distEnv, &mixEnv},
+                    subLenMs),
+        true};
+
   const float clickDecayMs =
       apvts_.getRawParameterValue(ParamIDs::clickSampleDecay)->load();
   const auto clickAmpEnv =
       env("clickAmp", load(ParamIDs::clickSampleAmp) / 100.0f);
-  bakeLut(clickAmpEnv, clickEngine_.clickAmpLut(), clickDecayMs);
+  if (const auto h = lutInputHash({&clickAmpEnv}, clickDecayMs);
+      keys[AppliedState::kClickLut].needsBake(
+          h, clickEngine_.clickAmpLut().generation()))
+    keys[AppliedState::kClickLut] = {
+        h, bakeLut(clickAmpEnv, clickEngine_.clickAmpLut(), clickDecayMs),
+        true};
+
   const auto directAmpEnv =
       env("directAmp", load(ParamIDs::directAmp) / 100.0f);
-  bakeLut(directAmpEnv, directEngine_.directAmpLut(), directDecayMs);
+  if (const auto h = lutInputHash({&directAmpEnv}, directDecayMs);
+      keys[AppliedState::kDirectLut].needsBake(
+          h, directEngine_.directAmpLut().generation()))
+    keys[AppliedState::kDirectLut] = {
+        h, bakeLut(directAmpEnv, directEngine_.directAmpLut(), directDecayMs),
+        true};
 }
 
 juce::AudioProcessor *JUCE_CALLTYPE createPluginFilter() {
@@ -1,21 +1,33 @@
 #pragma once
 
+#include "DSP/BrickwallLimiter.h"
 #include "DSP/ChannelState.h"
 #include "DSP/ClickEngine.h"
 #include "DSP/DirectEngine.h"
-#include "DSP/LevelDetector.h"
+#include "DSP/DspArena.h"
+#include "DSP/Lookahead.h"
+#include "DSP/MeterEngine.h"
+#include "DSP/PeakDecimator.h"
 #include "DSP/SubEngine.h"
 #include "DSP/TransientDetector.h"
 #include "PresetManager.h"
+#include "StateCodec.h"
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <span>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_audio_utils/juce_audio_utils.h>
 #include <juce_dsp/juce_dsp.h>
 
 class BoomBabyAudioProcessor
     : public juce::AudioProcessor,
-      private juce::AudioProcessorValueTreeState::Listener {
+      private juce::AudioProcessorValueTreeState::Listener,
+      private juce::ValueTree::Listener,
+      private juce::AsyncUpdater {
 public:
   BoomBabyAudioProcessor();
   ~BoomBabyAudioProcessor() override;
@@ -63,38 +75,100 @@ public:
   DirectEngine &directEngine() noexcept { return directEngine_; }
   ChannelState &channelState() noexcept { return channelState_; }
 
-  // ── マスターセクション（ゲイン・レベル計測。将来: limiter / preset
-  // 拡張用）──
+  // ── マスターセクション（ゲイン + ルックアヘッド ブリックウォール リミッター）──
   struct MasterSection {
     std::atomic<float> gainDb_{0.0f};
-    mutable std::array<LevelDetector, 2> detector_; ///< 0=L, 1=R
+    std::atomic<bool> limiterOn_{false};
+    std::atomic<float> ceilingDb_{-1.0f};
+    std::atomic<bool> truePeak_{true};
+    /// UI が前回読んでからの最大ゲインリダクション（dB, 0 以下）
+    std::atomic<float> reductionDb_{0.0f};
+    // 以下はオーディオスレッド専用（UI が書く上のアトミックとはラインを分ける）
+    /// OFF でも遅延線は回し続け、ゲインだけクロスフェードで外す
+    alignas(kCacheLineSize) BrickwallLimiter limiter_;
+    /// ステムをメインと同じだけ遅らせる（Sub/Click/Direct）
+    std::array<Lookahead, 3> stemDelay_;
 
     void setGain(float db) noexcept { gainDb_.store(db); }
     float getGain() const noexcept { return gainDb_.load(); }
-    float getLevelDb(int ch) const noexcept {
-      return detector_[static_cast<std::size_t>(ch & 1)].getPeakDb();
+
+    /// リミッター分の追加レイテンシ（ON/OFF に関わらず一定）
+    int limiterLatency() const noexcept { return limiter_.latencySamples(); }
+    /// リミッター内部に鳴り残りがなければ true
+    bool isSettled() const noexcept { return limiter_.isSettled(); }
+
+    /// オーディオスレッド: 直近のゲインリダクションを UI 向けに積む
+    void publishReduction(float db) noexcept {
+      float held = reductionDb_.load(std::memory_order_relaxed);
+      while (db < held && !reductionDb_.compare_exchange_weak(
+                              held, db, std::memory_order_relaxed))
+        ;
+    }
+    /// UI: 前回からの最大ゲインリダクションを読み、0 に戻す
+    float takeReductionDb() noexcept {
+      return reductionDb_.exchange(0.0f, std::memory_order_relaxed);
     }
   };
   MasterSection &master() noexcept { return master_; }
 
-  // ── 入力モニター（FIFO 波形表示。将来: spectrum / input gain 拡張用）──
+  /// マスター L/R と各チャンネルのメーター（ピーク / RMS / True Peak /
+  /// LUFS）。UI は meters().snapshot() で最新値を読む。
+  MeterEngine &meters() noexcept { return meters_; }
+
+  // ── 入力モニター（波形表示用 min/max ピラミッドの FIFO）──
+  //   オーディオスレッドで PeakDecimator が間引いたビンをレベル毎の FIFO へ
+  //   積む。GUI は表示倍率に合うレベルだけを読み、残りは読み捨てる。
   struct InputMonitor {
-    static constexpr int kCapacity = 192000; ///< ~1秒分 @ 192kHz
-    juce::AbstractFifo fifo_{kCapacity};
-    std::vector<float> data_;
+    using Bin = PeakDecimator::MinMax;
+    static constexpr int kNumLevels = PeakDecimator::kNumLevels;
+    /// レベル 0 の容量（ビン数）。~1.3秒分 @ 192kHz、上位レベルは 1/4 ずつ
+    static constexpr int kBaseCapacity = 16384;
 
-    juce::AbstractFifo &fifo() noexcept { return fifo_; }
-    const std::vector<float> &data() const noexcept { return data_; }
+    struct Level {
+      explicit Level(int capacity)
+          : fifo(capacity), data(static_cast<std::size_t>(capacity)) {}
+      juce::AbstractFifo fifo;
+      std::vector<Bin> data;
+    };
+    std::array<Level, kNumLevels> levels_{Level{kBaseCapacity},
+                                          Level{kBaseCapacity / 4},
+                                          Level{kBaseCapacity / 16}};
+    PeakDecimator decimator_; ///< オーディオスレッド専用
+
+    juce::AbstractFifo &fifo(int level) noexcept {
+      return levels_[static_cast<std::size_t>(level)].fifo;
+    }
+    const std::vector<Bin> &data(int level) const noexcept {
+      return levels_[static_cast<std::size_t>(level)].data;
+    }
   };
   InputMonitor &inputMonitor() noexcept { return inputMonitor_; }
 
   // ── Direct モード（パススルー / トランジェント検出 / ルックアヘッド補正）──
   struct DirectMode {
+    /// Lookahead 選択肢（APVTS Choice と同順）
+    static constexpr std::array<float, 3> kLookaheadMs{0.0f, 2.0f, 5.0f};
+    static constexpr int kMaxLookaheadIdx =
+        static_cast<int>(kLookaheadMs.size()) - 1;
+
     std::atomic<bool> sampleMode_{false};
-    TransientDetector transientDetector_;
+    std::atomic<int> lookaheadIdx_{0};
+    alignas(kCacheLineSize) TransientDetector transientDetector_;
+    Lookahead lookahead_; ///< オーディオスレッド専用
 
     bool isPassthrough() const noexcept { return !sampleMode_.load(); }
     TransientDetector &detector() noexcept { return transientDetector_; }
+
+    static int lookaheadSamplesFor(int idx, double sr) noexcept {
+      const auto i = static_cast<std::size_t>(std::clamp(idx, 0,
+                                                          kMaxLookaheadIdx));
+      return static_cast<int>(std::lround(kLookaheadMs[i] * 0.001 * sr));
+    }
+    /// 現在の実効ルックアヘッド（サンプル）。Sample モードでは 0。
+    int lookaheadSamples(double sr) const noexcept {
+      return isPassthrough() ? lookaheadSamplesFor(lookaheadIdx_.load(), sr)
+                             : 0;
+    }
     /// Sample モード切り替え（UI スレッドから設定）
     void setSampleMode(bool isSample, DirectEngine &engine) noexcept {
       sampleMode_.store(isSample);
@@ -107,15 +181,56 @@ public:
   /// プリセットマネージャー
   PresetManager &presetManager() noexcept { return presetManager_; }
 
+  /// 保留中の LUT 再ベイクがあれば今すぐ行う（メッセージスレッド専用。
+  /// 非同期の handleAsyncUpdate() を待たずに結果を読みたいとき用）
+  void flushPendingLutBake() { handleUpdateNowIfNeeded(); }
+
+  /// 出力バス番号（0 = メインミックス、1〜3 = 各チャンネルのステム）。
+  /// ステムの並びは ChannelState::Channel と同順。
+  enum OutputBus { kMainBus = 0, kSubStemBus, kClickStemBus, kDirectStemBus };
+
+  /// 内部サブブロック長。processBlock はホストのブロック長に関係なく
+  /// この長さ単位でエンジンを回す（スクラッチは常に L1 に収まるサイズ）。
+  static constexpr int kSubBlockSize = 128;
+
+  /// APVTS パラメータ数（.cpp の kAllParamIDs と一致することを検査する）
+  static constexpr std::size_t kNumParams = 56;
+
 private:
   /// APVTS Listener: パラメータ変更を DSP へ反映
   void parameterChanged(const juce::String &parameterID,
                         float newValue) override;
 
-  /// replaceState 後のパラメータ／LUT／サンプル再適用（共通処理）
+  /// AsyncUpdater: parameterChanged で保留した LUT 再ベイクを
+  /// メッセージスレッドで行う
+  void handleAsyncUpdate() override;
+
+  /// 1 パラメータ分の DSP セッター呼び出し（LUT の再ベイクは含まない）
+  void applyParam(const juce::String &parameterID, float value);
+
+  // ValueTree::Listener: 非パラメータ状態（エンベロープ・サンプルパス等）
+  // の変更で保存キャッシュを無効化する
+  void valueTreePropertyChanged(juce::ValueTree &tree,
+                                const juce::Identifier &property) override;
+  void valueTreeChildAdded(juce::ValueTree &parent,
+                           juce::ValueTree &child) override;
+  void valueTreeChildRemoved(juce::ValueTree &parent, juce::ValueTree &child,
+                             int index) override;
+  void valueTreeChildOrderChanged(juce::ValueTree &parent, int oldIndex,
+                                  int newIndex) override;
+  void valueTreeRedirected(juce::ValueTree &tree) override;
+
+  /// Lookahead / Direct モード / リミッターからレイテンシを再計算して
+  /// ホストへ通知
+  void updateLookaheadLatency();
+
+  /// replaceState 後のパラメータ／LUT／サンプル再適用（共通処理）。
+  /// applied_ と比べて変わったものだけを適用する。
   void applyRestoredState();
 
-  /// 保存済み APVTS state の ENVELOPE ノードから全 LUT を再ベイク。
+  /// 保存済み APVTS state の ENVELOPE ノードから LUT を再ベイク。
+  /// 入力（エンベロープ・期間）も LUT も前回焼いたときのままのグループは
+  /// 焼き直さない。
   void bakeAllLutsFromState();
 
   juce::MidiKeyboardState keyboardState;
@@ -124,11 +239,15 @@ private:
   DirectEngine directEngine_;
   ChannelState channelState_;
   MasterSection master_;
+  MeterEngine meters_;
   InputMonitor inputMonitor_;
   DirectMode directMode_;
-  std::vector<float> monoMixBuffer_; ///< トランジェント検出用モノ合成バッファ
-  std::vector<float> passthroughL_; ///< Direct パススルー用 L入力
-  std::vector<float> passthroughR_; ///< Direct パススルー用 R入力
+  /// インスタンス内の DSP 作業メモリ（prepareToPlay で一括確保）
+  DspArena arena_;
+  // 以下のスクラッチは arena_ から kSubBlockSize 分だけ切り出す
+  std::span<float> monoMixBuffer_; ///< トランジェント検出用モノ合成バッファ
+  std::span<float> passthroughL_;  ///< Direct パススルー用 L入力
+  std::span<float> passthroughR_;  ///< Direct パススルー用 R入力
 
   /// APVTS（全パラメータの一元管理 + 状態保存/復元）
   static juce::AudioProcessorValueTreeState::ParameterLayout
@@ -141,5 +260,49 @@ private:
   /// DAW Undo/Redo 検出用: setStateInformation 呼び出し毎にインクリメント
   std::atomic<int> nonParamStateVersion_{0};
 
+  /// 直近に DSP へ適用した状態。applyRestoredState() はこれと比べて
+  /// 変わった部分だけを適用する。
+  struct AppliedState {
+    /// kAllParamIDs 順の適用済み値（未適用は NaN。任意のスレッドから更新）
+    std::array<std::atomic<float>, kNumParams> params;
+
+    /// LUT グループ（Sub バンク / Click / Direct）ごとの焼き込み記録
+    struct LutKey {
+      std::uint64_t inputHash = 0;  ///< エンベロープ点列と期間のハッシュ
+      std::uint64_t generation = 0; ///< 焼いた直後の LUT 世代
+      bool valid = false;
+
+      /// 入力が変わったか、他所（エディタ / reset）で焼き直されていれば true
+      bool needsBake(std::uint64_t hash, std::uint64_t gen) const noexcept {
+        return !valid || hash != inputHash || gen != generation;
+      }
+    };
+    enum LutGroup : std::size_t {
+      kSubLuts,
+      kClickLut,
+      kDirectLut,
+      kNumGroups
+    };
+    std::array<LutKey, kNumGroups> luts;
+    std::mutex lutMutex; ///< luts と焼き込みを直列化
+  };
+  AppliedState applied_;
+
+  /// getStateInformation の結果キャッシュ。状態が変わっていなければ
+  /// 前回のバイナリをそのまま返す（ホストの自動保存 / Undo 毎の呼び出し用）。
+  struct StateCache {
+    std::mutex mutex;
+    juce::MemoryBlock blob;
+    juce::String presetName; ///< blob に書いたプリセット名
+    StateCodec::SampleHashCache hashes;
+  };
+  StateCache stateCache_;
+  /// パラメータ / ValueTree が変わったら true（任意のスレッドから立てる）
+  std::atomic<bool> stateDirty_{true};
+  /// LUT 駆動パラメータが変わったら true。parameterChanged は
+  /// オーディオスレッドからも呼ばれるため、ここでは印を付けるだけにして
+  /// 焼き込み（ロック・確保を伴う）は handleAsyncUpdate() で行う。
+  std::atomic<bool> lutsDirty_{false};
+
   JUCE_LEAK_DETECTOR(BoomBabyAudioProcessor)
 };
@@ -0,0 +1,226 @@
+#include "PresetCatalog.h"
+#include "StateCodec.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+juce::StringArray readTags(const void *xml, size_t size) {
+  juce::StringArray tags;
+  juce::XmlDocument doc(
+      juce::String::fromUTF8(static_cast<const char *>(xml),
+                             static_cast<int>(size)));
+  // ルート要素の属性だけを読む（PARAM 等の子要素は解析しない）
+  if (const auto root = doc.getDocumentElement(true)) {
+    tags.addTokens(root->getStringAttribute("tags"), ",", "\"");
+    tags.trim();
+    tags.removeEmptyStrings();
+  }
+  return tags;
+}
+
+/// entries の User 側へ entry をフォルダ順で入れる（同じフォルダは置き換え）
+void insertUser(std::vector<PresetCatalog::Entry> &entries,
+                PresetCatalog::Entry entry) {
+  std::erase_if(entries, [&entry](const PresetCatalog::Entry &e) {
+    return !e.isFactory && e.folder == entry.folder;
+  });
+  const auto pos = std::ranges::find_if(
+      entries, [&entry](const PresetCatalog::Entry &e) {
+        return !e.isFactory && entry.folder < e.folder;
+      });
+  entries.insert(pos, std::move(entry));
+}
+} // namespace
+
+// ─────────────────────────────────────────────────────────────────
+// Snapshot
+// ─────────────────────────────────────────────────────────────────
+PresetCatalog::Snapshot::Snapshot(std::vector<Entry> entries)
+    : entries_(std::move(entries)) {
+  byName_.reserve(entries_.size());
+  sortedNames_.reserve(entries_.size());
+  for (int i = 0; i < size(); ++i) {
+    const auto &name = entries_[static_cast<std::size_t>(i)].name;
+    byName_.try_emplace(name, i);
+    sortedNames_.emplace_back(name.toLowerCase(), i);
+  }
+  std::sort(sortedNames_.begin(), sortedNames_.end());
+}
+
+int PresetCatalog::Snapshot::indexOf(const juce::String &name) const {
+  const auto it = byName_.find(name);
+  return it != byName_.end() ? it->second : -1;
+}
+
+int PresetCatalog::Snapshot::step(int index, int delta) const noexcept {
+  const int n = size();
+  if (n == 0)
+    return -1;
+  if (index < 0)
+    return delta > 0 ? 0 : n - 1;
+  return ((index + delta) % n + n) % n;
+}
+
+std::vector<int>
+PresetCatalog::Snapshot::searchPrefix(const juce::String &prefix,
+                                      int maxResults) const {
+  std::vector<int> out;
+  const auto key = prefix.toLowerCase();
+  auto it = std::lower_bound(
+      sortedNames_.begin(), sortedNames_.end(), key,
+      [](const auto &entry, const juce::String &k) {
+        return entry.first < k;
+      });
+  for (; it != sortedNames_.end() && it->first.startsWith(key); ++it) {
+    if (static_cast<int>(out.size()) >= maxResults)
+      break;
+    out.push_back(it->second);
+  }
+  return out;
+}
+
+// ─────────────────────────────────────────────────────────────────
+// lifecycle
+// ─────────────────────────────────────────────────────────────────
+PresetCatalog::PresetCatalog(std::vector<Entry> builtIn, juce::File userDir,
+                             int pollIntervalMs)
+    : juce::Thread("BoomBaby preset catalog"), builtIn_(std::move(builtIn)),
+      userDir_(std::move(userDir)),
+      pollIntervalMs_(pollIntervalMs),
+      snapshot_(std::make_shared<const Snapshot>(builtIn_)) {}
+
+PresetCatalog::~PresetCatalog() { stopThread(5000); }
+
+void PresetCatalog::start() { startThread(juce::Thread::Priority::low); }
+
+std::shared_ptr<const PresetCatalog::Snapshot>
+PresetCatalog::snapshot() const {
+  const std::scoped_lock lock(mutex_);
+  return snapshot_;
+}
+
+PresetCatalog::Entry PresetCatalog::makeEntry(const juce::String &name,
+                                              juce::File folder,
+                                              const void *xml, size_t size,
+                                              bool isFactory) {
+  return {name, std::move(folder), readTags(xml, size),
+          StateCodec::hashBytes(xml, size), isFactory};
+}
+
+std::optional<PresetCatalog::Entry>
+PresetCatalog::readEntry(const juce::File &folder) {
+  juce::MemoryBlock data;
+  if (!folder.getChildFile("state.xml").loadFileAsData(data))
+    return std::nullopt;
+  return makeEntry(folder.getFileNameWithoutExtension(), folder,
+                   data.getData(), data.getSize(), false);
+}
+
+void PresetCatalog::add(Entry entry) {
+  // 書き込み後に番号を取るので、この番号以降の走査はフォルダを見つける
+  const auto ticket = requested_.fetch_add(1) + 1;
+  {
+    const std::scoped_lock lock(mutex_);
+    auto entries = snapshot_->entries();
+    insertUser(entries, entry);
+    snapshot_ = std::make_shared<const Snapshot>(std::move(entries));
+    added_.push_back({ticket, std::move(entry)});
+  }
+  notify();
+}
+
+void PresetCatalog::rescan() {
+  requested_.fetch_add(1);
+  notify();
+}
+
+bool PresetCatalog::rescanAndWait(int timeoutMs) {
+  const auto ticket = requested_.fetch_add(1) + 1;
+  notify();
+  return waitForScan(ticket, timeoutMs);
+}
+
+bool PresetCatalog::waitForScan(std::uint64_t ticket, int timeoutMs) const {
+  std::unique_lock lock(mutex_);
+  return published_.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                             [&] { return served_ >= ticket; });
+}
+
+// ─────────────────────────────────────────────────────────────────
+// 走査スレッド
+// ─────────────────────────────────────────────────────────────────
+void PresetCatalog::run() {
+  while (!threadShouldExit()) {
+    // 走査を始める前に番号を取るので、走査中に来た要求は次の周で拾う
+    const auto ticket = requested_.load();
+    if (ticket > served_ || directoriesChanged()) {
+      auto entries = scan();
+      if (threadShouldExit())
+        break;
+      {
+        const std::scoped_lock lock(mutex_);
+        // 走査より後に add() されたものは、この結果に無くても残す
+        std::erase_if(added_,
+                      [ticket](const Added &a) { return a.ticket <= ticket; });
+        for (const auto &a : added_)
+          insertUser(entries, a.entry);
+        snapshot_ = std::make_shared<const Snapshot>(std::move(entries));
+        served_ = ticket;
+      }
+      ready_.store(true);
+      published_.notify_all();
+    }
+    if (requested_.load() <= served_)
+      wait(pollIntervalMs_);
+  }
+}
+
+bool PresetCatalog::directoriesChanged() {
+  const auto user = userDir_.getLastModificationTime();
+  const bool changed = user != userModified_;
+  userModified_ = user;
+  return changed;
+}
+
+std::vector<PresetCatalog::Entry> PresetCatalog::scan() {
+  std::vector<Entry> entries = builtIn_;
+  std::unordered_map<juce::String, Cached> nextCache;
+  scanDirectory(userDir_, entries, nextCache);
+  cache_ = std::move(nextCache); // 消えたフォルダの控えはここで落ちる
+  return entries;
+}
+
+void PresetCatalog::scanDirectory(
+    const juce::File &dir, std::vector<Entry> &out,
+    std::unordered_map<juce::String, Cached> &nextCache) {
+  if (!dir.isDirectory())
+    return;
+  juce::Array<juce::File> folders;
+  for (const auto &entry : juce::RangedDirectoryIterator(
+           dir, false, "*.bbpreset", juce::File::findDirectories))
+    folders.add(entry.getFile());
+  folders.sort();
+
+  for (const auto &folder : folders) {
+    if (threadShouldExit())
+      return;
+    const auto stateFile = folder.getChildFile("state.xml");
+    const auto path = folder.getFullPathName();
+    const auto modified = stateFile.getLastModificationTime();
+    const auto size = stateFile.getSize();
+
+    if (const auto it = cache_.find(path); it != cache_.end() &&
+                                           it->second.modified == modified &&
+                                           it->second.size == size) {
+      out.push_back({folder.getFileNameWithoutExtension(), folder,
+                     it->second.tags, it->second.hash, false});
+    } else if (auto entry = readEntry(folder)) {
+      out.push_back(std::move(*entry));
+    } else {
+      continue; // state.xml の無いフォルダはプリセットとして扱わない
+    }
+    nextCache.insert_or_assign(
+        path, Cached{modified, size, out.back().tags, out.back().contentHash});
+  }
+}
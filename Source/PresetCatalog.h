@@ -0,0 +1,148 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// .bbpreset フォルダのメモリ上の索引。
+///
+/// User ディレクトリの走査はバックグラウンドスレッドで行い、組み込みの
+/// Factory プリセットと合わせた結果を不変の Snapshot として差し替える。UI は snapshot() を取り出して
+/// 読むだけなので、プリセットが数千個あっても ◀ / ▶ で待たされない。
+///   - 名前 → 位置はハッシュで引き、前後移動は O(1)
+///   - 名前の前方一致検索は整列済みの索引を二分探索
+///   - ディレクトリは定期的に更新時刻を見て、変わったときだけ再走査する
+///     （更新時刻とサイズが同じ state.xml は前回の結果を使い回す）。
+///     フォルダ内の state.xml だけの書き換えはディレクトリの更新時刻に
+///     出ないので、自分で書いたものは add() / rescan() で知らせる
+class PresetCatalog : private juce::Thread {
+public:
+  struct Entry {
+    juce::String name; ///< フォルダ名（拡張子なし）
+    juce::File folder; ///< Factory（埋め込み）は空
+    juce::StringArray tags;       ///< state.xml ルートの tags 属性
+    juce::uint64 contentHash = 0; ///< state.xml の内容ハッシュ
+    bool isFactory = false;
+  };
+
+  /// 1 回の走査結果（不変）。並びは Factory → User、それぞれ名前順。
+  class Snapshot {
+  public:
+    Snapshot() = default;
+    explicit Snapshot(std::vector<Entry> entries);
+
+    const std::vector<Entry> &entries() const noexcept { return entries_; }
+    bool empty() const noexcept { return entries_.empty(); }
+    int size() const noexcept { return static_cast<int>(entries_.size()); }
+    const Entry &operator[](int index) const {
+      return entries_[static_cast<std::size_t>(index)];
+    }
+
+    /// name の位置（同名が複数あれば先頭、無ければ -1）
+    int indexOf(const juce::String &name) const;
+
+    /// index から delta だけ進めた位置（両端で折り返す）。index が -1 の
+    /// ときは ▶ なら先頭、◀ なら末尾になる。
+    int step(int index, int delta) const noexcept;
+
+    /// 名前が prefix で始まる（大文字小文字を区別しない）エントリの位置を
+    /// 名前順で最大 maxResults 件返す。
+    std::vector<int> searchPrefix(const juce::String &prefix,
+                                  int maxResults) const;
+
+  private:
+    std::vector<Entry> entries_;
+    std::unordered_map<juce::String, int> byName_;
+    /// 小文字化した名前と位置の組（名前順）
+    std::vector<std::pair<juce::String, int>> sortedNames_;
+  };
+
+  /// builtIn は Factory プリセット（走査せずそのまま先頭に並べる）
+  PresetCatalog(std::vector<Entry> builtIn, juce::File userDir,
+                int pollIntervalMs = 2000);
+  ~PresetCatalog() override;
+
+  /// 走査スレッドを開始する（ディレクトリの準備ができてから呼ぶ）
+  void start();
+
+  /// 最新の走査結果（初回の走査が終わるまでは組み込みのみ）
+  std::shared_ptr<const Snapshot> snapshot() const;
+
+  /// 初回の走査が終わっていれば true
+  bool isReady() const noexcept { return ready_.load(); }
+
+  /// 初回の走査が終わるまで最大 timeoutMs 待つ
+  bool waitUntilReady(int timeoutMs) const {
+    return waitForScan(1, timeoutMs);
+  }
+
+  /// state.xml の中身からエントリを作る（タグ・内容ハッシュを埋める）
+  static Entry makeEntry(const juce::String &name, juce::File folder,
+                         const void *xml, size_t size, bool isFactory);
+
+  /// folder（.bbpreset）の state.xml を読んでエントリを作る
+  /// （state.xml が読めなければ nullopt）
+  static std::optional<Entry> readEntry(const juce::File &folder);
+
+  /// 保存・取り込み直後のフォルダを、走査を待たずに snapshot() へ入れる
+  /// （同じフォルダのエントリは置き換える）。ディスクとの突き合わせは
+  /// 続けて行う再走査に任せるので、呼び出し側は待たない。
+  void add(Entry entry);
+
+  /// 次の巡回を待たずに再走査させる
+  void rescan();
+
+  /// 再走査させ、その結果が snapshot() に出るまで最大 timeoutMs 待つ
+  /// （外部でのフォルダ操作を確実に反映させたいとき。メッセージスレッド
+  /// からの保存・取り込みは add() を使う）
+  bool rescanAndWait(int timeoutMs);
+
+private:
+  struct Cached {
+    juce::Time modified;
+    juce::int64 size = 0;
+    juce::StringArray tags;
+    juce::uint64 hash = 0;
+  };
+
+  void run() override;
+  bool waitForScan(std::uint64_t ticket, int timeoutMs) const;
+  bool directoriesChanged();
+  std::vector<Entry> scan();
+  void scanDirectory(const juce::File &dir, std::vector<Entry> &out,
+                     std::unordered_map<juce::String, Cached> &nextCache);
+
+  const std::vector<Entry> builtIn_;
+  const juce::File userDir_;
+  const int pollIntervalMs_;
+
+  mutable std::mutex mutex_;
+  mutable std::condition_variable published_;
+  std::shared_ptr<const Snapshot> snapshot_;
+  /// add() したエントリと、その時点の再走査要求の番号（mutex_ で保護）。
+  /// その番号より前に始まった走査の結果には出ないことがあるので、
+  /// 番号に追いつく走査が出るまでは結果に足して公開する。
+  struct Added {
+    std::uint64_t ticket;
+    Entry entry;
+  };
+  std::vector<Added> added_;
+  /// 反映済みの再走査要求の番号（mutex_ で保護、書くのは走査スレッドだけ）
+  std::uint64_t served_ = 0;
+  /// 再走査要求の番号。served_ より大きければ走査が必要（初回は 1）
+  std::atomic<std::uint64_t> requested_{1};
+  std::atomic<bool> ready_{false};
+
+  // 以下は走査スレッド専用
+  /// フォルダパス → 前回の結果
+  std::unordered_map<juce::String, Cached> cache_;
+  juce::Time userModified_;
+};
@@ -1,75 +1,119 @@
 #include "PresetManager.h"
-#include "BinaryData.h"
+#include "FactoryPresets.h"
+#include "SampleRef.h"
+#include "SampleStore.h"
+#include "StateCodec.h"
+
+#include <array>
+#include <utility>
+
+namespace {
+juce::File userPresetsDirectory() {
+  return juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+      .getChildFile("Auditive")
+      .getChildFile("BoomBaby")
+      .getChildFile("Presets");
+}
+
+/// 自己完結フォルダでのサンプルのファイル名
+constexpr std::array<std::pair<const char *, const char *>, 2> kSampleFiles = {
+    {{"clickSamplePath", "click_sample.wav"},
+     {"directSamplePath", "direct_sample.wav"}}};
+} // namespace
 
 // ─────────────────────────────────────────────────────────────────
 // ctor
 // ─────────────────────────────────────────────────────────────────
 PresetManager::PresetManager(juce::AudioProcessorValueTreeState &apvts)
-    : apvts_(apvts) {
-  ensureDirectoryExists();
-
-  // Factory プリセット展開（バージョン不一致 or 未展開時のみ）
-  auto factoryDir = getFactoryDirectory();
-  auto versionFile = factoryDir.getChildFile(".version");
-  const juce::String currentVersion(JucePlugin_VersionString);
-
-  if (!versionFile.existsAsFile() ||
-      versionFile.loadFileAsString().trim() != currentVersion) {
-    factoryDir.createDirectory();
-    expandFactoryPresets();
-    versionFile.replaceWithText(currentVersion);
-  }
+    : apvts_(apvts) {}
+
+PresetManager::Shared::Shared()
+    : catalog(factoryCatalogEntries(), userPresetsDirectory()) {
+  // User ディレクトリの走査はカタログのスレッドが行う。ここではディスクに
+  // 触れない（セッションを開くと数十インスタンスが一斉に生成されるため）
+  catalog.start();
+}
+
+std::vector<PresetCatalog::Entry> PresetManager::factoryCatalogEntries() {
+  std::vector<PresetCatalog::Entry> entries;
+  for (const auto &p : FactoryPresets::all())
+    entries.push_back(PresetCatalog::makeEntry(
+        p.name, {}, p.stateData, static_cast<size_t>(p.stateSize), true));
+  return entries;
 }
 
 // ─────────────────────────────────────────────────────────────────
 // ディレクトリ
 // ─────────────────────────────────────────────────────────────────
 juce::File PresetManager::getPresetsDirectory() const {
-  return juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
-      .getChildFile("Auditive")
-      .getChildFile("BoomBaby")
-      .getChildFile("Presets");
-}
-
-juce::File PresetManager::getFactoryDirectory() const {
-  return getPresetsDirectory().getChildFile("Factory");
-}
-
-void PresetManager::ensureDirectoryExists() const {
-  getPresetsDirectory().createDirectory();
+  return userPresetsDirectory();
 }
 
 // ─────────────────────────────────────────────────────────────────
-// 保存
+// 保存 / 書き出し / 取り込み
 // ─────────────────────────────────────────────────────────────────
 bool PresetManager::savePreset(const juce::String &name) {
   if (name.isEmpty())
     return false;
 
-  auto presetDir = getPresetsDirectory().getChildFile(name + ".bbpreset");
+  const auto presetDir =
+      getPresetsDirectory().getChildFile(name + ".bbpreset");
+  if (!writePresetFolder(apvts_.copyState(), presetDir, false))
+    return false;
+
+  currentPresetName_ = name;
+  // 直後に開かれる一覧・◀ / ▶ に出るよう、走査を待たずに索引へ入れる
+  if (auto entry = PresetCatalog::readEntry(presetDir))
+    shared_->catalog.add(std::move(*entry));
+  return true;
+}
+
+bool PresetManager::exportPreset(const juce::File &presetFolder) {
+  return writePresetFolder(apvts_.copyState(), presetFolder, true);
+}
+
+bool PresetManager::importPreset(const juce::File &presetFolder) {
+  // 自己完結フォルダの ./ サンプルは絶対パスに解決されて読まれる
+  auto state = PresetPrefetcher::readPresetState(presetFolder);
+  if (!state.isValid())
+    return false;
 
+  const auto presetDir = getPresetsDirectory().getChildFile(
+      presetFolder.getFileNameWithoutExtension() + ".bbpreset");
+  if (!writePresetFolder(std::move(state), presetDir, false))
+    return false;
+
+  if (auto entry = PresetCatalog::readEntry(presetDir))
+    shared_->catalog.add(std::move(*entry));
+  return true;
+}
+
+bool PresetManager::writePresetFolder(juce::ValueTree state,
+                                      const juce::File &presetDir,
+                                      bool selfContained) {
   if (!presetDir.createDirectory())
     return false;
 
-  // 現在の APVTS state をコピー
-  auto state = apvts_.copyState();
-
-  // サンプルファイルをプリセットフォルダにコピーし、パスを相対化
-  auto copySample = [&](const char *propName, const char *destName) {
-    const auto path = state.getProperty(propName).toString();
-    if (path.isEmpty())
-      return;
-    const juce::File src(path);
-    if (!src.existsAsFile())
-      return;
-    auto dest = presetDir.getChildFile(destName);
-    src.copyFileTo(dest);
-    state.setProperty(propName, juce::String("./" + juce::String(destName)),
-                      nullptr);
-  };
-
-  copySample("clickSamplePath", "click_sample.wav");
-  copySample("directSamplePath", "direct_sample.wav");
+  // 自己完結: サンプルをフォルダにコピーしてパスを相対化
+  // 通常: サンプル置き場に入れてハッシュ参照にする（同じ中身は 1 つだけ）
+  juce::Array<juce::File> staleCopies;
+  for (const auto &[prop, fileName] : kSampleFiles) {
+    // 内容ハッシュは実行中の付け替え用。プリセットへは持ち出さない
+    state.removeProperty(StateCodec::hashPropFor(prop), nullptr);
+    const auto ref = state.getProperty(prop).toString();
+    if (ref.isEmpty())
+      continue;
+    const auto copy = presetDir.getChildFile(fileName);
+    if (selfContained) {
+      if (SampleRef::copyTo(ref, copy))
+        state.setProperty(prop, "./" + juce::String(fileName), nullptr);
+    } else if (const auto stored = SampleStore::add(ref); stored.isNotEmpty()) {
+      state.setProperty(prop, stored, nullptr);
+      // 以前の形式で上書き保存したときに残るコピー
+      if (copy.existsAsFile())
+        staleCopies.add(copy);
+    }
+  }
 
   // state.xml 書き出し
   auto xml = state.createXml();
@@ -79,7 +123,8 @@ bool PresetManager::savePreset(const juce::String &name) {
   if (auto stateFile = presetDir.getChildFile("state.xml"); !xml->writeTo(stateFile))
     return false;
 
-  currentPresetName_ = name;
+  for (const auto &f : staleCopies)
+    f.deleteFile();
   return true;
 }
 
@@ -87,164 +132,110 @@ bool PresetManager::savePreset(const juce::String &name) {
 // 読み込み
 // ─────────────────────────────────────────────────────────────────
 bool PresetManager::loadPreset(const juce::File &presetDir) {
-  auto stateFile = presetDir.getChildFile("state.xml");
-  if (!stateFile.existsAsFile())
+  // 先読み済みなら state.xml の解析もサンプルのデコードも済んでいる
+  const auto prepared = shared_->prefetcher.find(presetDir);
+  auto state = prepared ? prepared->state.createCopy()
+                        : PresetPrefetcher::readPresetState(presetDir);
+  if (!state.isValid())
     return false;
 
-  auto xml = juce::XmlDocument::parse(stateFile);
-  if (!xml)
-    return false;
+  loading_ = prepared;
+  applyLoadedState(std::move(state), presetDir.getFileNameWithoutExtension());
+  loading_.reset();
+  return true;
+}
 
-  auto state = juce::ValueTree::fromXml(*xml);
+bool PresetManager::loadFactoryPreset(const juce::String &name) {
+  const auto *preset = FactoryPresets::find(name);
+  if (preset == nullptr)
+    return false;
+  auto state = FactoryPresets::readState(*preset);
   if (!state.isValid())
     return false;
+  applyLoadedState(std::move(state), preset->name);
+  return true;
+}
 
-  // 相対パス (./ 始まり) をプリセットフォルダ基準の絶対パスに解決
-  auto resolvePath = [&](const char *propName) {
-    const auto path = state.getProperty(propName).toString();
-    if (path.startsWith("./")) {
-      auto resolved = presetDir.getChildFile(path.substring(2));
-      state.setProperty(propName, resolved.getFullPathName(), nullptr);
-    }
-  };
-
-  resolvePath("clickSamplePath");
-  resolvePath("directSamplePath");
-
+void PresetManager::applyLoadedState(juce::ValueTree state,
+                                     const juce::String &name) {
   // APVTS state 差し替え
   apvts_.replaceState(state);
   // XML 内の presetName 属性が古い名前の場合でも上書きされないよう、
-  // ディレクトリ名を正とし、applyRestoredState() より先に両方更新する
-  currentPresetName_ = presetDir.getFileNameWithoutExtension();
+  // フォルダ名（Factory はプリセット名）を正とし、applyRestoredState()
+  // より先に両方更新する
+  currentPresetName_ = name;
   apvts_.state.setProperty("presetName", currentPresetName_, nullptr);
 
   if (onStateReplaced_)
     onStateReplaced_();
 
-  return true;
+  // 次の ◀ / ▶ に備えて前後を先読み
+  prefetchNeighbours();
+}
+
+std::shared_ptr<const SamplePlayer::Decoded>
+PresetManager::preparedSample(const juce::String &ref) const {
+  if (loading_ == nullptr)
+    return nullptr;
+  for (const auto &sample : loading_->samples)
+    if (SampleRef::sameSample(sample->source, ref) &&
+        SampleRef::isCurrent(*sample))
+      return sample;
+  return nullptr;
 }
 
 // ─────────────────────────────────────────────────────────────────
 // ナビゲーション
 // ─────────────────────────────────────────────────────────────────
-void PresetManager::loadNextPreset() {
-  auto all = getAllPresetFolders();
-  if (all.isEmpty())
+void PresetManager::stepPreset(int delta) {
+  // 初回の走査中でも待たず、その時点の一覧（Factory + 保存・取り込み済み）
+  // で動く。ただし今のプリセットがまだ一覧に無ければ位置が分からないので、
+  // 先頭・末尾へ飛ばずに何もしない
+  const auto snapshot = shared_->catalog.snapshot();
+  const int current = snapshot->indexOf(currentPresetName_);
+  if (current < 0 && !shared_->catalog.isReady())
     return;
-
-  int idx = -1;
-  for (int i = 0; i < all.size(); ++i) {
-    if (all[i].getFileNameWithoutExtension() == currentPresetName_) {
-      idx = i;
-      break;
-    }
-  }
-
-  idx = (idx + 1) % all.size();
-  loadPreset(all[idx]);
+  const int idx = snapshot->step(current, delta);
+  if (idx < 0)
+    return;
+  if (const auto &entry = (*snapshot)[idx]; entry.isFactory)
+    loadFactoryPreset(entry.name);
+  else
+    loadPreset(entry.folder);
 }
 
-void PresetManager::loadPreviousPreset() {
-  auto all = getAllPresetFolders();
-  if (all.isEmpty())
+void PresetManager::prefetchNeighbours() {
+  const auto snapshot = shared_->catalog.snapshot();
+  const int idx = snapshot->indexOf(currentPresetName_);
+  if (idx < 0)
     return;
+  // Factory はメモリ上にあり、解析・デコードも軽いので先読みしない
+  std::vector<juce::File> folders;
+  for (const int delta : {+1, -1})
+    if (const auto &entry = (*snapshot)[snapshot->step(idx, delta)];
+        !entry.isFactory)
+      folders.push_back(entry.folder);
+  shared_->prefetcher.prefetch(folders);
+}
 
-  int idx = 0;
-  for (int i = 0; i < all.size(); ++i) {
-    if (all[i].getFileNameWithoutExtension() == currentPresetName_) {
-      idx = i;
-      break;
-    }
-  }
+void PresetManager::loadNextPreset() { stepPreset(+1); }
 
-  idx = (idx - 1 + all.size()) % all.size();
-  loadPreset(all[idx]);
-}
+void PresetManager::loadPreviousPreset() { stepPreset(-1); }
 
 // ─────────────────────────────────────────────────────────────────
 // 一覧
 // ─────────────────────────────────────────────────────────────────
-juce::Array<juce::File> PresetManager::getFactoryPresets() const {
-  juce::Array<juce::File> results;
-  if (auto factoryDir = getFactoryDirectory(); factoryDir.isDirectory()) {
-    for (const auto &entry : juce::RangedDirectoryIterator(
-             factoryDir, false, "*.bbpreset", juce::File::findDirectories))
-      results.add(entry.getFile());
-  }
-  results.sort();
-  return results;
+juce::StringArray PresetManager::getFactoryPresets() const {
+  juce::StringArray names;
+  for (const auto &p : FactoryPresets::all())
+    names.add(p.name);
+  return names;
 }
 
 juce::Array<juce::File> PresetManager::getUserPresets() const {
   juce::Array<juce::File> results;
-  auto presetsDir = getPresetsDirectory();
-  for (const auto &entry : juce::RangedDirectoryIterator(
-           presetsDir, false, "*.bbpreset", juce::File::findDirectories))
-    results.add(entry.getFile());
-  results.sort();
+  for (const auto &entry : shared_->catalog.snapshot()->entries())
+    if (!entry.isFactory)
+      results.add(entry.folder);
   return results;
 }
-
-juce::Array<juce::File> PresetManager::getAllPresetFolders() const {
-  juce::Array<juce::File> results;
-  results.addArray(getFactoryPresets());
-  results.addArray(getUserPresets());
-  return results;
-}
-
-// ─────────────────────────────────────────────────────────────────
-// Factory プリセット展開（BinaryData → ディスク）
-// ─────────────────────────────────────────────────────────────────
-void PresetManager::expandFactoryPresets() const {
-  struct FactoryEntry {
-    const char *presetName;
-    const char *stateData;
-    int stateSize;
-    // サンプル付きプリセット用（将来拡張）
-    const char *clickData = nullptr;
-    int clickSize = 0;
-    const char *directData = nullptr;
-    int directSize = 0;
-  };
-
-  const std::array<FactoryEntry, 3> entries = {{
-      {"default",      BinaryData::default_state_xml,
-       BinaryData::default_state_xmlSize},
-      {"junglist",     BinaryData::junglist_state_xml,
-       BinaryData::junglist_state_xmlSize,
-       nullptr, 0,
-       BinaryData::junglist_direct_wav, BinaryData::junglist_direct_wavSize},
-      {"sub osc only", BinaryData::sub_osc_only_state_xml,
-       BinaryData::sub_osc_only_state_xmlSize},
-  }};
-
-  auto factoryDir = getFactoryDirectory();
-
-  // 旧バージョンの不要プリセットを削除
-  juce::StringArray validNames;
-  for (const auto &e : entries)
-    validNames.add(juce::String(e.presetName) + ".bbpreset");
-
-  for (const auto &entry : juce::RangedDirectoryIterator(
-           factoryDir, false, "*.bbpreset", juce::File::findDirectories)) {
-    if (!validNames.contains(entry.getFile().getFileName()))
-      entry.getFile().deleteRecursively();
-  }
-
-  for (const auto &e : entries) {
-    auto presetDir =
-        factoryDir.getChildFile(juce::String(e.presetName) + ".bbpreset");
-    presetDir.createDirectory();
-
-    presetDir.getChildFile("state.xml")
-        .replaceWithData(e.stateData, static_cast<size_t>(e.stateSize));
-
-    if (e.clickData != nullptr)
-      presetDir.getChildFile("click_sample.wav")
-          .replaceWithData(e.clickData, static_cast<size_t>(e.clickSize));
-
-    if (e.directData != nullptr)
-      presetDir.getChildFile("direct_sample.wav")
-          .replaceWithData(e.directData, static_cast<size_t>(e.directSize));
-  }
-}
@@ -1,28 +1,41 @@
 #pragma once
 
+#include "PresetCatalog.h"
+#include "PresetPrefetcher.h"
+
 #include <functional>
 #include <juce_audio_processors/juce_audio_processors.h>
 
 /// .bbpreset フォルダ形式のプリセット保存 / 読み込み / ナビゲーション。
+/// Factory プリセットはディスクに展開せず BinaryData から直接読む。
+/// User プリセットのサンプルは SampleStore に置き、ハッシュで参照する。
+/// 他の環境へ持ち出すときは exportPreset() で自己完結フォルダにする。
 class PresetManager {
 public:
   explicit PresetManager(juce::AudioProcessorValueTreeState &apvts);
 
   // ── ディレクトリ ──
   juce::File getPresetsDirectory() const;
-  juce::File getFactoryDirectory() const;
 
   // ── 保存 / 読み込み ──
   bool savePreset(const juce::String &name);
+  /// 現在の状態を、サンプルもコピーした自己完結フォルダとして書き出す
+  bool exportPreset(const juce::File &presetFolder);
+  /// .bbpreset フォルダ（自己完結でもよい）を User プリセットに取り込む。
+  /// サンプルはサンプル置き場へ移る。
+  bool importPreset(const juce::File &presetFolder);
   bool loadPreset(const juce::File &presetFolder);
+  /// 埋め込みの Factory プリセットを読み込む（ディスクに触れない）
+  bool loadFactoryPreset(const juce::String &name);
 
   // ── ナビゲーション ──
   void loadNextPreset();
   void loadPreviousPreset();
 
   // ── 一覧 ──
-  juce::Array<juce::File> getFactoryPresets() const;
+  juce::StringArray getFactoryPresets() const;
   juce::Array<juce::File> getUserPresets() const;
+  const PresetCatalog &catalog() const noexcept { return shared_->catalog; }
 
   // ── 現在のプリセット名 ──
   const juce::String &getCurrentPresetName() const noexcept {
@@ -36,12 +49,32 @@ public:
     onStateReplaced_ = std::move(cb);
   }
 
+  /// loadPreset() が先読み結果を使っている間（onStateReplaced コールバック
+  /// の中）だけ、サンプル参照 ref のデコード済みデータを返す。
+  /// それ以外は nullptr。
+  std::shared_ptr<const SamplePlayer::Decoded>
+  preparedSample(const juce::String &ref) const;
+
 private:
   juce::AudioProcessorValueTreeState &apvts_;
   juce::String currentPresetName_{"Init"};
   std::function<void()> onStateReplaced_;
+  /// 索引と先読みはプロセス内の全インスタンスで 1 つを共有する
+  /// （何個挿しても走査・先読みのスレッドは 1 本ずつ）
+  struct Shared {
+    Shared();
+    PresetCatalog catalog;
+    PresetPrefetcher prefetcher;
+  };
+  juce::SharedResourcePointer<Shared> shared_;
+  /// loadPreset() 中だけ有効な先読み結果
+  std::shared_ptr<const PresetPrefetcher::Prepared> loading_;
 
-  juce::Array<juce::File> getAllPresetFolders() const;
-  void ensureDirectoryExists() const;
-  void expandFactoryPresets() const;
+  static bool writePresetFolder(juce::ValueTree state,
+                                const juce::File &presetDir,
+                                bool selfContained);
+  void applyLoadedState(juce::ValueTree state, const juce::String &name);
+  void stepPreset(int delta);
+  void prefetchNeighbours();
+  static std::vector<PresetCatalog::Entry> factoryCatalogEntries();
 };
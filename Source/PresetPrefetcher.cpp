@@ -0,0 +1,142 @@
+#include "PresetPrefetcher.h"
+#include "SampleRef.h"
+#include "StateCodec.h"
+
+#include <algorithm>
+
+// ─────────────────────────────────────────────────────────────────
+// lifecycle
+// ─────────────────────────────────────────────────────────────────
+PresetPrefetcher::PresetPrefetcher(int capacity)
+    : juce::Thread("BoomBaby preset prefetch"),
+      capacity_(static_cast<std::size_t>(std::max(capacity, 1))) {
+  formatManager_.registerBasicFormats(); // WAV / AIFF
+}
+
+PresetPrefetcher::~PresetPrefetcher() { stopThread(5000); }
+
+// ─────────────────────────────────────────────────────────────────
+// state.xml
+// ─────────────────────────────────────────────────────────────────
+juce::ValueTree PresetPrefetcher::readPresetState(const juce::File &presetDir) {
+  const auto stateFile = presetDir.getChildFile("state.xml");
+  if (!stateFile.existsAsFile())
+    return {};
+
+  const auto xml = juce::XmlDocument::parse(stateFile);
+  if (!xml)
+    return {};
+
+  auto state = juce::ValueTree::fromXml(*xml);
+  if (!state.isValid())
+    return {};
+
+  // 相対パス (./ 始まり) をプリセットフォルダ基準の絶対パスに解決
+  for (const auto *prop : StateCodec::kSamplePathProps) {
+    if (const auto path = state.getProperty(prop).toString();
+        path.startsWith("./"))
+      state.setProperty(
+          prop, presetDir.getChildFile(path.substring(2)).getFullPathName(),
+          nullptr);
+  }
+  return state;
+}
+
+// ─────────────────────────────────────────────────────────────────
+// 要求 / 取り出し（メッセージスレッド）
+// ─────────────────────────────────────────────────────────────────
+void PresetPrefetcher::prefetch(const std::vector<juce::File> &folders) {
+  {
+    const std::scoped_lock lock(mutex_);
+    pending_.clear();
+    for (const auto &folder : folders) {
+      const auto it = std::ranges::find_if(
+          lru_, [&](const auto &p) { return p->folder == folder; });
+      if (it != lru_.end())
+        lru_.splice(lru_.begin(), lru_, it);
+      else if (std::ranges::find(pending_, folder) == pending_.end())
+        pending_.push_back(folder);
+    }
+    if (pending_.empty())
+      return;
+  }
+  if (!isThreadRunning())
+    startThread(juce::Thread::Priority::low);
+  notify();
+}
+
+std::shared_ptr<const PresetPrefetcher::Prepared>
+PresetPrefetcher::find(const juce::File &folder) {
+  const auto modified =
+      folder.getChildFile("state.xml").getLastModificationTime();
+  const std::scoped_lock lock(mutex_);
+  const auto it = std::ranges::find_if(
+      lru_, [&](const auto &p) { return p->folder == folder; });
+  if (it == lru_.end())
+    return nullptr;
+  if ((*it)->stateModified != modified) {
+    lru_.erase(it);
+    return nullptr;
+  }
+  lru_.splice(lru_.begin(), lru_, it);
+  return lru_.front();
+}
+
+bool PresetPrefetcher::contains(const juce::File &folder) const {
+  const std::scoped_lock lock(mutex_);
+  return std::ranges::any_of(
+      lru_, [&](const auto &p) { return p->folder == folder; });
+}
+
+// ─────────────────────────────────────────────────────────────────
+// ワーカースレッド
+// ─────────────────────────────────────────────────────────────────
+void PresetPrefetcher::run() {
+  while (!threadShouldExit()) {
+    juce::File folder;
+    {
+      const std::scoped_lock lock(mutex_);
+      if (!pending_.empty()) {
+        folder = pending_.front();
+        pending_.erase(pending_.begin());
+      }
+    }
+    if (folder == juce::File{}) {
+      wait(-1);
+      continue;
+    }
+    if (auto prepared = prepare(folder))
+      insert(std::move(prepared));
+  }
+}
+
+std::shared_ptr<const PresetPrefetcher::Prepared>
+PresetPrefetcher::prepare(const juce::File &folder) {
+  auto prepared = std::make_shared<Prepared>();
+  prepared->folder = folder;
+  prepared->stateModified =
+      folder.getChildFile("state.xml").getLastModificationTime();
+  prepared->state = readPresetState(folder);
+  if (!prepared->state.isValid())
+    return nullptr;
+
+  for (const auto *prop : StateCodec::kSamplePathProps) {
+    if (threadShouldExit())
+      return nullptr;
+    const auto ref = prepared->state.getProperty(prop).toString();
+    if (ref.isEmpty())
+      continue;
+    if (auto decoded = SampleRef::decode(ref, formatManager_))
+      prepared->samples.push_back(std::move(decoded));
+  }
+  return prepared;
+}
+
+void PresetPrefetcher::insert(std::shared_ptr<const Prepared> prepared) {
+  const std::scoped_lock lock(mutex_);
+  std::erase_if(lru_,
+                [&](const auto &p) { return p->folder == prepared->folder; });
+  lru_.push_front(std::move(prepared));
+  while (lru_.size() > capacity_)
+    lru_.pop_back();
+}
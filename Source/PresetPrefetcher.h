@@ -0,0 +1,61 @@
+#pragma once
+
+#include "DSP/SamplePlayer.h"
+
+#include <juce_core/juce_core.h>
+#include <juce_data_structures/juce_data_structures.h>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/// ◀ / ▶ で次に選ばれそうなプリセットの先読み。
+///
+/// state.xml の解析とサンプルのデコードをワーカースレッドで済ませ、結果を
+/// 小さな LRU に置いておく。PresetManager::loadPreset() はここに結果が
+/// あれば、出来上がった ValueTree とバッファを差し込むだけで済む
+/// （演奏中に矢印を連打してもディスク I/O とデコードを待たない）。
+class PresetPrefetcher : private juce::Thread {
+public:
+  /// 先読み済みのプリセット（不変）
+  struct Prepared {
+    juce::File folder;
+    juce::Time stateModified; ///< 解析時点の state.xml 更新時刻
+    /// サンプルパス解決済みの状態（使う側で createCopy() すること）
+    juce::ValueTree state;
+    std::vector<std::shared_ptr<const SamplePlayer::Decoded>> samples;
+  };
+
+  static constexpr int kDefaultCapacity = 4;
+
+  explicit PresetPrefetcher(int capacity = kDefaultCapacity);
+  ~PresetPrefetcher() override;
+
+  /// presetDir/state.xml を読み、./ 始まりのサンプルパスをフォルダ基準の
+  /// 絶対パスに解決して返す（読めなければ無効な ValueTree）
+  static juce::ValueTree readPresetState(const juce::File &presetDir);
+
+  /// folders を先読みさせる（すぐ戻る）。まだ手を付けていない以前の
+  /// 要求は捨て、LRU にあるものは最近使ったことにするだけ。
+  void prefetch(const std::vector<juce::File> &folders);
+
+  /// folder の先読み結果。未完了か、解析後に state.xml が書き換えられて
+  /// いれば nullptr（古い結果はここで捨てる）。
+  std::shared_ptr<const Prepared> find(const juce::File &folder);
+
+  /// folder の先読みが終わっていれば true
+  bool contains(const juce::File &folder) const;
+
+private:
+  void run() override;
+  std::shared_ptr<const Prepared> prepare(const juce::File &folder);
+  void insert(std::shared_ptr<const Prepared> prepared);
+
+  const std::size_t capacity_;
+  juce::AudioFormatManager formatManager_; ///< ワーカースレッド専用
+
+  mutable std::mutex mutex_;
+  std::list<std::shared_ptr<const Prepared>> lru_; ///< 先頭が最近
+  std::vector<juce::File> pending_;
+};
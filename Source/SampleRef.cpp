@@ -0,0 +1,120 @@
+#include "SampleRef.h"
+#include "DSP/SamplePool.h"
+#include "FactoryPresets.h"
+#include "SampleStore.h"
+
+namespace {
+/// ref がファイルを指すなら、その juce::File（それ以外は nullopt）
+std::optional<juce::File> asFile(const juce::String &ref) {
+  if (!juce::File::isAbsolutePath(ref))
+    return std::nullopt;
+  return juce::File{ref};
+}
+} // namespace
+
+namespace SampleRef {
+
+bool exists(const juce::String &ref) {
+  if (SampleStore::isRef(ref))
+    return SampleStore::fileFor(ref).existsAsFile();
+  if (FactoryPresets::isSampleRef(ref))
+    return FactoryPresets::openSample(ref) != nullptr;
+  const auto file = asFile(ref);
+  return file && file->existsAsFile();
+}
+
+juce::String relocate(const juce::String &ref, juce::uint64 hash) {
+  if (const auto factory = FactoryPresets::fromLegacyPath(ref);
+      factory.isNotEmpty())
+    return factory;
+  const auto file = asFile(ref);
+  if (!file || file->existsAsFile())
+    return ref;
+  if (const auto stored = SampleStore::find(hash, file->getFileName());
+      stored.isNotEmpty())
+    return stored;
+  return ref;
+}
+
+juce::String displayName(const juce::String &ref) {
+  return ref.fromLastOccurrenceOf("/", false, false)
+      .fromLastOccurrenceOf("\\", false, false)
+      .upToLastOccurrenceOf(".", false, false);
+}
+
+bool sameSample(const juce::String &source, const juce::String &ref) {
+  if (SampleStore::isRef(source) && SampleStore::isRef(ref)) {
+    const auto file = SampleStore::fileFor(ref);
+    return file != juce::File{} && SampleStore::fileFor(source) == file;
+  }
+  return source == ref;
+}
+
+bool isLoadedIn(const SamplePlayer &sampler, const juce::String &ref) {
+  if (SampleStore::isRef(ref)) {
+    const auto &loaded = sampler.loadedSample();
+    return sampler.isLoaded() && loaded != nullptr &&
+           sameSample(loaded->source, ref);
+  }
+  if (FactoryPresets::isSampleRef(ref))
+    return sampler.isLoadedFrom(ref);
+  const auto file = asFile(ref);
+  return file && sampler.isLoadedFrom(*file);
+}
+
+bool isCurrent(const SamplePlayer::Decoded &decoded) {
+  // ストアの実体と埋め込みデータは中身が変わらない
+  if (SampleStore::isRef(decoded.source) ||
+      FactoryPresets::isSampleRef(decoded.source))
+    return true;
+  const auto file = asFile(decoded.source);
+  return file && file->getLastModificationTime() == decoded.modified;
+}
+
+void loadInto(SamplePlayer &sampler, const juce::String &ref) {
+  if (isLoadedIn(sampler, ref))
+    return;
+  if (SampleStore::isRef(ref)) {
+    // 他のインスタンス / 先読みと同じデコード結果を使い回す
+    sampler.loadDecoded(SampleStore::decode(ref));
+  } else if (FactoryPresets::isSampleRef(ref)) {
+    sampler.loadSample(FactoryPresets::openSample(ref), ref);
+  } else if (const auto file = asFile(ref); file && file->existsAsFile()) {
+    sampler.loadSample(*file);
+  }
+}
+
+std::shared_ptr<const SamplePlayer::Decoded>
+decode(const juce::String &ref, juce::AudioFormatManager &formatManager) {
+  if (SampleStore::isRef(ref))
+    return SampleStore::decode(ref);
+  if (FactoryPresets::isSampleRef(ref))
+    return SamplePool::acquire(ref, [&] {
+      return SamplePlayer::decode(FactoryPresets::openSample(ref), ref,
+                                  formatManager);
+    });
+  if (const auto file = asFile(ref); file && file->existsAsFile())
+    return SamplePool::acquire(SamplePool::keyFor(*file), [&] {
+      return SamplePlayer::decode(*file, formatManager);
+    });
+  return nullptr;
+}
+
+bool copyTo(const juce::String &ref, const juce::File &dest) {
+  if (SampleStore::isRef(ref)) {
+    const auto file = SampleStore::fileFor(ref);
+    return file.existsAsFile() && file.copyFileTo(dest);
+  }
+  if (FactoryPresets::isSampleRef(ref)) {
+    const auto in = FactoryPresets::openSample(ref);
+    if (in == nullptr)
+      return false;
+    juce::MemoryBlock data;
+    in->readIntoMemoryBlock(data);
+    return dest.replaceWithData(data.getData(), data.getSize());
+  }
+  const auto file = asFile(ref);
+  return file && file->existsAsFile() && file->copyFileTo(dest);
+}
+
+} // namespace SampleRef
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "DSP/SamplePlayer.h"
+
+#include <juce_core/juce_core.h>
+
+#include <memory>
+
+/// state に保存するサンプル参照（clickSamplePath / directSamplePath の値）。
+///
+/// 参照はファイルの絶対パス、埋め込み Factory サンプルの "factory:" 参照、
+/// サンプル置き場（SampleStore）の "sample:" 参照のいずれか。
+/// 相対パスの juce::File を作ると JUCE が assert するので、参照を扱う
+/// ところは juce::File を直接作らずにここを通す。
+namespace SampleRef {
+
+/// ref の中身が読めるなら true
+bool exists(const juce::String &ref);
+
+/// 保存された参照 ref を今の置き場所へ読み替える。
+///   - 旧版が展開した Factory サンプルのパスは埋め込みの factory: 参照へ
+///   - 見つからないファイルは、同じ内容ハッシュ（StateCodec が保存した
+///     もの）の実体がサンプル置き場にあればそのストア参照へ
+/// どちらにも当たらなければ ref をそのまま返す。
+juce::String relocate(const juce::String &ref, juce::uint64 hash);
+
+/// ボタン等に出す名前（拡張子なしのファイル名）
+juce::String displayName(const juce::String &ref);
+
+/// デコード結果の source と参照 ref が同じ中身を指すなら true
+/// （ストア参照はハッシュが同じなら名前が違っても同じとみなす）
+bool sameSample(const juce::String &source, const juce::String &ref);
+
+/// sampler が ref をロード済み（ファイルなら更新時刻も一致）なら true
+bool isLoadedIn(const SamplePlayer &sampler, const juce::String &ref);
+
+/// ref を sampler にロードする。ロード済みなら何もしない（メッセージ
+/// スレッドから呼ぶこと）。
+void loadInto(SamplePlayer &sampler, const juce::String &ref);
+
+/// decoded が今の参照先の中身から作られたもの（ファイルなら更新時刻が
+/// 一致）なら true
+bool isCurrent(const SamplePlayer::Decoded &decoded);
+
+/// ref をデコードだけして返す（formatManager を別に持てばワーカースレッド可）。
+/// 結果は SamplePool で他のロードと共有する。読めなければ nullptr。
+std::shared_ptr<const SamplePlayer::Decoded>
+decode(const juce::String &ref, juce::AudioFormatManager &formatManager);
+
+/// ref の中身を dest に書き出す（プリセットを自己完結させるとき）
+bool copyTo(const juce::String &ref, const juce::File &dest);
+
+} // namespace SampleRef
@@ -0,0 +1,160 @@
+#include "SampleStore.h"
+#include "DSP/SamplePool.h"
+#include "FactoryPresets.h"
+#include "StateCodec.h"
+
+#include <mutex>
+
+namespace {
+constexpr int kHashDigits = 16;
+
+struct Store {
+  std::mutex mutex;
+  juce::File dir =
+      juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+          .getChildFile("Auditive")
+          .getChildFile("BoomBaby")
+          .getChildFile("Samples");
+  StateCodec::SampleHashCache hashes;
+
+  std::mutex decodeMutex; ///< formatManager はデコード中だけ占有する
+  juce::AudioFormatManager formatManager;
+
+  Store() { formatManager.registerBasicFormats(); } // WAV / AIFF
+};
+
+Store &store() {
+  static Store s;
+  return s;
+}
+
+/// 拡張子（"." 付き小文字）。英数字以外を含む等、怪しければ ".wav"
+juce::String extensionOf(const juce::String &fileName) {
+  const auto ext = fileName.fromLastOccurrenceOf(".", true, false);
+  if (ext.length() < 2 || ext.length() > 8 ||
+      !ext.substring(1).containsOnly(
+          "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"))
+    return ".wav";
+  return ext.toLowerCase();
+}
+
+juce::String makeRef(juce::uint64 hash, const juce::String &fileName) {
+  return SampleStore::kScheme +
+         juce::String::toHexString(static_cast<juce::int64>(hash))
+             .paddedLeft('0', kHashDigits) +
+         "/" + fileName;
+}
+
+/// dest へ write(tmp) の結果を原子的に置く（途中で落ちても半端な実体を
+/// 残さない）
+template <typename Write> bool writeAtomically(const juce::File &dest,
+                                               Write write) {
+  if (!dest.getParentDirectory().createDirectory())
+    return false;
+  juce::TemporaryFile tmp(dest);
+  return write(tmp.getFile()) && tmp.overwriteTargetFileWithTemporary();
+}
+} // namespace
+
+namespace SampleStore {
+
+juce::File directory() {
+  auto &s = store();
+  const std::scoped_lock lock(s.mutex);
+  return s.dir;
+}
+
+void setDirectory(const juce::File &dir) {
+  auto &s = store();
+  const std::scoped_lock lock(s.mutex);
+  s.dir = dir;
+}
+
+bool isRef(const juce::String &ref) noexcept {
+  return ref.startsWith(kScheme);
+}
+
+juce::File fileFor(const juce::String &ref) {
+  if (!isRef(ref))
+    return {};
+  const auto body = ref.substring(juce::String(kScheme).length());
+  const auto hash = body.upToFirstOccurrenceOf("/", false, false);
+  if (hash.length() != kHashDigits ||
+      !hash.containsOnly("0123456789abcdef"))
+    return {};
+  return directory().getChildFile(
+      hash + extensionOf(body.fromFirstOccurrenceOf("/", false, false)));
+}
+
+juce::String find(juce::uint64 hash, const juce::String &fileName) {
+  if (hash == 0)
+    return {};
+  const auto ref = makeRef(hash, fileName);
+  return fileFor(ref).existsAsFile() ? ref : juce::String{};
+}
+
+juce::String add(const juce::String &ref) {
+  if (isRef(ref))
+    return fileFor(ref).existsAsFile() ? ref : juce::String{};
+
+  if (FactoryPresets::isSampleRef(ref)) {
+    const auto in = FactoryPresets::openSample(ref);
+    if (in == nullptr)
+      return {};
+    juce::MemoryBlock data;
+    in->readIntoMemoryBlock(data);
+    const auto stored =
+        makeRef(StateCodec::hashBytes(data.getData(), data.getSize()),
+                ref.fromLastOccurrenceOf("/", false, false));
+    const auto dest = fileFor(stored);
+    if (dest.existsAsFile() ||
+        writeAtomically(dest, [&](const juce::File &f) {
+          return f.replaceWithData(data.getData(), data.getSize());
+        }))
+      return stored;
+    return {};
+  }
+
+  if (!juce::File::isAbsolutePath(ref))
+    return {};
+  const juce::File source{ref};
+  juce::uint64 hash;
+  {
+    // 更新されていないファイルは読み直さない
+    auto &s = store();
+    const std::scoped_lock lock(s.mutex);
+    hash = s.hashes.hashOf(ref);
+  }
+  if (hash == 0)
+    return {};
+  const auto stored = makeRef(hash, source.getFileName());
+  const auto dest = fileFor(stored);
+  if (dest.existsAsFile() ||
+      writeAtomically(dest, [&](const juce::File &f) {
+        return source.copyFileTo(f);
+      }))
+    return stored;
+  return {};
+}
+
+std::shared_ptr<const SamplePlayer::Decoded> decode(const juce::String &ref) {
+  // 中身はハッシュで決まるので、名前ではなく実体ファイルをプールのキーに
+  // する（同じ中身を別名で参照しても 1 回だけデコードする）
+  const auto file = fileFor(ref);
+  if (!file.existsAsFile())
+    return nullptr;
+  return SamplePool::acquire(
+      file.getFullPathName(),
+      [&ref, &file]() -> std::optional<SamplePlayer::Decoded> {
+        auto &s = store();
+        const std::scoped_lock lock(s.decodeMutex);
+        auto d = SamplePlayer::decode(file, s.formatManager);
+        if (d) {
+          d->source = ref;
+          d->modified = {};
+        }
+        return d;
+      });
+}
+
+} // namespace SampleStore
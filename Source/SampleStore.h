@@ -0,0 +1,47 @@
+#pragma once
+
+#include "DSP/SamplePlayer.h"
+
+#include <juce_core/juce_core.h>
+
+#include <memory>
+
+/// 内容ハッシュで引くサンプル置き場（User プリセット共通）。
+///
+/// プリセットはサンプルを "sample:<ハッシュ16桁>/<元のファイル名>" という
+/// 参照で持ち、実体は directory()/<ハッシュ><拡張子> に 1 つだけ置く。
+/// 同じ中身のサンプルを何度保存しても増えない。元のファイル名は表示用。
+/// デコード結果は SamplePool で共有する（同じハッシュは 1 回だけデコード）。
+namespace SampleStore {
+
+inline constexpr const char *kScheme = "sample:";
+
+/// 置き場のディレクトリ（既定は Documents/Auditive/BoomBaby/Samples）
+juce::File directory();
+
+/// 置き場を差し替える（テスト用）
+void setDirectory(const juce::File &dir);
+
+/// ref がストア参照なら true（中身の有無は問わない）
+bool isRef(const juce::String &ref) noexcept;
+
+/// ストア参照 ref の実体ファイル（形式が不正なら juce::File{}）
+juce::File fileFor(const juce::String &ref);
+
+/// 内容ハッシュ hash の実体が置き場にあれば、それを fileName の名前で
+/// 指すストア参照を返す（無ければ空）
+juce::String find(juce::uint64 hash, const juce::String &fileName);
+
+/// ref（ファイルの絶対パス / factory: / sample:）の中身を置き場に入れ、
+/// ストア参照を返す。同じ中身が既にあれば書き込まない。読めなければ空。
+/// メッセージスレッドから呼ぶこと。
+juce::String add(const juce::String &ref);
+
+/// ストア参照 ref をデコードして返す。誰かが同じ中身（ハッシュ）の
+/// デコード結果を持っている間は、名前が違ってもデコードし直さない
+/// （その場合 source は先にデコードした側の参照のまま）。
+/// 読めなければ nullptr。
+/// どのスレッドからでも呼べる。
+std::shared_ptr<const SamplePlayer::Decoded> decode(const juce::String &ref);
+
+} // namespace SampleStore
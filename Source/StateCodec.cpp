@@ -0,0 +1,253 @@
+#include "StateCodec.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace StateCodec {
+
+namespace {
+const juce::Identifier kParamTag{"PARAM"};
+const juce::Identifier kEnvelopeTag{"ENVELOPE"};
+const juce::Identifier kPointTag{"POINT"};
+const juce::Identifier kPropId{"id"};
+const juce::Identifier kPropValue{"value"};
+const juce::Identifier kPropName{"name"};
+const juce::Identifier kPropDefault{"defaultValue"};
+const juce::Identifier kPropTimeMs{"timeMs"};
+const juce::Identifier kPropCurve{"curve"};
+
+bool isSampleProp(const juce::Identifier &name) {
+  for (const auto *p : kSamplePathProps)
+    if (name == juce::Identifier{p} || name == hashPropFor(p))
+      return true;
+  return false;
+}
+
+/// 残り count 要素 × elemBytes がストリームに収まるか（壊れた件数で
+/// 巨大な確保をしないため）
+bool fits(const juce::MemoryInputStream &in, int count, int elemBytes) {
+  return count >= 0 &&
+         static_cast<juce::int64>(count) * elemBytes <=
+             in.getNumBytesRemaining();
+}
+
+void writeEnvelope(juce::MemoryOutputStream &out, const juce::ValueTree &env) {
+  out.writeString(env.getProperty(kPropName).toString());
+  out.writeFloat(env.getProperty(kPropDefault, 1.0f));
+  int numPoints = 0;
+  for (const auto &pt : env)
+    numPoints += pt.hasType(kPointTag) ? 1 : 0;
+  out.writeInt(numPoints);
+  for (const auto &pt : env) {
+    if (!pt.hasType(kPointTag))
+      continue;
+    out.writeFloat(pt.getProperty(kPropTimeMs, 0.0f));
+    out.writeFloat(pt.getProperty(kPropValue, 1.0f));
+    out.writeFloat(pt.getProperty(kPropCurve, 0.0f));
+  }
+}
+
+juce::ValueTree readEnvelope(juce::MemoryInputStream &in) {
+  juce::ValueTree env{kEnvelopeTag};
+  env.setProperty(kPropName, in.readString(), nullptr);
+  env.setProperty(kPropDefault, in.readFloat(), nullptr);
+  const int numPoints = in.readInt();
+  if (!fits(in, numPoints, 3 * static_cast<int>(sizeof(float))))
+    return {};
+  for (int i = 0; i < numPoints; ++i) {
+    juce::ValueTree pt{kPointTag};
+    pt.setProperty(kPropTimeMs, in.readFloat(), nullptr);
+    pt.setProperty(kPropValue, in.readFloat(), nullptr);
+    pt.setProperty(kPropCurve, in.readFloat(), nullptr);
+    env.addChild(pt, -1, nullptr);
+  }
+  return env;
+}
+} // namespace
+
+// ─────────────────────────────────────────────────────────────────
+// サンプルの内容ハッシュ
+// ─────────────────────────────────────────────────────────────────
+juce::uint64 hashBytes(const void *data, size_t size,
+                       juce::uint64 h) noexcept {
+  const auto *p = static_cast<const juce::uint8 *>(data);
+  for (size_t i = 0; i < size; ++i) {
+    h ^= p[i];
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+juce::uint64 hashFile(const juce::File &file) {
+  juce::FileInputStream in(file);
+  if (!in.openedOk())
+    return 0;
+  juce::uint64 h = kHashSeed;
+  std::array<juce::uint8, 8192> chunk{};
+  for (int n; (n = in.read(chunk.data(), static_cast<int>(chunk.size()))) > 0;)
+    h = hashBytes(chunk.data(), static_cast<size_t>(n), h);
+  return h;
+}
+
+juce::uint64 SampleHashCache::hashOf(const juce::String &path) {
+  // 埋め込みサンプル（factory: 参照）等、ファイルでない参照は対象外
+  if (!juce::File::isAbsolutePath(path))
+    return 0;
+  const juce::File file{path};
+  if (!file.existsAsFile())
+    return 0;
+  const auto modified = file.getLastModificationTime();
+  const auto size = file.getSize();
+  if (const auto it = entries_.find(path);
+      it != entries_.end() && it->second.modified == modified &&
+      it->second.size == size)
+    return it->second.hash;
+  const auto hash = hashFile(file);
+  entries_[path] = {modified, size, hash};
+  return hash;
+}
+
+juce::Identifier hashPropFor(const char *pathProp) {
+  return juce::String(pathProp) + "Hash";
+}
+
+void setSamplePath(juce::ValueTree &state, const char *pathProp,
+                   const juce::String &ref) {
+  if (state.getProperty(pathProp).toString() != ref)
+    state.removeProperty(hashPropFor(pathProp), nullptr);
+  state.setProperty(pathProp, ref, nullptr);
+}
+
+// ─────────────────────────────────────────────────────────────────
+// 書き出し
+// ─────────────────────────────────────────────────────────────────
+bool isBinaryState(const void *data, int sizeInBytes) noexcept {
+  return data != nullptr && sizeInBytes >= 8 &&
+         juce::ByteOrder::littleEndianInt(data) == kMagic;
+}
+
+void encode(const juce::ValueTree &state,
+            std::span<const char *const> paramIds, SampleHashCache &hashes,
+            juce::MemoryBlock &dest) {
+  juce::MemoryOutputStream out(dest, false);
+  out.writeInt(static_cast<int>(kMagic));
+  out.writeInt(static_cast<int>(kVersion));
+
+  out.writeInt(static_cast<int>(paramIds.size()));
+  for (const auto *id : paramIds) {
+    const auto p = state.getChildWithProperty(kPropId, juce::String(id));
+    out.writeFloat(p.getProperty(kPropValue, 0.0f));
+  }
+
+  juce::ValueTree rest{state.getType()};
+  rest.copyPropertiesFrom(state, nullptr);
+  std::vector<juce::ValueTree> envelopes;
+  for (const auto &child : state) {
+    if (child.hasType(kEnvelopeTag))
+      envelopes.push_back(child);
+    else if (!child.hasType(kParamTag))
+      rest.appendChild(child.createCopy(), nullptr);
+  }
+  out.writeInt(static_cast<int>(envelopes.size()));
+  for (const auto &env : envelopes)
+    writeEnvelope(out, env);
+
+  // ファイルが見つからないときは前回読み込んだハッシュを引き継ぐ
+  int numSamples = 0;
+  for (const auto *p : kSamplePathProps)
+    numSamples += state.hasProperty(p) ? 1 : 0;
+  out.writeInt(numSamples);
+  for (const auto *p : kSamplePathProps) {
+    if (!state.hasProperty(p))
+      continue;
+    const auto path = state.getProperty(p).toString();
+    juce::uint64 hash = path.isNotEmpty() ? hashes.hashOf(path) : 0;
+    if (hash == 0 && path.isNotEmpty())
+      hash = static_cast<juce::uint64>(
+          state.getProperty(hashPropFor(p)).toString().getHexValue64());
+    out.writeString(p);
+    out.writeString(path);
+    out.writeInt64(static_cast<juce::int64>(hash));
+  }
+
+  for (int i = rest.getNumProperties(); --i >= 0;)
+    if (const auto name = rest.getPropertyName(i); isSampleProp(name))
+      rest.removeProperty(name, nullptr);
+  rest.writeToStream(out);
+}
+
+// ─────────────────────────────────────────────────────────────────
+// 読み込み
+// ─────────────────────────────────────────────────────────────────
+juce::ValueTree decode(const void *data, int sizeInBytes,
+                       std::span<const char *const> paramIds) {
+  if (!isBinaryState(data, sizeInBytes))
+    return {};
+  juce::MemoryInputStream in(data, static_cast<size_t>(sizeInBytes), false);
+  in.readInt(); // magic
+  if (const int version = in.readInt();
+      version < 1 || version > static_cast<int>(kVersion))
+    return {};
+
+  const int numParams = in.readInt();
+  if (!fits(in, numParams, static_cast<int>(sizeof(float))))
+    return {};
+  std::vector<float> values(static_cast<std::size_t>(numParams));
+  for (auto &v : values)
+    v = in.readFloat();
+
+  const int numEnvelopes = in.readInt();
+  if (!fits(in, numEnvelopes, 1))
+    return {};
+  std::vector<juce::ValueTree> envelopes;
+  for (int i = 0; i < numEnvelopes; ++i) {
+    auto env = readEnvelope(in);
+    if (!env.isValid())
+      return {};
+    envelopes.push_back(std::move(env));
+  }
+
+  struct SampleRef {
+    juce::String prop;
+    juce::String path;
+    juce::uint64 hash;
+  };
+  const int numSamples = in.readInt();
+  if (!fits(in, numSamples, 1))
+    return {};
+  std::vector<SampleRef> samples;
+  for (int i = 0; i < numSamples; ++i) {
+    auto prop = in.readString();
+    auto path = in.readString();
+    const auto hash = static_cast<juce::uint64>(in.readInt64());
+    samples.push_back({std::move(prop), std::move(path), hash});
+  }
+
+  auto state = juce::ValueTree::readFromStream(in);
+  if (!state.isValid())
+    return {};
+
+  // 保存側より後に追加されたパラメータは PARAM ノード無し
+  // （replaceState 時に APVTS が既定値を使う）
+  const auto n = std::min(values.size(), paramIds.size());
+  for (std::size_t i = 0; i < n; ++i) {
+    juce::ValueTree p{kParamTag};
+    p.setProperty(kPropId, juce::String(paramIds[i]), nullptr);
+    p.setProperty(kPropValue, values[i], nullptr);
+    state.addChild(p, static_cast<int>(i), nullptr);
+  }
+  auto index = static_cast<int>(n);
+  for (auto &env : envelopes)
+    state.addChild(env, index++, nullptr);
+  for (const auto &s : samples) {
+    state.setProperty(s.prop, s.path, nullptr);
+    if (s.hash != 0)
+      state.setProperty(s.prop + "Hash",
+                        juce::String::toHexString(
+                            static_cast<juce::int64>(s.hash)),
+                        nullptr);
+  }
+  return state;
+}
+
+} // namespace StateCodec
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_data_structures/juce_data_structures.h>
+
+#include <array>
+#include <map>
+#include <span>
+
+/// プラグイン状態（APVTS ValueTree）のコンパクト バイナリ形式。
+///
+/// getStateInformation() の出力に使う。XML 版（copyXmlToBinary）と違い、
+/// パラメータは float の詰め合わせ、エンベロープは点列の塊、サンプルは
+/// パス + 内容ハッシュで書く。それ以外のプロパティと子ノード（Click の
+/// ModeState 等）は JUCE の ValueTree バイナリでそのまま運ぶ。
+///
+/// レイアウト（リトルエンディアン）:
+///   magic "BBST" / version
+///   パラメータ数 N / float × N          … paramIds の順
+///   エンベロープ数 / { name, defaultValue, 点数 M, (timeMs, value, curve) × M }
+///   サンプル数 / { プロパティ名, パス, 内容ハッシュ(u64) }
+///   残りの ValueTree（PARAM / ENVELOPE / サンプルのプロパティを除く）
+namespace StateCodec {
+
+inline constexpr juce::uint32 kMagic = 0x54534242; // "BBST"
+inline constexpr juce::uint32 kVersion = 1;
+
+/// パス + 内容ハッシュで保存するサンプル参照プロパティ
+inline constexpr std::array<const char *, 2> kSamplePathProps = {
+    "clickSamplePath", "directSamplePath"};
+
+/// decode() が pathProp の内容ハッシュを入れるプロパティ（"<pathProp>Hash"）
+juce::Identifier hashPropFor(const char *pathProp);
+
+/// state のサンプル参照 pathProp を ref にする。参照が変わるときは、前の
+/// サンプルの内容ハッシュ（hashPropFor）も消す（別の中身への付け替えや
+/// 保存に古いハッシュが使われないように）。サンプルの読み込み・クリアは
+/// すべてここを通す。
+void setSamplePath(juce::ValueTree &state, const char *pathProp,
+                   const juce::String &ref);
+
+/// 64bit FNV-1a の初期値
+inline constexpr juce::uint64 kHashSeed = 0xcbf29ce484222325ULL;
+
+/// バイト列を 64bit FNV-1a で h に混ぜ込む（分割して続けて呼べる）
+juce::uint64 hashBytes(const void *data, size_t size,
+                       juce::uint64 h = kHashSeed) noexcept;
+
+/// ファイル内容の 64bit FNV-1a ハッシュ（読めなければ 0）
+juce::uint64 hashFile(const juce::File &file);
+
+/// ハッシュ計算済みのサンプルを (パス, 更新時刻, サイズ) で覚えておき、
+/// 同じファイルを保存のたびに読み直さないためのキャッシュ。
+class SampleHashCache {
+public:
+  juce::uint64 hashOf(const juce::String &path);
+
+private:
+  struct Entry {
+    juce::Time modified;
+    juce::int64 size = 0;
+    juce::uint64 hash = 0;
+  };
+  std::map<juce::String, Entry> entries_;
+};
+
+/// data がバイナリ状態（magic 一致）なら true。false なら旧 XML 形式として扱う。
+bool isBinaryState(const void *data, int sizeInBytes) noexcept;
+
+/// state をバイナリ化して dest を置き換える。
+/// paramIds の並びは形式の一部（追加は末尾のみ、並べ替え・削除は不可）。
+void encode(const juce::ValueTree &state,
+            std::span<const char *const> paramIds, SampleHashCache &hashes,
+            juce::MemoryBlock &dest);
+
+/// バイナリ状態から ValueTree を復元する（PARAM / ENVELOPE ノードを含む、
+/// XML から読んだものと同じ構造）。サンプルの内容ハッシュは
+/// "<プロパティ名>Hash" に 16 進で入る（ファイルが消えていたときに
+/// サンプル置き場の同じ中身へ付け替えるのに使う。SampleRef::relocate）。壊れたデータや未知の新しい
+/// バージョンは無効な ValueTree を返す。
+juce::ValueTree decode(const void *data, int sizeInBytes,
+                       std::span<const char *const> paramIds);
+
+} // namespace StateCodec
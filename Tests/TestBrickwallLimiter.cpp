@@ -0,0 +1,154 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "DSP/BrickwallLimiter.h"
+#include "DSP/MeterEngine.h"
+
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <vector>
+
+using namespace Catch::Matchers;
+
+namespace {
+constexpr double kSr = 48000.0;
+constexpr int kBlock = 128;
+
+/// ノイズ + 低域サイン（+12 dB 程度のオーバー）を生成
+std::vector<float> makeHotSignal(int n) {
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> v(static_cast<std::size_t>(n));
+  for (int i = 0; i < n; ++i) {
+    const auto t = static_cast<double>(i) / kSr;
+    v[static_cast<std::size_t>(i)] =
+        2.0f * static_cast<float>(std::sin(2.0 * std::numbers::pi * 60.0 * t)) +
+        1.5f * dist(rng);
+  }
+  return v;
+}
+} // namespace
+
+// 天井以下の信号はレイテンシ分遅れるだけで波形が変わらないことを確認する
+TEST_CASE("BrickwallLimiter: below ceiling is a pure delay",
+          "[brickwall_limiter]") {
+  BrickwallLimiter lim;
+  lim.prepare(kSr);
+  lim.setCeilingDb(-1.0f);
+  const int latency = lim.latencySamples();
+  REQUIRE(latency > 0);
+
+  std::vector<float> l(512, 0.0f);
+  std::vector<float> r(512, 0.0f);
+  l[10] = 0.5f;
+  r[10] = -0.25f;
+  lim.process(l.data(), r.data(), 512, 1.0f);
+
+  CHECK_THAT(l[static_cast<std::size_t>(10 + latency)], WithinAbs(0.5, 1e-5));
+  CHECK_THAT(r[static_cast<std::size_t>(10 + latency)], WithinAbs(-0.25, 1e-5));
+  CHECK_THAT(l[10], WithinAbs(0.0, 1e-6));
+}
+
+// 大きくオーバーする信号でもサンプルピークが天井を超えないことを確認する
+TEST_CASE("BrickwallLimiter: output never exceeds the ceiling",
+          "[brickwall_limiter]") {
+  BrickwallLimiter lim;
+  lim.prepare(kSr);
+  lim.setCeilingDb(-1.0f);
+  lim.setTruePeak(false);
+  const float ceiling = std::pow(10.0f, -1.0f / 20.0f);
+
+  auto l = makeHotSignal(48000);
+  auto r = l;
+  float maxOut = 0.0f;
+  for (int start = 0; start < 48000; start += kBlock) {
+    lim.process(l.data() + start, r.data() + start, kBlock, 1.0f);
+    for (int i = start; i < start + kBlock; ++i)
+      maxOut = std::max(maxOut, std::abs(l[static_cast<std::size_t>(i)]));
+  }
+  CHECK(maxOut <= ceiling * 1.0001f);
+  CHECK(maxOut > ceiling * 0.9f);
+  CHECK(lim.lastReductionDb() < 0.0f);
+}
+
+// True Peak モードでは 4× 補間ピークも天井付近に収まることを確認する
+TEST_CASE("BrickwallLimiter: true-peak mode bounds inter-sample peaks",
+          "[brickwall_limiter]") {
+  BrickwallLimiter lim;
+  lim.prepare(kSr);
+  lim.setCeilingDb(-1.0f);
+  lim.setTruePeak(true);
+
+  MeterEngine meter;
+  meter.prepare(kSr, kBlock);
+
+  // fs/4 付近の高域はサンプル間ピークが大きい
+  std::vector<float> l(48000);
+  for (std::size_t i = 0; i < l.size(); ++i)
+    l[i] = 1.8f * static_cast<float>(std::sin(
+               2.0 * std::numbers::pi * 11000.0 * static_cast<double>(i) / kSr +
+               0.3));
+  auto r = l;
+  for (int start = 0; start < 48000; start += kBlock) {
+    lim.process(l.data() + start, r.data() + start, kBlock, 1.0f);
+    meter.process({l.data() + start, r.data() + start, nullptr, nullptr,
+                   nullptr},
+                  kBlock);
+  }
+  CHECK(meter.snapshot().truePeakDb(MeterEngine::kMasterL) < -0.8f);
+}
+
+// inputGain がリミッター前に適用されることを確認する
+TEST_CASE("BrickwallLimiter: input gain is applied before limiting",
+          "[brickwall_limiter]") {
+  BrickwallLimiter lim;
+  lim.prepare(kSr);
+  lim.setCeilingDb(0.0f);
+  std::vector<float> l(256, 0.0f);
+  l[0] = 0.25f;
+  lim.process(l.data(), nullptr, 256, 2.0f);
+  CHECK_THAT(l[static_cast<std::size_t>(lim.latencySamples())],
+             WithinAbs(0.5, 1e-5));
+}
+
+// バイパスは遅延線を止めず、ゲインだけ途切れずに 1 へ戻ることを確認する
+TEST_CASE("BrickwallLimiter: bypass crossfades without a dropout",
+          "[brickwall_limiter]") {
+  BrickwallLimiter lim;
+  lim.prepare(kSr);
+  lim.setCeilingDb(0.0f);
+  lim.setTruePeak(false);
+  const int fadeLen = static_cast<int>(
+      std::ceil(BrickwallLimiter::kBypassFadeMs * 0.001 * kSr));
+
+  // 2.0 の DC を天井 1.0 まで下げた状態から OFF にする
+  std::vector<float> l(static_cast<std::size_t>(4800), 2.0f);
+  lim.process(l.data(), nullptr, 4800, 1.0f);
+  REQUIRE_THAT(l.back(), WithinAbs(1.0, 1e-4));
+
+  lim.setEnabled(false);
+  std::vector<float> out(static_cast<std::size_t>(fadeLen + 64), 2.0f);
+  lim.process(out.data(), nullptr, static_cast<int>(out.size()), 1.0f);
+  for (std::size_t i = 1; i < out.size(); ++i) {
+    CHECK(out[i] >= out[i - 1] - 1e-6f); // 無音を挟まず単調に戻る
+    CHECK(out[i] - out[i - 1] < 0.01f);  // 段差なし
+  }
+  CHECK_THAT(out.front(), WithinAbs(1.0, 0.01));
+  CHECK_THAT(out.back(), WithinAbs(2.0, 1e-5));
+
+  lim.process(out.data(), nullptr, 64, 1.0f);
+  CHECK_THAT(lim.lastReductionDb(), WithinAbs(0.0, 1e-4));
+}
+
+// 無音が窓長ぶん続くと isSettled() になり、信号が来ると解除されることを確認する
+TEST_CASE("BrickwallLimiter: settles after silence", "[brickwall_limiter]") {
+  BrickwallLimiter lim;
+  lim.prepare(kSr);
+  std::vector<float> l(256, 0.0f);
+  l[0] = 1.0f;
+  lim.process(l.data(), nullptr, 1, 1.0f);
+  CHECK_FALSE(lim.isSettled());
+  lim.process(l.data() + 1, nullptr, 255, 1.0f);
+  CHECK(lim.isSettled());
+}
@@ -0,0 +1,87 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "DSP/DspArena.h"
+
+#include <cstdint>
+
+namespace {
+bool isLineAligned(const void *p) {
+  return reinterpret_cast<std::uintptr_t>(p) % kCacheLineSize == 0;
+}
+} // namespace
+
+// ── bytesFor ──────────────────────────────────────────
+
+// キャッシュライン境界まで切り上げること（ライン長は 64 / 128 のどちらでも）
+TEST_CASE("DspArena: bytesFor rounds up to cache lines", "[dsp_arena]") {
+  constexpr std::size_t perLine = kCacheLineSize / sizeof(float);
+  CHECK(DspArena::bytesFor<float>(1) == kCacheLineSize);
+  CHECK(DspArena::bytesFor<float>(perLine) == kCacheLineSize);
+  CHECK(DspArena::bytesFor<float>(perLine + 1) == 2 * kCacheLineSize);
+  CHECK(DspArena::bytesFor<double>(0) == 0);
+}
+
+// ── take ──────────────────────────────────────────────
+
+// 切り出した領域はライン境界から始まり、ゼロ初期化され、互いに重ならない
+TEST_CASE("DspArena: take returns aligned zeroed disjoint spans",
+          "[dsp_arena]") {
+  DspArena arena;
+  arena.reset(DspArena::bytesFor<float>(5) + DspArena::bytesFor<int>(7));
+  auto a = arena.take<float>(5);
+  auto b = arena.take<int>(7);
+
+  REQUIRE(a.size() == 5);
+  REQUIRE(b.size() == 7);
+  CHECK(isLineAligned(a.data()));
+  CHECK(isLineAligned(b.data()));
+  for (const float v : a)
+    CHECK(v == 0.0f);
+  for (const int v : b)
+    CHECK(v == 0);
+  CHECK(static_cast<const void *>(b.data()) >=
+        static_cast<const void *>(a.data() + a.size()));
+  CHECK(arena.used() == arena.capacity());
+}
+
+// ── reset ─────────────────────────────────────────────
+
+// 容量が足りていれば再確保せず、先頭から切り出し直してゼロ初期化する
+TEST_CASE("DspArena: reset reuses capacity", "[dsp_arena]") {
+  DspArena arena;
+  arena.reset(DspArena::bytesFor<float>(64));
+  auto first = arena.take<float>(64);
+  first[3] = 1.0f;
+
+  arena.reset(DspArena::bytesFor<float>(32));
+  CHECK(arena.capacity() == DspArena::bytesFor<float>(64));
+  CHECK(arena.used() == 0);
+  auto again = arena.take<float>(32);
+  CHECK(again.data() == first.data());
+  CHECK(again[3] == 0.0f);
+}
+
+// ── 容量超過 ──────────────────────────────────────────
+
+#ifdef NDEBUG
+// 見積もり漏れでもリリースビルドでは範囲外を返さず、別確保で補う
+// （デバッグビルドでは assert で止まるため NDEBUG 時のみ）
+TEST_CASE("DspArena: take falls back to a separate block on overflow",
+          "[dsp_arena]") {
+  DspArena arena;
+  arena.reset(DspArena::bytesFor<float>(16));
+  auto fits = arena.take<float>(16);
+  auto spill = arena.take<float>(100);
+
+  REQUIRE(spill.size() == 100);
+  CHECK(isLineAligned(spill.data()));
+  for (const float v : spill)
+    CHECK(v == 0.0f);
+  spill[99] = 1.0f; // 書き込めること
+  CHECK(fits.size() == 16);
+  CHECK(arena.overflowCount() == 1);
+
+  arena.reset(DspArena::bytesFor<float>(16));
+  CHECK(arena.overflowCount() == 0);
+}
+#endif
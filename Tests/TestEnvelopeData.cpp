@@ -328,3 +328,81 @@ TEST_CASE("EnvelopeData: evaluate never returns NaN or Inf",
     CHECK(std::isfinite(v));
   }
 }
+
+// ─────────────────────────────────────────────────────────────────
+// 14. evaluateRange: カーソル評価が evaluate と一致
+// ─────────────────────────────────────────────────────────────────
+
+TEST_CASE("EnvelopeData: evaluateRange matches evaluate", "[envelope_data]") {
+  EnvelopeData env;
+  env.addPoint(5.0f, 0.2f);
+  env.addPoint(40.0f, 1.8f);
+  env.addPoint(40.0f, 0.6f); // 同時刻ポイント
+  env.addPoint(120.0f, 1.0f);
+  env.addPoint(250.0f, 0.0f);
+  env.setSegmentCurve(0, 0.7f);
+  env.setSegmentCurve(2, -0.4f);
+  env.setSegmentCurve(3, 1.0f);
+
+  constexpr int n = 701;
+  std::vector<float> out(n);
+  env.evaluateRange(-20.0f, 0.43f, n, out.data());
+  for (int k = 0; k < n; ++k) {
+    const float t = -20.0f + 0.43f * static_cast<float>(k);
+    CHECK_THAT(out[static_cast<size_t>(k)], WithinAbs(env.evaluate(t), 1e-6f));
+  }
+}
+
+TEST_CASE("EnvelopeData: evaluateRange handles flat and single-point envelopes",
+          "[envelope_data]") {
+  EnvelopeData env;
+  env.setDefaultValue(0.25f);
+  std::vector<float> out(8, -1.0f);
+  env.evaluateRange(0.0f, 1.0f, 8, out.data());
+  for (const float v : out)
+    CHECK_THAT(v, WithinAbs(0.25f, 1e-6f));
+
+  env.addPoint(10.0f, 0.9f);
+  env.evaluateRange(0.0f, 5.0f, 8, out.data());
+  for (const float v : out)
+    CHECK_THAT(v, WithinAbs(0.9f, 1e-6f));
+}
+
+TEST_CASE("EnvelopeData: curve edits survive point insertion and removal",
+          "[envelope_data]") {
+  EnvelopeData env;
+  env.addPoint(0.0f, 0.0f);
+  env.addPoint(100.0f, 1.0f);
+  env.setSegmentCurve(0, 1.0f);
+  const float curved = env.evaluate(50.0f);
+
+  // 後ろに挿入しても既存セグメントのカーブは保たれる
+  env.addPoint(200.0f, 0.5f);
+  CHECK_THAT(env.evaluate(50.0f), WithinAbs(curved, 1e-6f));
+  CHECK_THAT(env.evaluate(150.0f), WithinAbs(0.75f, 1e-6f));
+
+  // 先頭を削除すると旧セグメント 1（直線）が先頭になる
+  env.removePoint(0);
+  CHECK_THAT(env.evaluate(150.0f), WithinAbs(0.75f, 1e-6f));
+}
+
+TEST_CASE("EnvelopeData: evaluateRange over a dense freehand envelope",
+          "[envelope_data]") {
+  EnvelopeData env;
+  constexpr int numPoints = 4000;
+  for (int i = 0; i < numPoints; ++i) {
+    const float t = static_cast<float>(i) * 0.1f;
+    env.addPoint(t, 1.0f + std::sin(t * 0.05f));
+    if (i % 3 == 0)
+      env.setSegmentCurve(i, 0.5f);
+  }
+
+  constexpr int n = 512;
+  std::vector<float> out(n);
+  const float dt = 400.0f / static_cast<float>(n - 1);
+  env.evaluateRange(0.0f, dt, n, out.data());
+  for (int k = 0; k < n; k += 7) {
+    const float t = dt * static_cast<float>(k);
+    CHECK_THAT(out[static_cast<size_t>(k)], WithinAbs(env.evaluate(t), 1e-6f));
+  }
+}
@@ -2,15 +2,30 @@
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 
 #include "DSP/EnvelopeLutManager.h"
+#include "GUI/LutBaker.h"
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <random>
 #include <vector>
 
 using namespace Catch::Matchers;
 
+namespace {
+EnvelopeLutManager::Table flatTable(float v) {
+  EnvelopeLutManager::Table t;
+  t.pos[1] = 1.0f;
+  t.value[0] = v;
+  t.value[1] = v;
+  t.size = 2;
+  return t;
+}
+} // namespace
+
 // ── reset ───────────────────────────────────────────
 
-// reset() 後は両バッファが 1.0 で埋まり、activeIndex が 0 になること
+// reset() 後は公開中の LUT が 1.0 のフラットになること
 TEST_CASE("EnvelopeLutManager: reset fills lut with 1.0", "[envelope_lut]") {
   EnvelopeLutManager mgr;
   // bake で何か書き込んでおく
@@ -21,11 +36,13 @@ TEST_CASE("EnvelopeLutManager: reset fills lut with 1.0", "[envelope_lut]") {
 
   mgr.reset();
   const auto &lut = mgr.getActiveLut();
-  for (int i = 0; i < EnvelopeLutManager::lutSize; ++i)
-    CHECK(lut[static_cast<std::size_t>(i)] == 1.0f);
+  REQUIRE(lut.size == 2);
+  CHECK(lut.value[0] == 1.0f);
+  CHECK(lut.value[1] == 1.0f);
+  CHECK(lut.evaluate(0.37f) == 1.0f);
 }
 
-// ── bake (リサンプル & ダブルバッファフリップ) ──────
+// ── bake (リサンプル & 公開) ─────────────────────────
 
 // 2点 {0.0, 1.0} を bake すると LUT が 0→1 のランプになること
 TEST_CASE("EnvelopeLutManager: bake resamples linear ramp", "[envelope_lut]") {
@@ -36,15 +53,17 @@ TEST_CASE("EnvelopeLutManager: bake resamples linear ramp", "[envelope_lut]") {
   mgr.bake(src.data(), 2);
 
   const auto &lut = mgr.getActiveLut();
-  CHECK(lut[0] == 0.0f);
-  CHECK(lut[EnvelopeLutManager::lutSize - 1] == 1.0f);
+  REQUIRE(lut.size == EnvelopeLutManager::lutSize);
+  CHECK(lut.value[0] == 0.0f);
+  CHECK(lut.value[EnvelopeLutManager::lutSize - 1] == 1.0f);
   // 中間点は≈0.5
   const auto mid = static_cast<std::size_t>(EnvelopeLutManager::lutSize / 2);
-  CHECK_THAT(lut[mid], WithinAbs(0.5, 0.01));
+  CHECK_THAT(lut.value[mid], WithinAbs(0.5, 0.01));
+  CHECK_THAT(lut.evaluate(0.25f), WithinAbs(0.25, 1e-5));
 }
 
-// bake を2回呼ぶとダブルバッファが交互にフリップすること
-TEST_CASE("EnvelopeLutManager: double buffer flips on each bake",
+// bake を連続で呼ぶと、その都度最新の LUT が公開されること
+TEST_CASE("EnvelopeLutManager: each bake publishes the latest lut",
           "[envelope_lut]") {
   EnvelopeLutManager mgr;
   mgr.reset();
@@ -52,12 +71,12 @@ TEST_CASE("EnvelopeLutManager: double buffer flips on each bake",
   // 1回目: 全部 0.25
   const std::array<float, 1> d1 = {0.25f};
   mgr.bake(d1.data(), 1);
-  CHECK(mgr.getActiveLut()[0] == 0.25f);
+  CHECK(mgr.getActiveLut().value[0] == 0.25f);
 
-  // 2回目: 全部 0.75 → もう一方のバッファに書かれてフリップ
+  // 2回目: 全部 0.75 → 読み手が次に acquire した時点で切り替わる
   const std::array<float, 1> d2 = {0.75f};
   mgr.bake(d2.data(), 1);
-  CHECK(mgr.getActiveLut()[0] == 0.75f);
+  CHECK(mgr.getActiveLut().value[0] == 0.75f);
 }
 
 // ── setDurationMs / getDurationMs ───────────────────
@@ -76,8 +95,7 @@ TEST_CASE("EnvelopeLutManager: duration ms get/set", "[envelope_lut]") {
 // 均一 LUT (1.0) で duration 内ならamp≈1.0 を返すこと
 TEST_CASE("EnvelopeLutManager: computeAmp returns 1.0 for flat lut",
           "[envelope_lut]") {
-  std::array<float, EnvelopeLutManager::lutSize> lut{};
-  lut.fill(1.0f);
+  const auto lut = flatTable(1.0f);
 
   // duration 冒頭
   CHECK_THAT(EnvelopeLutManager::computeAmp(lut, 300.0f, 0.0f),
@@ -89,18 +107,17 @@ TEST_CASE("EnvelopeLutManager: computeAmp returns 1.0 for flat lut",
 
 // ── computeAmp: LUT 補間 ───────────────────────────
 
-// ランプ LUT (0→1) の中間時刻で≈0.5 を返すこと
+// ランプ LUT (0→1) の中間時刻で 0.5 を返すこと（線形補間）
 TEST_CASE("EnvelopeLutManager: computeAmp reads ramp lut at midpoint",
           "[envelope_lut]") {
-  std::array<float, EnvelopeLutManager::lutSize> lut{};
-  for (int i = 0; i < EnvelopeLutManager::lutSize; ++i)
-    lut[static_cast<std::size_t>(i)] =
-        static_cast<float>(i) /
-        static_cast<float>(EnvelopeLutManager::lutSize - 1);
+  EnvelopeLutManager::Table lut;
+  lut.pos[1] = 1.0f;
+  lut.value[1] = 1.0f;
+  lut.size = 2;
 
   // t=150ms / dur=300ms → LUT 中央 ≈ 0.5（ただし fadeOut 開始前）
   const float amp = EnvelopeLutManager::computeAmp(lut, 300.0f, 150.0f);
-  CHECK_THAT(amp, WithinAbs(0.5, 0.01));
+  CHECK_THAT(amp, WithinAbs(0.5, 1e-5));
 }
 
 // ── computeAmp: 末尾 5ms half-cosine フェードアウト ─
@@ -108,8 +125,7 @@ TEST_CASE("EnvelopeLutManager: computeAmp reads ramp lut at midpoint",
 // duration 末尾で 0 に近づくこと（半余弦フェード）
 TEST_CASE("EnvelopeLutManager: computeAmp fades to zero at end",
           "[envelope_lut]") {
-  std::array<float, EnvelopeLutManager::lutSize> lut{};
-  lut.fill(1.0f);
+  const auto lut = flatTable(1.0f);
 
   const float durMs = 300.0f;
   // ちょうど duration 位置 → t=1.0 → cos(π)=-1 → 0.5*(1-1)=0
@@ -124,13 +140,12 @@ TEST_CASE("EnvelopeLutManager: computeAmp fades to zero at end",
 
 // ── computeAmp: duration=0 の境界ケース ─────────────
 
-// ampDurMs=0 のとき lutIdx=0 を参照し、即座にフェードアウトすること
+// ampDurMs=0 のとき先頭値を参照し、即座にフェードアウトすること
 TEST_CASE("EnvelopeLutManager: computeAmp with zero duration",
           "[envelope_lut]") {
-  std::array<float, EnvelopeLutManager::lutSize> lut{};
-  lut.fill(0.8f);
+  const auto lut = flatTable(0.8f);
 
-  // t=0, dur=0 → lutPos=0, fadeStart=max(0, -5)=0 → t=min(0/5,1)=0 →
+  // t=0, dur=0 → u=0, fadeStart=max(0, -5)=0 → t=min(0/5,1)=0 →
   // cos(0)=1 → amp = 0.8 * 0.5*(1+1) = 0.8
   CHECK_THAT(EnvelopeLutManager::computeAmp(lut, 0.0f, 0.0f),
              WithinAbs(0.8, 1e-5));
@@ -145,9 +160,256 @@ TEST_CASE("EnvelopeLutManager: computeAmp with zero duration",
 // noteTimeMs が duration+5ms を超えたら確実に 0 になること
 TEST_CASE("EnvelopeLutManager: computeAmp returns 0 well past duration",
           "[envelope_lut]") {
-  std::array<float, EnvelopeLutManager::lutSize> lut{};
-  lut.fill(1.0f);
+  const auto lut = flatTable(1.0f);
 
   const float amp = EnvelopeLutManager::computeAmp(lut, 300.0f, 1000.0f);
   CHECK_THAT(amp, WithinAbs(0.0, 1e-4));
 }
+
+// ブロック内でカーソルを使い回しても、毎回探索した値と一致すること
+TEST_CASE("EnvelopeLutManager: computeAmp with a block cursor",
+          "[envelope_lut]") {
+  EnvelopeLutManager::Table lut;
+  for (int i = 0; i < 64; ++i) {
+    const auto k = static_cast<std::size_t>(i);
+    lut.pos[k] = static_cast<float>(i * i) / (63.0f * 63.0f);
+    lut.value[k] = static_cast<float>(i % 7) / 7.0f;
+  }
+  lut.size = 64;
+
+  int cursor = -1;
+  for (float t = 0.0f; t < 310.0f; t += 0.37f)
+    CHECK(EnvelopeLutManager::computeAmp(lut, 300.0f, t, cursor) ==
+          EnvelopeLutManager::computeAmp(lut, 300.0f, t));
+  CHECK(cursor == 62); // 末尾セグメントまで進んでいる
+}
+
+// ── 折れ線 LUT: 補間とカーソル ───────────────────────
+
+// 不等間隔頂点を線形補間し、ステップ（同位置）は右側の値を採ること
+TEST_CASE("EnvelopeLutManager: breakpoint table interpolates and steps",
+          "[envelope_lut]") {
+  EnvelopeLutManager mgr;
+  const std::array<float, 5> pos = {0.0f, 0.01f, 0.5f, 0.5f, 1.0f};
+  const std::array<float, 5> val = {0.0f, 1.0f, 0.5f, 2.0f, 0.0f};
+  mgr.bakeBreakpoints(pos.data(), val.data(), 5);
+
+  const auto &lut = mgr.getActiveLut();
+  REQUIRE(lut.size == 5);
+  CHECK_THAT(lut.evaluate(0.005f), WithinAbs(0.5, 1e-5));
+  CHECK_THAT(lut.evaluate(0.255f), WithinAbs(0.75, 1e-5));
+  CHECK_THAT(lut.evaluate(0.5f), WithinAbs(2.0, 1e-6));
+  CHECK_THAT(lut.evaluate(0.75f), WithinAbs(1.0, 1e-5));
+  CHECK(lut.evaluate(-1.0f) == 0.0f);
+  CHECK(lut.evaluate(2.0f) == 0.0f);
+
+  // 単調増加の呼び出し列ではカーソル付き評価が毎回の二分探索と一致する
+  int cursor = -1;
+  for (int i = 0; i <= 1000; ++i) {
+    const float u = static_cast<float>(i) / 1000.0f;
+    CHECK(lut.evaluate(u, cursor) == lut.evaluate(u));
+  }
+}
+
+// ── LutCompiler: EnvelopeData → 折れ線 ────────────────
+
+// 直線だけのエンベロープは制御点そのものが頂点になり、
+// 0.5ms の速いアタックも角が正確に残ること
+TEST_CASE("LutCompiler: linear envelope keeps exact corners",
+          "[envelope_lut]") {
+  EnvelopeData env;
+  env.addPoint(0.0f, 0.0f);
+  env.addPoint(0.5f, 1.0f);
+  env.addPoint(2000.0f, 0.2f);
+
+  EnvelopeLutManager mgr;
+  bakeLut(env, mgr, 2000.0f);
+  const auto &lut = mgr.getActiveLut();
+  CHECK(lut.size == 3);
+  int cursor = -1;
+  for (const float t : {0.0f, 0.1f, 0.25f, 0.5f, 1.0f, 700.0f, 1999.0f})
+    CHECK_THAT(lut.evaluateMs(t, 2000.0f, cursor),
+               WithinAbs(env.evaluate(t), 1e-5));
+}
+
+// カーブ付きセグメント（Freq の長いピッチドロップ）を相対誤差内で近似し、
+// 等間隔 512 点より少ない頂点で済むこと
+TEST_CASE("LutCompiler: curved pitch drop stays within tolerance",
+          "[envelope_lut]") {
+  EnvelopeData env;
+  env.addPoint(0.0f, 2000.0f);
+  env.addPoint(2000.0f, 40.0f);
+  env.setSegmentCurve(0, 1.0f);
+
+  EnvelopeLutManager mgr;
+  bakeLut(env, mgr, 2000.0f);
+  const auto &lut = mgr.getActiveLut();
+  CHECK(lut.size < EnvelopeLutManager::lutSize);
+
+  int cursor = -1;
+  for (int i = 0; i <= 20000; ++i) {
+    const float t = static_cast<float>(i) * 0.1f;
+    const float expected = env.evaluate(t);
+    const float actual = lut.evaluateMs(t, 2000.0f, cursor);
+    // 候補点間の補間誤差を含めて 0.2% 以内（≈3.5 cent 未満）
+    CHECK_THAT(actual, WithinRel(expected, 0.002f));
+  }
+}
+
+// 手描き相当の数千点でも lutSize 以内に収まること
+TEST_CASE("LutCompiler: dense freehand envelope fits the table",
+          "[envelope_lut]") {
+  EnvelopeData env;
+  for (int i = 0; i < 3000; ++i) {
+    const float t = static_cast<float>(i) * 0.1f;
+    env.addPoint(t, 1.0f + 0.5f * std::sin(t * 0.2f));
+  }
+
+  EnvelopeLutManager mgr;
+  bakeLut(env, mgr, 299.9f);
+  const auto &lut = mgr.getActiveLut();
+  CHECK(lut.size <= EnvelopeLutManager::lutSize);
+  int cursor = -1;
+  for (int i = 0; i < 2999; i += 13) {
+    const float t = static_cast<float>(i) * 0.1f;
+    CHECK_THAT(lut.evaluateMs(t, 299.9f, cursor),
+               WithinAbs(env.evaluate(t), 0.01));
+  }
+}
+
+// ランダムな折れ線（ステップ混じり）を間引いても、端点とステップの両側は
+// 残り、間引いた点はすべて残った線分から各点の許容誤差以内にあること
+TEST_CASE("LutCompiler: simplify keeps dropped points within tolerance",
+          "[envelope_lut]") {
+  constexpr float relTol = 1.0e-3f;
+  constexpr float absTol = 1.0e-3f;
+  std::mt19937 rng(38);
+  std::uniform_real_distribution<float> step(0.0f, 1.0f);
+
+  for (int run = 0; run < 2000; ++run) {
+    std::vector<LutCompiler::Vertex> in;
+    float t = 0.0f;
+    float v = 0.0f;
+    const int n = 2 + static_cast<int>(step(rng) * 300.0f);
+    for (int k = 0; k < n; ++k) {
+      const float r = step(rng);
+      if (r > 0.03f || k == 0)
+        t += 0.05f + r; // r ≤ 0.03 のとき同時刻（ステップ）
+      v += (step(rng) - 0.5f) * (r < 0.5f ? 0.002f : 0.2f);
+      in.push_back({t, v});
+    }
+
+    const auto out = LutCompiler::simplify(in, relTol, absTol);
+    REQUIRE(out.size() >= 2);
+    CHECK(out.front().timeMs == in.front().timeMs);
+    CHECK(out.back().timeMs == in.back().timeMs);
+
+    std::size_t j = 0;
+    for (std::size_t k = 1; k < in.size(); ++k) {
+      if (in[k].timeMs == in[k - 1].timeMs) {
+        // ステップの両側は頂点として残る
+        CHECK(std::ranges::count_if(out, [&](const auto &o) {
+                return o.timeMs == in[k].timeMs;
+              }) >= 2);
+        continue;
+      }
+      while (j + 1 < out.size() && out[j + 1].timeMs < in[k].timeMs)
+        ++j;
+      const auto &a = out[j];
+      const auto &b = out[j + 1];
+      if (in[k].timeMs == b.timeMs)
+        continue; // 残った頂点
+      const float s = (in[k].timeMs - a.timeMs) / (b.timeMs - a.timeMs);
+      const float tol = std::max(absTol, relTol * std::abs(in[k].value));
+      CHECK(std::abs(std::lerp(a.value, b.value, s) - in[k].value) <=
+            tol * 1.01f);
+    }
+  }
+}
+
+// ノブ制御（ポイント 1 個以下）はフラット 2 頂点になること
+TEST_CASE("LutCompiler: knob-controlled envelope bakes flat",
+          "[envelope_lut]") {
+  EnvelopeData env;
+  env.setDefaultValue(0.6f);
+  EnvelopeLutManager mgr;
+  bakeLut(env, mgr, 300.0f);
+  CHECK(mgr.getActiveLut().size == 2);
+  CHECK(mgr.getActiveLut().evaluate(0.5f) == 0.6f);
+}
+
+// ── Bank: 複数本の一括公開 ────────────────────────────
+
+// update() 内の変更は全 slot まとめて公開され、読み手は acquire() するまで
+// 取り込み済みの組を読み続けること
+TEST_CASE("EnvelopeLutManager::Bank: update publishes all slots at once",
+          "[envelope_lut]") {
+  EnvelopeLutManager::Bank<2> bank;
+  const auto &before = bank.acquire();
+  REQUIRE(before[0].table.evaluate(0.5f) == 1.0f);
+
+  bank.update([](EnvelopeLutManager::Bank<2>::Luts &luts) {
+    luts[0].setFlat(0.25f);
+    luts[0].durationMs = 100.0f;
+    luts[1].setFlat(0.75f);
+    luts[1].durationMs = 200.0f;
+  });
+  CHECK(bank.current()[0].table.evaluate(0.5f) == 1.0f);
+  CHECK(bank.current()[1].table.evaluate(0.5f) == 1.0f);
+
+  const auto &after = bank.acquire();
+  CHECK(after[0].table.evaluate(0.5f) == 0.25f);
+  CHECK(after[0].durationMs == 100.0f);
+  CHECK(after[1].table.evaluate(0.5f) == 0.75f);
+  CHECK(after[1].durationMs == 200.0f);
+  CHECK(bank.durationMs(1) == 200.0f);
+}
+
+// slot 指定の bakeLut は他の slot を変えないこと
+TEST_CASE("EnvelopeLutManager::Bank: bakeLut on one slot keeps others",
+          "[envelope_lut]") {
+  EnvelopeLutManager::Bank<2> bank;
+  EnvelopeData env;
+  env.setDefaultValue(0.4f);
+  bakeLut(env, bank, 1, 50.0f);
+
+  const auto &luts = bank.acquire();
+  CHECK(luts[0].table.evaluate(0.5f) == 1.0f);
+  CHECK(luts[1].table.evaluate(0.5f) == 0.4f);
+  CHECK(luts[1].durationMs == 50.0f);
+}
+
+// 公開（update / reset）のたびに世代が進み、update は公開後の世代を返す
+TEST_CASE("EnvelopeLutManager::Bank: generation counts publishes",
+          "[envelope_lut]") {
+  EnvelopeLutManager::Bank<2> bank;
+  const auto g0 = bank.generation();
+  EnvelopeData env;
+  const auto g1 = bakeLut(env, bank, 0, 50.0f);
+  CHECK(g1 == g0 + 1);
+  CHECK(bank.generation() == g1);
+  bank.reset();
+  CHECK(bank.generation() == g1 + 1);
+
+  EnvelopeLutManager lut;
+  const auto h0 = lut.generation();
+  CHECK(bakeLut(env, lut, 100.0f) == h0 + 1);
+}
+
+// bakeLutBank は各エンベロープの実効区間を期間に使うこと
+TEST_CASE("LutCompiler: bakeLutBank uses effective durations",
+          "[envelope_lut]") {
+  EnvelopeData knob;
+  knob.setDefaultValue(0.5f);
+  EnvelopeData ramp;
+  ramp.addPoint(0.0f, 0.0f);
+  ramp.addPoint(120.0f, 1.0f);
+
+  EnvelopeLutManager::Bank<2> bank;
+  bakeLutBank(bank, {&knob, &ramp}, 300.0f);
+  const auto &luts = bank.acquire();
+  CHECK(luts[0].durationMs == 300.0f);
+  CHECK(luts[1].durationMs == 120.0f);
+  int cursor = -1;
+  CHECK_THAT(luts[1].evaluateMs(60.0f, cursor), WithinAbs(0.5, 1e-5));
+}
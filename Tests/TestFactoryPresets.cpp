@@ -0,0 +1,102 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "FactoryPresets.h"
+#include "SampleRef.h"
+
+#include <array>
+#include <cstring>
+
+// ── 一覧 / 解析 ───────────────────────────────────────
+
+// 名前順に並び、名前で引ける
+TEST_CASE("FactoryPresets: presets are sorted and found by name",
+          "[factory_presets]") {
+  const auto presets = FactoryPresets::all();
+  REQUIRE_FALSE(presets.empty());
+  for (std::size_t i = 1; i < presets.size(); ++i)
+    CHECK(juce::String(presets[i - 1].name) < juce::String(presets[i].name));
+
+  CHECK(FactoryPresets::find("junglist") != nullptr);
+  CHECK(FactoryPresets::find("no such preset") == nullptr);
+}
+
+// state はメモリから解析され、埋め込みサンプルは factory: 参照になる
+TEST_CASE("FactoryPresets: readState points samples at embedded data",
+          "[factory_presets]") {
+  for (const auto &p : FactoryPresets::all())
+    CHECK(FactoryPresets::readState(p).isValid());
+
+  const auto state =
+      FactoryPresets::readState(*FactoryPresets::find("junglist"));
+  const auto ref = state["directSamplePath"].toString();
+  CHECK(ref == "factory:junglist/direct_sample.wav");
+  CHECK(FactoryPresets::isSampleRef(ref));
+  CHECK(state["clickSamplePath"].toString().isEmpty());
+
+  const auto stream = FactoryPresets::openSample(ref);
+  REQUIRE(stream != nullptr);
+  std::array<char, 4> magic{};
+  REQUIRE(stream->read(magic.data(), 4) == 4);
+  CHECK(std::memcmp(magic.data(), "RIFF", 4) == 0);
+
+  CHECK(FactoryPresets::openSample("factory:junglist/click_sample.wav") ==
+        nullptr);
+  CHECK(FactoryPresets::openSample("factory:missing/direct_sample.wav") ==
+        nullptr);
+  CHECK(FactoryPresets::openSample("/tmp/direct_sample.wav") == nullptr);
+}
+
+// ── SampleRef ─────────────────────────────────────────
+
+// 埋め込みサンプルはディスクを介さずロードでき、二度目はデコードしない
+TEST_CASE("SampleRef: embedded samples load from memory", "[factory_presets]") {
+  const juce::String ref = "factory:junglist/direct_sample.wav";
+  CHECK(SampleRef::exists(ref));
+  CHECK_FALSE(SampleRef::exists("factory:junglist/click_sample.wav"));
+  CHECK_FALSE(SampleRef::exists("relative/path.wav"));
+  CHECK(SampleRef::displayName(ref) == "direct_sample");
+
+  SamplePlayer sampler;
+  sampler.prepare();
+  SampleRef::loadInto(sampler, ref);
+  REQUIRE(sampler.isLoaded());
+  CHECK(SampleRef::isLoadedIn(sampler, ref));
+  CHECK(sampler.durationSec() > 0.0);
+
+  juce::AudioFormatManager fm;
+  fm.registerBasicFormats();
+  const auto decoded = SampleRef::decode(ref, fm);
+  REQUIRE(decoded != nullptr);
+  CHECK(decoded->source == ref);
+  CHECK(SampleRef::isCurrent(*decoded));
+}
+
+// 保存時は埋め込みサンプルの中身がそのままファイルになる
+TEST_CASE("SampleRef: copyTo writes embedded data out", "[factory_presets]") {
+  const auto dest = juce::File::createTempFile(".wav");
+  REQUIRE(SampleRef::copyTo("factory:junglist/direct_sample.wav", dest));
+  const auto *preset = FactoryPresets::find("junglist");
+  CHECK(dest.getSize() == preset->directSize);
+  CHECK_FALSE(SampleRef::copyTo("factory:junglist/click_sample.wav", dest));
+  dest.deleteFile();
+}
+
+// 旧版が展開した Factory サンプルのパスは埋め込みサンプルへ読み替える
+TEST_CASE("SampleRef: legacy factory paths map to embedded samples",
+          "[factory_presets]") {
+  const juce::String dir = "/Users/me/Documents/Auditive/BoomBaby/Presets/";
+  CHECK(SampleRef::relocate(dir + "Factory/junglist.bbpreset/direct_sample.wav",
+                            0) == "factory:junglist/direct_sample.wav");
+  CHECK(FactoryPresets::fromLegacyPath(
+            "C:\\Users\\me\\Documents\\Auditive\\BoomBaby\\Presets\\"
+            "Factory\\junglist.bbpreset\\direct_sample.wav") ==
+        "factory:junglist/direct_sample.wav");
+
+  // User プリセット・未知のプリセット・埋め込みに無いサンプルはそのまま
+  for (const auto *rest : {"User/junglist.bbpreset/direct_sample.wav",
+                           "Factory/missing.bbpreset/direct_sample.wav",
+                           "Factory/junglist.bbpreset/click_sample.wav"}) {
+    CHECK(FactoryPresets::fromLegacyPath(dir + rest).isEmpty());
+    CHECK(SampleRef::relocate(dir + rest, 0) == dir + rest);
+  }
+}
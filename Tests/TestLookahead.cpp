@@ -0,0 +1,111 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "DSP/Lookahead.h"
+
+#include <vector>
+
+// ─── delayStereo ────────────────────────────────────────────────
+
+// delay 0 では入力がそのまま残ることを確認する
+TEST_CASE("Lookahead: zero delay is passthrough", "[lookahead]") {
+  Lookahead la;
+  la.prepare(64);
+  std::vector<float> l = {1.0f, 2.0f, 3.0f};
+  std::vector<float> r = {4.0f, 5.0f, 6.0f};
+  la.delayStereo(l.data(), r.data(), 3);
+  CHECK(l == std::vector<float>{1.0f, 2.0f, 3.0f});
+  CHECK(r == std::vector<float>{4.0f, 5.0f, 6.0f});
+}
+
+// ブロック境界をまたいでも N サンプル遅延になることを確認する
+TEST_CASE("Lookahead: delays by N samples across blocks", "[lookahead]") {
+  Lookahead la;
+  la.prepare(8);
+  la.setDelaySamples(5);
+
+  std::vector<float> outL;
+  float next = 1.0f;
+  for (int blk = 0; blk < 4; ++blk) {
+    std::vector<float> l(3);
+    std::vector<float> r(3);
+    for (auto &v : l)
+      v = next++;
+    r = l;
+    la.delayStereo(l.data(), r.data(), 3);
+    CHECK(l == r);
+    outL.insert(outL.end(), l.begin(), l.end());
+  }
+  for (std::size_t i = 0; i < outL.size(); ++i) {
+    const float expected = i < 5 ? 0.0f : static_cast<float>(i - 5 + 1);
+    CHECK(outL[i] == expected);
+  }
+}
+
+// 遅延量は prepare した最大値でクランプされることを確認する
+TEST_CASE("Lookahead: delay is clamped to prepared maximum", "[lookahead]") {
+  Lookahead la;
+  la.prepare(10);
+  la.setDelaySamples(100);
+  CHECK(la.getDelaySamples() == 10);
+  la.setDelaySamples(-3);
+  CHECK(la.getDelaySamples() == 0);
+}
+
+// 遅延量を変えたら、以前の遅延中にリングへ残った音は出てこない
+TEST_CASE("Lookahead: changing the delay clears stale audio", "[lookahead]") {
+  Lookahead la;
+  la.prepare(8);
+  la.setDelaySamples(4);
+  std::vector<float> l(6, 1.0f);
+  std::vector<float> r(6, 1.0f);
+  la.delayStereo(l.data(), r.data(), 6);
+
+  // 0 → N の切り替えでも同じ（0 の間はリングを更新しない）
+  la.setDelaySamples(0);
+  la.setDelaySamples(3);
+  std::vector<float> outL(3, 0.5f);
+  std::vector<float> outR(3, 0.5f);
+  la.delayStereo(outL.data(), outR.data(), 3);
+  CHECK(outL == std::vector<float>{0.0f, 0.0f, 0.0f});
+  CHECK(outR == std::vector<float>{0.0f, 0.0f, 0.0f});
+
+  // 同じ値の再設定ではクリアしない（毎ブロック設定される）
+  std::vector<float> moreL(3, 0.0f);
+  std::vector<float> moreR(3, 0.0f);
+  la.setDelaySamples(3);
+  la.delayStereo(moreL.data(), moreR.data(), 3);
+  CHECK(moreL == std::vector<float>{0.5f, 0.5f, 0.5f});
+}
+
+// ─── schedule / popDue ──────────────────────────────────────────
+
+// 予約は昇順で発火し、範囲外の予約は次のブロックへ繰り越されることを確認する
+TEST_CASE("Lookahead: pops due triggers in order and carries the rest",
+          "[lookahead]") {
+  Lookahead la;
+  la.prepare(16);
+  la.schedule(150);
+  la.schedule(10);
+  la.schedule(127);
+
+  std::vector<int> fired;
+  la.popDue(128, [&](int pos) { fired.push_back(pos); });
+  CHECK(fired == std::vector<int>{10, 127});
+  REQUIRE(la.numPending() == 1);
+
+  fired.clear();
+  la.popDue(128, [&](int pos) { fired.push_back(pos); });
+  CHECK(fired == std::vector<int>{22});
+  CHECK(la.numPending() == 0);
+}
+
+// 容量を超えた予約は破棄され、reset() で全予約が消えることを確認する
+TEST_CASE("Lookahead: pending capacity and reset", "[lookahead]") {
+  Lookahead la;
+  la.prepare(16);
+  for (int i = 0; i < Lookahead::kMaxPending + 4; ++i)
+    la.schedule(1000 + i);
+  CHECK(la.numPending() == Lookahead::kMaxPending);
+  la.reset();
+  CHECK(la.numPending() == 0);
+}
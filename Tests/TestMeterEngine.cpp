@@ -0,0 +1,136 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "DSP/MeterEngine.h"
+
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+using namespace Catch::Matchers;
+
+namespace {
+constexpr double kSr = 48000.0;
+constexpr int kBlock = 128;
+
+/// 全ストリームに同じサイン波を流す（phase は呼び出し間で継続）
+void feedSine(MeterEngine &m, float amp, double hz, double &phase,
+              int numBlocks, bool masterOnly = false) {
+  std::vector<float> buf(kBlock);
+  const double inc = 2.0 * std::numbers::pi * hz / kSr;
+  for (int b = 0; b < numBlocks; ++b) {
+    for (auto &v : buf) {
+      v = amp * static_cast<float>(std::sin(phase));
+      phase += inc;
+    }
+    const float *ch = masterOnly ? nullptr : buf.data();
+    m.process({buf.data(), buf.data(), ch, ch, ch}, kBlock);
+  }
+}
+} // namespace
+
+// ── ピーク / RMS ──────────────────────────────────────
+
+// 正弦波のサンプルピークと RMS（ピーク − 3.01 dB）を確認する
+TEST_CASE("MeterEngine: sine peak and RMS", "[meter_engine]") {
+  MeterEngine m;
+  m.prepare(kSr, kBlock);
+  double phase = 0.0;
+  feedSine(m, 0.5f, 1000.0, phase, 375 * 2); // 2 秒
+
+  const auto &s = m.snapshot();
+  CHECK_THAT(s.peakDb(MeterEngine::kMasterL), WithinAbs(-6.02, 0.05));
+  CHECK_THAT(s.rmsDb(MeterEngine::kMasterL), WithinAbs(-9.03, 0.1));
+  CHECK_THAT(s.peakDb(MeterEngine::kSub), WithinAbs(-6.02, 0.05));
+}
+
+// nullptr ストリームは無音として扱われることを確認する
+TEST_CASE("MeterEngine: null stream reads silence", "[meter_engine]") {
+  MeterEngine m;
+  m.prepare(kSr, kBlock);
+  double phase = 0.0;
+  feedSine(m, 0.5f, 1000.0, phase, 100, true);
+
+  const auto &s = m.snapshot();
+  CHECK(s.peakDb(MeterEngine::kMasterL) > -7.0f);
+  CHECK(s.peakDb(MeterEngine::kClick) == MeterEngine::kFloorDb);
+  CHECK(s.shortTermLufs(MeterEngine::kLoudClick) == MeterEngine::kFloorDb);
+}
+
+// ── True Peak ─────────────────────────────────────────
+
+// fs/4 の正弦波を 45° ずらすとサンプルピークは -3 dB だが、
+// True Peak は 0 dBTP 付近を示すことを確認する
+TEST_CASE("MeterEngine: true peak catches inter-sample peaks",
+          "[meter_engine]") {
+  MeterEngine m;
+  m.prepare(kSr, kBlock);
+  double phase = std::numbers::pi / 4.0;
+  feedSine(m, 1.0f, kSr / 4.0, phase, 20);
+
+  const auto &s = m.snapshot();
+  CHECK_THAT(s.peakDb(MeterEngine::kMasterL), WithinAbs(-3.01, 0.05));
+  CHECK_THAT(s.truePeakDb(MeterEngine::kMasterL), WithinAbs(0.0, 0.3));
+}
+
+// ── LUFS ──────────────────────────────────────────────
+
+// EBU Tech 3341 Test 1: 1 kHz / -23 dBFS ステレオ正弦波 → -23 LUFS
+TEST_CASE("MeterEngine: 1 kHz stereo sine at -23 dBFS reads -23 LUFS",
+          "[meter_engine]") {
+  MeterEngine m;
+  m.prepare(kSr, kBlock);
+  double phase = 0.0;
+  const float amp = std::pow(10.0f, -23.0f / 20.0f);
+  feedSine(m, amp, 1000.0, phase, 375 * 4); // 4 秒（Short-term 窓が埋まる）
+
+  const auto &s = m.snapshot();
+  CHECK_THAT(s.momentaryLufs(MeterEngine::kLoudMaster), WithinAbs(-23.0, 0.1));
+  CHECK_THAT(s.shortTermLufs(MeterEngine::kLoudMaster), WithinAbs(-23.0, 0.1));
+  // モノのチャンネルは片側分なので -3 LU
+  CHECK_THAT(s.shortTermLufs(MeterEngine::kLoudSub), WithinAbs(-26.0, 0.1));
+}
+
+// ── 減衰 ──────────────────────────────────────────────
+
+// decay() によるまとめ減衰が、無音ブロックを流した場合と一致することを確認する
+TEST_CASE("MeterEngine: analytic decay matches silent blocks",
+          "[meter_engine]") {
+  MeterEngine a;
+  MeterEngine b;
+  a.prepare(kSr, kBlock);
+  b.prepare(kSr, kBlock);
+  double pa = 0.0;
+  double pb = 0.0;
+  feedSine(a, 0.8f, 100.0, pa, 50);
+  feedSine(b, 0.8f, 100.0, pb, 50);
+
+  a.decay(kBlock * 40);
+  const std::vector<float> zeros(kBlock, 0.0f);
+  for (int i = 0; i < 40; ++i)
+    b.process({zeros.data(), zeros.data(), nullptr, nullptr, nullptr}, kBlock);
+
+  const auto &sa = a.snapshot();
+  const auto &sb = b.snapshot();
+  CHECK_THAT(sa.peakDb(MeterEngine::kMasterL),
+             WithinAbs(sb.peakDb(MeterEngine::kMasterL), 0.01));
+  CHECK_THAT(sa.rmsDb(MeterEngine::kMasterL),
+             WithinAbs(sb.rmsDb(MeterEngine::kMasterL), 0.01));
+  CHECK(sa.peakDb(MeterEngine::kMasterL) < -1.94f);
+}
+
+// 長い無音でラウドネス窓が空になり、床値まで落ちることを確認する
+TEST_CASE("MeterEngine: loudness falls to floor after long silence",
+          "[meter_engine]") {
+  MeterEngine m;
+  m.prepare(kSr, kBlock);
+  double phase = 0.0;
+  feedSine(m, 0.5f, 1000.0, phase, 400);
+  REQUIRE(m.snapshot().shortTermLufs(MeterEngine::kLoudMaster) > -20.0f);
+
+  m.decay(static_cast<int>(kSr) * 4);
+  CHECK(m.snapshot().shortTermLufs(MeterEngine::kLoudMaster) ==
+        MeterEngine::kFloorDb);
+  CHECK(m.snapshot().momentaryLufs(MeterEngine::kLoudMaster) ==
+        MeterEngine::kFloorDb);
+}
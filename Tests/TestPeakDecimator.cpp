@@ -0,0 +1,123 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "DSP/PeakDecimator.h"
+#include "GUI/PeakColumnRing.h"
+
+#include <vector>
+
+using namespace Catch::Matchers;
+
+namespace {
+struct Collected {
+  std::vector<PeakDecimator::MinMax> bins[PeakDecimator::kNumLevels];
+};
+
+void pushAll(PeakDecimator &d, const float *src, int n, Collected &out) {
+  d.push(src, n, [&out](int level, PeakDecimator::MinMax bin) {
+    out.bins[level].push_back(bin);
+  });
+}
+} // namespace
+
+// ビン数がレベル毎に 1/4 ずつ減り、値が区間の min/max になることを確認する
+TEST_CASE("PeakDecimator: pyramid bins cover their spans",
+          "[peak_decimator]") {
+  PeakDecimator d;
+  d.reset();
+  constexpr int kN = 1024;
+  std::vector<float> x(kN, 0.0f);
+  x[5] = 0.8f;    // レベル 0 の 0 番ビン
+  x[700] = -0.6f; // レベル 0 の 43 番ビン / レベル 2 の 2 番ビン
+
+  Collected c;
+  // 端数ブロックでも結果が変わらないよう分割して入力
+  pushAll(d, x.data(), 37, c);
+  pushAll(d, x.data() + 37, kN - 37, c);
+
+  REQUIRE(c.bins[0].size() == kN / PeakDecimator::binSize(0));
+  REQUIRE(c.bins[1].size() == kN / PeakDecimator::binSize(1));
+  REQUIRE(c.bins[2].size() == kN / PeakDecimator::binSize(2));
+
+  CHECK_THAT(c.bins[0][0].max, WithinAbs(0.8, 1e-6));
+  CHECK_THAT(c.bins[0][43].min, WithinAbs(-0.6, 1e-6));
+  CHECK_THAT(c.bins[1][0].max, WithinAbs(0.8, 1e-6));
+  CHECK_THAT(c.bins[2][0].max, WithinAbs(0.8, 1e-6));
+  CHECK_THAT(c.bins[2][2].min, WithinAbs(-0.6, 1e-6));
+  CHECK_THAT(c.bins[2][1].max, WithinAbs(0.0, 1e-6));
+}
+
+// nullptr 入力は無音ビンとして出力されることを確認する
+TEST_CASE("PeakDecimator: null input emits silent bins", "[peak_decimator]") {
+  PeakDecimator d;
+  d.reset();
+  Collected c;
+  pushAll(d, nullptr, PeakDecimator::binSize(2), c);
+  REQUIRE(c.bins[2].size() == 1);
+  CHECK(c.bins[2][0].min == 0.0f);
+  CHECK(c.bins[2][0].max == 0.0f);
+}
+
+// 列リングがビンを束ね、最新列を右端に並べることを確認する
+TEST_CASE("PeakColumnRing: groups bins and right-aligns newest",
+          "[peak_decimator]") {
+  PeakColumnRing ring;
+  ring.configure(4, 2);
+  for (int i = 0; i < 6; ++i)
+    ring.pushBin({-static_cast<float>(i), static_cast<float>(i)});
+
+  REQUIRE(ring.filled() == 3);
+  CHECK(ring.column(0).max == 0.0f); // 未充填
+  CHECK(ring.column(1).max == 1.0f);
+  CHECK(ring.column(2).max == 3.0f);
+  CHECK(ring.column(3).max == 5.0f);
+  CHECK(ring.column(3).min == -5.0f);
+
+  // 容量を超えると最古の列から上書き
+  for (int i = 6; i < 10; ++i)
+    ring.pushBin({0.0f, static_cast<float>(i)});
+  CHECK(ring.filled() == 4);
+  CHECK(ring.column(0).max == 3.0f);
+  CHECK(ring.column(3).max == 9.0f);
+
+  // 設定変更で履歴を破棄
+  ring.configure(8, 2);
+  CHECK(ring.filled() == 0);
+}
+
+// 小数のビン数/列では列幅が交互に変わり、平均が設定値に一致することを確認する
+TEST_CASE("PeakColumnRing: fractional bins per column keep the average",
+          "[peak_decimator]") {
+  PeakColumnRing ring;
+  ring.configure(8, 1.5);
+  for (int i = 0; i < 6; ++i)
+    ring.pushBin({-static_cast<float>(i), static_cast<float>(i)});
+
+  // 列の区切り: 2 / 1 / 2 / 1 ビン
+  REQUIRE(ring.filled() == 4);
+  CHECK(ring.column(4).max == 1.0f);
+  CHECK(ring.column(5).max == 2.0f);
+  CHECK(ring.column(6).max == 4.0f);
+  CHECK(ring.column(6).min == -4.0f);
+  CHECK(ring.column(7).max == 5.0f);
+
+  // 長く流しても列数はビン数 / 1.5 からずれない
+  for (int i = 6; i < 3000; ++i)
+    ring.pushBin({0.0f, 1.0f});
+  CHECK(ring.totalColumns() == 2000);
+}
+
+// 新着列の累計と履歴破棄の世代番号を確認する
+TEST_CASE("PeakColumnRing: counts columns and clear generations",
+          "[peak_decimator]") {
+  PeakColumnRing ring;
+  ring.configure(2, 1);
+  const int gen = ring.generation();
+  for (int i = 0; i < 5; ++i)
+    ring.pushBin({0.0f, 1.0f});
+  CHECK(ring.totalColumns() == 5);
+  CHECK(ring.generation() == gen);
+  ring.clear();
+  CHECK(ring.generation() == gen + 1);
+  CHECK(ring.totalColumns() == 5);
+}
@@ -0,0 +1,84 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "DSP/PeakPyramid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+/// 素朴に bins 分割して求めた (L + R) / 2 の min/max（比較用）
+PeakPyramid::Level naiveLevel(const std::vector<float> &l,
+                              const std::vector<float> &r, int bins) {
+  PeakPyramid::Level out;
+  const auto total = static_cast<long long>(l.size());
+  for (int bin = 0; bin < bins; ++bin) {
+    const auto s = static_cast<std::size_t>(bin * total / bins);
+    const auto e = static_cast<std::size_t>((bin + 1) * total / bins);
+    float mn = 0.0f;
+    float mx = 0.0f;
+    for (std::size_t j = s; j < e; ++j) {
+      mn = std::min(mn, (l[j] + r[j]) * 0.5f);
+      mx = std::max(mx, (l[j] + r[j]) * 0.5f);
+    }
+    out.min.push_back(mn);
+    out.max.push_back(mx);
+  }
+  return out;
+}
+} // namespace
+
+// レベル 0 から順に 4096 / 1024 / 256 / 64 ビン
+TEST_CASE("PeakPyramid: bin counts and level selection", "[peak_pyramid]") {
+  CHECK(PeakPyramid::numBins(0) == 4096);
+  CHECK(PeakPyramid::numBins(1) == 1024);
+  CHECK(PeakPyramid::numBins(2) == 256);
+  CHECK(PeakPyramid::numBins(3) == 64);
+
+  // 必要数以上で最も粗いレベル。足りなければ最も細かいレベル
+  CHECK(PeakPyramid::levelFor(1) == 3);
+  CHECK(PeakPyramid::levelFor(64) == 3);
+  CHECK(PeakPyramid::levelFor(65) == 2);
+  CHECK(PeakPyramid::levelFor(512) == 1);
+  CHECK(PeakPyramid::levelFor(100000) == 0);
+}
+
+// 束ねて作った上位レベルは、直接そのビン数で走査した結果と一致する
+TEST_CASE("PeakPyramid: every level matches a direct scan",
+          "[peak_pyramid]") {
+  // 4096 で割り切れない長さ、L/R で異なる波形
+  const int length = 10007;
+  std::vector<float> l(static_cast<std::size_t>(length));
+  std::vector<float> r(static_cast<std::size_t>(length));
+  for (int i = 0; i < length; ++i) {
+    l[static_cast<std::size_t>(i)] = std::sin(static_cast<float>(i) * 0.013f);
+    r[static_cast<std::size_t>(i)] =
+        0.5f * std::cos(static_cast<float>(i) * 0.21f);
+  }
+  const PeakPyramid peaks(l.data(), r.data(), length);
+  for (int level = 0; level < PeakPyramid::kNumLevels; ++level) {
+    const auto expected = naiveLevel(l, r, PeakPyramid::numBins(level));
+    CHECK(peaks.level(level).min == expected.min);
+    CHECK(peaks.level(level).max == expected.max);
+  }
+}
+
+// ビン数より短いサンプル・空のサンプルでも全レベルが揃い、空ビンは 0
+TEST_CASE("PeakPyramid: short and empty input", "[peak_pyramid]") {
+  const std::vector<float> x{0.5f, -0.25f, 1.0f};
+  const PeakPyramid shortPeaks(x.data(), x.data(), 3);
+  const auto &coarse = shortPeaks.level(3);
+  REQUIRE(coarse.min.size() == 64);
+  // サンプル j はビン境界 bin * 3 / 64 で決まる位置（21 / 42 / 63）に入る
+  CHECK(coarse.max[21] == 0.5f);
+  CHECK(coarse.min[42] == -0.25f);
+  CHECK(coarse.max[63] == 1.0f);
+  CHECK(coarse.max[0] == 0.0f);
+
+  const PeakPyramid empty(nullptr, nullptr, 0);
+  for (int level = 0; level < PeakPyramid::kNumLevels; ++level) {
+    const auto &lv = empty.level(level);
+    CHECK(std::ranges::all_of(lv.min, [](float v) { return v == 0.0f; }));
+    CHECK(std::ranges::all_of(lv.max, [](float v) { return v == 0.0f; }));
+  }
+}
@@ -74,6 +74,22 @@ TEST_CASE("isBusesLayoutSupported - stereo I/O accepts", "[PluginProcessor]") {
   CHECK(p.isBusesLayoutSupported(layout));
 }
 
+TEST_CASE("isBusesLayoutSupported - stem buses accept stereo or disabled",
+          "[PluginProcessor]") {
+  BoomBabyAudioProcessor p;
+  juce::AudioProcessor::BusesLayout layout;
+  layout.inputBuses.add(juce::AudioChannelSet::stereo());
+  layout.outputBuses.add(juce::AudioChannelSet::stereo());
+  layout.outputBuses.add(juce::AudioChannelSet::stereo());   // Sub
+  layout.outputBuses.add(juce::AudioChannelSet::disabled()); // Click
+  layout.outputBuses.add(juce::AudioChannelSet::stereo());   // Direct
+  CHECK(p.isBusesLayoutSupported(layout));
+
+  // メインと異なる構成のステムは拒否
+  layout.outputBuses.getReference(2) = juce::AudioChannelSet::mono();
+  CHECK_FALSE(p.isBusesLayoutSupported(layout));
+}
+
 // ─────────────────────────────────────────────────────────────────
 // prepareToPlay — デフォルト値の適用確認
 // ─────────────────────────────────────────────────────────────────
@@ -165,16 +181,34 @@ TEST_CASE("LUT rebake on subLength change", "[PluginProcessor]") {
   BoomBabyAudioProcessor p;
   prepare(p);
 
-  float dur1 = p.subEngine().envLut().getDurationMs();
+  float dur1 = p.subEngine().luts().durationMs(SubEngine::kAmpLut);
 
   p.getAPVTS().getRawParameterValue(ParamIDs::subLength)->store(800.0f);
   prepare(p);
 
-  float dur2 = p.subEngine().envLut().getDurationMs();
+  float dur2 = p.subEngine().luts().durationMs(SubEngine::kAmpLut);
   // subLength 変更で LUT duration が変化するはず
   CHECK(std::abs(dur2 - dur1) > 1.0f);
 }
 
+// パラメータ通知（オーディオスレッドからも来る）では焼かず、
+// メッセージスレッドへ回してから焼く
+TEST_CASE("LUT rebake from parameterChanged is deferred",
+          "[PluginProcessor]") {
+  BoomBabyAudioProcessor p;
+  prepare(p);
+  const auto gen = p.subEngine().luts().generation();
+
+  auto *len = p.getAPVTS().getParameter(ParamIDs::subLength);
+  len->setValueNotifyingHost(len->convertTo0to1(800.0f));
+  CHECK(p.subEngine().luts().generation() == gen);
+
+  p.flushPendingLutBake();
+  CHECK(p.subEngine().luts().generation() != gen);
+  CHECK_THAT(p.subEngine().luts().durationMs(SubEngine::kAmpLut),
+             WithinAbs(800.0f, 1.0f));
+}
+
 // ─────────────────────────────────────────────────────────────────
 // processBlock
 // ─────────────────────────────────────────────────────────────────
@@ -261,7 +295,7 @@ TEST_CASE("processBlock - passthrough feeds input monitor FIFO",
   juce::MidiBuffer midi;
   p.processBlock(buffer, midi);
 
-  CHECK(p.inputMonitor().fifo().getNumReady() > 0);
+  CHECK(p.inputMonitor().fifo(0).getNumReady() > 0);
 }
 
 TEST_CASE("processBlock - sample mode skips passthrough monitor",
@@ -279,7 +313,7 @@ TEST_CASE("processBlock - sample mode skips passthrough monitor",
   p.processBlock(buffer, midi);
 
   // Sample モードでは processPassthroughMonitor が早期リターン → FIFO 空のまま
-  CHECK(p.inputMonitor().fifo().getNumReady() == 0);
+  CHECK(p.inputMonitor().fifo(0).getNumReady() == 0);
 }
 
 TEST_CASE("processBlock - empty MIDI buffer does not crash",
@@ -295,6 +329,109 @@ TEST_CASE("processBlock - empty MIDI buffer does not crash",
   CHECK(std::isfinite(maxAbsOfBuffer(buffer)));
 }
 
+TEST_CASE("processBlock - idle block outputs silence and decays meters",
+          "[PluginProcessor]") {
+  BoomBabyAudioProcessor p;
+  prepare(p);
+
+  // 一度鳴らしてメーターを振らせる
+  p.subEngine().triggerNote(0);
+  juce::AudioBuffer<float> buffer(2, kBlock);
+  buffer.clear();
+  juce::MidiBuffer midi;
+  p.processBlock(buffer, midi);
+  const float peakAfterHit =
+      p.meters().snapshot().peakDb(MeterEngine::kMasterL);
+
+  // Sub が止まるまで無音入力を流す（300ms 超）
+  for (int i = 0; i < 40; ++i) {
+    buffer.clear();
+    p.processBlock(buffer, midi);
+  }
+  CHECK_FALSE(p.subEngine().isActive());
+  CHECK(maxAbsOfBuffer(buffer) < 1e-6f);
+  CHECK(p.meters().snapshot().peakDb(MeterEngine::kMasterL) < peakAfterHit);
+  // パススルー時は無音でも FIFO 供給が続く
+  CHECK(p.inputMonitor().fifo(0).getNumReady() > 0);
+}
+
+TEST_CASE("processBlock - enabled stem bus receives its channel only",
+          "[PluginProcessor]") {
+  BoomBabyAudioProcessor p;
+  juce::AudioProcessor::BusesLayout layout;
+  layout.inputBuses.add(juce::AudioChannelSet::stereo());
+  for (int i = 0; i < 4; ++i)
+    layout.outputBuses.add(juce::AudioChannelSet::stereo());
+  REQUIRE(p.setBusesLayout(layout));
+  prepare(p);
+
+  p.subEngine().triggerNote(0);
+
+  // 2ch × (Main, Sub, Click, Direct)
+  juce::AudioBuffer<float> buffer(8, kBlock);
+  buffer.clear();
+  juce::MidiBuffer midi;
+  p.processBlock(buffer, midi);
+
+  const auto busPeak = [&](int bus) {
+    float m = 0.0f;
+    for (int ch = bus * 2; ch < bus * 2 + 2; ++ch)
+      m = std::max(m, buffer.getMagnitude(ch, 0, kBlock));
+    return m;
+  };
+  CHECK(busPeak(BoomBabyAudioProcessor::kSubStemBus) > 0.0f);
+  CHECK(busPeak(BoomBabyAudioProcessor::kClickStemBus) < 1e-6f);
+  CHECK(busPeak(BoomBabyAudioProcessor::kDirectStemBus) < 1e-6f);
+  // メインはステムの和（Sub のみ鳴っているのでマスター 0 dB で一致）
+  CHECK_THAT(busPeak(BoomBabyAudioProcessor::kMainBus),
+             WithinAbs(busPeak(BoomBabyAudioProcessor::kSubStemBus), 1e-5));
+}
+
+TEST_CASE("processBlock - host block larger than prepared size is safe",
+          "[PluginProcessor]") {
+  // prepareToPlay より大きいブロックでもサブブロック分割で安全に処理される
+  BoomBabyAudioProcessor p;
+  prepare(p);
+
+  constexpr int kLarge = kBlock * 8;
+  juce::AudioBuffer<float> buffer(2, kLarge);
+  for (int i = 0; i < kLarge; ++i) {
+    buffer.setSample(0, i, 0.25f);
+    buffer.setSample(1, i, 0.25f);
+  }
+  juce::MidiBuffer midi;
+  midi.addEvent(juce::MidiMessage::noteOn(1, 60, 1.0f), 0);
+  p.processBlock(buffer, midi);
+
+  CHECK(maxAbsOfBuffer(buffer) > 0.0f);
+  CHECK(std::isfinite(maxAbsOfBuffer(buffer)));
+}
+
+TEST_CASE("processBlock - MIDI note in later sub-block starts at its offset",
+          "[PluginProcessor]") {
+  BoomBabyAudioProcessor p;
+  p.getAPVTS().getRawParameterValue(ParamIDs::subSolo)->store(1.0f);
+  prepare(p);
+
+  // 2 つ目のサブブロック途中にノートオン
+  constexpr int kOffset = BoomBabyAudioProcessor::kSubBlockSize + 10;
+  juce::AudioBuffer<float> buffer(2, kBlock);
+  buffer.clear();
+  juce::MidiBuffer midi;
+  midi.addEvent(juce::MidiMessage::noteOn(1, 60, 1.0f), kOffset);
+  p.processBlock(buffer, midi);
+
+  float before = 0.0f;
+  for (int i = 0; i < kOffset; ++i)
+    before = std::max(before, std::abs(buffer.getSample(0, i)));
+  float after = 0.0f;
+  for (int i = kOffset; i < kBlock; ++i)
+    after = std::max(after, std::abs(buffer.getSample(0, i)));
+
+  CHECK(before < 1e-6f);
+  CHECK(after > 0.0f);
+}
+
 // ─────────────────────────────────────────────────────────────────
 // setStateInformation / getStateInformation
 // ─────────────────────────────────────────────────────────────────
@@ -355,6 +492,85 @@ TEST_CASE("setStateInformation - round trip with modified parameter",
   CHECK(p2.nonParamStateVersion() == 1);
 }
 
+TEST_CASE("getStateInformation - cached until state changes",
+          "[PluginProcessor]") {
+  BoomBabyAudioProcessor p;
+  prepare(p);
+
+  juce::MemoryBlock a;
+  juce::MemoryBlock b;
+  p.getStateInformation(a);
+  p.getStateInformation(b);
+  CHECK(StateCodec::isBinaryState(a.getData(), static_cast<int>(a.getSize())));
+  CHECK(a == b);
+
+  // パラメータ変更
+  auto *param = p.getAPVTS().getParameter(ParamIDs::subGain);
+  param->setValueNotifyingHost(param->convertTo0to1(-3.0f));
+  p.getStateInformation(b);
+  CHECK(a != b);
+
+  // 非パラメータ状態（サンプルパス）の変更
+  p.getStateInformation(a);
+  p.getAPVTS().state.setProperty("clickSamplePath", "/tmp/none.wav", nullptr);
+  p.getStateInformation(b);
+  CHECK(a != b);
+}
+
+TEST_CASE("setStateInformation - only changed LUT groups are re-baked",
+          "[PluginProcessor]") {
+  BoomBabyAudioProcessor p;
+  prepare(p);
+  juce::MemoryBlock same;
+  p.getStateInformation(same);
+
+  const auto subGen = p.subEngine().luts().generation();
+  const auto clickGen = p.clickEngine().clickAmpLut().generation();
+  const auto directGen = p.directEngine().directAmpLut().generation();
+
+  // 同じ状態の復元では何も焼き直さない
+  p.setStateInformation(same.getData(), static_cast<int>(same.getSize()));
+  CHECK(p.subEngine().luts().generation() == subGen);
+  CHECK(p.clickEngine().clickAmpLut().generation() == clickGen);
+  CHECK(p.directEngine().directAmpLut().generation() == directGen);
+
+  // Sub Length だけ違う状態では Sub バンクだけ焼き直す
+  BoomBabyAudioProcessor other;
+  prepare(other);
+  auto *len = other.getAPVTS().getParameter(ParamIDs::subLength);
+  len->setValueNotifyingHost(len->convertTo0to1(800.0f));
+  juce::MemoryBlock changed;
+  other.getStateInformation(changed);
+
+  p.setStateInformation(changed.getData(),
+                        static_cast<int>(changed.getSize()));
+  CHECK(p.subEngine().luts().generation() != subGen);
+  CHECK_THAT(p.subEngine().luts().durationMs(SubEngine::kAmpLut),
+             WithinAbs(800.0f, 1.0f));
+  CHECK(p.clickEngine().clickAmpLut().generation() == clickGen);
+  CHECK(p.directEngine().directAmpLut().generation() == directGen);
+}
+
+TEST_CASE("setStateInformation - legacy XML state still loads",
+          "[PluginProcessor]") {
+  BoomBabyAudioProcessor p1;
+  p1.prepareToPlay(kSR, kBlock);
+  auto *param = p1.getAPVTS().getParameter(ParamIDs::masterGain);
+  param->setValueNotifyingHost(param->convertTo0to1(-9.0f));
+
+  // 旧バージョンと同じ XML 形式で書き出す
+  juce::MemoryBlock state;
+  const auto xml = p1.getAPVTS().copyState().createXml();
+  juce::AudioProcessor::copyXmlToBinary(*xml, state);
+
+  BoomBabyAudioProcessor p2;
+  prepare(p2);
+  p2.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+  CHECK_THAT(p2.getAPVTS().getRawParameterValue(ParamIDs::masterGain)->load(),
+             WithinAbs(-9.0f, 0.5f));
+  CHECK(p2.nonParamStateVersion() == 1);
+}
+
 // ─────────────────────────────────────────────────────────────────
 // その他のカバレッジ
 // ─────────────────────────────────────────────────────────────────
@@ -371,9 +587,36 @@ TEST_CASE("MIDI properties", "[PluginProcessor]") {
   CHECK_FALSE(p.isMidiEffect());
 }
 
-TEST_CASE("tail length is zero", "[PluginProcessor]") {
+TEST_CASE("tail length follows longest channel decay", "[PluginProcessor]") {
   BoomBabyAudioProcessor p;
-  CHECK_THAT(p.getTailLengthSeconds(), WithinAbs(0.0, 0.001));
+  // デフォルト: Sub Length 300ms / Click Noise Decay 30ms / Direct Decay 300ms
+  CHECK_THAT(p.getTailLengthSeconds(), WithinAbs(0.3, 0.001));
+
+  p.getAPVTS().getRawParameterValue(ParamIDs::subLength)->store(1500.0f);
+  CHECK_THAT(p.getTailLengthSeconds(), WithinAbs(1.5, 0.001));
+}
+
+TEST_CASE("tail length includes lookahead, limiter latency and release",
+          "[PluginProcessor]") {
+  BoomBabyAudioProcessor p;
+  prepare(p);
+  const double base = p.getTailLengthSeconds();
+
+  auto *lookahead = p.getAPVTS().getParameter(ParamIDs::directLookahead);
+  REQUIRE(lookahead != nullptr);
+  lookahead->setValueNotifyingHost(lookahead->convertTo0to1(2.0f)); // 5 ms
+  const double lookaheadSec =
+      static_cast<double>(std::lround(0.005 * kSR)) / kSR;
+  CHECK_THAT(p.getTailLengthSeconds(), WithinAbs(base + lookaheadSec, 1e-9));
+
+  auto *limiter = p.getAPVTS().getParameter(ParamIDs::masterLimiter);
+  REQUIRE(limiter != nullptr);
+  limiter->setValueNotifyingHost(1.0f);
+  // 遅延は OFF でも base に入っている。ON で増えるのはリリースだけ
+  const double limiterSec =
+      static_cast<double>(BrickwallLimiter::kReleaseMs) / 1000.0;
+  CHECK_THAT(p.getTailLengthSeconds(),
+             WithinAbs(base + lookaheadSec + limiterSec, 1e-9));
 }
 
 TEST_CASE("program accessors", "[PluginProcessor]") {
@@ -397,3 +640,55 @@ TEST_CASE("hasEditor returns true", "[PluginProcessor]") {
   BoomBabyAudioProcessor p;
   CHECK(p.hasEditor());
 }
+
+TEST_CASE("direct lookahead reports latency in passthrough mode only",
+          "[PluginProcessor]") {
+  BoomBabyAudioProcessor p;
+  prepare(p);
+  // マスターリミッターの遅延は ON/OFF に関わらず常に入る
+  const int limiterLatency = BrickwallLimiter::latencyFor(kSR);
+  CHECK(p.getLatencySamples() == limiterLatency);
+
+  auto *lookahead = p.getAPVTS().getParameter(ParamIDs::directLookahead);
+  REQUIRE(lookahead != nullptr);
+  lookahead->setValueNotifyingHost(lookahead->convertTo0to1(2.0f)); // 5 ms
+  CHECK(p.getLatencySamples() ==
+        static_cast<int>(std::lround(0.005 * kSR)) + limiterLatency);
+
+  // Sample モードでは入力を遅延しないので Direct 分は 0
+  auto *mode = p.getAPVTS().getParameter(ParamIDs::directMode);
+  mode->setValueNotifyingHost(mode->convertTo0to1(1.0f));
+  CHECK(p.getLatencySamples() == limiterLatency);
+}
+
+TEST_CASE("master limiter latency is constant and bounds the main output",
+          "[PluginProcessor]") {
+  BoomBabyAudioProcessor p;
+  prepare(p);
+  auto *limiter = p.getAPVTS().getParameter(ParamIDs::masterLimiter);
+  REQUIRE(limiter != nullptr);
+  limiter->setValueNotifyingHost(1.0f);
+
+  BrickwallLimiter ref;
+  ref.prepare(kSR);
+  CHECK(p.getLatencySamples() == ref.latencySamples());
+
+  // +12 dB のマスターゲインで Sub を鳴らしても天井（-1 dB）を超えない
+  p.master().setGain(12.0f);
+  juce::AudioBuffer<float> buffer(2, kBlock);
+  juce::MidiBuffer midi;
+  midi.addEvent(juce::MidiMessage::noteOn(1, 60, 1.0f), 0);
+  float maxOut = 0.0f;
+  for (int b = 0; b < 20; ++b) {
+    buffer.clear();
+    p.processBlock(buffer, midi);
+    midi.clear();
+    maxOut = std::max(maxOut, maxAbsOfBuffer(buffer));
+  }
+  CHECK(maxOut > 0.5f);
+  CHECK(maxOut <= juce::Decibels::decibelsToGain(-1.0f) * 1.0001f);
+
+  // OFF にしても遅延線は回し続けるのでレイテンシは変わらない
+  limiter->setValueNotifyingHost(0.0f);
+  CHECK(p.getLatencySamples() == ref.latencySamples());
+}
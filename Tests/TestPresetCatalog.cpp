@@ -0,0 +1,164 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "PresetCatalog.h"
+
+namespace {
+constexpr int kWaitMs = 5000;
+
+/// User ディレクトリ（テスト終了時に削除）
+struct PresetDirs {
+  juce::File user =
+      juce::File::getSpecialLocation(juce::File::tempDirectory)
+          .getNonexistentChildFile("BoomBabyPresetCatalog", "");
+
+  PresetDirs() { user.createDirectory(); }
+  ~PresetDirs() { user.deleteRecursively(); }
+
+  static void add(const juce::File &dir, const juce::String &name,
+                  const juce::String &tags = {}) {
+    const auto folder = dir.getChildFile(name + ".bbpreset");
+    folder.createDirectory();
+    folder.getChildFile("state.xml")
+        .replaceWithText("<BoomBabyState tags=\"" + tags + "\"/>");
+  }
+};
+
+/// 埋め込み Factory プリセット相当のエントリ
+PresetCatalog::Entry builtIn(const juce::String &name,
+                             const juce::String &tags = {}) {
+  const juce::String xml = "<BoomBabyState tags=\"" + tags + "\"/>";
+  return PresetCatalog::makeEntry(name, {}, xml.toRawUTF8(),
+                                  xml.getNumBytesAsUTF8(), true);
+}
+
+juce::StringArray namesOf(const PresetCatalog::Snapshot &snapshot) {
+  juce::StringArray names;
+  for (const auto &e : snapshot.entries())
+    names.add(e.name);
+  return names;
+}
+} // namespace
+
+// ── 走査 ──────────────────────────────────────────────
+
+// 組み込み（Factory）→ User（名前順）に並び、タグと内容ハッシュが付く
+TEST_CASE("PresetCatalog: built-in entries come before scanned user presets",
+          "[preset_catalog]") {
+  PresetDirs dirs;
+  PresetDirs::add(dirs.user, "b-user", "kick, sub");
+  PresetDirs::add(dirs.user, "a-user");
+  dirs.user.getChildFile("no-state.bbpreset").createDirectory();
+
+  PresetCatalog catalog({builtIn("factory")}, dirs.user);
+  catalog.start();
+  REQUIRE(catalog.waitUntilReady(kWaitMs));
+  CHECK(catalog.isReady());
+
+  const auto snapshot = catalog.snapshot();
+  REQUIRE(snapshot->size() == 3); // state.xml の無いフォルダは除外
+  const auto names = namesOf(*snapshot);
+  CHECK(names[0] == "factory");
+  CHECK(names[1] == "a-user");
+  CHECK(names[2] == "b-user");
+
+  CHECK((*snapshot)[0].isFactory);
+  const auto &b = (*snapshot)[2];
+  CHECK_FALSE(b.isFactory);
+  REQUIRE(b.tags.size() == 2);
+  CHECK(b.tags[0] == "kick");
+  CHECK(b.tags[1] == "sub");
+  CHECK(b.contentHash != 0);
+  CHECK(b.contentHash != (*snapshot)[1].contentHash);
+}
+
+// 再走査で追加・削除が反映され、古いスナップショットは変わらない
+TEST_CASE("PresetCatalog: rescan publishes a new snapshot",
+          "[preset_catalog]") {
+  PresetDirs dirs;
+  PresetDirs::add(dirs.user, "first");
+
+  PresetCatalog catalog({}, dirs.user);
+  catalog.start();
+  REQUIRE(catalog.waitUntilReady(kWaitMs));
+  const auto before = catalog.snapshot();
+
+  PresetDirs::add(dirs.user, "second");
+  dirs.user.getChildFile("first.bbpreset").deleteRecursively();
+  REQUIRE(catalog.rescanAndWait(kWaitMs));
+
+  const auto after = catalog.snapshot();
+  REQUIRE(after->size() == 1);
+  CHECK((*after)[0].name == "second");
+  REQUIRE(before->size() == 1);
+  CHECK((*before)[0].name == "first");
+}
+
+// 保存直後の add() は走査を待たずに並び順どおり反映され、その後の
+// 再走査でも残る（同じフォルダは置き換え）
+TEST_CASE("PresetCatalog: add publishes a saved preset immediately",
+          "[preset_catalog]") {
+  PresetDirs dirs;
+  PresetDirs::add(dirs.user, "a");
+  PresetDirs::add(dirs.user, "c");
+
+  PresetCatalog catalog({builtIn("factory")}, dirs.user, 60000);
+  catalog.start();
+  REQUIRE(catalog.waitUntilReady(kWaitMs));
+
+  PresetDirs::add(dirs.user, "b", "new");
+  const auto folder = dirs.user.getChildFile("b.bbpreset");
+  auto entry = PresetCatalog::readEntry(folder);
+  REQUIRE(entry.has_value());
+  CHECK(entry->tags == juce::StringArray{"new"});
+  catalog.add(*entry);
+  CHECK(namesOf(*catalog.snapshot()) ==
+        juce::StringArray{"factory", "a", "b", "c"});
+
+  catalog.add(*entry);
+  CHECK(catalog.snapshot()->size() == 4);
+
+  REQUIRE(catalog.rescanAndWait(kWaitMs));
+  CHECK(namesOf(*catalog.snapshot()) ==
+        juce::StringArray{"factory", "a", "b", "c"});
+
+  CHECK_FALSE(
+      PresetCatalog::readEntry(dirs.user.getChildFile("none.bbpreset")));
+}
+
+// ── 索引 ──────────────────────────────────────────────
+
+// 名前 → 位置、前後移動は両端で折り返す
+TEST_CASE("PresetCatalog: indexOf and step wrap around",
+          "[preset_catalog]") {
+  std::vector<PresetCatalog::Entry> entries;
+  for (const auto *name : {"alpha", "beta", "gamma"})
+    entries.push_back({name, {}, {}, 0, false});
+  const PresetCatalog::Snapshot snapshot(std::move(entries));
+
+  CHECK(snapshot.indexOf("beta") == 1);
+  CHECK(snapshot.indexOf("missing") == -1);
+  CHECK(snapshot.step(1, +1) == 2);
+  CHECK(snapshot.step(2, +1) == 0);
+  CHECK(snapshot.step(0, -1) == 2);
+  CHECK(snapshot.step(-1, +1) == 0); // 一覧に無い名前からの ▶ は先頭
+  CHECK(snapshot.step(-1, -1) == 2); // ◀ は末尾
+  CHECK(PresetCatalog::Snapshot{}.step(0, +1) == -1);
+}
+
+// 前方一致は大文字小文字を区別せず名前順、件数上限を守る
+TEST_CASE("PresetCatalog: prefix search", "[preset_catalog]") {
+  std::vector<PresetCatalog::Entry> entries;
+  for (const auto *name : {"Kick Hard", "snare", "kick soft", "Kickback"})
+    entries.push_back({name, {}, {}, 0, false});
+  const PresetCatalog::Snapshot snapshot(std::move(entries));
+
+  const auto hits = snapshot.searchPrefix("KICK", 10);
+  REQUIRE(hits.size() == 3);
+  CHECK(snapshot[hits[0]].name == "Kick Hard");
+  CHECK(snapshot[hits[1]].name == "kick soft");
+  CHECK(snapshot[hits[2]].name == "Kickback");
+
+  CHECK(snapshot.searchPrefix("kick", 2).size() == 2);
+  CHECK(snapshot.searchPrefix("hat", 10).empty());
+  CHECK(snapshot.searchPrefix("", 10).size() == 4);
+}
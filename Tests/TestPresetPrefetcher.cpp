@@ -0,0 +1,107 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "PresetPrefetcher.h"
+#include "TestWavUtils.h"
+
+#include <memory>
+
+namespace {
+constexpr int kWaitMs = 5000;
+
+/// .bbpreset フォルダを作る（sample=true なら相対パスの WAV 付き）
+juce::File makePreset(const juce::File &root, const juce::String &name,
+                      bool sample) {
+  const auto folder = root.getChildFile(name + ".bbpreset");
+  folder.createDirectory();
+  juce::String attrs;
+  if (sample) {
+    TestWav::write(folder.getChildFile("direct_sample.wav"),
+                   TestWav::ramp(512, 64));
+    attrs = " directSamplePath=\"./direct_sample.wav\"";
+  }
+  folder.getChildFile("state.xml")
+      .replaceWithText("<BoomBabyState presetName=\"" + name + "\"" + attrs +
+                       "/>");
+  return folder;
+}
+
+/// 先読みが終わるまで待つ
+bool waitFor(const PresetPrefetcher &prefetcher, const juce::File &folder) {
+  for (int waited = 0; waited < kWaitMs; waited += 10) {
+    if (prefetcher.contains(folder))
+      return true;
+    juce::Thread::sleep(10);
+  }
+  return false;
+}
+
+struct TempDir {
+  juce::File dir = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                       .getNonexistentChildFile("BoomBabyPrefetch", "");
+  TempDir() { dir.createDirectory(); }
+  ~TempDir() { dir.deleteRecursively(); }
+};
+} // namespace
+
+// 相対サンプルパスはプリセットフォルダ基準の絶対パスに解決される
+TEST_CASE("PresetPrefetcher: readPresetState resolves sample paths",
+          "[preset_prefetcher]") {
+  TempDir tmp;
+  const auto folder = makePreset(tmp.dir, "kick", true);
+  const auto state = PresetPrefetcher::readPresetState(folder);
+  REQUIRE(state.isValid());
+  CHECK(state["directSamplePath"].toString() ==
+        folder.getChildFile("direct_sample.wav").getFullPathName());
+  CHECK_FALSE(
+      PresetPrefetcher::readPresetState(tmp.dir.getChildFile("none.bbpreset"))
+          .isValid());
+}
+
+// 先読みでサンプルまでデコードされ、state.xml が変われば捨てられる
+TEST_CASE("PresetPrefetcher: prepares state and samples in the background",
+          "[preset_prefetcher]") {
+  TempDir tmp;
+  const auto withSample = makePreset(tmp.dir, "with sample", true);
+  const auto plain = makePreset(tmp.dir, "plain", false);
+
+  PresetPrefetcher prefetcher;
+  prefetcher.prefetch({withSample, plain});
+  REQUIRE(waitFor(prefetcher, withSample));
+  REQUIRE(waitFor(prefetcher, plain));
+
+  const auto prepared = prefetcher.find(withSample);
+  REQUIRE(prepared != nullptr);
+  CHECK(prepared->state["presetName"].toString() == "with sample");
+  REQUIRE(prepared->samples.size() == 1);
+  CHECK(prepared->samples[0]->source ==
+        withSample.getChildFile("direct_sample.wav").getFullPathName());
+  CHECK(prepared->samples[0]->samples.length() == 512);
+  CHECK(prefetcher.find(plain)->samples.empty());
+
+  const auto stateFile = withSample.getChildFile("state.xml");
+  stateFile.setLastModificationTime(stateFile.getLastModificationTime() +
+                                    juce::RelativeTime::seconds(10.0));
+  CHECK(prefetcher.find(withSample) == nullptr);
+  CHECK_FALSE(prefetcher.contains(withSample));
+}
+
+// 容量を超えると最も長く使われていないものから捨てる
+TEST_CASE("PresetPrefetcher: evicts the least recently used preset",
+          "[preset_prefetcher]") {
+  TempDir tmp;
+  const auto a = makePreset(tmp.dir, "a", false);
+  const auto b = makePreset(tmp.dir, "b", false);
+  const auto c = makePreset(tmp.dir, "c", false);
+
+  PresetPrefetcher prefetcher(2);
+  prefetcher.prefetch({a});
+  REQUIRE(waitFor(prefetcher, a));
+  prefetcher.prefetch({b});
+  REQUIRE(waitFor(prefetcher, b));
+  REQUIRE(prefetcher.find(a) != nullptr); // a を最近使ったことにする
+
+  prefetcher.prefetch({c});
+  REQUIRE(waitFor(prefetcher, c));
+  CHECK(prefetcher.contains(a));
+  CHECK_FALSE(prefetcher.contains(b));
+}
@@ -0,0 +1,57 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "GUI/RealtimeWaveRenderer.h"
+
+#include <vector>
+
+using namespace Catch::Matchers;
+
+// ストリーミング SVF が一括版 applySvfPass と同じ結果になることを確認する
+TEST_CASE("SvfCascade matches applySvfPass", "[realtime_wave]") {
+  std::vector<float> data(64);
+  for (std::size_t i = 0; i < data.size(); ++i)
+    data[i] = (i % 7 == 0) ? 1.0f : -0.25f;
+  auto batch = data;
+  SvfPassUtils::applySvfPass(batch, 1200.0f, 0.9f, 2, 0, 44100.0f);
+
+  SvfPassUtils::SvfCascade cascade;
+  cascade.setup(1200.0f, 0.9f, 2, 0, 44100.0f);
+  for (std::size_t i = 0; i < data.size(); ++i)
+    CHECK_THAT(cascade.process(data[i]), WithinAbs(batch[i], 1e-5));
+}
+
+// 新着列だけが処理され、Style 変更時は全列が再処理されることを確認する
+TEST_CASE("RealtimeWaveRenderer processes only new columns",
+          "[realtime_wave]") {
+  PeakColumnRing raw;
+  raw.configure(8, 1);
+  RealtimeWaveRenderer renderer;
+  RealtimeWaveRenderer::Style hard;
+  hard.clipType = 1; // Hard: ±1 以内は素通し
+  renderer.setStyle(hard);
+
+  // 初回は全列処理（空でも表示は変わる扱い）
+  CHECK(renderer.update(raw));
+  CHECK(renderer.empty());
+  CHECK_FALSE(renderer.update(raw));
+
+  raw.pushBin({-0.5f, 0.5f});
+  raw.pushBin({-0.25f, 0.75f});
+  CHECK(renderer.update(raw));
+  CHECK_FALSE(renderer.update(raw));
+  CHECK_THAT(renderer.column(7).max, WithinAbs(0.75, 1e-6));
+  CHECK_THAT(renderer.column(6).min, WithinAbs(-0.5, 1e-6));
+
+  // Drive を上げると既存列も再処理される
+  auto driven = hard;
+  driven.driveDb = 12.0f;
+  renderer.setStyle(driven);
+  CHECK(renderer.update(raw));
+  CHECK(renderer.column(7).max > 0.75f);
+
+  // 列リングが破棄されたら追従する
+  raw.clear();
+  CHECK(renderer.update(raw));
+  CHECK(renderer.empty());
+}
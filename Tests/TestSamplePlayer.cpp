@@ -2,6 +2,7 @@
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 
 #include "DSP/SamplePlayer.h"
+#include "TestWavUtils.h"
 #include <cmath>
 #include <memory>
 #include <vector>
@@ -27,20 +28,8 @@ static juce::File writeTestWav(int numSamples, double sr = kSampleRate) {
         0, i,
         static_cast<float>(std::sin(2.0 * juce::MathConstants<double>::pi *
                                     440.0 * static_cast<double>(i) / sr)));
-
-  auto dir = juce::File::getSpecialLocation(juce::File::tempDirectory);
-  auto file = dir.getChildFile("boombaby_test_sample.wav");
-
-  // WAV 16bit で書き出し
-  juce::WavAudioFormat wav;
-  std::unique_ptr<juce::OutputStream> stream(std::make_unique<juce::FileOutputStream>(file));
-  auto writer = wav.createWriterFor(stream,
-      juce::AudioFormatWriterOptions{}.withSampleRate(sr).withNumChannels(1).withBitsPerSample(16));
-  REQUIRE(writer != nullptr);
-  writer->writeFromAudioSampleBuffer(buf, 0, numSamples);
-  writer.reset(); // flush
-
-  return file;
+  return TestWav::write(TestWav::tempFile("boombaby_test_sample.wav"), buf,
+                        sr);
 }
 
 /// テスト用ステレオ WAV を書き出すヘルパー（モノ化テスト用）
@@ -51,19 +40,8 @@ static juce::File writeStereoTestWav(int numSamples, double sr = kSampleRate) {
     buf.setSample(0, i, t);  // L: ramp 0→1
     buf.setSample(1, i, -t); // R: ramp 0→-1
   }
-
-  auto dir = juce::File::getSpecialLocation(juce::File::tempDirectory);
-  auto file = dir.getChildFile("boombaby_test_stereo.wav");
-
-  juce::WavAudioFormat wav;
-  std::unique_ptr<juce::OutputStream> stream(std::make_unique<juce::FileOutputStream>(file));
-  auto writer = wav.createWriterFor(stream,
-      juce::AudioFormatWriterOptions{}.withSampleRate(sr).withNumChannels(2).withBitsPerSample(16));
-  REQUIRE(writer != nullptr);
-  writer->writeFromAudioSampleBuffer(buf, 0, numSamples);
-  writer.reset();
-
-  return file;
+  return TestWav::write(TestWav::tempFile("boombaby_test_stereo.wav"), buf,
+                        sr);
 }
 
 // ─── 初期状態 ──────────────────────────────────────────────────
@@ -116,6 +94,60 @@ TEST_CASE("SamplePlayer: unloadSample resets state", "[sample_player]") {
   file.deleteFile();
 }
 
+// isLoadedFrom はロード元のパスと更新時刻が一致するときだけ true
+TEST_CASE("SamplePlayer: isLoadedFrom tracks the loaded file",
+          "[sample_player]") {
+  auto sp = makePrepared();
+  auto file = writeTestWav(kTestLen);
+  CHECK_FALSE(sp->isLoadedFrom(file));
+
+  sp->loadSample(file);
+  CHECK(sp->isLoadedFrom(file));
+  CHECK_FALSE(sp->isLoadedFrom(file.getSiblingFile("other.wav")));
+
+  // ファイルが書き換えられたら再ロードが必要
+  file.setLastModificationTime(file.getLastModificationTime() +
+                               juce::RelativeTime::seconds(10.0));
+  CHECK_FALSE(sp->isLoadedFrom(file));
+
+  sp->loadSample(file);
+  sp->unloadSample();
+  CHECK_FALSE(sp->isLoadedFrom(file));
+
+  file.deleteFile();
+}
+
+// decode() は別の AudioFormatManager で呼べ、loadDecoded() の結果は
+// loadSample() と同じになる
+TEST_CASE("SamplePlayer: decode + loadDecoded matches loadSample",
+          "[sample_player]") {
+  auto file = writeTestWav(kTestLen);
+  juce::AudioFormatManager fm;
+  fm.registerBasicFormats();
+  auto decoded = SamplePlayer::decode(file, fm);
+  REQUIRE(decoded.has_value());
+  CHECK(decoded->samples.numChannels() == 1);
+  CHECK(decoded->source == file.getFullPathName());
+  CHECK_FALSE(
+      SamplePlayer::decode(file.getSiblingFile("missing.wav"), fm).has_value());
+
+  auto direct = makePrepared();
+  direct->loadSample(file);
+  auto injected = makePrepared();
+  injected->loadDecoded(
+      std::make_shared<const SamplePlayer::Decoded>(std::move(*decoded)));
+  CHECK(injected->isLoadedFrom(file));
+  CHECK(injected->durationSec() == direct->durationSec());
+
+  const auto a = direct->lock();
+  const auto b = injected->lock();
+  REQUIRE(a.samples.length == b.samples.length);
+  for (int i = 0; i < a.samples.length; ++i)
+    REQUIRE(a.samples.sample(0, i) == b.samples.sample(0, i));
+
+  file.deleteFile();
+}
+
 // ─── ステレオ → モノ化 ──────────────────────────────────────────
 
 // ステレオ WAV をロードした場合、内部バッファがモノ（L+R
@@ -128,49 +160,171 @@ TEST_CASE("SamplePlayer: stereo file is stored as 2ch", "[sample_player]") {
 
   auto view = sp->lock();
   REQUIRE(static_cast<bool>(view));
-  REQUIRE(view.dataR != nullptr);
+  REQUIRE_FALSE(view.samples.isMono());
 
   // L=ramp 0→1, R=-ramp 0→-1 がそれぞれ保存されていることを確認
-  const int mid = view.length / 2;
-  REQUIRE(view.data[mid] > 0.0f);  // L: 正のランプ
-  REQUIRE(view.dataR[mid] < 0.0f); // R: 負のランプ
+  const auto &s = view.samples;
+  const int mid = s.length / 2;
+  REQUIRE(s.sample(0, mid) > 0.0f); // L: 正のランプ
+  REQUIRE(s.sample(1, mid) < 0.0f); // R: 負のランプ
 
   // L+R の平均は 0 に近い（元のダウンミックス検証と同等）
   float maxAbsMix = 0.0f;
-  for (int i = 0; i < view.length; ++i)
-    maxAbsMix = std::max(maxAbsMix, std::abs(view.data[i] + view.dataR[i]));
+  for (int i = 0; i < s.length; ++i)
+    maxAbsMix = std::max(maxAbsMix, std::abs(s.sample(0, i) + s.sample(1, i)));
   REQUIRE(maxAbsMix < 0.01f);
 
   file.deleteFile();
 }
 
-// ─── copyThumbnail ──────────────────────────────────────────────
+// ─── 常駐形式 ──────────────────────────────────────────────────
 
-// 未ロード時 copyThumbnail が false を返すことを確認する
-TEST_CASE("SamplePlayer: copyThumbnail returns false when not loaded",
+// モノ 16bit は 1ch・int16 のまま常駐し（float 2ch の 1/4）、R は L を共有する
+TEST_CASE("SamplePlayer: mono 16-bit file stays mono int16",
           "[sample_player]") {
+  auto file = writeTestWav(kTestLen);
+  juce::AudioFormatManager fm;
+  fm.registerBasicFormats();
+  const auto decoded = SamplePlayer::decode(file, fm);
+  REQUIRE(decoded.has_value());
+  CHECK(decoded->samples.format() == SampleFormat::int16);
+  CHECK(decoded->samples.numChannels() == 1);
+  CHECK(decoded->samples.sizeInBytes() ==
+        static_cast<std::size_t>(kTestLen) * sizeof(std::int16_t));
+  CHECK(decoded->samples.view().isMono());
+
+  // 明示指定すれば float / half でも持てる
+  const auto asFloat =
+      SamplePlayer::decode(file, fm, SamplePlayer::Residency::float32);
+  const auto asHalf =
+      SamplePlayer::decode(file, fm, SamplePlayer::Residency::half);
+  REQUIRE(asFloat.has_value());
+  REQUIRE(asHalf.has_value());
+  CHECK(asFloat->samples.format() == SampleFormat::float32);
+  CHECK(asHalf->samples.format() == SampleFormat::half);
+  const auto f = asFloat->samples.view();
+  const auto h = asHalf->samples.view();
+  const auto i16 = decoded->samples.view();
+  for (int i = 0; i < kTestLen; ++i) {
+    CHECK(i16.sample(0, i) == f.sample(0, i)); // 16bit ソースは無損失
+    CHECK_THAT(h.sample(0, i), WithinAbs(f.sample(0, i), 1e-3));
+  }
+
+  file.deleteFile();
+}
+
+// ブロック読み出しは 1 サンプルずつ読んだ結果と一致し、末端以降は 0
+TEST_CASE("SamplePlayer: readBlockStereo matches per-sample reads",
+          "[sample_player]") {
+  auto file = writeStereoTestWav(kTestLen);
+  auto block = makePrepared();
+  auto single = makePrepared();
+  block->loadSample(file);
+  single->loadSample(file);
+
+  constexpr int kFrames = kTestLen + 64;
+  constexpr double kRate = 0.75;
+  std::vector<float> outL(kFrames);
+  std::vector<float> outR(kFrames);
+  block->resetPlayhead();
+  int produced = 0;
+  {
+    const auto view = block->lock();
+    REQUIRE(static_cast<bool>(view));
+    for (int offset = 0; offset < kFrames; offset += 32)
+      produced += block->readBlockStereo(view.samples, kRate,
+                                         outL.data() + offset,
+                                         outR.data() + offset, 32);
+  }
+
+  single->resetPlayhead();
+  int expectedFrames = 0;
+  for (int i = 0; i < kFrames; ++i) {
+    bool finished = false;
+    const auto [l, r] = single->readNextStereo(kRate, finished);
+    expectedFrames += finished ? 0 : 1;
+    REQUIRE(outL[static_cast<std::size_t>(i)] == l);
+    REQUIRE(outR[static_cast<std::size_t>(i)] == r);
+  }
+  CHECK(produced == expectedFrames);
+  CHECK(outL.back() == 0.0f);
+
+  file.deleteFile();
+}
+
+// ─── ロード時の切り詰め ──────────────────────────────────────────
+
+// 先頭の無音を削り、再生が届く範囲（kMaxReachSec）より後ろは持たない
+TEST_CASE("SamplePlayer: decode trims silence and keeps the reachable window",
+          "[sample_player]") {
+  constexpr double kSr = 8000.0;
+  constexpr int kSilence = 4000; // 0.5 秒
+  constexpr int kLen = 84000;    // 10.5 秒
+  juce::AudioBuffer<float> buf(1, kLen);
+  buf.clear();
+  for (int i = kSilence; i < kLen; ++i)
+    buf.setSample(0, i, 0.25f);
+  auto file =
+      TestWav::write(TestWav::tempFile("boombaby_test_trim.wav"), buf, kSr);
+
+  juce::AudioFormatManager fm;
+  fm.registerBasicFormats();
+  const auto d = SamplePlayer::decode(file, fm);
+  REQUIRE(d.has_value());
+  const int preRoll = static_cast<int>(kSr * SampleTrim::kPreRollSec);
+  const int window = static_cast<int>(SampleTrim::kMaxReachSec * kSr) + 1;
+  CHECK(d->samples.length() == window);
+  CHECK_THAT(d->info.durationSec,
+             WithinAbs(static_cast<double>(window) / kSr, 1e-9));
+  const auto v = d->samples.view();
+  CHECK(v.sample(0, preRoll - 1) == 0.0f);
+  CHECK(v.sample(0, preRoll) == 0.25f);
+
+  // 切り詰めなければファイル全体を持つ
+  const auto whole = SamplePlayer::decode(
+      file, fm, SamplePlayer::Residency::automatic,
+      {.skipSilence = false, .maxLengthSec = 60.0});
+  REQUIRE(whole.has_value());
+  CHECK(whole->samples.length() == kLen);
+  CHECK(whole->samples.view().sample(0, kSilence - 1) == 0.0f);
+  CHECK(whole->samples.view().sample(0, kSilence) == 0.25f);
+
+  file.deleteFile();
+}
+
+// ─── peaks ──────────────────────────────────────────────────────
+
+// 未ロード時 peaks が nullptr を返すことを確認する
+TEST_CASE("SamplePlayer: peaks is null when not loaded", "[sample_player]") {
   auto sp = makePrepared();
-  std::vector<float> mn;
-  std::vector<float> mx;
-  REQUIRE_FALSE(sp->copyThumbnail(mn, mx));
+  REQUIRE(sp->peaks() == nullptr);
 }
 
-// ロード後 copyThumbnail が 512 ビンのサムネイルを返すことを確認する
-TEST_CASE("SamplePlayer: copyThumbnail returns 512-bin data after load",
+// ロード後は全レベルを持つピラミッドを共有で返し、アンロードで手放す
+TEST_CASE("SamplePlayer: peaks shares a pyramid after load",
           "[sample_player]") {
   auto sp = makePrepared();
   auto file = writeTestWav(4096);
   sp->loadSample(file);
 
-  std::vector<float> mn;
-  std::vector<float> mx;
-  REQUIRE(sp->copyThumbnail(mn, mx));
-  REQUIRE(mn.size() == 512);
-  REQUIRE(mx.size() == 512);
+  const auto peaks = sp->peaks();
+  REQUIRE(peaks != nullptr);
+  CHECK(peaks == sp->peaks()); // コピーではなく同じもの
+  CHECK(peaks == sp->loadedSample()->peaks);
+  for (int level = 0; level < PeakPyramid::kNumLevels; ++level) {
+    const auto &l = peaks->level(level);
+    REQUIRE(l.min.size() ==
+            static_cast<std::size_t>(PeakPyramid::numBins(level)));
+    REQUIRE(l.max.size() == l.min.size());
+    // min <= max が全ビンで成り立つ
+    for (std::size_t i = 0; i < l.min.size(); ++i)
+      REQUIRE(l.min[i] <= l.max[i]);
+  }
+  // サイン波なので振幅 1 近くまで振れている
+  CHECK(peaks->level(PeakPyramid::kNumLevels - 1).max[0] > 0.9f);
 
-  // min <= max が全ビンで成り立つ
-  for (std::size_t i = 0; i < mn.size(); ++i)
-    REQUIRE(mn[i] <= mx[i]);
+  sp->unloadSample();
+  CHECK(sp->peaks() == nullptr);
 
   file.deleteFile();
 }
@@ -265,16 +419,17 @@ TEST_CASE("SamplePlayer: readInterpolated does linear interpolation",
 
   // playRate=0.5 で 2 サンプル読む → s[0] と lerp(s[0], s[1], 0.5)
   bool fin = false;
-  float v0 = sp->readInterpolated(view.data, view.length, 0.5, fin);
+  const auto &s = view.samples;
+  float v0 = sp->readInterpolated(s, 0.5, fin);
   REQUIRE_FALSE(fin);
   REQUIRE_THAT(v0,
-               WithinAbs(view.data[0], 1e-5f)); // first call returns data[0]
-  float v1 = sp->readInterpolated(view.data, view.length, 0.5, fin);
+               WithinAbs(s.sample(0, 0), 1e-5f)); // first call returns s[0]
+  float v1 = sp->readInterpolated(s, 0.5, fin);
   REQUIRE_FALSE(fin);
 
   // second call returns the midpoint interpolation between the first two
   // samples
-  float expected = view.data[0] * 0.5f + view.data[1] * 0.5f;
+  float expected = s.sample(0, 0) * 0.5f + s.sample(0, 1) * 0.5f;
   REQUIRE_THAT(v1, WithinAbs(expected, 1e-5f));
 
   file.deleteFile();
@@ -288,8 +443,8 @@ TEST_CASE("SamplePlayer: lock returns invalid view when not loaded",
   auto sp = makePrepared();
   auto view = sp->lock();
   REQUIRE_FALSE(static_cast<bool>(view));
-  REQUIRE(view.data == nullptr);
-  REQUIRE(view.length == 0);
+  REQUIRE(view.samples.left == nullptr);
+  REQUIRE(view.samples.length == 0);
 }
 
 // ロード後に lock() が有効なビューを返し、長さが一致することを確認する
@@ -301,8 +456,8 @@ TEST_CASE("SamplePlayer: lock returns valid view after load",
 
   auto view = sp->lock();
   REQUIRE(static_cast<bool>(view));
-  REQUIRE(view.data != nullptr);
-  REQUIRE(view.length == kTestLen);
+  REQUIRE(view.samples.left != nullptr);
+  REQUIRE(view.samples.length == kTestLen);
 
   file.deleteFile();
 }
@@ -321,7 +476,7 @@ TEST_CASE("SamplePlayer: samples longer than 30s are truncated",
   auto view = sp->lock();
   REQUIRE(static_cast<bool>(view));
   const auto expected30s = static_cast<int>(kSampleRate * 30.0);
-  REQUIRE(view.length == expected30s);
+  REQUIRE(view.samples.length == expected30s);
   REQUIRE_THAT(sp->durationSec(), WithinAbs(30.0, 0.1));
 
   file.deleteFile();
@@ -0,0 +1,83 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "DSP/SamplePool.h"
+#include "TestWavUtils.h"
+
+#include <memory>
+
+namespace {
+/// 1ch 16bit の WAV を一時ディレクトリに書く
+juce::File writeWav(const juce::String &name) {
+  return TestWav::write(TestWav::tempFile(name), TestWav::ramp(1024, 32));
+}
+
+std::unique_ptr<SamplePlayer> makePrepared() {
+  auto sp = std::make_unique<SamplePlayer>();
+  sp->prepare();
+  return sp;
+}
+} // namespace
+
+// 同じファイルをロードしたインスタンスは 1 つのバッファを共有し、
+// 全員が手放すとプールからも消える
+TEST_CASE("SamplePool: players loading the same file share one buffer",
+          "[sample_pool]") {
+  const auto file = writeWav("boombaby_pool_shared.wav");
+  const auto key = SamplePool::keyFor(file);
+  {
+    auto a = makePrepared();
+    auto b = makePrepared();
+    a->loadSample(file);
+    b->loadSample(file);
+    REQUIRE(a->isLoaded());
+    REQUIRE(b->isLoaded());
+    CHECK(a->loadedSample() == b->loadedSample());
+    CHECK(a->lock().samples.left == b->lock().samples.left);
+    CHECK(SamplePool::find(key) == a->loadedSample());
+
+    // プレイヘッドはインスタンスごと
+    bool finished = false;
+    a->resetPlayhead();
+    b->resetPlayhead();
+    a->readNext(1.0, finished);
+    const float a1 = a->readNext(1.0, finished);
+    const float b0 = b->readNext(1.0, finished);
+    CHECK(a1 != b0);
+
+    a->unloadSample();
+    CHECK(SamplePool::find(key) != nullptr);
+    b->unloadSample();
+    CHECK(SamplePool::find(key) == nullptr);
+  }
+  file.deleteFile();
+}
+
+// 書き換えられたファイルは別のサンプルとしてデコードし直す
+TEST_CASE("SamplePool: a modified file gets a new entry", "[sample_pool]") {
+  const auto file = writeWav("boombaby_pool_modified.wav");
+  auto a = makePrepared();
+  a->loadSample(file);
+
+  file.setLastModificationTime(file.getLastModificationTime() +
+                               juce::RelativeTime::seconds(10.0));
+  auto b = makePrepared();
+  b->loadSample(file);
+  REQUIRE(b->isLoaded());
+  CHECK(a->loadedSample() != b->loadedSample());
+  CHECK(b->isLoadedFrom(file));
+  CHECK_FALSE(a->isLoadedFrom(file));
+  file.deleteFile();
+}
+
+// デコードに失敗したものは登録しない
+TEST_CASE("SamplePool: failed decodes are not registered", "[sample_pool]") {
+  int calls = 0;
+  const auto decode = [&calls]() -> std::optional<SamplePlayer::Decoded> {
+    ++calls;
+    return std::nullopt;
+  };
+  CHECK(SamplePool::acquire("pool-test:missing", decode) == nullptr);
+  CHECK(SamplePool::acquire("pool-test:missing", decode) == nullptr);
+  CHECK(calls == 2);
+  CHECK(SamplePool::find("pool-test:missing") == nullptr);
+}
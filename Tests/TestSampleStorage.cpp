@@ -0,0 +1,96 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "DSP/SampleStorage.h"
+
+#include <cmath>
+#include <limits>
+
+using Catch::Matchers::WithinAbs;
+
+namespace {
+float halfRoundTrip(float v) {
+  return SampleConvert::toFloat(SampleConvert::toHalf(v));
+}
+
+/// 2ch のランプ（R は L の符号反転）
+juce::AudioBuffer<float> makeRamp(int length) {
+  juce::AudioBuffer<float> buf(2, length);
+  for (int i = 0; i < length; ++i) {
+    const float v = static_cast<float>(i) / static_cast<float>(length);
+    buf.setSample(0, i, v);
+    buf.setSample(1, i, -v);
+  }
+  return buf;
+}
+} // namespace
+
+// ── 変換 ──────────────────────────────────────────────
+
+// half で正確に表せる値はそのまま戻り、それ以外も相対誤差 2^-11 以内
+TEST_CASE("SampleConvert: half round trip", "[sample_storage]") {
+  for (const float v : {0.0f, 1.0f, -1.0f, 0.5f, -0.25f, 65504.0f,
+                        0x1.0p-24f, 0x1.0p-14f})
+    CHECK(halfRoundTrip(v) == v);
+
+  for (int i = -1000; i <= 1000; ++i) {
+    const float v = static_cast<float>(i) / 997.0f;
+    CHECK(std::abs(halfRoundTrip(v) - v) <= std::abs(v) * 0x1.0p-11f +
+                                                0x1.0p-25f);
+  }
+
+  // 範囲外は飽和、NaN は 0（読み出し側に Inf / NaN を渡さない）
+  CHECK(halfRoundTrip(1.0e6f) == 65504.0f);
+  CHECK(halfRoundTrip(-1.0e6f) == -65504.0f);
+  CHECK(halfRoundTrip(std::numeric_limits<float>::quiet_NaN()) == 0.0f);
+}
+
+// 16bit ソース由来の値（k / 32768）は int16 で無損失、範囲外は飽和
+TEST_CASE("SampleConvert: int16 is lossless for 16-bit values",
+          "[sample_storage]") {
+  for (const int k : {-32768, -12345, -1, 0, 1, 777, 32767}) {
+    const float v = static_cast<float>(k) / 32768.0f;
+    CHECK(SampleConvert::toFloat(SampleConvert::toInt16(v)) == v);
+  }
+  CHECK(SampleConvert::toInt16(1.0f) == 32767);
+  CHECK(SampleConvert::toInt16(-2.0f) == -32768);
+}
+
+// ── SampleStorage ─────────────────────────────────────
+
+// モノは 1ch 分だけ持ち、R は L と同じ領域を指す
+TEST_CASE("SampleStorage: mono shares one channel", "[sample_storage]") {
+  const auto src = makeRamp(100);
+  const SampleStorage mono(src, 1, 100, SampleFormat::int16);
+  CHECK(mono.numChannels() == 1);
+  CHECK(mono.sizeInBytes() == 100 * sizeof(std::int16_t));
+
+  const auto v = mono.view();
+  REQUIRE(static_cast<bool>(v));
+  CHECK(v.isMono());
+  CHECK(v.left == v.right);
+  CHECK(v.length == 100);
+  CHECK_THAT(v.sample(1, 50), WithinAbs(0.5, 1.0 / 32768.0));
+}
+
+// 各形式で 2ch を持ち、float 形式はビット単位で一致する
+TEST_CASE("SampleStorage: stereo in every format", "[sample_storage]") {
+  const auto src = makeRamp(64);
+  for (const auto format :
+       {SampleFormat::float32, SampleFormat::int16, SampleFormat::half}) {
+    const SampleStorage s(src, 2, 64, format);
+    CHECK(s.format() == format);
+    CHECK(s.sizeInBytes() ==
+          2 * 64 * SampleStorage::bytesPerSample(format));
+    const auto v = s.view();
+    REQUIRE_FALSE(v.isMono());
+    for (int i = 0; i < 64; ++i) {
+      CHECK_THAT(v.sample(0, i), WithinAbs(src.getSample(0, i), 1e-3));
+      CHECK_THAT(v.sample(1, i), WithinAbs(src.getSample(1, i), 1e-3));
+      if (format == SampleFormat::float32)
+        CHECK(v.sample(0, i) == src.getSample(0, i));
+    }
+  }
+
+  CHECK_FALSE(static_cast<bool>(SampleStorage{}.view()));
+}
@@ -0,0 +1,157 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "SampleRef.h"
+#include "SampleStore.h"
+#include "StateCodec.h"
+#include "TestWavUtils.h"
+
+#include <memory>
+
+namespace {
+/// テスト中だけサンプル置き場を一時ディレクトリに向ける
+struct TempStore {
+  juce::File root = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                        .getNonexistentChildFile("BoomBabyStore", "");
+  juce::File previous = SampleStore::directory();
+  TempStore() {
+    root.createDirectory();
+    SampleStore::setDirectory(root.getChildFile("Samples"));
+  }
+  ~TempStore() {
+    SampleStore::setDirectory(previous);
+    root.deleteRecursively();
+  }
+};
+
+/// 1ch 16bit の WAV を書く（phase で中身を変える）
+juce::File writeWav(const juce::File &file, int phase) {
+  return TestWav::write(file, TestWav::ramp(512, 64, phase));
+}
+
+int numStoredFiles() {
+  return SampleStore::directory().getNumberOfChildFiles(
+      juce::File::findFiles);
+}
+} // namespace
+
+// 同じ中身は別名・別フォルダでも 1 つだけ置かれ、参照は元の名前を保つ
+TEST_CASE("SampleStore: identical samples are stored once",
+          "[sample_store]") {
+  TempStore tmp;
+  const auto a = writeWav(tmp.root.getChildFile("a/kick.wav"), 0);
+  const auto b = writeWav(tmp.root.getChildFile("b/kick copy.wav"), 0);
+  const auto c = writeWav(tmp.root.getChildFile("snare.wav"), 7);
+
+  const auto refA = SampleStore::add(a.getFullPathName());
+  const auto refB = SampleStore::add(b.getFullPathName());
+  const auto refC = SampleStore::add(c.getFullPathName());
+  REQUIRE(SampleStore::isRef(refA));
+  CHECK(refA != refB);
+  CHECK(SampleStore::fileFor(refA) == SampleStore::fileFor(refB));
+  CHECK(SampleStore::fileFor(refA) != SampleStore::fileFor(refC));
+  CHECK(numStoredFiles() == 2);
+
+  CHECK(SampleRef::displayName(refB) == "kick copy");
+  CHECK(SampleRef::exists(refA));
+  // 既にストア参照ならそのまま
+  CHECK(SampleStore::add(refA) == refA);
+  CHECK(numStoredFiles() == 2);
+
+  // 元のファイルが消えてもストアから読める
+  a.deleteFile();
+  const auto dest = tmp.root.getChildFile("exported.wav");
+  REQUIRE(SampleRef::copyTo(refA, dest));
+  CHECK(dest.getSize() == b.getSize());
+}
+
+// 埋め込み Factory サンプルも取り込める。読めない参照は空を返す
+TEST_CASE("SampleStore: adds embedded samples and rejects unknown refs",
+          "[sample_store]") {
+  TempStore tmp;
+  const auto ref = SampleStore::add("factory:junglist/direct_sample.wav");
+  REQUIRE(SampleStore::isRef(ref));
+  CHECK(SampleStore::fileFor(ref).existsAsFile());
+  CHECK(SampleRef::displayName(ref) == "direct_sample");
+
+  CHECK(SampleStore::add("factory:junglist/click_sample.wav").isEmpty());
+  CHECK(SampleStore::add("relative/path.wav").isEmpty());
+  CHECK(SampleStore::add(
+            tmp.root.getChildFile("missing.wav").getFullPathName())
+            .isEmpty());
+  CHECK(SampleStore::fileFor("sample:not-a-hash/x.wav") == juce::File{});
+  CHECK_FALSE(SampleRef::exists("sample:0123456789abcdef/missing.wav"));
+}
+
+// 同じ参照のデコード結果は共有され、ロードはそれを使い回す
+TEST_CASE("SampleStore: decoded samples are shared across loads",
+          "[sample_store]") {
+  TempStore tmp;
+  const auto ref = SampleStore::add(
+      writeWav(tmp.root.getChildFile("kick.wav"), 0).getFullPathName());
+  REQUIRE(ref.isNotEmpty());
+
+  const auto first = SampleStore::decode(ref);
+  REQUIRE(first != nullptr);
+  CHECK(first->source == ref);
+  CHECK(SampleRef::isCurrent(*first));
+  CHECK(SampleStore::decode(ref) == first);
+
+  juce::AudioFormatManager fm;
+  fm.registerBasicFormats();
+  CHECK(SampleRef::decode(ref, fm) == first);
+
+  SamplePlayer sampler;
+  sampler.prepare();
+  SampleRef::loadInto(sampler, ref);
+  REQUIRE(sampler.isLoaded());
+  CHECK(SampleRef::isLoadedIn(sampler, ref));
+  CHECK(sampler.durationSec() == first->info.durationSec);
+}
+
+// 消えたファイル参照は、保存時の内容ハッシュで置き場の実体へ付け替える
+TEST_CASE("SampleRef: relocates a missing file by its content hash",
+          "[sample_store]") {
+  TempStore tmp;
+  const auto file = writeWav(tmp.root.getChildFile("kick.wav"), 0);
+  const auto path = file.getFullPathName();
+  const auto hash = StateCodec::hashFile(file);
+  const auto stored = SampleStore::add(path);
+  REQUIRE(stored.isNotEmpty());
+
+  // ファイルがあるうちはそのまま
+  CHECK(SampleRef::relocate(path, hash) == path);
+
+  file.deleteFile();
+  CHECK(SampleRef::relocate(path, hash) == stored);
+  CHECK(SampleStore::find(hash, "kick.wav") == stored);
+
+  // ハッシュ不明・置き場に無い中身・ファイル以外の参照は変えない
+  CHECK(SampleRef::relocate(path, 0) == path);
+  CHECK(SampleRef::relocate(path, hash ^ 1) == path);
+  CHECK(SampleRef::relocate(stored, hash) == stored);
+}
+
+// 同じ中身を別名で参照しても 1 回だけデコードし、ロード済みとみなす
+TEST_CASE("SampleStore: names sharing one hash share one decode",
+          "[sample_store]") {
+  TempStore tmp;
+  const auto refA = SampleStore::add(
+      writeWav(tmp.root.getChildFile("a/kick.wav"), 3).getFullPathName());
+  const auto refB = SampleStore::add(
+      writeWav(tmp.root.getChildFile("b/boom.wav"), 3).getFullPathName());
+  REQUIRE(refA.isNotEmpty());
+  REQUIRE(refA != refB);
+
+  const auto a = SampleStore::decode(refA);
+  REQUIRE(a != nullptr);
+  CHECK(SampleStore::decode(refB) == a);
+  CHECK(SampleRef::sameSample(a->source, refB));
+  CHECK_FALSE(SampleRef::sameSample(a->source, "sample:0123456789abcdef/x"));
+
+  SamplePlayer sampler;
+  sampler.prepare();
+  SampleRef::loadInto(sampler, refA);
+  REQUIRE(sampler.isLoaded());
+  CHECK(SampleRef::isLoadedIn(sampler, refB));
+  CHECK(sampler.loadedSample() == a);
+}
@@ -0,0 +1,35 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "DSP/SampleTrim.h"
+
+#include <array>
+#include <vector>
+
+// 無音判定は ch をまたいで最初に閾値を超えたフレーム、無ければ -1
+TEST_CASE("SampleTrim: firstAbove finds the first audible frame",
+          "[sample_trim]") {
+  std::vector<float> l(100, 0.0f);
+  std::vector<float> r(100, 0.0f);
+  const std::array<const float *, 2> ch{l.data(), r.data()};
+  CHECK(SampleTrim::firstAbove(ch.data(), 2, 100,
+                               SampleTrim::kSilenceThreshold) == -1);
+
+  l[60] = 0.5f;
+  r[40] = -0.01f; // 負の値も振幅で見る
+  CHECK(SampleTrim::firstAbove(ch.data(), 2, 100,
+                               SampleTrim::kSilenceThreshold) == 40);
+  CHECK(SampleTrim::firstAbove(ch.data(), 1, 100,
+                               SampleTrim::kSilenceThreshold) == 60);
+
+  // 閾値ちょうどは無音扱い
+  r[40] = SampleTrim::kSilenceThreshold;
+  CHECK(SampleTrim::firstAbove(ch.data(), 2, 100,
+                               SampleTrim::kSilenceThreshold) == 60);
+}
+
+// 届く範囲は Decay / Pitch の上限から決まる（2000 ms を 4 倍速 = 8 秒）
+TEST_CASE("SampleTrim: reach follows the Decay and Pitch maxima",
+          "[sample_trim]") {
+  CHECK(SampleTrim::kMaxPlayRate == 4.0);
+  CHECK(SampleTrim::kMaxReachSec == 8.0);
+}
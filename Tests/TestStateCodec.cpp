@@ -0,0 +1,171 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "StateCodec.h"
+
+#include <array>
+
+namespace {
+constexpr std::array<const char *, 3> kIds = {"a", "b", "c"};
+
+/// APVTS の copyState() と同じ形の ValueTree を作る
+juce::ValueTree makeState() {
+  juce::ValueTree state{"BoomBabyState"};
+  state.setProperty("presetName", "Kick", nullptr);
+  state.setProperty("clickSamplePath", "", nullptr);
+  state.setProperty("directSamplePath", "/no/such/file.wav", nullptr);
+  for (std::size_t i = 0; i < kIds.size(); ++i) {
+    juce::ValueTree p{"PARAM"};
+    p.setProperty("id", juce::String(kIds[i]), nullptr);
+    p.setProperty("value", 0.5f * static_cast<float>(i + 1), nullptr);
+    state.appendChild(p, nullptr);
+  }
+  juce::ValueTree env{"ENVELOPE"};
+  env.setProperty("name", "amp", nullptr);
+  env.setProperty("defaultValue", 0.8f, nullptr);
+  for (int i = 0; i < 3; ++i) {
+    juce::ValueTree pt{"POINT"};
+    pt.setProperty("timeMs", 10.0f * static_cast<float>(i), nullptr);
+    pt.setProperty("value", 1.0f - 0.25f * static_cast<float>(i), nullptr);
+    pt.setProperty("curve", 0.1f * static_cast<float>(i), nullptr);
+    env.appendChild(pt, nullptr);
+  }
+  state.appendChild(env, nullptr);
+  juce::ValueTree mode{"CLICK_MODE_STATE"};
+  mode.setProperty("name", "clickNoise", nullptr);
+  mode.setProperty("hpfFreq", 120.0, nullptr);
+  state.appendChild(mode, nullptr);
+  return state;
+}
+
+juce::ValueTree roundTrip(const juce::ValueTree &state,
+                          std::span<const char *const> ids) {
+  StateCodec::SampleHashCache hashes;
+  juce::MemoryBlock blob;
+  StateCodec::encode(state, ids, hashes, blob);
+  return StateCodec::decode(blob.getData(), static_cast<int>(blob.getSize()),
+                            ids);
+}
+} // namespace
+
+// ── 往復 ──────────────────────────────────────────────
+
+// パラメータ・エンベロープ・その他の子ノード・プロパティが復元される
+TEST_CASE("StateCodec: round trip preserves state", "[state_codec]") {
+  const auto src = makeState();
+  const auto dst = roundTrip(src, kIds);
+  REQUIRE(dst.hasType("BoomBabyState"));
+
+  for (const auto *id : kIds) {
+    const auto a = src.getChildWithProperty("id", juce::String(id));
+    const auto b = dst.getChildWithProperty("id", juce::String(id));
+    REQUIRE(b.isValid());
+    CHECK(static_cast<float>(b["value"]) == static_cast<float>(a["value"]));
+  }
+
+  const auto env = dst.getChildWithName("ENVELOPE");
+  REQUIRE(env.isValid());
+  CHECK(env["name"].toString() == "amp");
+  CHECK(static_cast<float>(env["defaultValue"]) == 0.8f);
+  REQUIRE(env.getNumChildren() == 3);
+  CHECK(static_cast<float>(env.getChild(2)["timeMs"]) == 20.0f);
+  CHECK(static_cast<float>(env.getChild(2)["value"]) == 0.5f);
+  CHECK(static_cast<float>(env.getChild(1)["curve"]) == 0.1f);
+
+  const auto mode = dst.getChildWithName("CLICK_MODE_STATE");
+  REQUIRE(mode.isValid());
+  CHECK(static_cast<double>(mode["hpfFreq"]) == 120.0);
+
+  CHECK(dst["presetName"].toString() == "Kick");
+  CHECK(dst["clickSamplePath"].toString().isEmpty());
+  CHECK(dst["directSamplePath"].toString() == "/no/such/file.wav");
+}
+
+// XML 版より小さい
+TEST_CASE("StateCodec: binary is smaller than XML", "[state_codec]") {
+  const auto state = makeState();
+  StateCodec::SampleHashCache hashes;
+  juce::MemoryBlock blob;
+  StateCodec::encode(state, kIds, hashes, blob);
+  const auto xml = state.toXmlString();
+  CHECK(blob.getSize() < static_cast<size_t>(xml.getNumBytesAsUTF8()));
+  CHECK(StateCodec::isBinaryState(blob.getData(),
+                                  static_cast<int>(blob.getSize())));
+}
+
+// サンプルは内容ハッシュ付きで保存され、ファイルが消えてもハッシュは残る
+TEST_CASE("StateCodec: sample references carry a content hash",
+          "[state_codec]") {
+  const auto file = juce::File::createTempFile(".wav");
+  REQUIRE(file.replaceWithText("not really a wav"));
+  auto state = makeState();
+  state.setProperty("clickSamplePath", file.getFullPathName(), nullptr);
+
+  const auto restored = roundTrip(state, kIds);
+  const auto hash = restored["clickSamplePathHash"].toString();
+  CHECK(hash ==
+        juce::String::toHexString(
+            static_cast<juce::int64>(StateCodec::hashFile(file))));
+
+  file.deleteFile();
+  const auto again = roundTrip(restored, kIds);
+  CHECK(again["clickSamplePathHash"].toString() == hash);
+}
+
+// 別のサンプルへ差し替えた・クリアしたら前の中身のハッシュは残らない
+TEST_CASE("StateCodec: changing a sample reference drops its old hash",
+          "[state_codec]") {
+  const auto file = juce::File::createTempFile(".wav");
+  REQUIRE(file.replaceWithText("not really a wav"));
+  auto state = makeState();
+  state.setProperty("clickSamplePath", file.getFullPathName(), nullptr);
+  auto restored = roundTrip(state, kIds);
+  REQUIRE(restored.hasProperty("clickSamplePathHash"));
+
+  // 同じ参照を書き直すだけなら保持する
+  StateCodec::setSamplePath(restored, "clickSamplePath",
+                            file.getFullPathName());
+  CHECK(restored.hasProperty("clickSamplePathHash"));
+
+  StateCodec::setSamplePath(restored, "clickSamplePath", "/no/such/other.wav");
+  CHECK_FALSE(restored.hasProperty("clickSamplePathHash"));
+  CHECK_FALSE(roundTrip(restored, kIds).hasProperty("clickSamplePathHash"));
+
+  restored = roundTrip(state, kIds);
+  StateCodec::setSamplePath(restored, "clickSamplePath", {});
+  CHECK_FALSE(restored.hasProperty("clickSamplePathHash"));
+  file.deleteFile();
+}
+
+// 保存後に追加されたパラメータは PARAM ノード無し（既定値扱い）
+TEST_CASE("StateCodec: newer parameter list falls back to defaults",
+          "[state_codec]") {
+  StateCodec::SampleHashCache hashes;
+  juce::MemoryBlock blob;
+  StateCodec::encode(makeState(), std::span(kIds).first(2), hashes, blob);
+  const auto dst = StateCodec::decode(
+      blob.getData(), static_cast<int>(blob.getSize()), kIds);
+  REQUIRE(dst.isValid());
+  CHECK(dst.getChildWithProperty("id", "b").isValid());
+  CHECK_FALSE(dst.getChildWithProperty("id", "c").isValid());
+}
+
+// ── 不正データ ────────────────────────────────────────
+
+// XML・途中で切れたデータ・未知の新バージョンは受け付けない
+TEST_CASE("StateCodec: rejects foreign or broken data", "[state_codec]") {
+  const juce::String xml = "<BoomBabyState/>";
+  CHECK_FALSE(StateCodec::isBinaryState(xml.toRawUTF8(),
+                                        static_cast<int>(xml.length())));
+
+  StateCodec::SampleHashCache hashes;
+  juce::MemoryBlock blob;
+  StateCodec::encode(makeState(), kIds, hashes, blob);
+  CHECK_FALSE(StateCodec::decode(blob.getData(), 16, kIds).isValid());
+
+  juce::MemoryBlock future(blob);
+  static_cast<char *>(future.getData())[4] =
+      static_cast<char>(StateCodec::kVersion + 1);
+  CHECK_FALSE(StateCodec::decode(future.getData(),
+                                 static_cast<int>(future.getSize()), kIds)
+                  .isValid());
+}
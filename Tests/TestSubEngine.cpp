@@ -15,12 +15,12 @@ constexpr double kSampleRate = 44100.0;
 constexpr int kBlockSize = 512;
 constexpr float kDefaultFreqHz = 200.0f;
 
-/// freqLut に定数周波数を設定するヘルパー
+/// freq LUT に定数周波数を設定するヘルパー
 void setConstantFreqLut(SubEngine &eng, float hz = kDefaultFreqHz) {
-  std::array<float, EnvelopeLutManager::lutSize> buf;
-  buf.fill(hz);
-  eng.freqLut().bake(buf.data(), EnvelopeLutManager::lutSize);
-  eng.freqLut().setDurationMs(300.0f);
+  eng.luts().update([hz](SubEngine::LutBank::Luts &luts) {
+    luts[SubEngine::kFreqLut].setFlat(hz);
+    luts[SubEngine::kFreqLut].durationMs = 300.0f;
+  });
 }
 
 /// prepare → freq LUT 設定 済みのエンジンを返すヘルパー
@@ -32,11 +32,10 @@ std::unique_ptr<SubEngine> makeEngine(float lengthMs = 300.0f,
 
   // dist/mix LUT はリセット後 1.0f 埋め → drive 24dB / mix=additive になるので
   // テスト用にゼロ（クリーン／Sine）へ上書きする
-  std::array<float, EnvelopeLutManager::lutSize> zeros{};
-  eng->distLut().bake(zeros.data(), EnvelopeLutManager::lutSize);
-  eng->distLut().setDurationMs(300.0f);
-  eng->mixLut().bake(zeros.data(), EnvelopeLutManager::lutSize);
-  eng->mixLut().setDurationMs(300.0f);
+  eng->luts().update([](SubEngine::LutBank::Luts &luts) {
+    luts[SubEngine::kDistLut].setFlat(0.0f);
+    luts[SubEngine::kMixLut].setFlat(0.0f);
+  });
 
   eng->setLengthMs(lengthMs);
   eng->setGainDb(gainDb);
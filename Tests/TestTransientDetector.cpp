@@ -2,6 +2,8 @@
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 
 #include "DSP/TransientDetector.h"
+#include <cmath>
+#include <numbers>
 #include <vector>
 
 namespace {
@@ -213,3 +215,176 @@ TEST_CASE("TransientDetector: empty block returns -1 without crash",
   const std::vector<float> empty;
   REQUIRE(td.process(empty) == -1);
 }
+
+// ─── isSettled(): アイドル判定 ──────────────────────────────────
+
+// 初期状態は settled、トリガー直後は未 settled、長い無音の後に settled へ戻ることを確認する
+TEST_CASE("TransientDetector: isSettled tracks envelope decay",
+          "[transient_detector]") {
+  TransientDetector td;
+  td.prepare(kSr);
+  td.setEnabled(true);
+  td.setThresholdDb(-40.0f);
+  td.setHoldMs(10.0f);
+  REQUIRE(td.isSettled());
+
+  const auto block = makeImpulseBlock(64, 0);
+  REQUIRE(td.process(block) >= 0);
+  REQUIRE_FALSE(td.isSettled());
+
+  // slow release 200ms → 5 秒分の無音で -100 dB 以下まで減衰
+  for (int i = 0; i < 50; ++i)
+    processZeros(td, 100);
+  REQUIRE(td.isSettled());
+}
+
+// ─── Onsets: 1 ブロック内の複数オンセット ─────────────────────────
+
+// 大きなブロック内の複数インパルスがすべて位置順に追記されることを確認する
+TEST_CASE("TransientDetector: reports every onset in a large block",
+          "[transient_detector]") {
+  TransientDetector td;
+  td.prepare(kSr);
+  td.setEnabled(true);
+  td.setThresholdDb(-40.0f);
+  td.setHoldMs(20.0f);
+
+  std::vector<float> block(4096, 0.0f);
+  for (const int p : {100, 1600, 3100})
+    block[static_cast<size_t>(p)] = 1.0f;
+
+  TransientDetector::Onsets onsets;
+  td.process(block, onsets);
+  REQUIRE(onsets.size() == 3);
+  CHECK(onsets[0].position == 100);
+  CHECK(onsets[1].position == 1600);
+  CHECK(onsets[2].position == 3100);
+}
+
+// 容量を超えたオンセットは破棄され、バッファがあふれないことを確認する
+TEST_CASE("TransientDetector: onsets buffer drops beyond capacity",
+          "[transient_detector]") {
+  TransientDetector::Onsets onsets;
+  for (int i = 0; i < TransientDetector::Onsets::kCapacity + 5; ++i)
+    onsets.push({i, 0});
+  CHECK(onsets.size() == TransientDetector::Onsets::kCapacity);
+  CHECK(onsets[TransientDetector::Onsets::kCapacity - 1].position ==
+        TransientDetector::Onsets::kCapacity - 1);
+  onsets.clear();
+  CHECK(onsets.empty());
+}
+
+// ─── Onset::lag: 立ち上がり開始からの検出遅れ ──────────────────────
+
+// 緩やかなランプでは検出位置より前に立ち上がり開始が推定され、
+// その推定位置がランプ開始以降に収まることを確認する
+TEST_CASE("TransientDetector: onset lag points back to rise start",
+          "[transient_detector]") {
+  TransientDetector td;
+  td.prepare(kSr);
+  td.setEnabled(true);
+  td.setThresholdDb(-24.0f);
+
+  constexpr int kRampStart = 32;
+  // 定常ランプでの onset ≈ 傾き × slow attack（10ms = kSr で 10 サンプル）。
+  // 200 サンプルでは 0.05 と −24 dB（≈0.063）に届かず検出されないため、
+  // 閾値を確実に超える 40 サンプル（≈0.25）にする。
+  constexpr int kRampLen = 40;
+  std::vector<float> block(512, 0.0f);
+  for (int i = 0; i < kRampLen; ++i)
+    block[static_cast<size_t>(kRampStart + i)] =
+        static_cast<float>(i + 1) / static_cast<float>(kRampLen);
+
+  TransientDetector::Onsets onsets;
+  td.process(block, onsets);
+  REQUIRE(onsets.size() == 1);
+  const auto onset = onsets[0];
+  REQUIRE(onset.position > kRampStart);
+  CHECK(onset.lag > 0);
+  CHECK(onset.position - onset.lag >= kRampStart);
+}
+
+// 急峻なインパルスでは検出遅れがほぼ 0 であることを確認する
+TEST_CASE("TransientDetector: impulse has near-zero onset lag",
+          "[transient_detector]") {
+  TransientDetector td;
+  td.prepare(kSr);
+  td.setEnabled(true);
+  td.setThresholdDb(-40.0f);
+
+  TransientDetector::Onsets onsets;
+  td.process(makeImpulseBlock(64, 10), onsets);
+  REQUIRE(onsets.size() == 1);
+  CHECK(onsets[0].position == 10);
+  CHECK(onsets[0].lag <= 1);
+}
+
+// ─── 帯域検出（OnsetFilterbank） ──────────────────────────────────
+
+namespace {
+// 帯域検出は実際のオーディオレートで確認する
+constexpr double kBandSr = 44100.0;
+
+/// 減衰するサイン波バースト（start から len サンプル）
+std::vector<float> makeBurst(float hz, int start, int len, int total) {
+  std::vector<float> v(static_cast<size_t>(total), 0.0f);
+  const auto sr = static_cast<float>(kBandSr);
+  for (int i = 0; i < len; ++i) {
+    const auto t = static_cast<float>(i);
+    v[static_cast<size_t>(start + i)] =
+        0.8f * std::exp(-t / (0.02f * sr)) *
+        std::sin(2.0f * std::numbers::pi_v<float> * hz * t / sr);
+  }
+  return v;
+}
+
+int countOnsets(TransientDetector::Band band, const std::vector<float> &in) {
+  TransientDetector td;
+  td.prepare(kBandSr);
+  td.setEnabled(true);
+  td.setBand(band);
+  TransientDetector::Onsets onsets;
+  td.process(in, onsets);
+  return onsets.size();
+}
+} // namespace
+
+// フィルターバンクは kDecimation サンプル毎に 1 フレームを出力することを確認する
+TEST_CASE("OnsetFilterbank: emits one frame per decimation step",
+          "[transient_detector]") {
+  OnsetFilterbank fb;
+  fb.prepare(kBandSr);
+  int frames = 0;
+  float out = 0.0f;
+  for (int i = 0; i < OnsetFilterbank::kDecimation * 10; ++i)
+    frames += fb.push(1.0f, OnsetFilterbank::Band::low, out) ? 1 : 0;
+  CHECK(frames == 10);
+}
+
+// 高域のバースト（ハイハット相当）は Full では検出され、Low / Mid では
+// 無視されることを確認する
+TEST_CASE("TransientDetector: band mode ignores high-frequency bleed",
+          "[transient_detector]") {
+  const auto hat = makeBurst(8000.0f, 1000, 4000, 8192);
+  CHECK(countOnsets(TransientDetector::Band::full, hat) == 1);
+  CHECK(countOnsets(TransientDetector::Band::low, hat) == 0);
+  CHECK(countOnsets(TransientDetector::Band::mid, hat) == 0);
+}
+
+// Low 帯域で低域バーストを検出し、位置がバースト開始付近になることを確認する
+TEST_CASE("TransientDetector: low band detects kick fundamental",
+          "[transient_detector]") {
+  TransientDetector td;
+  td.prepare(kBandSr);
+  td.setEnabled(true);
+  td.setBand(TransientDetector::Band::low);
+
+  const auto kick = makeBurst(60.0f, 1000, 4000, 8192);
+  TransientDetector::Onsets onsets;
+  td.process(kick, onsets);
+  REQUIRE(onsets.size() == 1);
+  const auto onset = onsets[0];
+  CHECK(onset.position >= 1000);
+  CHECK(onset.position - onset.lag >= 1000 - OnsetFilterbank::kDecimation);
+  CHECK(onset.position < 1000 + 128);
+}
@@ -0,0 +1,95 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "DSP/TripleBuffer.h"
+
+#include <array>
+#include <atomic>
+#include <thread>
+
+namespace {
+/// 書き手が全要素を同じ値で埋める（読み手は不揃いなら破損を検出できる）
+struct Payload {
+  std::array<int, 64> v{};
+};
+} // namespace
+
+// ── 基本動作 ──────────────────────────────────────────
+
+// 初期値は全面に入り、acquire() は公開前でも初期値を返す
+TEST_CASE("TripleBuffer: initial value", "[triple_buffer]") {
+  TripleBuffer<int> tb(7);
+  CHECK(tb.acquire() == 7);
+  CHECK(tb.current() == 7);
+}
+
+// publish() した値が次の acquire() で見える
+TEST_CASE("TripleBuffer: acquire sees latest publish", "[triple_buffer]") {
+  TripleBuffer<int> tb(0);
+  tb.publish(1);
+  CHECK(tb.acquire() == 1);
+  tb.publish(2);
+  tb.publish(3);
+  CHECK(tb.acquire() == 3);
+  // 新しい公開がなければ同じ面のまま
+  CHECK(tb.acquire() == 3);
+}
+
+// 読み手が保持している面は、連続で公開されても書き換えられない
+TEST_CASE("TripleBuffer: held snapshot survives repeated publishes",
+          "[triple_buffer]") {
+  TripleBuffer<int> tb(0);
+  tb.publish(10);
+  const int &held = tb.acquire();
+  for (int i = 11; i < 20; ++i)
+    tb.publish(i);
+  CHECK(held == 10);
+  CHECK(tb.current() == 10);
+  CHECK(tb.acquire() == 19);
+}
+
+// reset() は全面を同じ値にし、未読の公開を捨てる
+TEST_CASE("TripleBuffer: reset", "[triple_buffer]") {
+  TripleBuffer<int> tb(0);
+  tb.publish(5);
+  tb.reset(9);
+  CHECK(tb.acquire() == 9);
+  tb.publish(4);
+  CHECK(tb.acquire() == 4);
+}
+
+// ── 並行動作 ──────────────────────────────────────────
+
+// 書き手と読み手を並行に回し、読み手が不揃いな面や逆行を見ないこと
+TEST_CASE("TripleBuffer: concurrent reader never sees torn data",
+          "[triple_buffer]") {
+  TripleBuffer<Payload> tb;
+  constexpr int kWrites = 20000;
+  std::atomic<bool> done{false};
+
+  std::thread writer([&] {
+    for (int n = 1; n <= kWrites; ++n) {
+      tb.back().v.fill(n);
+      tb.publish();
+    }
+    done.store(true);
+  });
+
+  bool torn = false;
+  bool backwards = false;
+  int last = 0;
+  auto check = [&] {
+    const auto &p = tb.acquire();
+    for (const int x : p.v)
+      torn = torn || x != p.v[0];
+    backwards = backwards || p.v[0] < last;
+    last = p.v[0];
+  };
+  while (!done.load())
+    check();
+  writer.join();
+  check();
+
+  CHECK_FALSE(torn);
+  CHECK_FALSE(backwards);
+  CHECK(last == kWrites);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include <memory>
+
+/// テスト用 WAV の書き出し（サンプル関連のテストで共用）
+namespace TestWav {
+
+/// buf を file へ WAV（PCM bitsPerSample ビット）で書き出して file を返す。
+/// 親ディレクトリが無ければ作る。ch 数は buf に合わせる。
+inline juce::File write(const juce::File &file,
+                        const juce::AudioBuffer<float> &buf,
+                        double sampleRate = 44100.0, int bitsPerSample = 16) {
+  file.getParentDirectory().createDirectory();
+  file.deleteFile();
+  juce::WavAudioFormat wav;
+  std::unique_ptr<juce::OutputStream> stream(
+      std::make_unique<juce::FileOutputStream>(file));
+  auto writer = wav.createWriterFor(
+      stream, juce::AudioFormatWriterOptions{}
+                  .withSampleRate(sampleRate)
+                  .withNumChannels(buf.getNumChannels())
+                  .withBitsPerSample(bitsPerSample));
+  REQUIRE(writer != nullptr);
+  writer->writeFromAudioSampleBuffer(buf, 0, buf.getNumSamples());
+  writer.reset(); // flush
+  return file;
+}
+
+/// 1ch のノコギリ波（0〜1 を period サンプル周期、phase だけずらす）。
+/// phase を変えると中身（内容ハッシュ）の違うサンプルになる。
+inline juce::AudioBuffer<float> ramp(int numSamples, int period,
+                                     int phase = 0) {
+  juce::AudioBuffer<float> buf(1, numSamples);
+  for (int i = 0; i < numSamples; ++i)
+    buf.setSample(0, i,
+                  static_cast<float>((i + phase) % period) /
+                      static_cast<float>(period));
+  return buf;
+}
+
+/// 一時ディレクトリの name
+inline juce::File tempFile(const juce::String &name) {
+  return juce::File::getSpecialLocation(juce::File::tempDirectory)
+      .getChildFile(name);
+}
+
+} // namespace TestWav